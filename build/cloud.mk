@@ -4,10 +4,14 @@ CLOUD_SERVER_SOURCES = \
 	$(SRC)/Cloud/Serialiser.cpp \
 	$(SRC)/Cloud/Client.cpp \
 	$(SRC)/Cloud/Thermal.cpp \
-	$(SRC)/Cloud/Data.cpp \
+	$(SRC)/Cloud/ShardedClient.cpp \
+	$(SRC)/Cloud/ShardedThermal.cpp \
+	$(SRC)/Cloud/ShardedData.cpp \
 	$(SRC)/Cloud/Sender.cpp \
+	$(SRC)/Cloud/AsyncLog.cpp \
+	$(SRC)/Cloud/Journal.cpp \
 	$(SRC)/Cloud/Main.cpp
-CLOUD_SERVER_DEPENDS = ASYNC IO OS GEO MATH UTIL
+CLOUD_SERVER_DEPENDS = ASYNC IO OS GEO MATH UTIL THREAD
 $(eval $(call link-program,xcsoar-cloud-server,CLOUD_SERVER))
 
 CLOUD_TO_KML_SOURCES = \
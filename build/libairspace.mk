@@ -9,6 +9,7 @@ AIRSPACE_SOURCES = \
 	$(AIRSPACE_SRC_DIR)/AbstractAirspace.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspaceCircle.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspacePolygon.cpp \
+	$(AIRSPACE_SRC_DIR)/AirspacePolygonIndex.cpp \
 	$(AIRSPACE_SRC_DIR)/Airspaces.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspaceIntersectSort.cpp \
 	$(AIRSPACE_SRC_DIR)/SoonestAirspace.cpp \
@@ -4,6 +4,7 @@ TERRAIN_SOURCES = \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
 	$(SRC)/Terrain/RasterTileCache.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/ZzipStream.cpp \
 	$(SRC)/Terrain/Loader.cpp \
 	$(SRC)/Terrain/WorldFile.cpp \
@@ -12,6 +13,7 @@ TERRAIN_SOURCES = \
 	$(SRC)/Terrain/RasterTerrain.cpp \
 	$(SRC)/Terrain/Thread.cpp \
 	$(SRC)/Terrain/HeightMatrix.cpp \
+	$(SRC)/Terrain/SlopeShading.cpp \
 	$(SRC)/Terrain/RasterRenderer.cpp \
 	$(SRC)/Terrain/TerrainRenderer.cpp \
 	$(SRC)/Terrain/TerrainSettings.cpp
@@ -16,6 +16,7 @@ UTIL_SOURCES = \
 	$(UTIL_SRC_DIR)/StaticString.cxx \
 	$(UTIL_SRC_DIR)/AllocatedString.cxx \
 	$(UTIL_SRC_DIR)/StringView.cxx \
+	$(UTIL_SRC_DIR)/StringViewParser.cpp \
 	$(UTIL_SRC_DIR)/StringCompare.cxx \
 	$(UTIL_SRC_DIR)/StringUtil.cpp
 
@@ -32,6 +32,7 @@ LUA_SOURCES = \
         $(SRC)/Lua/Settings.cpp \
         $(SRC)/Lua/Wind.cpp \
         $(SRC)/Lua/Logger.cpp \
+        $(SRC)/Lua/Timing.cpp \
         $(SRC)/Lua/Tracking.cpp \
 		$(SRC)/Lua/Replay.cpp \
 	    $(SRC)/Lua/InputEvent.cpp \
@@ -75,6 +75,8 @@ DIALOG_SOURCES = \
 	$(SRC)/Dialogs/StatusPanels/TaskStatusPanel.cpp \
 	$(SRC)/Dialogs/StatusPanels/RulesStatusPanel.cpp \
 	$(SRC)/Dialogs/StatusPanels/TimesStatusPanel.cpp \
+	$(SRC)/Dialogs/StatusPanels/TimingStatusPanel.cpp \
+	$(SRC)/Dialogs/StatusPanels/TopographyStatusPanel.cpp \
 	\
 	$(SRC)/Dialogs/Waypoint/WaypointInfoWidget.cpp \
 	$(SRC)/Dialogs/Waypoint/WaypointCommandsWidget.cpp \
@@ -208,6 +210,7 @@ XCSOAR_SOURCES := \
 	\
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Airspace/NearestAirspace.cpp \
@@ -263,6 +266,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Computer/GlideRatioCalculator.cpp \
 	$(SRC)/Computer/GlideRatioComputer.cpp \
 	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/ComputerProfiler.cpp \
 	$(SRC)/Computer/GlideComputerBlackboard.cpp \
 	$(SRC)/Computer/GlideComputerAirData.cpp \
 	$(SRC)/Computer/WaveComputer.cpp \
@@ -517,6 +521,7 @@ XCSOAR_SOURCES := \
 	$(SRC)/Blackboard/ScopeCalculatedListener.cpp \
 	\
 	$(SRC)/Blackboard/DeviceBlackboard.cpp \
+	$(SRC)/Blackboard/BlackboardStatistics.cpp \
 	$(SRC)/MapWindow/MapWindowBlackboard.cpp \
 	$(SRC)/Dialogs/DialogSettings.cpp \
 	$(SRC)/UIReceiveBlackboard.cpp \
@@ -534,12 +539,15 @@ XCSOAR_SOURCES := \
 	$(SRC)/DisplayMode.cpp \
 	\
 	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyFileStore.cpp \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/TopographyFileRenderer.cpp \
 	$(SRC)/Topography/TopographyRenderer.cpp \
 	$(SRC)/Topography/Thread.cpp \
+	$(SRC)/Topography/Prefetch.cpp \
 	$(SRC)/Topography/TopographyGlue.cpp \
 	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ShapeArena.cpp \
 	$(SRC)/Topography/CachedTopographyRenderer.cpp \
 	$(SRC)/Markers/Markers.cpp \
 	\
@@ -46,12 +46,13 @@ PYTHON_SOURCES = \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceIntersectionVisitor.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceIntersectSort.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspacePolygon.cpp \
+	$(ENGINE_SRC_DIR)/Airspace/AirspacePolygonIndex.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/Airspaces.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceSorter.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceAircraftPerformance.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/Predicate/AirspacePredicate.cpp \
 	$(SRC)/NMEA/Aircraft.cpp
-PYTHON_LDADD = $(DEBUG_REPLAY_LDADD)
+PYTHON_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
 PYTHON_LDLIBS = $(shell python-config --ldflags)
 PYTHON_DEPENDS = CONTEST WAYPOINT UTIL ZZIP GEO MATH TIME
 PYTHON_CPPFLAGS = $(shell python-config --includes) \
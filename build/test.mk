@@ -87,6 +87,8 @@ TEST_NAMES = \
 	test_pressure \
 	test_task \
 	TestOverwritingRingBuffer \
+	TestSnapshotBuffer \
+	TestStandbyThread \
 	TestDateTime TestRoughTime TestWrapClock \
 	TestMath \
 	TestMathTables \
@@ -94,11 +96,11 @@ TEST_NAMES = \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
 	TestAllocatedGrid \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestFlatHashMap TestPackedKDTree TestStringViewParser TestGeoBounds TestGeoClip \
 	TestLogger TestGRecord TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
-	TestColorRamp TestGeoPoint TestDiffFilter \
+	TestColorRamp TestSlopeShading TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
 	TestMacCready TestOrderedTask TestAATPoint \
@@ -108,6 +110,15 @@ TEST_NAMES = \
 	TestTeamCode \
 	TestZeroFinder \
 	TestAirspaceParser \
+	TestAirspacePolygonIndex \
+	TestAirspaceWarningManager \
+	TestAbortTask \
+	TestTopographyFile \
+	TestTopographyFileStore \
+	TestTopographyPrefetch \
+	TestRasterTileStore \
+	TestHeightMatrix \
+	TestShapeArena \
 	TestMETARParser \
 	TestIGCParser \
 	TestByteOrder \
@@ -122,8 +133,14 @@ TEST_NAMES = \
 	TestIGCFilenameFormatter \
 	TestLXNToIGC \
 	TestLeastSquares \
-	TestThermalBand
+	TestThermalBand \
+	TestOLCTriangle \
+	TestComputerProfiler
 
+ifeq ($(TARGET),UNIX)
+# the cloud server is POSIX-only
+TEST_NAMES += TestCloudJournal
+endif
 
 TESTS = $(call name-to-bin,$(TEST_NAMES))
 
@@ -140,6 +157,22 @@ TEST_LEASTSQUARES_SOURCES = \
 	$(TEST_SRC_DIR)/TestLeastSquares.cpp
 $(eval $(call link-program,TestLeastSquares,TEST_LEASTSQUARES))
 
+TEST_OLC_TRIANGLE_SOURCES = \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestOLCTriangle.cpp
+TEST_OLC_TRIANGLE_DEPENDS = CONTEST GEO MATH UTIL
+$(eval $(call link-program,TestOLCTriangle,TEST_OLC_TRIANGLE))
+
+TEST_COMPUTER_PROFILER_SOURCES = \
+	$(SRC)/Computer/ComputerProfiler.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestComputerProfiler.cpp
+TEST_COMPUTER_PROFILER_DEPENDS = THREAD
+$(eval $(call link-program,TestComputerProfiler,TEST_COMPUTER_PROFILER))
+
 TEST_THERMALBAND_SOURCES = \
 $(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
 $(ENGINE_SRC_DIR)/ThermalBand/ThermalSlice.cpp \
@@ -155,11 +188,24 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_SNAPSHOT_BUFFER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSnapshotBuffer.cpp
+TEST_SNAPSHOT_BUFFER_DEPENDS = THREAD MATH
+$(eval $(call link-program,TestSnapshotBuffer,TEST_SNAPSHOT_BUFFER))
+
+TEST_STANDBY_THREAD_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestStandbyThread.cpp
+TEST_STANDBY_THREAD_DEPENDS = THREAD
+$(eval $(call link-program,TestStandbyThread,TEST_STANDBY_THREAD))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCReader.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestIGCParser.cpp
-TEST_IGC_PARSER_DEPENDS = MATH UTIL
+TEST_IGC_PARSER_DEPENDS = TIME MATH UTIL
 $(eval $(call link-program,TestIGCParser,TEST_IGC_PARSER))
 
 TEST_BYTE_ORDER_SOURCES = \
@@ -184,6 +230,7 @@ $(eval $(call link-program,TestMETARParser,TEST_METAR_PARSER))
 
 TEST_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -197,6 +244,96 @@ TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
 TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
+TEST_AIRSPACE_POLYGON_INDEX_SOURCES = \
+	$(ENGINE_SRC_DIR)/Airspace/AirspacePolygonIndex.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspacePolygonIndex.cpp
+TEST_AIRSPACE_POLYGON_INDEX_DEPENDS = GEO MATH
+$(eval $(call link-program,TestAirspacePolygonIndex,TEST_AIRSPACE_POLYGON_INDEX))
+
+TEST_AIRSPACE_WARNING_MANAGER_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspaceWarningManager.cpp
+TEST_AIRSPACE_WARNING_MANAGER_DEPENDS = TASK ROUTE GLIDE AIRSPACE GEO MATH UTIL
+$(eval $(call link-program,TestAirspaceWarningManager,TEST_AIRSPACE_WARNING_MANAGER))
+
+TEST_ABORT_TASK_SOURCES = \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAbortTask.cpp
+TEST_ABORT_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+$(eval $(call link-program,TestAbortTask,TEST_ABORT_TASK))
+
+TEST_CLOUD_JOURNAL_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(SRC)/Cloud/Serialiser.cpp \
+	$(SRC)/Cloud/Client.cpp \
+	$(SRC)/Cloud/Thermal.cpp \
+	$(SRC)/Cloud/ShardedClient.cpp \
+	$(SRC)/Cloud/ShardedThermal.cpp \
+	$(SRC)/Cloud/ShardedData.cpp \
+	$(SRC)/Cloud/Journal.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestCloudJournal.cpp
+TEST_CLOUD_JOURNAL_DEPENDS = ASYNC IO OS GEO MATH UTIL THREAD
+$(eval $(call link-program,TestCloudJournal,TEST_CLOUD_JOURNAL))
+
+TEST_RASTER_TILE_STORE_SOURCES = \
+	$(SRC)/Terrain/RasterTileStore.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRasterTileStore.cpp
+TEST_RASTER_TILE_STORE_DEPENDS = JASPER OS UTIL
+$(eval $(call link-program,TestRasterTileStore,TEST_RASTER_TILE_STORE))
+
+TEST_TOPOGRAPHY_FILE_SOURCES = \
+	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyFileStore.cpp \
+	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ShapeArena.cpp \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTopographyFile.cpp
+ifeq ($(OPENGL),y)
+TEST_TOPOGRAPHY_FILE_SOURCES += \
+	$(SCREEN_SRC_DIR)/Layout.cpp \
+	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
+endif
+TEST_TOPOGRAPHY_FILE_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_TOPOGRAPHY_FILE_DEPENDS = GEO MATH THREAD IO OS UTIL SHAPELIB ZZIP
+$(eval $(call link-program,TestTopographyFile,TEST_TOPOGRAPHY_FILE))
+
+TEST_TOPOGRAPHY_FILE_STORE_SOURCES = \
+	$(SRC)/Topography/TopographyFileStore.cpp \
+	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ShapeArena.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTopographyFileStore.cpp
+ifeq ($(OPENGL),y)
+TEST_TOPOGRAPHY_FILE_STORE_SOURCES += \
+	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
+endif
+TEST_TOPOGRAPHY_FILE_STORE_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_TOPOGRAPHY_FILE_STORE_DEPENDS = GEO MATH IO OS UTIL SHAPELIB ZZIP
+$(eval $(call link-program,TestTopographyFileStore,TEST_TOPOGRAPHY_FILE_STORE))
+
+TEST_TOPOGRAPHY_PREFETCH_SOURCES = \
+	$(SRC)/Topography/Prefetch.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTopographyPrefetch.cpp
+TEST_TOPOGRAPHY_PREFETCH_DEPENDS = GEO MATH
+$(eval $(call link-program,TestTopographyPrefetch,TEST_TOPOGRAPHY_PREFETCH))
+
+TEST_SHAPE_ARENA_SOURCES = \
+	$(SRC)/Topography/ShapeArena.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestShapeArena.cpp
+TEST_SHAPE_ARENA_DEPENDS = THREAD
+$(eval $(call link-program,TestShapeArena,TEST_SHAPE_ARENA))
+
 TEST_DATE_TIME_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestDateTime.cpp
@@ -238,7 +375,7 @@ TEST_ORDERED_TASK_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestOrderedTask.cpp
 TEST_ORDERED_TASK_OBJS = $(call SRC_TO_OBJ,$(TEST_ORDERED_TASK_SOURCES))
-TEST_ORDERED_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+TEST_ORDERED_TASK_DEPENDS = TASK ROUTE THREAD GLIDE WAYPOINT GEO TIME MATH UTIL
 $(eval $(call link-program,TestOrderedTask,TEST_ORDERED_TASK))
 
 TEST_AAT_POINT_SOURCES = \
@@ -247,7 +384,7 @@ TEST_AAT_POINT_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAATPoint.cpp
 TEST_AAT_POINT_OBJS = $(call SRC_TO_OBJ,$(TEST_AAT_POINT_SOURCES))
-TEST_AAT_POINT_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+TEST_AAT_POINT_DEPENDS = TASK ROUTE THREAD GLIDE WAYPOINT GEO TIME MATH UTIL
 $(eval $(call link-program,TestAATPoint,TEST_AAT_POINT))
 
 TEST_PLANES_SOURCES = \
@@ -293,7 +430,7 @@ TEST_TROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_troute.cpp
-TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE THREAD GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_troute,TEST_TROUTE))
 
 TEST_REACH_SOURCES = \
@@ -302,9 +439,41 @@ TEST_REACH_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_reach.cpp
-TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS ROUTE THREAD GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_reach,TEST_REACH))
 
+RUN_REACH_FAN_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/RunReachFan.cpp
+RUN_REACH_FAN_DEPENDS = TERRAIN IO ZZIP OS ROUTE THREAD GLIDE GEO MATH UTIL
+$(eval $(call link-program,RunReachFan,RUN_REACH_FAN))
+
+RUN_TERRAIN_ROUTE_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/RunTerrainRoute.cpp
+RUN_TERRAIN_ROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE THREAD GLIDE GEO MATH UTIL
+$(eval $(call link-program,RunTerrainRoute,RUN_TERRAIN_ROUTE))
+
+BENCHMARK_ASTAR_SOURCES = \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAStar.cpp
+BENCHMARK_ASTAR_DEPENDS = TERRAIN IO ZZIP OS ROUTE THREAD AIRSPACE GLIDE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkAStar,BENCHMARK_ASTAR))
+
+BENCHMARK_AIRSPACE_QUERIES_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceQueries.cpp
+BENCHMARK_AIRSPACE_QUERIES_LDADD = $(FAKE_LIBS)
+BENCHMARK_AIRSPACE_QUERIES_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
+$(eval $(call link-program,BenchmarkAirspaceQueries,BENCHMARK_AIRSPACE_QUERIES))
+
 TEST_ROUTE_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -318,7 +487,7 @@ TEST_ROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/harness_airspace.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_route.cpp
-TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE AIRSPACE GLIDE GEO MATH UTIL
+TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE THREAD AIRSPACE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_route,TEST_ROUTE))
 
 TEST_REPLAY_TASK_SOURCES = \
@@ -352,7 +521,7 @@ TEST_REPLAY_TASK_SOURCES = \
 	$(TEST_SRC_DIR)/harness_task.cpp \
 	$(TEST_SRC_DIR)/test_debug.cpp \
 	$(TEST_SRC_DIR)/test_replay_task.cpp
-TEST_REPLAY_TASK_DEPENDS = TASK ROUTE WAYPOINT GLIDE GEO MATH IO OS UTIL TIME
+TEST_REPLAY_TASK_DEPENDS = TASK ROUTE THREAD WAYPOINT GLIDE GEO MATH IO OS UTIL TIME
 $(eval $(call link-program,test_replay_task,TEST_REPLAY_TASK))
 
 TEST_MATH_TABLES_SOURCES = \
@@ -383,6 +552,8 @@ $(eval $(call link-program,TestMath,TEST_MATH))
 
 TEST_CSV_LINE_SOURCES = \
 	$(SRC)/IO/CSVLine.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestCSVLine.cpp
 TEST_CSV_LINE_DEPENDS = MATH
@@ -580,6 +751,13 @@ TEST_COLOR_RAMP_SOURCES = \
 TEST_COLOR_RAMP_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,TestColorRamp,TEST_COLOR_RAMP))
 
+TEST_SLOPE_SHADING_SOURCES = \
+	$(SRC)/Terrain/SlopeShading.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSlopeShading.cpp
+TEST_SLOPE_SHADING_DEPENDS = MATH
+$(eval $(call link-program,TestSlopeShading,TEST_SLOPE_SHADING))
+
 TEST_SUN_EPHEMERIS_SOURCES = \
 	$(SRC)/Math/SunEphemeris.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -610,6 +788,24 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_FLAT_HASH_MAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlatHashMap.cpp
+TEST_FLAT_HASH_MAP_DEPENDS = UTIL
+$(eval $(call link-program,TestFlatHashMap,TEST_FLAT_HASH_MAP))
+
+TEST_PACKED_KD_TREE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPackedKDTree.cpp
+TEST_PACKED_KD_TREE_DEPENDS = UTIL
+$(eval $(call link-program,TestPackedKDTree,TEST_PACKED_KD_TREE))
+
+TEST_STRING_VIEW_PARSER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestStringViewParser.cpp
+TEST_STRING_VIEW_PARSER_DEPENDS = UTIL
+$(eval $(call link-program,TestStringViewParser,TEST_STRING_VIEW_PARSER))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -709,10 +905,18 @@ $(eval $(call link-program,TestTrace,TEST_TRACE))
 
 FLIGHT_TABLE_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCReader.cpp \
 	$(TEST_SRC_DIR)/FlightTable.cpp
-FLIGHT_TABLE_DEPENDS = GEO MATH IO OS UTIL
+FLIGHT_TABLE_DEPENDS = GEO MATH IO OS UTIL TIME
 $(eval $(call link-program,FlightTable,FLIGHT_TABLE))
 
+BENCHMARK_IGC_READER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCReader.cpp \
+	$(TEST_SRC_DIR)/BenchmarkIGCReader.cpp
+BENCHMARK_IGC_READER_DEPENDS = GEO MATH IO OS UTIL TIME
+$(eval $(call link-program,BenchmarkIGCReader,BENCHMARK_IGC_READER))
+
 build-check: $(TESTS)
 
 check: $(TESTS) | $(OUT)/test/dirstamp
@@ -721,6 +925,8 @@ check: $(TESTS) | $(OUT)/test/dirstamp
 
 DEBUG_PROGRAM_NAMES = \
 	test_reach \
+	RunReachFan \
+	RunTerrainRoute \
 	test_route \
 	test_troute \
 	TestTrace \
@@ -731,6 +937,12 @@ DEBUG_PROGRAM_NAMES = \
 	FlightPath \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkSlopeShading \
+	BenchmarkReplay \
+	BenchmarkAirspaceWarnings \
+	BenchmarkAStar \
+	BenchmarkAirspaceQueries \
+	BenchmarkIGCReader \
 	DumpTextFile DumpTextZip DumpTextInflate WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -748,6 +960,7 @@ DEBUG_PROGRAM_NAMES = \
 	EnumeratePorts \
 	ReadPort RunPortHandler LogPort \
 	RunDeviceDriver RunDeclare RunFlightList RunDownloadFlight \
+	BenchmarkNMEAParser \
 	RunEnableNMEA \
 	CAI302Tool \
 	lxn2igc \
@@ -792,7 +1005,8 @@ DEBUG_PROGRAM_NAMES = \
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
-	FeedFlyNetData
+	FeedFlyNetData \
+	RunCloudLoad
 endif
 
 ifeq ($(TARGET),PC)
@@ -835,6 +1049,7 @@ DEBUG_REPLAY_SOURCES = \
 	$(SRC)/Device/Util/NMEAReader.cpp \
 	$(SRC)/Device/Config.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCReader.cpp \
 	$(SRC)/IGC/Generator.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
@@ -1013,6 +1228,12 @@ RUN_SL_TRACKING_LDADD = $(DEBUG_REPLAY_LDADD)
 RUN_SL_TRACKING_DEPENDS = LIBNET OS GEO MATH UTIL TIME
 $(eval $(call link-program,RunSkyLinesTracking,RUN_SL_TRACKING))
 
+RUN_CLOUD_LOAD_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(TEST_SRC_DIR)/RunCloudLoad.cpp
+RUN_CLOUD_LOAD_DEPENDS = ASYNC OS GEO MATH UTIL
+$(eval $(call link-program,RunCloudLoad,RUN_CLOUD_LOAD))
+
 RUN_LIVETRACK24_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Tracking/LiveTrack24.cpp \
@@ -1116,16 +1337,19 @@ $(eval $(call link-program,KeyCodeDumper,KEY_CODE_DUMPER))
 LOAD_TOPOGRAPHY_SOURCES = \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyFileStore.cpp \
 	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ShapeArena.cpp \
 	$(SRC)/Projection/Projection.cpp \
 	$(SRC)/Projection/WindowProjection.cpp \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/LoadTopography.cpp
 ifeq ($(OPENGL),y)
 LOAD_TOPOGRAPHY_SOURCES += \
+	$(SCREEN_SRC_DIR)/Layout.cpp \
 	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
 endif
-LOAD_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO UTIL SHAPELIB ZZIP
+LOAD_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO OS UTIL SHAPELIB ZZIP
 LOAD_TOPOGRAPHY_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,LoadTopography,LOAD_TOPOGRAPHY))
 
@@ -1136,6 +1360,16 @@ LOAD_TERRAIN_CPPFLAGS = $(SCREEN_CPPFLAGS)
 LOAD_TERRAIN_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
 $(eval $(call link-program,LoadTerrain,LOAD_TERRAIN))
 
+TEST_HEIGHT_MATRIX_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestHeightMatrix.cpp
+TEST_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
+$(eval $(call link-program,TestHeightMatrix,TEST_HEIGHT_MATRIX))
+
 RUN_HEIGHT_MATRIX_SOURCES = \
 	$(SRC)/Projection/Projection.cpp \
 	$(SRC)/Projection/WindowProjection.cpp \
@@ -1145,6 +1379,11 @@ RUN_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
 RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
 $(eval $(call link-program,RunHeightMatrix,RUN_HEIGHT_MATRIX))
 
+BENCHMARK_SLOPE_SHADING_SOURCES = \
+	$(SRC)/Terrain/SlopeShading.cpp \
+	$(TEST_SRC_DIR)/BenchmarkSlopeShading.cpp
+$(eval $(call link-program,BenchmarkSlopeShading,BENCHMARK_SLOPE_SHADING))
+
 RUN_INPUT_PARSER_SOURCES = \
 	$(SRC)/Input/InputKeys.cpp \
 	$(SRC)/Input/InputConfig.cpp \
@@ -1209,6 +1448,7 @@ $(eval $(call link-program,RunFlightParser,RUN_FLIGHT_PARSER))
 
 RUN_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -1300,6 +1540,12 @@ RUN_DEVICE_DRIVER_SOURCES = \
 RUN_DEVICE_DRIVER_DEPENDS = DRIVER IO OS THREAD GEO MATH UTIL TIME
 $(eval $(call link-program,RunDeviceDriver,RUN_DEVICE_DRIVER))
 
+BENCHMARK_NMEA_PARSER_SOURCES = \
+	$(filter-out $(TEST_SRC_DIR)/RunDeviceDriver.cpp,$(RUN_DEVICE_DRIVER_SOURCES)) \
+	$(TEST_SRC_DIR)/BenchmarkNMEAParser.cpp
+BENCHMARK_NMEA_PARSER_DEPENDS = $(RUN_DEVICE_DRIVER_DEPENDS)
+$(eval $(call link-program,BenchmarkNMEAParser,BENCHMARK_NMEA_PARSER))
+
 RUN_DECLARE_SOURCES = \
 	$(SRC)/Device/Port/ConfiguredPort.cpp \
 	$(SRC)/Units/Descriptor.cpp \
@@ -1663,7 +1909,7 @@ RUN_OLC_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/ContestPrinting.cpp \
 	$(TEST_SRC_DIR)/RunOLCAnalysis.cpp
-RUN_OLC_LDADD = $(DEBUG_REPLAY_LDADD)
+RUN_OLC_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
 RUN_OLC_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,RunOLCAnalysis,RUN_OLC))
 
@@ -1685,6 +1931,7 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(SRC)/JSON/Writer.cpp \
 	$(SRC)/Formatter/TimeFormatter.cpp \
 	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/ComputerProfiler.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
@@ -1697,7 +1944,7 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(TEST_SRC_DIR)/FlightPhaseJSON.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseDetector.cpp \
 	$(TEST_SRC_DIR)/AnalyseFlight.cpp
-ANALYSE_FLIGHT_LDADD = $(DEBUG_REPLAY_LDADD)
+ANALYSE_FLIGHT_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
 ANALYSE_FLIGHT_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,AnalyseFlight,ANALYSE_FLIGHT))
 
@@ -1855,12 +2102,15 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Task/ProtectedRoutePlanner.cpp \
 	$(SRC)/Task/RoutePlannerGlue.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyFileStore.cpp \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/Thread.cpp \
+	$(SRC)/Topography/Prefetch.cpp \
 	$(SRC)/Topography/TopographyFileRenderer.cpp \
 	$(SRC)/Topography/TopographyRenderer.cpp \
 	$(SRC)/Topography/TopographyGlue.cpp \
 	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ShapeArena.cpp \
 	$(SRC)/Topography/CachedTopographyRenderer.cpp \
 	$(SRC)/Units/Units.cpp \
 	$(SRC)/Units/Settings.cpp \
@@ -2308,6 +2558,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/AverageVarioComputer.cpp \
 	$(SRC)/Computer/GlideRatioComputer.cpp \
 	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/ComputerProfiler.cpp \
 	$(SRC)/Computer/GlideComputerBlackboard.cpp \
 	$(SRC)/Computer/TaskComputer.cpp \
 	$(SRC)/Computer/RouteComputer.cpp \
@@ -2337,6 +2588,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ActivePredicate.cpp \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
@@ -2366,6 +2618,99 @@ RUN_ANALYSIS_DEPENDS = \
 	CONTEST TASK ROUTE GLIDE WAYPOINT ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
+BENCHMARK_REPLAY_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/Task/Deserialiser.cpp \
+	$(SRC)/Task/LoadFile.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Task/TaskFile.cpp \
+	$(SRC)/Task/TaskFileXCSoar.cpp \
+	$(SRC)/Task/TaskFileSeeYou.cpp \
+	$(SRC)/Task/TaskFileIGC.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/Factory.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Computer/Wind/CirclingWind.cpp \
+	$(SRC)/Computer/Wind/Store.cpp \
+	$(SRC)/Computer/Wind/MeasurementList.cpp \
+	$(SRC)/Computer/Wind/WindEKF.cpp \
+	$(SRC)/Computer/Wind/WindEKFGlue.cpp \
+	$(SRC)/Computer/Wind/Computer.cpp \
+	$(SRC)/Computer/Wind/Settings.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Units/Settings.cpp \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/DataNode.cpp \
+	$(SRC)/XML/DataNodeXML.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/Computer/ThermalLocator.cpp \
+	$(SRC)/Computer/ThermalBase.cpp \
+	$(SRC)/Computer/ThermalBandComputer.cpp \
+	$(SRC)/Computer/GlideRatioCalculator.cpp \
+	$(SRC)/Computer/AutoQNH.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WarningComputer.cpp \
+	$(SRC)/Computer/LiftDatabaseComputer.cpp \
+	$(SRC)/Computer/AverageVarioComputer.cpp \
+	$(SRC)/Computer/GlideRatioComputer.cpp \
+	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/ComputerProfiler.cpp \
+	$(SRC)/Computer/GlideComputerBlackboard.cpp \
+	$(SRC)/Computer/TaskComputer.cpp \
+	$(SRC)/Computer/RouteComputer.cpp \
+	$(SRC)/Computer/GlideComputerAirData.cpp \
+	$(SRC)/Computer/WaveComputer.cpp \
+	$(SRC)/Computer/StatsComputer.cpp \
+	$(SRC)/Computer/GlideComputerInterface.cpp \
+	$(SRC)/Computer/LogComputer.cpp \
+	$(SRC)/Computer/CuComputer.cpp \
+	$(SRC)/Computer/Settings.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Tracking/TrackingSettings.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/JSON/Writer.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/BenchmarkReplay.cpp
+BENCHMARK_REPLAY_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
+BENCHMARK_REPLAY_DEPENDS = \
+	TERRAIN \
+	IO OS THREAD \
+	CONTEST TASK ROUTE GLIDE WAYPOINT AIRSPACE ZZIP UTIL GEO MATH TIME
+$(eval $(call link-program,BenchmarkReplay,BENCHMARK_REPLAY))
+
+BENCHMARK_AIRSPACE_WARNINGS_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/JSON/Writer.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceWarnings.cpp
+BENCHMARK_AIRSPACE_WARNINGS_LDADD = $(DEBUG_REPLAY_LDADD)
+BENCHMARK_AIRSPACE_WARNINGS_DEPENDS = \
+	IO OS THREAD \
+	GLIDE AIRSPACE ZZIP UTIL GEO MATH TIME
+$(eval $(call link-program,BenchmarkAirspaceWarnings,BENCHMARK_AIRSPACE_WARNINGS))
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
@@ -2586,7 +2931,7 @@ TASK_INFO_SOURCES = \
 	$(SRC)/XML/DataNode.cpp \
 	$(SRC)/XML/DataNodeXML.cpp \
 	$(TEST_SRC_DIR)/TaskInfo.cpp
-TASK_INFO_DEPENDS = TASK ROUTE GLIDE WAYPOINT IO OS GEO TIME MATH UTIL
+TASK_INFO_DEPENDS = TASK ROUTE THREAD GLIDE WAYPOINT IO OS GEO TIME MATH UTIL
 $(eval $(call link-program,TaskInfo,TASK_INFO))
 
 DUMP_TASK_FILE_SOURCES = \
@@ -47,9 +47,15 @@ void
 XCSoarInterface::ReceiveGPS()
 {
   {
-    ScopeLock protect(device_blackboard->mutex);
+    const ScopeDuration duration(device_blackboard->statistics.read_basic);
+    const SnapshotBuffer<MoreData>::Reader
+      basic(device_blackboard->GetPublishedBasic());
+    ReadBlackboardBasic(*basic);
+  }
 
-    ReadBlackboardBasic(device_blackboard->Basic());
+  {
+    const TimedScopeLock protect(device_blackboard->mutex,
+                                 device_blackboard->statistics.ui_lock);
 
     const NMEAInfo &real = device_blackboard->RealState();
     Private::movement_detected = real.alive && real.gps.real &&
@@ -67,9 +73,15 @@ void
 XCSoarInterface::ReceiveCalculated()
 {
   {
-    ScopeLock protect(device_blackboard->mutex);
+    const ScopeDuration duration(device_blackboard->statistics.read_calculated);
+    const SnapshotBuffer<DerivedInfo>::Reader
+      calculated(device_blackboard->GetPublishedCalculated());
+    ReadBlackboardCalculated(*calculated);
+  }
 
-    ReadBlackboardCalculated(device_blackboard->Calculated());
+  {
+    const TimedScopeLock protect(device_blackboard->mutex,
+                                 device_blackboard->statistics.ui_lock);
     device_blackboard->ReadComputerSettings(GetComputerSettings());
   }
 
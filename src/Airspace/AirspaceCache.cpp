@@ -0,0 +1,307 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+
+*/
+
+#include "AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Util/tstring.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+#include <tchar.h>
+
+static constexpr uint32_t AIRSPACE_CACHE_MAGIC = 0x41535043; /* "ASPC" */
+
+/**
+ * Increment this whenever the layout of the structs below changes.
+ */
+static constexpr uint32_t AIRSPACE_CACHE_VERSION = 1;
+
+struct AirspaceCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t tchar_size;
+  uint32_t n_airspaces;
+  uint32_t n_points;
+  uint32_t n_chars;
+};
+
+struct CachedAltitude {
+  double altitude;
+  double flight_level;
+  double altitude_above_terrain;
+  uint32_t reference;
+  uint32_t reserved;
+};
+
+struct CachedPoint {
+  double longitude, latitude;
+};
+
+struct CachedAirspace {
+  uint8_t shape;
+  uint8_t type;
+  uint8_t days;
+  uint8_t reserved;
+
+  uint32_t name_offset, name_length;
+  uint32_t radio_offset, radio_length;
+
+  /**
+   * Range within the point array (polygons only).
+   */
+  uint32_t first_point, n_points;
+
+  uint32_t reserved2;
+
+  CachedAltitude base, top;
+
+  /**
+   * Circles only.
+   */
+  CachedPoint center;
+  double radius;
+};
+
+static_assert(sizeof(AirspaceCacheHeader) % sizeof(double) == 0,
+              "Misaligned airspace cache header");
+static_assert(sizeof(CachedAirspace) % sizeof(double) == 0,
+              "Misaligned airspace cache record");
+static_assert(sizeof(AirspaceActivity) == sizeof(uint8_t),
+              "Unexpected AirspaceActivity size");
+
+static CachedAltitude
+ToCache(const AirspaceAltitude &src)
+{
+  CachedAltitude dest;
+  dest.altitude = src.altitude;
+  dest.flight_level = src.flight_level;
+  dest.altitude_above_terrain = src.altitude_above_terrain;
+  dest.reference = uint32_t(src.reference);
+  dest.reserved = 0;
+  return dest;
+}
+
+static AirspaceAltitude
+FromCache(const CachedAltitude &src)
+{
+  AirspaceAltitude dest;
+  dest.altitude = src.altitude;
+  dest.flight_level = src.flight_level;
+  dest.altitude_above_terrain = src.altitude_above_terrain;
+  dest.reference = AltitudeReference(src.reference);
+  return dest;
+}
+
+static CachedPoint
+ToCache(const GeoPoint &src)
+{
+  return {src.longitude.Native(), src.latitude.Native()};
+}
+
+static GeoPoint
+FromCache(const CachedPoint &src)
+{
+  return GeoPoint(Angle::Native(src.longitude), Angle::Native(src.latitude));
+}
+
+static void
+AppendString(std::vector<TCHAR> &chars, const tstring &s,
+             uint32_t &offset_r, uint32_t &length_r)
+{
+  offset_r = chars.size();
+  length_r = s.length();
+  chars.insert(chars.end(), s.begin(), s.end());
+}
+
+template<typename T>
+static bool
+WriteArray(FILE *file, const std::vector<T> &v)
+{
+  return v.empty() || fwrite(v.data(), sizeof(T), v.size(), file) == v.size();
+}
+
+bool
+SaveAirspaceCache(const Airspaces &airspaces, FILE *file)
+{
+  std::vector<CachedAirspace> records;
+  std::vector<CachedPoint> points;
+  std::vector<TCHAR> chars;
+
+  records.reserve(airspaces.GetSize());
+
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+
+    CachedAirspace record;
+    memset(&record, 0, sizeof(record));
+
+    record.shape = uint8_t(airspace.GetShape());
+    record.type = uint8_t(airspace.GetType());
+    memcpy(&record.days, &airspace.GetDays(), sizeof(record.days));
+
+    AppendString(chars, airspace.GetName(),
+                 record.name_offset, record.name_length);
+    AppendString(chars, airspace.GetRadioText(),
+                 record.radio_offset, record.radio_length);
+
+    record.base = ToCache(airspace.GetBase());
+    record.top = ToCache(airspace.GetTop());
+
+    switch (airspace.GetShape()) {
+    case AbstractAirspace::Shape::CIRCLE: {
+      const AirspaceCircle &circle = (const AirspaceCircle &)airspace;
+      record.center = ToCache(circle.GetCenter());
+      record.radius = circle.GetRadius();
+      break;
+    }
+
+    case AbstractAirspace::Shape::POLYGON:
+      record.first_point = points.size();
+      for (const auto &p : airspace.GetPoints())
+        points.push_back(ToCache(p.GetLocation()));
+      record.n_points = points.size() - record.first_point;
+      break;
+    }
+
+    records.push_back(record);
+  }
+
+  /* pad the string table, so the file size stays a multiple of
+     sizeof(double) */
+  while ((chars.size() * sizeof(TCHAR)) % sizeof(double) != 0)
+    chars.push_back(_T('\0'));
+
+  AirspaceCacheHeader header;
+  header.magic = AIRSPACE_CACHE_MAGIC;
+  header.version = AIRSPACE_CACHE_VERSION;
+  header.tchar_size = sizeof(TCHAR);
+  header.n_airspaces = records.size();
+  header.n_points = points.size();
+  header.n_chars = chars.size();
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    WriteArray(file, records) &&
+    WriteArray(file, points) &&
+    WriteArray(file, chars);
+}
+
+/**
+ * Take an array of #n objects from the front of the buffer.
+ *
+ * @return nullptr if the buffer is too small
+ */
+template<typename T>
+static const T *
+ShiftArray(ConstBuffer<uint8_t> &buffer, size_t n)
+{
+  if (n > buffer.size / sizeof(T))
+    return nullptr;
+
+  const T *result = (const T *)buffer.data;
+  buffer.skip_front(n * sizeof(T));
+  return result;
+}
+
+static bool
+CheckRange(uint32_t offset, uint32_t length, uint32_t size)
+{
+  return offset <= size && length <= size - offset;
+}
+
+bool
+LoadAirspaceCache(Airspaces &airspaces, ConstBuffer<void> data)
+{
+  if (uintptr_t(data.data) % alignof(double) != 0)
+    return false;
+
+  auto buffer = ConstBuffer<uint8_t>::FromVoid(data);
+
+  const auto *header = ShiftArray<AirspaceCacheHeader>(buffer, 1);
+  if (header == nullptr ||
+      header->magic != AIRSPACE_CACHE_MAGIC ||
+      header->version != AIRSPACE_CACHE_VERSION ||
+      header->tchar_size != sizeof(TCHAR))
+    return false;
+
+  const auto *records =
+    ShiftArray<CachedAirspace>(buffer, header->n_airspaces);
+  const auto *points = ShiftArray<CachedPoint>(buffer, header->n_points);
+  const auto *chars = ShiftArray<TCHAR>(buffer, header->n_chars);
+  if (records == nullptr || points == nullptr || chars == nullptr)
+    return false;
+
+  std::vector<GeoPoint> polygon;
+
+  for (unsigned i = 0; i < header->n_airspaces; ++i) {
+    const CachedAirspace &record = records[i];
+
+    if (record.type >= AIRSPACECLASSCOUNT ||
+        !CheckRange(record.name_offset, record.name_length,
+                    header->n_chars) ||
+        !CheckRange(record.radio_offset, record.radio_length,
+                    header->n_chars))
+      return false;
+
+    AbstractAirspace *airspace;
+    switch (AbstractAirspace::Shape(record.shape)) {
+    case AbstractAirspace::Shape::CIRCLE:
+      airspace = new AirspaceCircle(FromCache(record.center), record.radius);
+      break;
+
+    case AbstractAirspace::Shape::POLYGON:
+      if (record.n_points < 3 ||
+          !CheckRange(record.first_point, record.n_points, header->n_points))
+        return false;
+
+      polygon.clear();
+      for (unsigned j = 0; j < record.n_points; ++j)
+        polygon.push_back(FromCache(points[record.first_point + j]));
+
+      airspace = new AirspacePolygon(polygon);
+      break;
+
+    default:
+      return false;
+    }
+
+    AirspaceActivity days;
+    memcpy(&days, &record.days, sizeof(days));
+
+    airspace->SetProperties(tstring(chars + record.name_offset,
+                                    record.name_length),
+                            AirspaceClass(record.type),
+                            FromCache(record.base), FromCache(record.top));
+    airspace->SetRadio(tstring(chars + record.radio_offset,
+                               record.radio_length));
+    airspace->SetDays(days);
+    airspaces.Add(airspace);
+  }
+
+  return true;
+}
@@ -0,0 +1,58 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_CACHE_HPP
+#define XCSOAR_AIRSPACE_CACHE_HPP
+
+#include "Util/ConstBuffer.hxx"
+
+#include <stdio.h>
+
+class Airspaces;
+
+/**
+ * Write the airspace database into a binary cache file.  Polygon
+ * points, names and the per-airspace properties (class, altitudes,
+ * activity) are stored in flat arrays.  The airspaces are written
+ * in the order of the R-tree leaves, so reloading them yields a
+ * spatially clustered tree.
+ *
+ * Call this after Airspaces::Optimise(), but before applying QNH or
+ * terrain, because those are not part of the cache.
+ *
+ * @return true on success
+ */
+bool
+SaveAirspaceCache(const Airspaces &airspaces, FILE *file);
+
+/**
+ * Load airspaces from a buffer written by SaveAirspaceCache()
+ * (e.g. mapped with #FileMapping) and add them to the database.
+ * The caller is responsible for calling Airspaces::Optimise().
+ *
+ * @return false if the cache is malformed or from an incompatible
+ * version; the database may contain a part of the airspaces then
+ */
+bool
+LoadAirspaceCache(Airspaces &airspaces, ConstBuffer<void> data);
+
+#endif
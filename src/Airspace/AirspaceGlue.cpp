@@ -23,27 +23,50 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Operation/Operation.hpp"
 #include "Language/Language.hpp"
 #include "LogFile.hpp"
 #include "OS/Path.hpp"
+#include "OS/FileMapping.hpp"
 #include "IO/FileLineReader.hpp"
 #include "IO/ZipArchive.hpp"
 #include "IO/ZipLineReader.hpp"
 #include "IO/MapFile.hpp"
+#include "IO/FileCache.hpp"
 #include "Profile/Profile.hpp"
+#include "Util/StringView.hxx"
+
+#include <memory>
+#include <vector>
 
 #include <string.h>
 
+static const TCHAR *const airspace_cache_name = _T("airspace");
+
+static bool
+ParseAirspaceFileLines(AirspaceParser &parser, Path path,
+                       OperationEnvironment &operation)
+{
+  FileLineReader reader(path, Charset::AUTO);
+  return parser.Parse(reader, operation);
+}
+
 static bool
 ParseAirspaceFile(AirspaceParser &parser, Path path,
                   OperationEnvironment &operation)
 try {
-  FileLineReader reader(path, Charset::AUTO);
-
-  if (!parser.Parse(reader, operation)) {
+  /* parse the file in place if it can be mapped; fall back to the
+     (copying) line reader otherwise */
+  const FileMapping mapping(path);
+  const bool success = mapping.error()
+    ? ParseAirspaceFileLines(parser, path, operation)
+    : parser.Parse(StringView((const char *)mapping.data(), mapping.size()),
+                   Charset::AUTO, operation);
+
+  if (!success) {
     LogFormat(_T("Failed to parse airspace file: %s"), path.c_str());
     return false;
   }
@@ -74,35 +97,104 @@ try {
   return false;
 }
 
-void
-ReadAirspace(Airspaces &airspaces,
-             RasterTerrain *terrain,
-             const AtmosphericPressure &press,
-             OperationEnvironment &operation)
+static bool
+LoadCache(Airspaces &airspaces, FileCache &cache,
+          ConstBuffer<Path> sources)
 {
-  LogFormat("ReadAirspace");
-  operation.SetText(_("Loading Airspace File..."));
+  size_t offset;
+  std::unique_ptr<FileMapping> mapping(cache.Map(airspace_cache_name,
+                                                 sources, offset));
+  if (!mapping)
+    return false;
 
-  bool airspace_ok = false;
+  if (!LoadAirspaceCache(airspaces,
+                         ConstBuffer<void>(mapping->at(offset),
+                                           mapping->size() - offset))) {
+    airspaces.Clear();
+    cache.Flush(airspace_cache_name);
+    return false;
+  }
 
-  AirspaceParser parser(airspaces);
+  return true;
+}
 
-  // Read the airspace filenames from the registry
-  auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
-  if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+static void
+SaveCache(const Airspaces &airspaces, FileCache &cache,
+          ConstBuffer<Path> sources)
+{
+  FILE *file = cache.Save(airspace_cache_name, sources);
+  if (file == nullptr)
+    return;
+
+  if (SaveAirspaceCache(airspaces, file))
+    cache.Commit(airspace_cache_name, file);
+  else
+    cache.Cancel(airspace_cache_name, file);
+}
+
+static bool
+ParseAirspaceFiles(AirspaceParser &parser, Path path, Path additional_path,
+                   OperationEnvironment &operation)
+{
+  bool airspace_ok = false;
 
-  path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
   if (!path.IsNull())
     airspace_ok |= ParseAirspaceFile(parser, path, operation);
 
+  if (!additional_path.IsNull())
+    airspace_ok |= ParseAirspaceFile(parser, additional_path, operation);
+
   auto archive = OpenMapFile();
   if (archive)
     airspace_ok |= ParseAirspaceFile(parser, archive->get(), "airspace.txt",
                                      operation);
 
+  return airspace_ok;
+}
+
+void
+ReadAirspace(Airspaces &airspaces,
+             RasterTerrain *terrain,
+             const AtmosphericPressure &press,
+             OperationEnvironment &operation,
+             FileCache *cache)
+{
+  LogFormat("ReadAirspace");
+  operation.SetText(_("Loading Airspace File..."));
+
+  // Read the airspace filenames from the registry
+  const auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
+  const auto additional_path =
+    Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
+  const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+
+  /* the cache is keyed on all files which may contribute
+     airspaces */
+  std::vector<Path> sources;
+  for (Path i : {Path(path), Path(additional_path), Path(map_path)})
+    if (!i.IsNull())
+      sources.push_back(i);
+
+  const ConstBuffer<Path> sources_buffer(sources.data(), sources.size());
+
+  bool airspace_ok = false, from_cache = false;
+
+  if (cache != nullptr && !sources.empty() &&
+      LoadCache(airspaces, *cache, sources_buffer)) {
+    LogFormat("Loaded airspace cache");
+    airspace_ok = from_cache = true;
+  } else {
+    AirspaceParser parser(airspaces);
+    airspace_ok = ParseAirspaceFiles(parser, path, additional_path,
+                                     operation);
+  }
+
   if (airspace_ok) {
     airspaces.Optimise();
+
+    if (cache != nullptr && !from_cache && !sources.empty())
+      SaveCache(airspaces, *cache, sources_buffer);
+
     airspaces.SetFlightLevels(press);
 
     if (terrain != NULL)
@@ -28,14 +28,20 @@ class RasterTerrain;
 class AtmosphericPressure;
 class Airspaces;
 class OperationEnvironment;
+class FileCache;
 
 /**
  * Reads the airspace files into the memory
+ *
+ * @param cache if not nullptr, the parsed database is stored in (or
+ * loaded from) a binary cache which is valid as long as the
+ * configured airspace files and the map file are unchanged
  */
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
-             OperationEnvironment &operation);
+             OperationEnvironment &operation,
+             FileCache *cache=nullptr);
 
 #endif
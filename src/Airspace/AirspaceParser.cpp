@@ -29,10 +29,13 @@ Copyright_License {
 #include "Language/Language.hpp"
 #include "Util/CharUtil.hxx"
 #include "Util/StringAPI.hxx"
-#include "Util/StringParser.hxx"
+#include "Util/StringViewParser.hpp"
+#include "Util/UTF8.hpp"
+#include "Util/ConvertString.hpp"
 #include "Util/Macros.hpp"
 #include "Geo/Math.hpp"
 #include "IO/LineReader.hpp"
+#include "IO/Charset.hpp"
 #include "Airspace/AirspacePolygon.hpp"
 #include "Airspace/AirspaceCircle.hpp"
 #include "Geo/GeoVector.hpp"
@@ -40,7 +43,10 @@ Copyright_License {
 #include "Util/StaticString.hxx"
 #include "Util/StringCompare.hxx"
 
+#include <string>
+
 #include <tchar.h>
+#include <string.h>
 
 enum class AirspaceFileType {
   UNKNOWN,
@@ -50,69 +56,110 @@ enum class AirspaceFileType {
 
 struct AirspaceClassCharCouple
 {
-  const TCHAR character;
+  const char character;
   AirspaceClass type;
 };
 
 struct AirspaceClassStringCouple
 {
-  const TCHAR *string;
+  const char *string;
   AirspaceClass type;
 };
 
 static constexpr AirspaceClassStringCouple airspace_class_strings[] = {
-  { _T("R"), RESTRICT },
-  { _T("Q"), DANGER },
-  { _T("P"), PROHIBITED },
-  { _T("CTR"), CTR },
-  { _T("A"), CLASSA },
-  { _T("B"), CLASSB },
-  { _T("C"), CLASSC },
-  { _T("D"), CLASSD },
-  { _T("GP"), NOGLIDER },
-  { _T("W"), WAVE },
-  { _T("E"), CLASSE },
-  { _T("F"), CLASSF },
-  { _T("TMZ"), TMZ },
-  { _T("G"), CLASSG },
-  { _T("RMZ"), RMZ },
-  { _T("MATZ"), MATZ },
-  { _T("GSEC"), WAVE },
+  { "R", RESTRICT },
+  { "Q", DANGER },
+  { "P", PROHIBITED },
+  { "CTR", CTR },
+  { "A", CLASSA },
+  { "B", CLASSB },
+  { "C", CLASSC },
+  { "D", CLASSD },
+  { "GP", NOGLIDER },
+  { "W", WAVE },
+  { "E", CLASSE },
+  { "F", CLASSF },
+  { "TMZ", TMZ },
+  { "G", CLASSG },
+  { "RMZ", RMZ },
+  { "MATZ", MATZ },
+  { "GSEC", WAVE },
 };
 
 static constexpr AirspaceClassCharCouple airspace_tnp_class_chars[] = {
-  { _T('A'), CLASSA },
-  { _T('B'), CLASSB },
-  { _T('C'), CLASSC },
-  { _T('D'), CLASSD },
-  { _T('E'), CLASSE },
-  { _T('F'), CLASSF },
-  { _T('G'), CLASSG },
+  { 'A', CLASSA },
+  { 'B', CLASSB },
+  { 'C', CLASSC },
+  { 'D', CLASSD },
+  { 'E', CLASSE },
+  { 'F', CLASSF },
+  { 'G', CLASSG },
 };
 
 static constexpr AirspaceClassStringCouple airspace_tnp_type_strings[] = {
-  { _T("C"), CTR },
-  { _T("CTA"), CTR },
-  { _T("CTR"), CTR },
-  { _T("CTA/CTR"), CTR },
-  { _T("CTR/CTA"), CTR },
-  { _T("R"), RESTRICT },
-  { _T("RESTRICTED"), RESTRICT },
-  { _T("P"), PROHIBITED },
-  { _T("PROHIBITED"), PROHIBITED },
-  { _T("D"), DANGER },
-  { _T("DANGER"), DANGER },
-  { _T("G"), WAVE },
-  { _T("GSEC"), WAVE },
-  { _T("T"), TMZ },
-  { _T("TMZ"), TMZ },
-  { _T("CYR"), RESTRICT },
-  { _T("CYD"), DANGER },
-  { _T("CYA"), CLASSF },
-  { _T("MATZ"), MATZ },
-  { _T("RMZ"), RMZ },
+  { "C", CTR },
+  { "CTA", CTR },
+  { "CTR", CTR },
+  { "CTA/CTR", CTR },
+  { "CTR/CTA", CTR },
+  { "R", RESTRICT },
+  { "RESTRICTED", RESTRICT },
+  { "P", PROHIBITED },
+  { "PROHIBITED", PROHIBITED },
+  { "D", DANGER },
+  { "DANGER", DANGER },
+  { "G", WAVE },
+  { "GSEC", WAVE },
+  { "T", TMZ },
+  { "TMZ", TMZ },
+  { "CYR", RESTRICT },
+  { "CYD", DANGER },
+  { "CYA", CLASSF },
+  { "MATZ", MATZ },
+  { "RMZ", RMZ },
 };
 
+/**
+ * Convert a string from the airspace file to a #tstring.  This is
+ * only done for the strings which are kept (name and radio), the
+ * rest of the file is parsed in its source encoding.
+ *
+ * @param charset the source character set; #Charset::AUTO is
+ * switched to #Charset::ISO_LATIN_1 as soon as the first invalid
+ * UTF-8 sequence is seen
+ */
+static tstring
+ImportText(StringView src, Charset &charset)
+{
+  std::string utf8(src.data, src.size);
+
+  bool latin1 = charset == Charset::ISO_LATIN_1;
+  if (!latin1 && !ValidateUTF8(utf8.c_str())) {
+    latin1 = true;
+    if (charset == Charset::AUTO)
+      charset = Charset::ISO_LATIN_1;
+  }
+
+  if (latin1) {
+    utf8.clear();
+    for (char ch : src) {
+      char buffer[2];
+      char *end = Latin1ToUTF8((unsigned char)ch, buffer);
+      utf8.append(buffer, end);
+    }
+  }
+
+#ifdef _UNICODE
+  UTF8ToWideConverter converted(utf8.c_str());
+  if (!converted.IsValid())
+    return tstring();
+
+  return tstring(converted);
+#else
+  return utf8;
+#endif
+}
+
 // this can now be called multiple times to load several airspaces.
 
 struct TempAirspaceType
@@ -140,6 +187,11 @@ struct TempAirspaceType
   // Arc
   int rotation;
 
+  /**
+   * The character set of the file being parsed.
+   */
+  Charset charset = Charset::UTF8;
+
   void
   Reset()
   {
@@ -165,6 +217,18 @@ struct TempAirspaceType
     radius = 0;
   }
 
+  void
+  SetName(StringView src)
+  {
+    name = ImportText(src, charset);
+  }
+
+  void
+  SetRadio(StringView src)
+  {
+    radio = ImportText(src, charset);
+  }
+
   void
   AddPolygon(Airspaces &airspace_database)
   {
@@ -201,6 +265,17 @@ struct TempAirspaceType
     return 5;
   }
 
+  /**
+   * Make room for all points of an arc, so they are emitted straight
+   * into the polygon storage without reallocating in between.
+   */
+  void
+  ReserveArc(Angle sweep, int step_degrees)
+  {
+    points.reserve(points.size() + 2 +
+                   unsigned(sweep.AbsoluteDegrees()) / step_degrees);
+  }
+
   void
   AppendArc(const GeoPoint start, const GeoPoint end)
   {
@@ -226,6 +301,8 @@ struct TempAirspaceType
         end_bearing -= Angle::FullCircle();
     }
 
+    ReserveArc(end_bearing - start_bearing, _step);
+
     // Add first polygon point
     points.push_back(start);
 
@@ -255,6 +332,8 @@ struct TempAirspaceType
         end -= Angle::FullCircle();
     }
 
+    ReserveArc(end - start, _step);
+
     // Add first polygon point
     points.push_back(FindLatitudeLongitude(center, start, radius));
 
@@ -280,7 +359,7 @@ ShowParseWarning(int line, const TCHAR *str, OperationEnvironment &operation)
 }
 
 static void
-ReadAltitude(StringParser<TCHAR> &input, AirspaceAltitude &altitude)
+ReadAltitude(StringViewParser &input, AirspaceAltitude &altitude)
 {
   auto unit = Unit::FEET;
   enum { MSL, AGL, SFC, FL, STD, UNLIMITED } type = MSL;
@@ -291,23 +370,23 @@ ReadAltitude(StringParser<TCHAR> &input, AirspaceAltitude &altitude)
 
     if (IsDigitASCII(input.front())) {
       input.ReadDouble(value);
-    } else if (input.SkipMatchIgnoreCase(_T("GND"), 3) ||
-               input.SkipMatchIgnoreCase(_T("AGL"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("GND", 3) ||
+               input.SkipMatchIgnoreCase("AGL", 3)) {
       type = AGL;
-    } else if (input.SkipMatchIgnoreCase(_T("SFC"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("SFC", 3)) {
       type = SFC;
-    } else if (input.SkipMatchIgnoreCase(_T("FL"), 2)) {
+    } else if (input.SkipMatchIgnoreCase("FL", 2)) {
       type = FL;
-    } else if (input.SkipMatchIgnoreCase(_T("FT"), 2)) {
+    } else if (input.SkipMatchIgnoreCase("FT", 2)) {
       unit = Unit::FEET;
-    } else if (input.SkipMatchIgnoreCase(_T("MSL"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("MSL", 3)) {
       type = MSL;
-    } else if (input.front() == _T('M') || input.front() == _T('m')) {
+    } else if (input.front() == 'M' || input.front() == 'm') {
       unit = Unit::METER;
       input.Skip();
-    } else if (input.SkipMatchIgnoreCase(_T("STD"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("STD", 3)) {
       type = STD;
-    } else if (input.SkipMatchIgnoreCase(_T("UNL"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("UNL", 3)) {
       type = UNLIMITED;
     } else if (input.IsEmpty())
       break;
@@ -374,7 +453,7 @@ ReadAltitude(StringParser<TCHAR> &input, AirspaceAltitude &altitude)
  * @return the non-negative angle or a negative value on error
  */
 static Angle
-ReadNonNegativeAngle(StringParser<TCHAR> &input, double max_degrees)
+ReadNonNegativeAngle(StringViewParser &input, double max_degrees)
 {
   double degrees;
   if (!input.ReadDouble(degrees) || degrees < 0 || degrees > max_degrees)
@@ -400,7 +479,7 @@ ReadNonNegativeAngle(StringParser<TCHAR> &input, double max_degrees)
 }
 
 static bool
-ReadCoords(StringParser<TCHAR> &input, GeoPoint &point)
+ReadCoords(StringViewParser &input, GeoPoint &point)
 {
   // Format: 53:20:41 N 010:24:41 E
   // Alternative Format: 53:20.68 N 010:24.68 E
@@ -434,7 +513,7 @@ ReadCoords(StringParser<TCHAR> &input, GeoPoint &point)
 }
 
 static bool
-ParseBearingDegrees(StringParser<TCHAR> &input, Angle &value_r)
+ParseBearingDegrees(StringViewParser &input, Angle &value_r)
 {
   double value;
   if (!input.ReadDouble(value) || value < 0 || value > 361)
@@ -445,7 +524,7 @@ ParseBearingDegrees(StringParser<TCHAR> &input, Angle &value_r)
 }
 
 static bool
-ParseArcBearings(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
+ParseArcBearings(StringViewParser &input, TempAirspaceType &temp_area)
 {
   // Determine radius and start/end bearing
 
@@ -464,7 +543,7 @@ ParseArcBearings(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
 }
 
 static bool
-ParseArcPoints(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
+ParseArcPoints(StringViewParser &input, TempAirspaceType &temp_area)
 {
   // Read start coordinates
   GeoPoint start;
@@ -486,28 +565,28 @@ ParseArcPoints(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
 }
 
 static AirspaceClass
-ParseType(const TCHAR *buffer)
+ParseType(StringView buffer)
 {
   for (unsigned i = 0; i < ARRAY_SIZE(airspace_class_strings); i++)
-    if (StringIsEqualIgnoreCase(buffer, airspace_class_strings[i].string))
+    if (buffer.EqualsIgnoreCase(airspace_class_strings[i].string))
       return airspace_class_strings[i].type;
 
   return OTHER;
 }
 
 static bool
-ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
+ParseLine(Airspaces &airspace_database, StringViewParser &input,
           TempAirspaceType &temp_area)
 {
   double d;
 
   // Only return expected lines
   switch (input.pop_front()) {
-  case _T('D'):
-  case _T('d'):
+  case 'D':
+  case 'd':
     switch (input.pop_front()) {
-    case _T('P'):
-    case _T('p'):
+    case 'P':
+    case 'p':
       if (!input.SkipWhitespace())
         break;
 
@@ -520,8 +599,8 @@ ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
       break;
     }
 
-    case _T('C'):
-    case _T('c'):
+    case 'C':
+    case 'c':
       if (!input.ReadDouble(d) || d < 0 || d > 1000)
         return false;
 
@@ -530,13 +609,13 @@ ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
       temp_area.Reset();
       break;
 
-    case _T('A'):
-    case _T('a'):
+    case 'A':
+    case 'a':
       ParseArcBearings(input, temp_area);
       break;
 
-    case _T('B'):
-    case _T('b'):
+    case 'B':
+    case 'b':
       return ParseArcPoints(input, temp_area);
 
     default:
@@ -544,55 +623,55 @@ ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
     }
     break;
 
-  case _T('V'):
-  case _T('v'):
+  case 'V':
+  case 'v':
     input.Strip();
-    if (input.SkipMatchIgnoreCase(_T("X="), 2)) {
+    if (input.SkipMatchIgnoreCase("X=", 2)) {
       if (!ReadCoords(input, temp_area.center))
         return false;
-    } else if (input.SkipMatchIgnoreCase(_T("D=-"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("D=-", 3)) {
       temp_area.rotation = -1;
-    } else if (input.SkipMatchIgnoreCase(_T("D=+"), 3)) {
+    } else if (input.SkipMatchIgnoreCase("D=+", 3)) {
       temp_area.rotation = +1;
     }
     break;
 
-  case _T('A'):
-  case _T('a'):
+  case 'A':
+  case 'a':
     switch (input.pop_front()) {
-    case _T('C'):
-    case _T('c'):
+    case 'C':
+    case 'c':
       if (!input.SkipWhitespace())
         break;
 
       temp_area.AddPolygon(airspace_database);
       temp_area.Reset();
 
-      temp_area.type = ParseType(input.c_str());
+      temp_area.type = ParseType(input.GetRest());
       break;
 
-    case _T('N'):
-    case _T('n'):
+    case 'N':
+    case 'n':
       if (input.SkipWhitespace())
-        temp_area.name = input.c_str();
+        temp_area.SetName(input.GetRest());
       break;
 
-    case _T('L'):
-    case _T('l'):
+    case 'L':
+    case 'l':
       if (input.SkipWhitespace())
         ReadAltitude(input, temp_area.base);
       break;
 
-    case _T('H'):
-    case _T('h'):
+    case 'H':
+    case 'h':
       if (input.SkipWhitespace())
         ReadAltitude(input, temp_area.top);
       break;
 
-    case _T('R'):
-    case _T('r'):
+    case 'R':
+    case 'r':
       if (input.SkipWhitespace())
-        temp_area.radio = input.c_str();
+        temp_area.SetRadio(input.GetRest());
       break;
 
     default:
@@ -606,49 +685,59 @@ ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
 }
 
 static bool
-ParseLine(Airspaces &airspace_database, TCHAR *line,
+ParseLine(Airspaces &airspace_database, StringView line,
           TempAirspaceType &temp_area)
 {
   // Strip comments
-  auto *comment = StringFind(line, _T('*'));
+  const char *comment = line.Find('*');
   if (comment != nullptr)
-    *comment = _T('\0');
+    line.size = comment - line.data;
 
-  return ParseLine(airspace_database, StringParser<TCHAR>(line), temp_area);
+  StringViewParser input(line);
+  return ParseLine(airspace_database, input, temp_area);
 }
 
 static AirspaceClass
-ParseClassTNP(const TCHAR *buffer)
+ParseClassTNP(StringView buffer)
 {
+  if (buffer.IsEmpty())
+    return OTHER;
+
   for (unsigned i = 0; i < ARRAY_SIZE(airspace_tnp_class_chars); i++)
-    if (buffer[0] == airspace_tnp_class_chars[i].character)
+    if (buffer.front() == airspace_tnp_class_chars[i].character)
       return airspace_tnp_class_chars[i].type;
 
   return OTHER;
 }
 
+static bool
+StartsWithIgnoreCase(StringView s, StringView prefix)
+{
+  return s.size >= prefix.size &&
+    StringIsEqualIgnoreCase(s.data, prefix.data, prefix.size);
+}
+
 static AirspaceClass
-ParseTypeTNP(const TCHAR *buffer)
+ParseTypeTNP(StringView type)
 {
   // Handle e.g. "TYPE=CLASS C" properly
-  const TCHAR *type = StringAfterPrefixCI(buffer, _T("CLASS "));
-  if (type) {
+  const StringView class_prefix("CLASS ");
+  if (StartsWithIgnoreCase(type, class_prefix)) {
+    type.skip_front(class_prefix.size);
     AirspaceClass _class = ParseClassTNP(type);
     if (_class != OTHER)
       return _class;
-  } else {
-    type = buffer;
   }
 
   for (unsigned i = 0; i < ARRAY_SIZE(airspace_tnp_type_strings); i++)
-    if (StringIsEqualIgnoreCase(type, airspace_tnp_type_strings[i].string))
+    if (type.EqualsIgnoreCase(airspace_tnp_type_strings[i].string))
       return airspace_tnp_type_strings[i].type;
 
   return OTHER;
 }
 
 static bool
-ReadNonNegativeAngleTNP(StringParser<TCHAR> &input, Angle &value_r,
+ReadNonNegativeAngleTNP(StringViewParser &input, Angle &value_r,
                         unsigned max_degrees)
 {
   unsigned deg, min, sec;
@@ -667,7 +756,7 @@ ReadNonNegativeAngleTNP(StringParser<TCHAR> &input, Angle &value_r,
 }
 
 static bool
-ParseCoordsTNP(StringParser<TCHAR> &input, GeoPoint &point)
+ParseCoordsTNP(StringViewParser &input, GeoPoint &point)
 {
   // Format: N542500 E0105000
   bool negative = false;
@@ -706,7 +795,7 @@ ParseCoordsTNP(StringParser<TCHAR> &input, GeoPoint &point)
 }
 
 static bool
-ParseArcTNP(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
+ParseArcTNP(StringViewParser &input, TempAirspaceType &temp_area)
 {
   if (temp_area.points.empty())
     return false;
@@ -719,13 +808,13 @@ ParseArcTNP(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
   if (!input.SkipWord())
     return false;
 
-  if (!input.SkipMatchIgnoreCase(_T("CENTRE="), 7))
+  if (!input.SkipMatchIgnoreCase("CENTRE=", 7))
     return false;
 
   if (!ParseCoordsTNP(input, temp_area.center))
     return false;
 
-  if (!input.SkipMatchIgnoreCase(_T(" TO="), 4))
+  if (!input.SkipMatchIgnoreCase(" TO=", 4))
     return false;
 
   GeoPoint to;
@@ -738,11 +827,11 @@ ParseArcTNP(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
 }
 
 static bool
-ParseCircleTNP(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
+ParseCircleTNP(StringViewParser &input, TempAirspaceType &temp_area)
 {
   // CIRCLE RADIUS=17.00 CENTRE=N533813 E0095943
 
-  if (!input.SkipMatchIgnoreCase(_T("RADIUS="), 7))
+  if (!input.SkipMatchIgnoreCase("RADIUS=", 7))
     return false;
 
   double radius;
@@ -751,23 +840,23 @@ ParseCircleTNP(StringParser<TCHAR> &input, TempAirspaceType &temp_area)
 
   temp_area.radius = Units::ToSysUnit(radius, Unit::NAUTICAL_MILES);
 
-  if (!input.SkipMatchIgnoreCase(_T(" CENTRE="), 8))
+  if (!input.SkipMatchIgnoreCase(" CENTRE=", 8))
     return false;
 
   return ParseCoordsTNP(input, temp_area.center);
 }
 
 static bool
-ParseLineTNP(Airspaces &airspace_database, StringParser<TCHAR> &input,
+ParseLineTNP(Airspaces &airspace_database, StringViewParser &input,
              TempAirspaceType &temp_area, bool &ignore)
 {
   if (input.Match('#'))
     return true;
 
-  if (input.SkipMatchIgnoreCase(_T("INCLUDE="), 8)) {
-    if (input.MatchIgnoreCase(_T("YES"), 3))
+  if (input.SkipMatchIgnoreCase("INCLUDE=", 8)) {
+    if (input.MatchIgnoreCase("YES", 3))
       ignore = false;
-    else if (input.MatchIgnoreCase(_T("NO"), 2))
+    else if (input.MatchIgnoreCase("NO", 2))
       ignore = true;
 
     return true;
@@ -776,50 +865,50 @@ ParseLineTNP(Airspaces &airspace_database, StringParser<TCHAR> &input,
   if (ignore)
     return true;
 
-  if (input.SkipMatchIgnoreCase(_T("POINT="), 6)) {
+  if (input.SkipMatchIgnoreCase("POINT=", 6)) {
     GeoPoint temp_point;
     if (!ParseCoordsTNP(input, temp_point))
       return false;
 
     temp_area.points.push_back(temp_point);
-  } else if (input.SkipMatchIgnoreCase(_T("CIRCLE "), 7)) {
+  } else if (input.SkipMatchIgnoreCase("CIRCLE ", 7)) {
     if (!ParseCircleTNP(input, temp_area))
       return false;
 
     temp_area.AddCircle(airspace_database);
     temp_area.ResetTNP();
-  } else if (input.SkipMatchIgnoreCase(_T("CLOCKWISE "), 10)) {
+  } else if (input.SkipMatchIgnoreCase("CLOCKWISE ", 10)) {
     temp_area.rotation = 1;
     if (!ParseArcTNP(input, temp_area))
       return false;
-  } else if (input.SkipMatchIgnoreCase(_T("ANTI-CLOCKWISE "), 15)) {
+  } else if (input.SkipMatchIgnoreCase("ANTI-CLOCKWISE ", 15)) {
     temp_area.rotation = -1;
     if (!ParseArcTNP(input, temp_area))
       return false;
-  } else if (input.SkipMatchIgnoreCase(_T("TITLE="), 6)) {
+  } else if (input.SkipMatchIgnoreCase("TITLE=", 6)) {
     temp_area.AddPolygon(airspace_database);
     temp_area.ResetTNP();
 
-    temp_area.name = input.c_str();
-  } else if (input.SkipMatchIgnoreCase(_T("TYPE="), 5)) {
+    temp_area.SetName(input.GetRest());
+  } else if (input.SkipMatchIgnoreCase("TYPE=", 5)) {
     temp_area.AddPolygon(airspace_database);
     temp_area.ResetTNP();
 
-    temp_area.type = ParseTypeTNP(input.c_str());
-  } else if (input.SkipMatchIgnoreCase(_T("CLASS="), 6)) {
-    temp_area.type = ParseClassTNP(input.c_str());
-  } else if (input.SkipMatchIgnoreCase(_T("TOPS="), 5)) {
+    temp_area.type = ParseTypeTNP(input.GetRest());
+  } else if (input.SkipMatchIgnoreCase("CLASS=", 6)) {
+    temp_area.type = ParseClassTNP(input.GetRest());
+  } else if (input.SkipMatchIgnoreCase("TOPS=", 5)) {
     ReadAltitude(input, temp_area.top);
-  } else if (input.SkipMatchIgnoreCase(_T("BASE="), 5)) {
+  } else if (input.SkipMatchIgnoreCase("BASE=", 5)) {
     ReadAltitude(input, temp_area.base);
-  } else if (input.SkipMatchIgnoreCase(_T("RADIO="), 6)) {
-    temp_area.radio = input.c_str();
-  } else if (input.SkipMatchIgnoreCase(_T("ACTIVE="), 7)) {
-    if (input.MatchAllIgnoreCase(_T("WEEKEND")))
+  } else if (input.SkipMatchIgnoreCase("RADIO=", 6)) {
+    temp_area.SetRadio(input.GetRest());
+  } else if (input.SkipMatchIgnoreCase("ACTIVE=", 7)) {
+    if (input.MatchAllIgnoreCase("WEEKEND"))
       temp_area.days_of_operation.SetWeekend();
-    else if (input.MatchAllIgnoreCase(_T("WEEKDAY")))
+    else if (input.MatchAllIgnoreCase("WEEKDAY"))
       temp_area.days_of_operation.SetWeekdays();
-    else if (input.MatchAllIgnoreCase(_T("EVERYDAY")))
+    else if (input.MatchAllIgnoreCase("EVERYDAY"))
       temp_area.days_of_operation.SetAll();
   }
 
@@ -827,20 +916,72 @@ ParseLineTNP(Airspaces &airspace_database, StringParser<TCHAR> &input,
 }
 
 static AirspaceFileType
-DetectFileType(const TCHAR *line)
+DetectFileType(StringView line)
 {
-  if (StringStartsWithIgnoreCase(line, _T("INCLUDE=")) ||
-      StringStartsWithIgnoreCase(line, _T("TYPE=")) ||
-      StringStartsWithIgnoreCase(line, _T("TITLE=")))
+  if (StartsWithIgnoreCase(line, "INCLUDE=") ||
+      StartsWithIgnoreCase(line, "TYPE=") ||
+      StartsWithIgnoreCase(line, "TITLE="))
     return AirspaceFileType::TNP;
 
-  const TCHAR *p = StringAfterPrefixCI(line, _T("AC"));
-  if (p != nullptr && (StringIsEmpty(p) || *p == _T(' ')))
+  if (StartsWithIgnoreCase(line, "AC") &&
+      (line.size == 2 || line.data[2] == ' '))
     return AirspaceFileType::OPENAIR;
 
   return AirspaceFileType::UNKNOWN;
 }
 
+/**
+ * Parse one line of an OpenAir or TNP file.
+ *
+ * @return false if parsing shall be aborted
+ */
+static bool
+ParseAnyLine(Airspaces &airspaces, StringView line, unsigned line_num,
+             TempAirspaceType &temp_area, AirspaceFileType &filetype,
+             bool &ignore, OperationEnvironment &operation)
+{
+  line.StripRight();
+
+  // Skip empty line
+  if (line.IsEmpty())
+    return true;
+
+  if (filetype == AirspaceFileType::UNKNOWN) {
+    filetype = DetectFileType(line);
+    if (filetype == AirspaceFileType::UNKNOWN)
+      return true;
+  }
+
+  // Parse the line
+  bool success;
+  if (filetype == AirspaceFileType::OPENAIR) {
+    success = ParseLine(airspaces, line, temp_area);
+  } else {
+    StringViewParser input(line);
+    success = ParseLineTNP(airspaces, input, temp_area, ignore);
+  }
+
+  return success ||
+    ShowParseWarning(line_num,
+                     ImportText(line, temp_area.charset).c_str(),
+                     operation);
+}
+
+static bool
+FinishParse(Airspaces &airspaces, TempAirspaceType &temp_area,
+            AirspaceFileType filetype, OperationEnvironment &operation)
+{
+  if (filetype == AirspaceFileType::UNKNOWN) {
+    operation.SetErrorMessage(_("Unknown airspace filetype"));
+    return false;
+  }
+
+  // Process final area (if any)
+  temp_area.AddPolygon(airspaces);
+
+  return true;
+}
+
 bool
 AirspaceParser::Parse(TLineReader &reader, OperationEnvironment &operation)
 {
@@ -854,47 +995,77 @@ AirspaceParser::Parse(TLineReader &reader, OperationEnvironment &operation)
   TempAirspaceType temp_area;
   AirspaceFileType filetype = AirspaceFileType::UNKNOWN;
 
+  /* the TLineReader has already converted the file to UTF-8 (or
+     TCHAR) */
+  temp_area.charset = Charset::UTF8;
+
   TCHAR *line;
 
   // Iterate through the lines
   for (unsigned line_num = 1; (line = reader.ReadLine()) != nullptr; line_num++) {
-    StripRight(line);
-
-    // Skip empty line
-    if (StringIsEmpty(line))
+#ifdef _UNICODE
+    const WideToUTF8Converter utf8(line);
+    if (!utf8.IsValid())
       continue;
 
-    if (filetype == AirspaceFileType::UNKNOWN) {
-      filetype = DetectFileType(line);
-      if (filetype == AirspaceFileType::UNKNOWN)
-        continue;
-    }
-
-    // Parse the line
-    if (filetype == AirspaceFileType::OPENAIR)
-      if (!ParseLine(airspaces, line, temp_area) &&
-          !ShowParseWarning(line_num, line, operation))
-        return false;
+    const StringView view((const char *)utf8);
+#else
+    const StringView view(line);
+#endif
 
-    if (filetype == AirspaceFileType::TNP) {
-      StringParser<TCHAR> input(line);
-      if (!ParseLineTNP(airspaces, input, temp_area, ignore) &&
-          !ShowParseWarning(line_num, line, operation))
-        return false;
-    }
+    if (!ParseAnyLine(airspaces, view, line_num, temp_area, filetype,
+                      ignore, operation))
+      return false;
 
     // Update the ProgressDialog
     if ((line_num & 0xff) == 0)
       operation.SetProgressPosition(reader.Tell() * 1024 / file_size);
   }
 
-  if (filetype == AirspaceFileType::UNKNOWN) {
-    operation.SetErrorMessage(_("Unknown airspace filetype"));
-    return false;
+  return FinishParse(airspaces, temp_area, filetype, operation);
+}
+
+bool
+AirspaceParser::Parse(StringView buffer, Charset charset,
+                      OperationEnvironment &operation)
+{
+  bool ignore = false;
+
+  operation.SetProgressRange(1024);
+
+  const char *const begin = buffer.begin();
+  const size_t file_size = buffer.size;
+
+  // Check if there is byte order mark in front
+  if (buffer.size >= 3 &&
+      buffer.data[0] == (char)0xEF &&
+      buffer.data[1] == (char)0xBB &&
+      buffer.data[2] == (char)0xBF &&
+      (charset == Charset::AUTO || charset == Charset::UTF8)) {
+    buffer.skip_front(3);
+    charset = Charset::UTF8;
   }
 
-  // Process final area (if any)
-  temp_area.AddPolygon(airspaces);
+  TempAirspaceType temp_area;
+  temp_area.charset = charset;
 
-  return true;
+  AirspaceFileType filetype = AirspaceFileType::UNKNOWN;
+
+  for (unsigned line_num = 1; !buffer.IsEmpty(); line_num++) {
+    const char *newline = (const char *)
+      memchr(buffer.data, '\n', buffer.size);
+    const char *line_end = newline != nullptr ? newline : buffer.end();
+
+    const StringView line(buffer.data, line_end);
+    buffer.skip_front(line.size + (newline != nullptr));
+
+    if (!ParseAnyLine(airspaces, line, line_num, temp_area, filetype,
+                      ignore, operation))
+      return false;
+
+    if ((line_num & 0xff) == 0)
+      operation.SetProgressPosition((buffer.data - begin) * 1024 / file_size);
+  }
+
+  return FinishParse(airspaces, temp_area, filetype, operation);
 }
@@ -27,6 +27,8 @@ Copyright_License {
 class Airspaces;
 class TLineReader;
 class OperationEnvironment;
+struct StringView;
+enum class Charset;
 
 class AirspaceParser
 {
@@ -36,6 +38,15 @@ public:
   AirspaceParser(Airspaces &_airspaces): airspaces(_airspaces) {}
 
   bool Parse(TLineReader &reader, OperationEnvironment &operation);
+
+  /**
+   * Parse an airspace file which is entirely in memory (e.g. mapped
+   * with #FileMapping).  The buffer is tokenised in place, without
+   * copying lines; only airspace names and radio frequencies are
+   * converted from the given character set.
+   */
+  bool Parse(StringView buffer, Charset charset,
+             OperationEnvironment &operation);
 };
 
 #endif
@@ -0,0 +1,149 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_BLACKBOARD_STATISTICS_HPP
+#define XCSOAR_BLACKBOARD_STATISTICS_HPP
+
+#include "Thread/Mutex.hpp"
+#include "OS/Clock.hpp"
+
+#include <atomic>
+
+#include <stdint.h>
+
+/**
+ * Accumulates durations (in microseconds) measured by any number of
+ * threads.
+ */
+class DurationStatistics {
+  std::atomic<unsigned> count;
+  std::atomic<uint64_t> total, maximum;
+
+public:
+  DurationStatistics():count(0), total(0), maximum(0) {}
+
+  void Add(uint64_t us) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t old = maximum.load(std::memory_order_relaxed);
+    while (us > old &&
+           !maximum.compare_exchange_weak(old, us,
+                                          std::memory_order_relaxed)) {}
+  }
+
+  unsigned GetCount() const {
+    return count.load(std::memory_order_relaxed);
+  }
+
+  uint64_t GetTotal() const {
+    return total.load(std::memory_order_relaxed);
+  }
+
+  uint64_t GetMaximum() const {
+    return maximum.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Write a summary to the log file.
+   */
+  void Log(const char *name) const;
+};
+
+/**
+ * Measures the duration of a scope.
+ */
+class ScopeDuration {
+  DurationStatistics &statistics;
+  const uint64_t start;
+
+public:
+  explicit ScopeDuration(DurationStatistics &_statistics)
+    :statistics(_statistics), start(MonotonicClockUS()) {}
+
+  ~ScopeDuration() {
+    statistics.Add(MonotonicClockUS() - start);
+  }
+
+  ScopeDuration(const ScopeDuration &) = delete;
+  ScopeDuration &operator=(const ScopeDuration &) = delete;
+};
+
+/**
+ * Like #ScopeLock, but records how long the #Mutex was held.
+ */
+class TimedScopeLock {
+  Mutex &mutex;
+  DurationStatistics &statistics;
+  uint64_t start;
+
+public:
+  TimedScopeLock(Mutex &_mutex, DurationStatistics &_statistics)
+    :mutex(_mutex), statistics(_statistics) {
+    mutex.Lock();
+    start = MonotonicClockUS();
+  }
+
+  ~TimedScopeLock() {
+    const uint64_t end = MonotonicClockUS();
+    mutex.Unlock();
+    statistics.Add(end - start);
+  }
+
+  TimedScopeLock(const TimedScopeLock &) = delete;
+  TimedScopeLock &operator=(const TimedScopeLock &) = delete;
+};
+
+/**
+ * Instrumentation of the #DeviceBlackboard: how long its mutex is
+ * held, and how long copying the published snapshots takes (work
+ * which used to be done while holding the mutex).
+ */
+struct BlackboardStatistics {
+  /**
+   * Mutex held by the MergeThread.
+   */
+  DurationStatistics merge_lock;
+
+  /**
+   * Mutex held by the UI thread while receiving new data.
+   */
+  DurationStatistics ui_lock;
+
+  /**
+   * Publishing a new #MoreData / #DerivedInfo snapshot.
+   */
+  DurationStatistics publish_basic, publish_calculated;
+
+  /**
+   * Copying a #MoreData / #DerivedInfo snapshot by a reader.
+   */
+  DurationStatistics read_basic, read_calculated;
+
+  /**
+   * Write all statistics to the log file.
+   */
+  void Log() const;
+};
+
+#endif
@@ -52,6 +52,9 @@ DeviceBlackboard::DeviceBlackboard()
 
   real_clock.Reset();
   replay_clock.Reset();
+
+  published_basic.Publish(gps_info);
+  published_calculated.Publish(calculated_info);
 }
 
 /**
@@ -64,10 +67,13 @@ DeviceBlackboard::DeviceBlackboard()
 void
 DeviceBlackboard::SetStartupLocation(const GeoPoint &loc, const double alt)
 {
-  ScopeLock protect(mutex);
+  {
+    const SnapshotBuffer<DerivedInfo>::Reader calculated(published_calculated);
+    if (calculated->flight.flying)
+      return;
+  }
 
-  if (Calculated().flight.flying)
-    return;
+  ScopeLock protect(mutex);
 
   for (unsigned i = 0; i < unsigned(NUMDEV); ++i)
     if (!per_device_data[i].location_available)
@@ -181,7 +187,8 @@ DeviceBlackboard::SetAltitude(double val)
 void
 DeviceBlackboard::ReadBlackboard(const DerivedInfo &derived_info)
 {
-  calculated_info = derived_info;
+  const ScopeDuration duration(statistics.publish_calculated);
+  published_calculated.Publish(derived_info);
 }
 
 /**
@@ -258,6 +265,13 @@ DeviceBlackboard::Merge()
   }
 }
 
+void
+DeviceBlackboard::PublishBasic()
+{
+  const ScopeDuration duration(statistics.publish_basic);
+  published_basic.Publish(gps_info);
+}
+
 void
 DeviceBlackboard::SetBallast(double fraction, double overload,
                              OperationEnvironment &env)
@@ -26,6 +26,8 @@ Copyright_License {
 
 #include "Blackboard/BaseBlackboard.hpp"
 #include "Blackboard/ComputerSettingsBlackboard.hpp"
+#include "Blackboard/SnapshotBuffer.hpp"
+#include "Blackboard/BlackboardStatistics.hpp"
 #include "Device/Simulator.hpp"
 #include "Device/Features.hpp"
 #include "Thread/Mutex.hpp"
@@ -44,6 +46,11 @@ class RadioFrequency;
  * 
  * The DeviceBlackboard is used as the global ground truth-state
  * since it is accessed quickly with only one mutex
+ *
+ * The merged #MoreData and the #DerivedInfo are additionally
+ * published as snapshots which may be read by any thread without
+ * locking the mutex; see GetPublishedBasic() and
+ * GetPublishedCalculated().
  */
 class DeviceBlackboard
   : public BaseBlackboard, public ComputerSettingsBlackboard
@@ -79,9 +86,21 @@ class DeviceBlackboard
    */
   WrapClock real_clock, replay_clock;
 
+  /**
+   * Snapshots of #gps_info, published by PublishBasic().
+   */
+  SnapshotBuffer<MoreData> published_basic;
+
+  /**
+   * Snapshots of the #DerivedInfo, published by ReadBlackboard().
+   */
+  SnapshotBuffer<DerivedInfo> published_calculated;
+
 public:
   Mutex mutex;
 
+  BlackboardStatistics statistics;
+
 public:
   DeviceBlackboard();
 
@@ -91,7 +110,12 @@ public:
     devices = &_devices;
   }
 
+  /**
+   * Publish new #DerivedInfo.  This method does not need the lock,
+   * but it must be called by only one thread at a time.
+   */
   void ReadBlackboard(const DerivedInfo &derived_info);
+
   void ReadComputerSettings(const ComputerSettings &settings);
 
 protected:
@@ -99,6 +123,30 @@ protected:
   MoreData &SetMoreData() { return gps_info; }
 
 public:
+  /**
+   * The #DerivedInfo is only available through
+   * GetPublishedCalculated().
+   */
+  const DerivedInfo &Calculated() const = delete;
+
+  /**
+   * Returns the published #MoreData snapshots.  The caller doesn't
+   * need to hold the lock; it should pin the current value with a
+   * SnapshotBuffer::Reader and release it quickly.
+   */
+  const SnapshotBuffer<MoreData> &GetPublishedBasic() const {
+    return published_basic;
+  }
+
+  /**
+   * Returns the published #DerivedInfo snapshots.
+   *
+   * @see GetPublishedBasic()
+   */
+  const SnapshotBuffer<DerivedInfo> &GetPublishedCalculated() const {
+    return published_calculated;
+  }
+
   const NMEAInfo &RealState(unsigned i) const {
     assert(i < NUMDEV);
     return per_device_data[i];
@@ -170,6 +218,13 @@ public:
    * Caller must lock the blackboard.
    */
   void Merge();
+
+  /**
+   * Publish #gps_info as a new snapshot.  Must be called by the
+   * thread which modifies #gps_info (i.e. the MergeThread), which
+   * doesn't need to hold the lock for this.
+   */
+  void PublishBasic();
 };
 
 #endif
@@ -0,0 +1,158 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SNAPSHOT_BUFFER_HPP
+#define XCSOAR_SNAPSHOT_BUFFER_HPP
+
+#include "OS/Sleep.h"
+
+#include <atomic>
+
+#include <assert.h>
+
+/**
+ * Publishes copies of a value from one writer thread to any number of
+ * reader threads without a mutex.  This is a triple buffer extended
+ * to more than one reader: the writer copies the new value into a
+ * slot which is neither the current one nor in use by a reader, and
+ * then makes it current with one atomic store.  A reader pins the
+ * current slot with a #Reader; it sees a consistent snapshot for as
+ * long as it holds it, and it never blocks the writer.
+ *
+ * With N slots, up to N-2 readers can hold a #Reader at the same time
+ * without making Publish() wait.  A #Reader should therefore only be
+ * held for a short time (e.g. to copy the value).  If more readers
+ * hold all other slots, Publish() spins briefly and then sleeps until
+ * one of them is finished.
+ */
+template<typename T, unsigned N=4>
+class SnapshotBuffer {
+  static_assert(N >= 3, "Need at least three slots");
+
+  struct Slot {
+    std::atomic<unsigned> readers;
+    T value;
+
+    Slot():readers(0) {}
+  };
+
+  mutable Slot slots[N];
+
+  /**
+   * The index of the slot containing the most recently published
+   * value.
+   */
+  std::atomic<unsigned> current;
+
+public:
+  SnapshotBuffer():current(0) {}
+
+  SnapshotBuffer(const SnapshotBuffer &) = delete;
+  SnapshotBuffer &operator=(const SnapshotBuffer &) = delete;
+
+  /**
+   * Publish a new value.  Must not be called by more than one thread
+   * at a time.
+   */
+  void Publish(const T &value) {
+    Slot &slot = slots[FindFreeSlot()];
+    slot.value = value;
+    current.store(&slot - slots);
+  }
+
+  /**
+   * Holds a reference to the most recently published value.  Newer
+   * values published meanwhile do not modify it.
+   */
+  class Reader {
+    Slot *slot;
+
+  public:
+    explicit Reader(const SnapshotBuffer &buffer) {
+      while (true) {
+        const unsigned i = buffer.current.load();
+        Slot &s = buffer.slots[i];
+        s.readers.fetch_add(1);
+
+        /* the writer may have picked this slot for a new value
+           before our reference was visible; it is only ours if it
+           is still the current one */
+        if (buffer.current.load() == i) {
+          slot = &s;
+          break;
+        }
+
+        s.readers.fetch_sub(1, std::memory_order_release);
+      }
+    }
+
+    ~Reader() {
+      slot->readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    const T &operator*() const {
+      return slot->value;
+    }
+
+    const T *operator->() const {
+      return &slot->value;
+    }
+  };
+
+  /**
+   * Copy the most recently published value.
+   */
+  void Read(T &dest) const {
+    const Reader reader(*this);
+    dest = *reader;
+  }
+
+private:
+  /**
+   * The number of rounds FindFreeSlot() spins before it yields the
+   * CPU to the readers.
+   */
+  static constexpr unsigned SPIN_ROUNDS = 64;
+
+  unsigned FindFreeSlot() const {
+    const unsigned c = current.load(std::memory_order_relaxed);
+
+    /* with N slots and less than N-1 concurrent readers, there is
+       always one; otherwise wait until a reader is finished */
+    for (unsigned round = 0;; ++round) {
+      for (unsigned i = 0; i < N; ++i)
+        if (i != c && slots[i].readers.load() == 0)
+          return i;
+
+      /* a reader which has been preempted cannot release its slot
+         while we keep the CPU busy: first yield, then back off */
+      if (round >= SPIN_ROUNDS)
+        Sleep(round < 2 * SPIN_ROUNDS ? 0 : 1);
+    }
+  }
+};
+
+#endif
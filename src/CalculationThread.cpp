@@ -66,12 +66,14 @@ CalculationThread::Tick()
 
   // update and transfer master info to glide computer
   {
-    ScopeLock protect(device_blackboard->mutex);
+    const ScopeDuration duration(device_blackboard->statistics.read_basic);
+    const SnapshotBuffer<MoreData>::Reader
+      basic(device_blackboard->GetPublishedBasic());
 
-    gps_updated = device_blackboard->Basic().location_available.Modified(glide_computer.Basic().location_available);
+    gps_updated = basic->location_available.Modified(glide_computer.Basic().location_available);
 
     // Copy data from DeviceBlackboard to GlideComputerBlackboard
-    glide_computer.ReadBlackboard(device_blackboard->Basic());
+    glide_computer.ReadBlackboard(*basic);
   }
 
   bool force;
@@ -98,10 +100,7 @@ CalculationThread::Tick()
   // values changed, so copy them back now: ONLY CALCULATED INFO
   // should be changed in DoCalculations, so we only need to write
   // that one back (otherwise we may write over new data)
-  {
-    ScopeLock protect(device_blackboard->mutex);
-    device_blackboard->ReadBlackboard(glide_computer.Calculated());
-  }
+  device_blackboard->ReadBlackboard(glide_computer.Calculated());
 
   // if (new GPS data)
   if (gps_updated || force)
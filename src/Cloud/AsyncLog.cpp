@@ -0,0 +1,102 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AsyncLog.hpp"
+
+#include <unistd.h>
+#include <errno.h>
+
+AsyncLog::AsyncLog(int _fd)
+  :StandbyThread("AsyncLog"), fd(_fd) {}
+
+AsyncLog::~AsyncLog()
+{
+  ScopeLock protect(mutex);
+  WaitDone();
+  Stop();
+}
+
+void
+AsyncLog::Append(const std::string &line)
+{
+  ScopeLock protect(mutex);
+
+  if (pending_lines.size() + line.size() >= MAX_PENDING) {
+    ++n_dropped;
+    return;
+  }
+
+  pending_lines.append(line);
+  pending_lines.push_back('\n');
+
+  /* if the thread has not yet started working on the previous
+     trigger, it will pick up this line as well */
+  if (!IsPending())
+    Trigger();
+}
+
+void
+AsyncLog::Flush()
+{
+  LockWaitDone();
+}
+
+void
+AsyncLog::WriteAll(const std::string &s)
+{
+  const char *p = s.data();
+  size_t size = s.size();
+
+  while (size > 0) {
+    ssize_t nbytes = write(fd, p, size);
+    if (nbytes < 0) {
+      if (errno == EINTR)
+        continue;
+
+      /* nothing we can do about it; discard this chunk */
+      break;
+    }
+
+    p += nbytes;
+    size -= nbytes;
+  }
+}
+
+void
+AsyncLog::Tick()
+{
+  writing.swap(pending_lines);
+
+  if (n_dropped > 0) {
+    writing.append("LOG\tdropped ");
+    writing.append(std::to_string(n_dropped));
+    writing.append(" lines\n");
+    n_dropped = 0;
+  }
+
+  {
+    const ScopeUnlock unlock(mutex);
+    WriteAll(writing);
+  }
+
+  writing.clear();
+}
@@ -0,0 +1,84 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_ASYNC_LOG_HPP
+#define XCSOAR_CLOUD_ASYNC_LOG_HPP
+
+#include "Thread/StandbyThread.hpp"
+
+#include <string>
+
+/**
+ * Writes log lines to a file descriptor in a background thread.  The
+ * caller never blocks on a slow terminal or pipe; lines are collected
+ * in a buffer and written in large chunks.  If the writer falls too
+ * far behind, new lines are dropped (and counted) instead of growing
+ * the buffer without bounds.
+ */
+class AsyncLog final : StandbyThread {
+  static constexpr size_t MAX_PENDING = 4 * 1024 * 1024;
+
+  const int fd;
+
+  /**
+   * Lines which have not yet been picked up by the thread.
+   * Protected by #mutex.
+   */
+  std::string pending_lines;
+
+  /**
+   * The chunk currently being written by the thread.
+   */
+  std::string writing;
+
+  /**
+   * The number of lines dropped because #pending_lines was full.
+   * Protected by #mutex.
+   */
+  unsigned long n_dropped = 0;
+
+public:
+  explicit AsyncLog(int _fd);
+
+  /**
+   * Writes all pending lines and stops the thread.
+   */
+  ~AsyncLog();
+
+  /**
+   * Queue one line.  A newline character is appended.
+   */
+  void Append(const std::string &line);
+
+  /**
+   * Wait until all queued lines have been written.
+   */
+  void Flush();
+
+private:
+  void WriteAll(const std::string &s);
+
+  /* virtual methods from class StandbyThread */
+  void Tick() override;
+};
+
+#endif
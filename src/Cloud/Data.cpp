@@ -32,9 +32,6 @@ using std::cout;
 using std::cerr;
 using std::endl;
 
-static constexpr uint32_t CLOUD_MAGIC = 0x5753f60f;
-static constexpr uint32_t CLOUD_VERSION = 1;
-
 void
 CloudData::DumpClients()
 {
@@ -27,9 +27,17 @@ Copyright_License {
 #include "Client.hpp"
 #include "Thermal.hpp"
 
+#include <stdint.h>
+
 class Serialiser;
 class Deserialiser;
 
+/**
+ * Identification of the database file format.
+ */
+static constexpr uint32_t CLOUD_MAGIC = 0x5753f60f;
+static constexpr uint32_t CLOUD_VERSION = 1;
+
 struct CloudData {
   CloudClientContainer clients;
   CloudThermalContainer thermals;
@@ -0,0 +1,313 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Journal.hpp"
+#include "ShardedData.hpp"
+#include "Data.hpp"
+#include "IO/FileReader.hxx"
+#include "OS/Error.hxx"
+
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+enum class JournalRecord : uint8_t {
+  CLIENT = 1,
+  THERMAL = 2,
+  EXPIRE_CLIENTS = 3,
+  EXPIRE_THERMALS = 4,
+};
+
+CloudJournal::CloudJournal(Path db_path)
+  :StandbyThread("CloudJournal"),
+   path(db_path + ".journal"), old_path(db_path + ".journal.old"),
+   pending_stream(pending), serialiser(pending_stream) {}
+
+CloudJournal::~CloudJournal()
+{
+  ScopeLock protect(mutex);
+  Drain();
+  Stop();
+  Close();
+}
+
+void
+CloudJournal::Open()
+{
+  assert(fd < 0);
+
+  fd = open(path.c_str(), O_WRONLY|O_CREAT|O_APPEND|O_CLOEXEC, 0666);
+  if (fd < 0)
+    throw FormatErrno("Failed to open %s", path.c_str());
+
+  const off_t offset = lseek(fd, 0, SEEK_END);
+  size = offset > 0 ? offset : 0;
+
+  if (size == 0) {
+    serialiser.Write32(CLOUD_JOURNAL_MAGIC);
+    serialiser.Write32(CLOUD_VERSION);
+    Submit();
+  }
+}
+
+void
+CloudJournal::Close()
+{
+  if (fd < 0)
+    return;
+
+  fdatasync(fd);
+  close(fd);
+  fd = -1;
+}
+
+void
+CloudJournal::Drain()
+{
+  if (!pending.empty() && !IsPending())
+    Trigger();
+
+  WaitDone();
+}
+
+void
+CloudJournal::Reset()
+{
+  ScopeLock protect(mutex);
+  Drain();
+  Close();
+
+  unlink(path.c_str());
+  unlink(old_path.c_str());
+  have_old = false;
+
+  Open();
+}
+
+uint64_t
+CloudJournal::GetSize()
+{
+  ScopeLock protect(mutex);
+  return size;
+}
+
+void
+CloudJournal::Submit()
+{
+  const size_t old_size = pending.size();
+  serialiser.Flush();
+  size += pending.size() - old_size;
+
+  /* wake up the thread only for large chunks; if it has not yet
+     started working on the previous trigger, it will pick up this
+     record as well */
+  if (pending.size() >= TRIGGER_SIZE && !IsPending())
+    Trigger();
+
+  if (pending.size() >= MAX_PENDING)
+    /* the disk can't keep up; throttle the caller instead of
+       losing records */
+    WaitDone();
+}
+
+void
+CloudJournal::Flush()
+{
+  ScopeLock protect(mutex);
+  if (!pending.empty() && !IsPending())
+    Trigger();
+}
+
+void
+CloudJournal::AppendClient(const CloudClient &client)
+{
+  ScopeLock protect(mutex);
+  serialiser.Write8(uint8_t(JournalRecord::CLIENT));
+  client.Save(serialiser);
+  Submit();
+}
+
+void
+CloudJournal::AppendThermal(const CloudThermal &thermal)
+{
+  ScopeLock protect(mutex);
+  serialiser.Write8(uint8_t(JournalRecord::THERMAL));
+  thermal.Save(serialiser);
+  Submit();
+}
+
+void
+CloudJournal::AppendExpireClients(std::chrono::steady_clock::time_point before)
+{
+  ScopeLock protect(mutex);
+  serialiser.Write8(uint8_t(JournalRecord::EXPIRE_CLIENTS));
+  serialiser << before;
+  Submit();
+}
+
+void
+CloudJournal::AppendExpireThermals(std::chrono::steady_clock::time_point before)
+{
+  ScopeLock protect(mutex);
+  serialiser.Write8(uint8_t(JournalRecord::EXPIRE_THERMALS));
+  serialiser << before;
+  Submit();
+}
+
+void
+CloudJournal::Rotate()
+{
+  ScopeLock protect(mutex);
+
+  if (have_old)
+    return;
+
+  /* all records submitted so far belong to the old file */
+  Drain();
+  Close();
+
+  if (rename(path.c_str(), old_path.c_str()) < 0) {
+    const int e = errno;
+    Open();
+    throw FormatErrno(e, "Failed to rename %s", path.c_str());
+  }
+
+  have_old = true;
+  Open();
+}
+
+void
+CloudJournal::DeleteOld()
+{
+  ScopeLock protect(mutex);
+
+  if (!have_old)
+    return;
+
+  unlink(old_path.c_str());
+  have_old = false;
+}
+
+void
+CloudJournal::WriteAll(const std::string &s)
+{
+  const char *p = s.data();
+  size_t remaining = s.size();
+
+  while (remaining > 0) {
+    ssize_t nbytes = write(fd, p, remaining);
+    if (nbytes < 0) {
+      if (errno == EINTR)
+        continue;
+
+      std::cerr << "Failed to write " << path.c_str()
+                << ": " << strerror(errno) << std::endl;
+      break;
+    }
+
+    p += nbytes;
+    remaining -= nbytes;
+  }
+}
+
+void
+CloudJournal::Tick()
+{
+  writing.swap(pending);
+
+  if (fd >= 0) {
+    /* Open() and Close() are only called while this thread is
+       idle, so the file descriptor can be used without the lock */
+    const ScopeUnlock unlock(mutex);
+    WriteAll(writing);
+    fdatasync(fd);
+  }
+
+  writing.clear();
+}
+
+/**
+ * Is the end of the file reached, i.e. are there no more records?
+ */
+static bool
+IsEnd(Deserialiser &s)
+{
+  return s.Read().IsEmpty() && !s.Fill(true);
+}
+
+unsigned
+ReplayCloudJournal(Path path, ShardedCloudData &data)
+{
+  FileReader fr(path);
+  Deserialiser s(fr);
+
+  if (s.Read32() != CLOUD_JOURNAL_MAGIC)
+    throw std::runtime_error("Bad journal magic");
+
+  if (s.Read32() != CLOUD_VERSION)
+    throw std::runtime_error("Bad journal version");
+
+  unsigned n = 0;
+
+  try {
+    while (!IsEnd(s)) {
+      std::chrono::steady_clock::time_point before;
+
+      switch (JournalRecord(s.Read8())) {
+      case JournalRecord::CLIENT:
+        data.clients.Restore(CloudClient::Load(s));
+        break;
+
+      case JournalRecord::THERMAL:
+        data.thermals.Restore(CloudThermal::Load(s));
+        break;
+
+      case JournalRecord::EXPIRE_CLIENTS:
+        s >> before;
+        data.clients.Expire(before);
+        break;
+
+      case JournalRecord::EXPIRE_THERMALS:
+        s >> before;
+        data.thermals.Expire(before);
+        break;
+
+      default:
+        throw std::runtime_error("Malformed journal record");
+      }
+
+      ++n;
+    }
+  } catch (const std::runtime_error &e) {
+    /* the rest of the file is unusable; this is usually a record
+       which was being written when the server crashed */
+    std::cerr << "Ignoring the rest of " << path.c_str()
+              << ": " << e.what() << std::endl;
+  }
+
+  return n;
+}
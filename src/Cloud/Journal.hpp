@@ -0,0 +1,227 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_JOURNAL_HPP
+#define XCSOAR_CLOUD_JOURNAL_HPP
+
+#include "Serialiser.hpp"
+#include "Thread/StandbyThread.hpp"
+#include "IO/OutputStream.hxx"
+#include "OS/Path.hpp"
+
+#include <string>
+#include <chrono>
+
+#include <stdint.h>
+
+struct CloudClient;
+struct CloudThermal;
+struct ShardedCloudData;
+
+static constexpr uint32_t CLOUD_JOURNAL_MAGIC = 0x5753f610;
+
+/**
+ * An append-only log of changes to #ShardedCloudData, written next
+ * to the snapshot file ("DBPATH.journal").  Workers submit records
+ * without blocking on the disk; a background thread appends them to
+ * the file in large chunks: it is woken up only when #TRIGGER_SIZE
+ * bytes have accumulated, or by Flush().  Unlike #AsyncLog, records
+ * are never dropped: if the thread falls too far behind, the caller
+ * waits.
+ *
+ * Compaction: Rotate() moves the current file to "DBPATH.journal.old"
+ * and starts a new one; after a snapshot has been committed,
+ * DeleteOld() removes it.  All records are idempotent (except for
+ * duplicate thermals, which ReplayCloudJournal() filters), so
+ * replaying records which are already contained in the snapshot is
+ * harmless.
+ */
+class CloudJournal final : StandbyThread {
+  static constexpr size_t TRIGGER_SIZE = 64 * 1024;
+  static constexpr size_t MAX_PENDING = 16 * 1024 * 1024;
+
+  /**
+   * Appends everything to #pending.
+   */
+  class PendingStream final : public OutputStream {
+    std::string &dest;
+
+  public:
+    explicit PendingStream(std::string &_dest):dest(_dest) {}
+
+    /* virtual methods from class OutputStream */
+    void Write(const void *data, size_t size) override {
+      dest.append((const char *)data, size);
+    }
+  };
+
+  const AllocatedPath path, old_path;
+
+  int fd = -1;
+
+  /**
+   * Records which have not yet been picked up by the thread.
+   * Protected by #mutex.
+   */
+  std::string pending;
+
+  PendingStream pending_stream;
+
+  /**
+   * Serialises records into #pending.  Protected by #mutex.
+   */
+  Serialiser serialiser;
+
+  /**
+   * The chunk currently being written by the thread.
+   */
+  std::string writing;
+
+  /**
+   * The number of bytes submitted to the current file.  Protected
+   * by #mutex.
+   */
+  uint64_t size = 0;
+
+  /**
+   * Does "DBPATH.journal.old" contain records which are not yet
+   * covered by a snapshot?  Protected by #mutex.
+   */
+  bool have_old = false;
+
+public:
+  explicit CloudJournal(Path db_path);
+
+  /**
+   * Writes all pending records and stops the thread.
+   */
+  ~CloudJournal();
+
+  Path GetPath() const {
+    return path;
+  }
+
+  Path GetOldPath() const {
+    return old_path;
+  }
+
+  /**
+   * Throw away all journal files and start a new one.  Call this
+   * after the replayed data has been saved to a new snapshot.
+   *
+   * Throws std::runtime_error on error.
+   */
+  void Reset();
+
+  /**
+   * Returns the size of the current journal file (including records
+   * which have not been written yet).
+   */
+  uint64_t GetSize();
+
+  /**
+   * Write all pending records in the background.  Call this
+   * periodically; it bounds the number of records which are lost in
+   * a crash.
+   */
+  void Flush();
+
+  /**
+   * Record a new or moved client.
+   */
+  void AppendClient(const CloudClient &client);
+
+  /**
+   * Record a new thermal.
+   */
+  void AppendThermal(const CloudThermal &thermal);
+
+  /**
+   * Record a ShardedCloudClientContainer::Expire() call.
+   */
+  void AppendExpireClients(std::chrono::steady_clock::time_point before);
+
+  /**
+   * Record a ShardedCloudThermalContainer::Expire() call.
+   */
+  void AppendExpireThermals(std::chrono::steady_clock::time_point before);
+
+  /**
+   * Wait until all records have been written, move the current file
+   * to "DBPATH.journal.old" and start a new one.  Does nothing if
+   * the old file still exists because the previous snapshot has
+   * failed; in that case, the next snapshot covers both files.
+   *
+   * Throws std::runtime_error on error.
+   */
+  void Rotate();
+
+  /**
+   * Delete "DBPATH.journal.old".  Call this after a snapshot has
+   * been committed which was started after Rotate().
+   */
+  void DeleteOld();
+
+private:
+  /**
+   * Caller must lock the mutex.
+   */
+  void Open();
+
+  /**
+   * Caller must lock the mutex.
+   */
+  void Close();
+
+  /**
+   * Write all pending records and wait until the thread is idle.
+   * Caller must lock the mutex.
+   */
+  void Drain();
+
+  /**
+   * Finish a record which has been written to #serialiser, and wake
+   * up the thread if enough data has accumulated.  Caller must lock
+   * the mutex.
+   */
+  void Submit();
+
+  void WriteAll(const std::string &s);
+
+  /* virtual methods from class StandbyThread */
+  void Tick() override;
+};
+
+/**
+ * Apply the records in the given journal file to the data.  A
+ * truncated record at the end (e.g. after a crash) is ignored.  Call
+ * this before starting the workers.
+ *
+ * Throws std::runtime_error on error.
+ *
+ * @return the number of records which have been applied
+ */
+unsigned
+ReplayCloudJournal(Path path, ShardedCloudData &data);
+
+#endif
@@ -21,16 +21,23 @@ Copyright_License {
 }
 */
 
-#include "Data.hpp"
+#include "ShardedData.hpp"
 #include "Dump.hpp"
 #include "Sender.hpp"
+#include "AsyncLog.hpp"
+#include "Journal.hpp"
 #include "Serialiser.hpp"
 #include "Tracking/SkyLines/Server.hpp"
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "OS/ByteOrder.hpp"
 #include "IO/FileOutputStream.hxx"
 #include "IO/FileReader.hxx"
+#include "OS/Args.hpp"
+#include "OS/FileUtil.hpp"
+#include "Thread/Thread.hpp"
+#include "Thread/StandbyThread.hpp"
 #include "Util/PrintException.hxx"
+#include "Util/StringCompare.hxx"
 #include "Compiler.h"
 
 #ifdef __linux__
@@ -40,8 +47,17 @@ Copyright_License {
 #include <boost/asio/steady_timer.hpp>
 
 #include <array>
+#include <vector>
+#include <list>
+#include <memory>
+#include <algorithm>
+#include <thread>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+
+#include <stdlib.h>
+#include <unistd.h>
 
 // TODO: review these settings
 static constexpr double TRAFFIC_RANGE = 50000;
@@ -52,67 +68,128 @@ static constexpr std::chrono::steady_clock::duration MAX_THERMAL_AGE = std::chro
 
 static constexpr std::chrono::steady_clock::duration REQUEST_EXPIRY = std::chrono::minutes(5);
 
-using std::cout;
+/**
+ * The default interval for sending new traffic locations to
+ * interested clients.
+ */
+static constexpr std::chrono::steady_clock::duration DEFAULT_TRAFFIC_TICK =
+  std::chrono::seconds(1);
+
+/**
+ * Write a new snapshot (and discard the journal) at least this
+ * often.
+ */
+static constexpr std::chrono::steady_clock::duration COMPACT_INTERVAL =
+  std::chrono::minutes(10);
+
+/**
+ * Write a new snapshot as soon as the journal has grown beyond this
+ * size.
+ */
+static constexpr uint64_t COMPACT_SIZE = 64 * 1024 * 1024;
+
 using std::cerr;
 using std::endl;
 
-class CloudServer final
-  : public SkyLinesTracking::Server,
-#ifdef __linux__
-    SignalListener,
-#endif
-    CloudData
+/**
+ * Format a log line with the given function (only if logging is
+ * enabled, i.e. @a log is not nullptr) and submit it to the
+ * #AsyncLog.
+ */
+template<typename F>
+static void
+Log(AsyncLog *log, F &&f)
 {
-  const AllocatedPath db_path;
-
-  boost::asio::steady_timer save_timer, expire_timer;
-
-public:
-  CloudServer(AllocatedPath &&_db_path, boost::asio::io_service &io_service,
-              boost::asio::ip::udp::endpoint endpoint)
-    :SkyLinesTracking::Server(io_service, endpoint),
-#ifdef __linux__
-    SignalListener(io_service),
-#endif
-    db_path(std::move(_db_path)),
-    save_timer(io_service),
-    expire_timer(io_service)
-  {
-#ifdef __linux__
-    SignalListener::Create(SIGTERM, SIGINT, SIGHUP, SIGUSR1);
-#endif
+  if (log == nullptr)
+    return;
 
-    ScheduleSave();
-  }
+  std::ostringstream os;
+  f(os);
+  log->Append(os.str());
+}
 
-  using SkyLinesTracking::Server::get_io_service;
+/**
+ * Handles the datagrams of one socket.  Each #CloudWorker thread has
+ * one; they all bind to the same port with SO_REUSEPORT, and the
+ * kernel distributes the clients among them.  All instances share
+ * one #ShardedCloudData.
+ */
+class CloudServer final : public SkyLinesTracking::Server {
+  ShardedCloudData &data;
+
+  CloudJournal &journal;
+
+  /**
+   * The log, or nullptr if logging is disabled.
+   */
+  AsyncLog *const log;
+
+  /**
+   * New traffic locations are collected and sent to interested
+   * clients in this interval.  Zero means send them immediately.
+   */
+  const std::chrono::steady_clock::duration traffic_tick;
+
+  boost::asio::steady_timer traffic_timer;
+
+  /**
+   * The keys of clients which have submitted a fix to this worker
+   * since the last SendTraffic() call.  May contain duplicates.
+   */
+  std::vector<uint64_t> pending_fixes;
+
+  /**
+   * A copy of the data needed to send one traffic record; it is
+   * collected while the tiles are locked, and sent after they have
+   * been unlocked.
+   */
+  struct TrafficUpdate {
+    Client recipient;
+    unsigned recipient_id;
+
+    unsigned pilot_id;
+    GeoPoint location;
+    int altitude;
+  };
+
+  /**
+   * Temporary buffer for SendTraffic(); it is a member to reuse its
+   * allocation.
+   */
+  std::vector<TrafficUpdate> traffic_updates;
+
+  TrafficBatchSender traffic_sender;
 
-  void Load();
-  void Save();
+public:
+  CloudServer(ShardedCloudData &_data, CloudJournal &_journal,
+              boost::asio::io_service &io_service,
+              boost::asio::ip::udp::endpoint endpoint, bool reuse_port,
+              AsyncLog *_log,
+              std::chrono::steady_clock::duration _traffic_tick)
+    :SkyLinesTracking::Server(io_service, endpoint, reuse_port),
+     data(_data), journal(_journal),
+     log(_log), traffic_tick(_traffic_tick),
+     traffic_timer(io_service),
+     traffic_sender(*this) {}
 
 private:
-  void ScheduleSave() {
-    save_timer.expires_from_now(std::chrono::minutes(1));
-    save_timer.async_wait([this](const boost::system::error_code &ec){
+  void ScheduleTraffic() {
+    traffic_timer.expires_from_now(traffic_tick);
+    traffic_timer.async_wait([this](const boost::system::error_code &ec){
         if (ec)
           return;
 
-        Save();
-        ScheduleSave();
+        SendTraffic();
       });
   }
 
-  void ScheduleExpire() {
-    expire_timer.expires_from_now(std::chrono::minutes(5));
-    expire_timer.async_wait([this](const boost::system::error_code &ec){
-        if (ec)
-          return;
-
-        clients.Expire(expire_timer.expires_at() - std::chrono::minutes(10));
-        if (!clients.empty())
-          ScheduleExpire();
-      });
-  }
+  /**
+   * Send the current locations of all clients in #pending_fixes to
+   * all interested clients nearby.  All updates for one recipient
+   * are coalesced into as few datagrams as possible, and all
+   * datagrams are submitted with few system calls.
+   */
+  void SendTraffic();
 
 protected:
   /* virtual methods from class SkyLinesTracking::Server */
@@ -151,25 +228,6 @@ protected:
     cerr << e.what() << endl;
     get_io_service().stop();
   }
-
-#ifdef __linux__
-  /* virtual methods from class SignalListener */
-  void OnSignal(int signo) override {
-    switch (signo) {
-    case SIGHUP:
-      Save();
-      break;
-
-    case SIGUSR1:
-      DumpClients();
-      break;
-
-    default:
-      get_io_service().stop();
-      break;
-    }
-  }
-#endif
 };
 
 void
@@ -179,46 +237,93 @@ CloudServer::OnFix(const Client &c,
 {
   (void)time_of_day; // TODO: use this parameter
 
-  CloudClient *client;
-  if (location.IsValid()) {
-    bool was_empty = clients.empty();
-
-    client = &clients.Make(c.endpoint, c.key, location, altitude);
+  if (!location.IsValid()) {
+    data.clients.Refresh(c.key, c.endpoint);
+    return;
+  }
 
-    cout << "FIX\t"
-         << client->endpoint << '\t'
-         << std::hex << client->key << std::dec << '\t'
-         << client->id << '\t'
-         << client->location << '\t'
-         << client->altitude << 'm'
-         << endl;
+  const unsigned id = data.clients.Make(c.endpoint, c.key,
+                                        location, altitude);
+
+  journal.AppendClient(CloudClient(c.endpoint, c.key, id,
+                                   location, altitude));
+
+  Log(log, [&](std::ostream &os){
+      os << "FIX\t"
+         << c.endpoint << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << id << '\t'
+         << location << '\t'
+         << altitude << 'm';
+    });
+
+  /* queue this new traffic location for all interested clients; it
+     will be sent by the next SendTraffic() call */
+  const bool was_idle = pending_fixes.empty();
+  pending_fixes.push_back(c.key);
+
+  if (traffic_tick <= std::chrono::steady_clock::duration::zero())
+    SendTraffic();
+  else if (was_idle)
+    ScheduleTraffic();
+}
 
-    if (was_empty)
-      ScheduleExpire();
-  } else {
-    client = clients.Find(c.key);
-    if (client != nullptr)
-      clients.Refresh(*client, c.endpoint);
-  }
+void
+CloudServer::SendTraffic()
+{
+  /* only the latest location of each client is relevant */
+  std::sort(pending_fixes.begin(), pending_fixes.end());
+  pending_fixes.erase(std::unique(pending_fixes.begin(), pending_fixes.end()),
+                      pending_fixes.end());
 
-  /* send this new traffic location to all interested clients
-     immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(location, TRAFFIC_RANGE)) {
-    if (i->key == c.key)
-      /* ignore this client's own submissions - he knows them
-         already */
-      continue;
 
-    if (now > i->wants_traffic)
-      /* not interested (anymore) */
+  traffic_updates.clear();
+
+  for (const uint64_t key : pending_fixes) {
+    TrafficUpdate traffic;
+    if (!data.clients.Visit(key, [&traffic](const CloudClient &client){
+          traffic.pilot_id = client.id;
+          traffic.location = client.location;
+          traffic.altitude = client.altitude;
+        }))
+      /* expired meanwhile */
       continue;
 
-    TrafficResponseSender s(*this, {i->endpoint, i->key});
-    s.Add(client->id, 0, //TODO: time?
-          client->location, client->altitude);
-    s.Flush();
+    data.clients.VisitWithinRange(traffic.location, TRAFFIC_RANGE,
+                                  [this, key, now, &traffic](const CloudClient &i){
+      if (i.key == key)
+        /* ignore this client's own submissions - he knows them
+           already */
+        return;
+
+      if (now > i.wants_traffic)
+        /* not interested (anymore) */
+        return;
+
+      traffic.recipient = {i.endpoint, i.key};
+      traffic.recipient_id = i.id;
+      traffic_updates.push_back(traffic);
+    });
   }
+
+  pending_fixes.clear();
+
+  /* group the updates by recipient, so TrafficBatchSender can
+     coalesce them */
+  std::sort(traffic_updates.begin(), traffic_updates.end(),
+            [](const TrafficUpdate &a, const TrafficUpdate &b){
+              return a.recipient_id != b.recipient_id
+                ? a.recipient_id < b.recipient_id
+                : a.pilot_id < b.pilot_id;
+            });
+
+  for (const auto &i : traffic_updates)
+    traffic_sender.Add(i.recipient,
+                       i.pilot_id, 0, //TODO: time?
+                       i.location, i.altitude);
+
+  traffic_sender.Flush();
 }
 
 void
@@ -228,36 +333,43 @@ CloudServer::OnTrafficRequest(const Client &c, bool near)
     /* "near" is the only selection flag we know */
     return;
 
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  GeoPoint location;
+  if (!data.clients.Visit(c.key, [now, &location](CloudClient &client){
+        client.wants_traffic = now + REQUEST_EXPIRY;
+        location = client.location;
+      }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_traffic = now + REQUEST_EXPIRY;
-
   const auto min_stamp = now - MAX_TRAFFIC_AGE;
 
-  TrafficResponseSender s(*this, c);
+  struct Traffic {
+    unsigned id;
+    GeoPoint location;
+    int altitude;
+  };
 
-  unsigned n = 0;
-  for (const auto &traffic : clients.QueryWithinRange(client->location,
-                                                      TRAFFIC_RANGE)) {
-    if (traffic.get() == client)
-      continue;
+  std::vector<Traffic> traffic;
+  data.clients.VisitWithinRange(location, TRAFFIC_RANGE,
+                                [&c, min_stamp, &traffic](const CloudClient &i){
+    if (i.key == c.key)
+      return;
 
-    if (traffic->stamp < min_stamp)
+    if (i.stamp < min_stamp)
       /* don't send stale traffic, it's probably not there anymore */
-      continue;
+      return;
 
-    s.Add(traffic->id, 0, //TODO: time?
-          traffic->location, traffic->altitude);
+    if (traffic.size() <= 64)
+      traffic.push_back({i.id, i.location, i.altitude});
+  });
 
-    if (++n > 64)
-      break;
-  }
+  TrafficResponseSender s(*this, c);
+  for (const auto &i : traffic)
+    s.Add(i.id, 0, //TODO: time?
+          i.location, i.altitude);
 
   s.Flush();
 }
@@ -270,21 +382,24 @@ CloudServer::OnWaveSubmit(const Client &c,
                           int top_altitude,
                           double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!data.clients.Visit(c.key, [&id](const CloudClient &client){
+        id = client.id;
+      }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
-  cout << "WAVE\t"
-       << client->endpoint << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << a << '\t'
-       << b << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+  Log(log, [&](std::ostream &os){
+      os << "WAVE\t"
+         << c.endpoint << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << id << '\t'
+         << a << '\t'
+         << b << '\t'
+         << bottom_altitude << '-' << top_altitude << "m\t"
+         << lift << "m/s";
+    });
 }
 
 void
@@ -296,42 +411,54 @@ CloudServer::OnThermalSubmit(const Client &c,
                              int top_altitude,
                              double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!data.clients.Visit(c.key, [&id](const CloudClient &client){
+        id = client.id;
+      }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
-  cout << "THERMAL\t"
-       << client->endpoint << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << top_location << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
-
-  const auto &thermal =
-    thermals.Make(c.key,
-                  AGeoPoint(bottom_location, bottom_altitude),
-                  AGeoPoint(top_location, top_altitude),
-                  lift);
+  Log(log, [&](std::ostream &os){
+      os << "THERMAL\t"
+         << c.endpoint << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << id << '\t'
+         << top_location << '\t'
+         << bottom_altitude << '-' << top_altitude << "m\t"
+         << lift << "m/s";
+    });
+
+  const auto thermal =
+    data.thermals.Make(c.key,
+                       AGeoPoint(bottom_location, bottom_altitude),
+                       AGeoPoint(top_location, top_altitude),
+                       lift);
+
+  journal.AppendThermal(*thermal);
 
   /* send this new thermal to all interested clients immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(bottom_location,
-                                                THERMAL_RANGE)) {
-    if (i->key == c.key)
+
+  std::vector<Client> recipients;
+  data.clients.VisitWithinRange(bottom_location, THERMAL_RANGE,
+                                [&c, now, &recipients](const CloudClient &i){
+    if (i.key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return;
 
-    if (now > i->wants_thermals)
+    if (now > i.wants_thermals)
       /* not interested (anymore) */
-      continue;
+      return;
 
-    ThermalResponseSender s(*this, {i->endpoint, i->key});
-    s.Add(thermal.Pack());
+    recipients.push_back({i.endpoint, i.key});
+  });
+
+  const auto packed = thermal->Pack();
+  for (const auto &i : recipients) {
+    ThermalResponseSender s(*this, i);
+    s.Add(packed);
     s.Flush();
   }
 }
@@ -339,92 +466,430 @@ CloudServer::OnThermalSubmit(const Client &c,
 void
 CloudServer::OnThermalRequest(const Client &c)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  GeoPoint location;
+  if (!data.clients.Visit(c.key, [now, &location](CloudClient &client){
+        client.wants_thermals = now + REQUEST_EXPIRY;
+        location = client.location;
+      }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_thermals = now + REQUEST_EXPIRY;
-
   const auto min_time = now - MAX_THERMAL_AGE;
 
-  ThermalResponseSender s(*this, c);
-
-  unsigned n = 0;
-  for (const auto &thermal : thermals.QueryWithinRange(client->location,
-                                                       THERMAL_RANGE)) {
-    if (thermal->client_key == c.key)
+  std::vector<SkyLinesTracking::Thermal> result;
+  data.thermals.VisitWithinRange(location, THERMAL_RANGE,
+                                 [&c, min_time, &result](const CloudThermal &thermal){
+    if (thermal.client_key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return;
 
-    if (thermal->time < min_time)
+    if (thermal.time < min_time)
       /* don't send old thermals, they're useless */
-      continue;
+      return;
 
-    s.Add(thermal->Pack());
+    if (result.size() <= 256)
+      result.push_back(thermal.Pack());
+  });
 
-    if (++n > 256)
-      break;
-  }
+  ThermalResponseSender s(*this, c);
+  for (const auto &i : result)
+    s.Add(i);
 
   s.Flush();
 }
 
-void
-CloudServer::Load()
-{
-  FileReader fr(db_path);
-  Deserialiser s(fr);
-  CloudData::Load(s);
-}
+/**
+ * Runs a #CloudServer with its own io_service in its own thread.
+ */
+class CloudWorker final : Thread {
+  boost::asio::io_service io_service;
 
-void
-CloudServer::Save()
-{
-  cout << "Saving data to " << db_path.c_str() << endl;
+  CloudServer server;
 
-  FileOutputStream fos(db_path);
+public:
+  CloudWorker(ShardedCloudData &data, CloudJournal &journal,
+              boost::asio::ip::udp::endpoint endpoint, bool reuse_port,
+              AsyncLog *log,
+              std::chrono::steady_clock::duration traffic_tick)
+    :Thread("CloudWorker"),
+     server(data, journal, io_service, endpoint, reuse_port, log, traffic_tick) {}
+
+  void Start() {
+    if (!Thread::Start())
+      throw std::runtime_error("Failed to start worker thread");
+  }
+
+  void Stop() {
+    io_service.stop();
+    Join();
+  }
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override {
+    io_service.run();
+  }
+};
+
+/**
+ * Write a snapshot of all data to the given file.  The file is
+ * replaced atomically.
+ */
+static void
+SaveSnapshot(Path path, const ShardedCloudData &data)
+{
+  FileOutputStream fos(path);
 
   {
     Serialiser s(fos);
-    CloudData::Save(s);
+    data.Save(s);
     s.Flush();
   }
 
   fos.Commit();
 }
 
+/**
+ * Writes a new snapshot in a background thread and then discards the
+ * journal records which it covers.  The workers keep running
+ * meanwhile; their changes go to the new journal file.
+ */
+class CloudCompactor final : StandbyThread {
+  const ShardedCloudData &data;
+
+  CloudJournal &journal;
+
+  const Path db_path;
+
+  AsyncLog *const log;
+
+public:
+  CloudCompactor(const ShardedCloudData &_data, CloudJournal &_journal,
+                 Path _db_path, AsyncLog *_log)
+    :StandbyThread("CloudCompactor"),
+     data(_data), journal(_journal), db_path(_db_path), log(_log) {}
+
+  ~CloudCompactor() {
+    LockStop();
+  }
+
+  /**
+   * Start a compaction in the background, unless one is already
+   * running.
+   */
+  void Start() {
+    ScopeLock protect(mutex);
+    if (!IsBusy())
+      Trigger();
+  }
+
+  /**
+   * Compact synchronously (after the background compaction, if one
+   * is running).
+   *
+   * Throws std::runtime_error on error.
+   */
+  void CompactNow() {
+    LockWaitDone();
+    Compact();
+  }
+
+private:
+  void Compact() {
+    Log(log, [this](std::ostream &os){
+        os << "Saving data to " << db_path.c_str();
+      });
+
+    journal.Rotate();
+    SaveSnapshot(db_path, data);
+    journal.DeleteOld();
+  }
+
+  /* virtual methods from class StandbyThread */
+  void Tick() override {
+    const ScopeUnlock unlock(mutex);
+
+    try {
+      Compact();
+    } catch (const std::runtime_error &e) {
+      /* the old journal file is kept, and the next attempt will
+         cover it */
+      PrintException(e);
+    }
+  }
+};
+
+/**
+ * The main thread of the cloud server.  It owns the data and the
+ * #CloudWorker threads, handles signals, and compacts the journal
+ * and expires the data periodically.
+ */
+class CloudInstance final
+#ifdef __linux__
+  : SignalListener
+#endif
+{
+  boost::asio::io_service &io_service;
+
+  const AllocatedPath db_path;
+
+  AsyncLog *const log;
+
+  ShardedCloudData data;
+
+  CloudJournal journal;
+
+  CloudCompactor compactor;
+
+  /**
+   * Flushes the journal every second, and starts a compaction when
+   * it is due.
+   */
+  boost::asio::steady_timer compact_timer;
+
+  boost::asio::steady_timer expire_timer;
+
+  std::chrono::steady_clock::time_point last_compaction;
+
+  std::list<CloudWorker> workers;
+
+public:
+  CloudInstance(AllocatedPath &&_db_path, boost::asio::io_service &_io_service,
+                AsyncLog *_log)
+    :
+#ifdef __linux__
+    SignalListener(_io_service),
+#endif
+    io_service(_io_service),
+    db_path(std::move(_db_path)),
+    log(_log),
+    journal(db_path),
+    compactor(data, journal, db_path, log),
+    compact_timer(io_service),
+    expire_timer(io_service),
+    last_compaction(std::chrono::steady_clock::now())
+  {
+#ifdef __linux__
+    SignalListener::Create(SIGTERM, SIGINT, SIGHUP, SIGUSR1);
+#endif
+
+    ScheduleCompact();
+    ScheduleExpire();
+  }
+
+  ~CloudInstance() {
+    StopWorkers();
+  }
+
+  /**
+   * Load the snapshot, replay the journal and fold it into a new
+   * snapshot.  Call this before starting the workers.
+   *
+   * Throws std::runtime_error if the new snapshot or the new
+   * journal cannot be written.
+   */
+  void Load();
+
+  /**
+   * Write a new snapshot synchronously.
+   */
+  void Save() {
+    compactor.CompactNow();
+  }
+
+  /**
+   * Launch the worker threads.  With more than one, their sockets
+   * share the port with SO_REUSEPORT.
+   */
+  void StartWorkers(boost::asio::ip::udp::endpoint endpoint,
+                    unsigned n_workers,
+                    std::chrono::steady_clock::duration traffic_tick) {
+    const bool reuse_port = n_workers > 1;
+
+    for (unsigned i = 0; i < n_workers; ++i)
+      workers.emplace_back(data, journal, endpoint, reuse_port, log,
+                           traffic_tick);
+
+    for (auto &worker : workers)
+      worker.Start();
+  }
+
+  void StopWorkers() {
+    for (auto &worker : workers)
+      worker.Stop();
+
+    workers.clear();
+  }
+
+private:
+  void Replay(Path path);
+
+  void ScheduleCompact() {
+    compact_timer.expires_from_now(std::chrono::seconds(1));
+    compact_timer.async_wait([this](const boost::system::error_code &ec){
+        if (ec)
+          return;
+
+        journal.Flush();
+
+        const auto now = compact_timer.expires_at();
+        if (now >= last_compaction + COMPACT_INTERVAL ||
+            journal.GetSize() >= COMPACT_SIZE) {
+          last_compaction = now;
+          compactor.Start();
+        }
+
+        ScheduleCompact();
+      });
+  }
+
+  void ScheduleExpire() {
+    expire_timer.expires_from_now(std::chrono::minutes(5));
+    expire_timer.async_wait([this](const boost::system::error_code &ec){
+        if (ec)
+          return;
+
+        const auto now = expire_timer.expires_at();
+
+        const auto client_before = now - std::chrono::minutes(10);
+        data.clients.Expire(client_before);
+        journal.AppendExpireClients(client_before);
+
+        const auto thermal_before = now - MAX_THERMAL_AGE;
+        data.thermals.Expire(thermal_before);
+        journal.AppendExpireThermals(thermal_before);
+
+        ScheduleExpire();
+      });
+  }
+
+#ifdef __linux__
+  /* virtual methods from class SignalListener */
+  void OnSignal(int signo) override {
+    switch (signo) {
+    case SIGHUP:
+      last_compaction = std::chrono::steady_clock::now();
+      compactor.Start();
+      break;
+
+    case SIGUSR1:
+      /* don't interleave the dump with pending log lines */
+      if (log != nullptr)
+        log->Flush();
+
+      data.DumpClients();
+      break;
+
+    default:
+      io_service.stop();
+      break;
+    }
+  }
+#endif
+};
+
+void
+CloudInstance::Replay(Path path)
+{
+  if (!File::Exists(path))
+    return;
+
+  try {
+    const unsigned n = ReplayCloudJournal(path, data);
+    cerr << "Replayed " << n << " records from "
+         << path.c_str() << endl;
+  } catch (const std::runtime_error &e) {
+    cerr << "Failed to replay journal" << endl;
+    PrintException(e);
+  }
+}
+
+void
+CloudInstance::Load()
+{
+  try {
+    FileReader fr(db_path);
+    Deserialiser s(fr);
+    data.Load(s);
+  } catch (const std::runtime_error &e) {
+    cerr << "Failed to load database" << endl;
+    PrintException(e);
+  }
+
+  /* the old file exists only if the server was interrupted while
+     compacting; its records are older than the current file's */
+  Replay(journal.GetOldPath());
+  Replay(journal.GetPath());
+
+  /* fold the journal into a new snapshot and start over with an
+     empty journal */
+  SaveSnapshot(db_path, data);
+  journal.Reset();
+}
+
 int
 main(int argc, char **argv)
 try {
-  if (argc != 2) {
-    cerr << "Usage: " << argv[0] << " DBPATH" << endl;
-    return EXIT_FAILURE;
+  Args args(argc, argv, "[--no-log] [--tick=MS] [--threads=N] DBPATH\n\n"
+            "--tick sets the interval for sending traffic updates\n"
+            "(default 1000); 0 sends them immediately.\n"
+            "--threads sets the number of worker threads (default: one\n"
+            "per CPU).");
+
+  bool enable_log = true;
+  std::chrono::steady_clock::duration traffic_tick = DEFAULT_TRAFFIC_TICK;
+  unsigned n_workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if (StringIsEqual(arg, "--no-log")) {
+      enable_log = false;
+    } else if ((value = StringAfterPrefix(arg, "--tick=")) != nullptr) {
+      char *endptr;
+      unsigned long ms = strtoul(value, &endptr, 10);
+      if (endptr == value || *endptr != 0)
+        args.UsageError();
+
+      traffic_tick = std::chrono::milliseconds(ms);
+    } else if ((value = StringAfterPrefix(arg, "--threads=")) != nullptr) {
+      n_workers = strtoul(value, nullptr, 10);
+      if (n_workers == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
   }
 
-  const Path db_path(argv[1]);
+  const Path db_path(args.ExpectNext());
+  args.ExpectEnd();
+
+  std::unique_ptr<AsyncLog> log;
+  if (enable_log)
+    log.reset(new AsyncLog(STDOUT_FILENO));
 
   boost::asio::io_service io_service;
 
   const boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::udp::v4(),
                                                 CloudServer::GetDefaultPort());
 
-  CloudServer server(db_path, io_service, endpoint);
+  std::unique_ptr<CloudInstance> instance(new CloudInstance(db_path, io_service,
+                                                            log.get()));
 
-  try {
-    server.Load();
-  } catch (const std::runtime_error &e) {
-    cerr << "Failed to load database" << endl;
-    PrintException(e);
-  }
+  instance->Load();
+
+  instance->StartWorkers(endpoint, n_workers, traffic_tick);
 
   io_service.run();
 
-  server.Save();
+  instance->StopWorkers();
+  instance->Save();
 
   return EXIT_SUCCESS;
 } catch (const std::exception &exception) {
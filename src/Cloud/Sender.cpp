@@ -27,20 +27,42 @@ Copyright_License {
 #include "Util/CRC.hpp"
 
 void
-TrafficResponseSender::Add(uint32_t pilot_id, uint32_t time,
+TrafficResponseBuffer::Set(unsigned i, uint32_t pilot_id, uint32_t time,
                            GeoPoint location, int altitude)
 {
-  assert(n_traffic < MAX_TRAFFIC);
+  assert(i < MAX_TRAFFIC);
+
+  auto &t = traffic[i];
+  t.pilot_id = ToBE32(pilot_id);
+  t.time = ToBE32(time);
+  t.location = SkyLinesTracking::ExportGeoPoint(location);
+  t.altitude = ToBE16(altitude);
+  t.reserved = 0;
+  t.reserved2 = 0;
+}
+
+size_t
+TrafficResponseBuffer::Finish(unsigned n_traffic)
+{
+  assert(n_traffic > 0);
+  assert(n_traffic <= MAX_TRAFFIC);
+
+  size_t size = sizeof(header) + sizeof(traffic[0]) * n_traffic;
+
+  header.traffic_count = n_traffic;
 
-  auto &traffic = data.traffic[n_traffic++];
-  traffic.pilot_id = ToBE32(pilot_id);
-  traffic.time = ToBE32(time);
-  traffic.location = SkyLinesTracking::ExportGeoPoint(location);
-  traffic.altitude = ToBE16(altitude);
-  traffic.reserved = 0;
-  traffic.reserved2 = 0;
+  header.header.crc = 0;
+  header.header.crc = ToBE16(UpdateCRC16CCITT(this, size, 0));
+  return size;
+}
+
+void
+TrafficResponseSender::Add(uint32_t pilot_id, uint32_t time,
+                           GeoPoint location, int altitude)
+{
+  data.Set(n_traffic++, pilot_id, time, location, altitude);
 
-  if (n_traffic == MAX_TRAFFIC)
+  if (n_traffic == data.MAX_TRAFFIC)
     Flush();
 }
 
@@ -50,16 +72,49 @@ TrafficResponseSender::Flush()
   if (n_traffic == 0)
     return;
 
-  size_t size = sizeof(data.header) + sizeof(data.traffic[0]) * n_traffic;
-
-  data.header.traffic_count = n_traffic;
+  size_t size = data.Finish(n_traffic);
   n_traffic = 0;
 
-  data.header.header.crc = 0;
-  data.header.header.crc = ToBE16(UpdateCRC16CCITT(&data, size, 0));
   server.SendBuffer(endpoint, boost::asio::const_buffer(&data, size));
 }
 
+void
+TrafficBatchSender::Add(const SkyLinesTracking::Server::Client &client,
+                        uint32_t pilot_id, uint32_t time,
+                        GeoPoint location, int altitude)
+{
+  Slot *slot = n_slots > 0 ? &slots[n_slots - 1] : nullptr;
+  if (slot == nullptr || slot->key != client.key ||
+      slot->endpoint != client.endpoint ||
+      slot->n_traffic == slot->data.MAX_TRAFFIC) {
+    /* start a new datagram */
+    if (n_slots == MAX_DATAGRAMS)
+      Flush();
+
+    slot = &slots[n_slots++];
+    slot->endpoint = client.endpoint;
+    slot->key = client.key;
+    slot->n_traffic = 0;
+    slot->data.Init(client.key);
+  }
+
+  slot->data.Set(slot->n_traffic++, pilot_id, time, location, altitude);
+}
+
+void
+TrafficBatchSender::Flush()
+{
+  for (unsigned i = 0; i < n_slots; ++i) {
+    auto &slot = slots[i];
+    size_t size = slot.data.Finish(slot.n_traffic);
+    datagrams[i] = {&slot.endpoint,
+                    boost::asio::const_buffer(&slot.data, size)};
+  }
+
+  server.SendBatch(datagrams.data(), n_slots);
+  n_slots = 0;
+}
+
 void
 ThermalResponseSender::Add(SkyLinesTracking::Thermal t)
 {
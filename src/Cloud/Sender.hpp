@@ -30,20 +30,48 @@ Copyright_License {
 
 #include <boost/asio/ip/udp.hpp>
 
-struct GeoPoint;
+#include <array>
 
-class TrafficResponseSender {
-  SkyLinesTracking::Server &server;
-  const boost::asio::ip::udp::endpoint &endpoint;
+struct GeoPoint;
 
+/**
+ * A TRAFFIC_RESPONSE datagram being assembled.
+ */
+struct TrafficResponseBuffer {
   static constexpr size_t MAX_TRAFFIC_SIZE = 1024;
   static constexpr size_t MAX_TRAFFIC =
     MAX_TRAFFIC_SIZE / sizeof(SkyLinesTracking::TrafficResponsePacket::Traffic);
 
-  struct Packet {
-    SkyLinesTracking::TrafficResponsePacket header;
-    std::array<SkyLinesTracking::TrafficResponsePacket::Traffic, MAX_TRAFFIC> traffic;
-  } data;
+  SkyLinesTracking::TrafficResponsePacket header;
+  std::array<SkyLinesTracking::TrafficResponsePacket::Traffic, MAX_TRAFFIC> traffic;
+
+  void Init(uint64_t key) {
+    header.header.magic = ToBE32(SkyLinesTracking::MAGIC);
+    header.header.type = ToBE16(SkyLinesTracking::Type::TRAFFIC_RESPONSE);
+    header.header.key = ToBE64(key);
+
+    header.reserved = 0;
+    header.reserved2 = 0;
+    header.reserved3 = 0;
+  }
+
+  void Set(unsigned i, uint32_t pilot_id, uint32_t time,
+           GeoPoint location, int altitude);
+
+  /**
+   * Finish the datagram with the given number of #traffic elements
+   * (fill in the count and the CRC).
+   *
+   * @return the size of the datagram in bytes
+   */
+  size_t Finish(unsigned n_traffic);
+};
+
+class TrafficResponseSender {
+  SkyLinesTracking::Server &server;
+  const boost::asio::ip::udp::endpoint &endpoint;
+
+  TrafficResponseBuffer data;
 
   unsigned n_traffic = 0;
 
@@ -51,13 +79,7 @@ public:
   TrafficResponseSender(SkyLinesTracking::Server &_server,
                         const SkyLinesTracking::Server::Client &client)
     :server(_server), endpoint(client.endpoint) {
-    data.header.header.magic = ToBE32(SkyLinesTracking::MAGIC);
-    data.header.header.type = ToBE16(SkyLinesTracking::Type::TRAFFIC_RESPONSE);
-    data.header.header.key = ToBE64(client.key);
-
-    data.header.reserved = 0;
-    data.header.reserved2 = 0;
-    data.header.reserved3 = 0;
+    data.Init(client.key);
   }
 
   void Add(uint32_t pilot_id, uint32_t time,
@@ -65,6 +87,43 @@ public:
   void Flush();
 };
 
+/**
+ * Sends TRAFFIC_RESPONSE datagrams to many clients with few system
+ * calls.  Consecutive Add() calls for the same client are coalesced
+ * into one datagram, and the datagrams are submitted with
+ * SkyLinesTracking::Server::SendBatch().
+ */
+class TrafficBatchSender {
+  SkyLinesTracking::Server &server;
+
+  static constexpr size_t MAX_DATAGRAMS = 64;
+
+  struct Slot {
+    boost::asio::ip::udp::endpoint endpoint;
+    uint64_t key;
+    unsigned n_traffic;
+    TrafficResponseBuffer data;
+  };
+
+  std::array<Slot, MAX_DATAGRAMS> slots;
+  std::array<SkyLinesTracking::Server::Datagram, MAX_DATAGRAMS> datagrams;
+
+  unsigned n_slots = 0;
+
+public:
+  explicit TrafficBatchSender(SkyLinesTracking::Server &_server)
+    :server(_server) {}
+
+  void Add(const SkyLinesTracking::Server::Client &client,
+           uint32_t pilot_id, uint32_t time,
+           GeoPoint location, int altitude);
+
+  /**
+   * Send all pending datagrams.
+   */
+  void Flush();
+};
+
 class ThermalResponseSender {
   SkyLinesTracking::Server &server;
   const boost::asio::ip::udp::endpoint &endpoint;
@@ -0,0 +1,228 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ShardedClient.hpp"
+#include "Serialiser.hpp"
+
+ShardedCloudClientContainer::ShardedCloudClientContainer()
+  :next_id(1), n_clients(0) {}
+
+ShardedCloudClientContainer::~ShardedCloudClientContainer() = default;
+
+void
+ShardedCloudClientContainer::Insert(KeyPartition &partition,
+                                    CloudClientPtr &&client)
+{
+  Shard &shard = shards[CloudTiles::ToIndex(client->location)];
+
+  {
+    const ScopeExclusiveLock lock(shard.mutex);
+    shard.Insert(*client);
+  }
+
+  partition.clients.emplace(client->key, std::move(client));
+  ++n_clients;
+}
+
+unsigned
+ShardedCloudClientContainer::Make(const boost::asio::ip::udp::endpoint &endpoint,
+                                  uint64_t key,
+                                  const GeoPoint &location, int altitude)
+{
+  auto &partition = GetPartition(key);
+  const ScopeLock protect(partition.mutex);
+
+  auto i = partition.clients.find(key);
+  if (i == partition.clients.end()) {
+    const unsigned id = next_id++;
+    Insert(partition,
+           std::make_shared<CloudClient>(endpoint, key, id,
+                                         location, altitude));
+    return id;
+  }
+
+  CloudClient &client = *i->second;
+
+  const unsigned old_index = CloudTiles::ToIndex(client.location);
+  const unsigned new_index = CloudTiles::ToIndex(location);
+
+  if (old_index == new_index) {
+    Shard &shard = shards[old_index];
+    const ScopeExclusiveLock lock(shard.mutex);
+
+    client.Refresh(endpoint);
+    shard.Touch(client);
+
+    if (location != client.location) {
+      auto ptr = client.shared_from_this();
+      shard.rtree.remove(ptr);
+      client.location = location;
+      shard.rtree.insert(ptr);
+    }
+
+    client.altitude = altitude;
+  } else {
+    /* the client has crossed a tile boundary; lock both tiles in
+       ascending order */
+    Shard &old_shard = shards[old_index], &new_shard = shards[new_index];
+    Shard &first = old_index < new_index ? old_shard : new_shard;
+    Shard &second = old_index < new_index ? new_shard : old_shard;
+
+    const ScopeExclusiveLock lock1(first.mutex);
+    const ScopeExclusiveLock lock2(second.mutex);
+
+    old_shard.Remove(client);
+    client.Refresh(endpoint);
+    client.location = location;
+    client.altitude = altitude;
+    new_shard.Insert(client);
+  }
+
+  return client.id;
+}
+
+bool
+ShardedCloudClientContainer::Refresh(uint64_t key,
+                                     const boost::asio::ip::udp::endpoint &endpoint)
+{
+  auto &partition = GetPartition(key);
+  const ScopeLock protect(partition.mutex);
+
+  auto i = partition.clients.find(key);
+  if (i == partition.clients.end())
+    return false;
+
+  CloudClient &client = *i->second;
+  Shard &shard = shards[CloudTiles::ToIndex(client.location)];
+  const ScopeExclusiveLock lock(shard.mutex);
+
+  client.Refresh(endpoint);
+  shard.Touch(client);
+  return true;
+}
+
+void
+ShardedCloudClientContainer::Expire(std::chrono::steady_clock::time_point before)
+{
+  std::vector<uint64_t> keys;
+
+  for (auto &shard : shards) {
+    /* collect the candidates while holding only this tile's lock;
+       the key partition must be locked first, so the removal is a
+       second pass */
+    {
+      const ScopeSharedLock lock(shard.mutex);
+      for (auto i = shard.list.rbegin(), end = shard.list.rend();
+           i != end && i->stamp < before; ++i)
+        keys.push_back(i->key);
+    }
+
+    for (const uint64_t key : keys) {
+      auto &partition = GetPartition(key);
+      const ScopeLock protect(partition.mutex);
+
+      auto i = partition.clients.find(key);
+      if (i == partition.clients.end())
+        continue;
+
+      CloudClient &client = *i->second;
+      Shard &current = shards[CloudTiles::ToIndex(client.location)];
+
+      {
+        const ScopeExclusiveLock lock(current.mutex);
+        if (client.stamp >= before)
+          /* refreshed meanwhile */
+          continue;
+
+        current.Remove(client);
+      }
+
+      partition.clients.erase(i);
+      --n_clients;
+    }
+
+    keys.clear();
+  }
+}
+
+void
+ShardedCloudClientContainer::Save(Serialiser &s) const
+{
+  s.Write32(next_id);
+
+  for (const auto &shard : shards) {
+    const ScopeSharedLock lock(shard.mutex);
+
+    /* oldest first, so Load() restores the expiry order */
+    for (auto i = shard.list.rbegin(), end = shard.list.rend();
+         i != end; ++i) {
+      s.Write8(1);
+      i->Save(s);
+    }
+  }
+
+  s.Write8(0);
+  s.Write8(0);
+}
+
+void
+ShardedCloudClientContainer::Load(Deserialiser &s)
+{
+  next_id = s.Read32();
+
+  while (s.Read8() != 0) {
+    auto client = std::make_shared<CloudClient>(CloudClient::Load(s));
+    auto &partition = GetPartition(client->key);
+    if (partition.clients.find(client->key) == partition.clients.end())
+      Insert(partition, std::move(client));
+  }
+
+  s.Read8();
+}
+
+void
+ShardedCloudClientContainer::Restore(CloudClient &&_client)
+{
+  auto client = std::make_shared<CloudClient>(std::move(_client));
+  auto &partition = GetPartition(client->key);
+  const ScopeLock protect(partition.mutex);
+
+  auto i = partition.clients.find(client->key);
+  if (i != partition.clients.end()) {
+    CloudClient &old = *i->second;
+    Shard &shard = shards[CloudTiles::ToIndex(old.location)];
+
+    {
+      const ScopeExclusiveLock lock(shard.mutex);
+      shard.Remove(old);
+    }
+
+    partition.clients.erase(i);
+    --n_clients;
+  }
+
+  if (client->id >= next_id)
+    next_id = client->id + 1;
+
+  Insert(partition, std::move(client));
+}
@@ -0,0 +1,237 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_SHARDED_CLIENT_HPP
+#define XCSOAR_CLOUD_SHARDED_CLIENT_HPP
+
+#include "Client.hpp"
+#include "Tile.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/SharedMutex.hpp"
+
+#include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/strategies/strategies.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <atomic>
+
+class Serialiser;
+class Deserialiser;
+
+/**
+ * A thread-safe variant of #CloudClientContainer.  Each #CloudTiles
+ * tile has its own R-tree, its own expiry list and its own
+ * #SharedMutex, so workers only contend when they touch the same
+ * region.  The key lookup table is partitioned by key, with one
+ * #Mutex per partition.
+ *
+ * Lock order: key partition first, then tile mutexes in ascending
+ * index order.  Callbacks run while the tile is locked; they must not
+ * call back into this object.
+ */
+class ShardedCloudClientContainer {
+  typedef boost::geometry::index::rtree<CloudClientPtr, boost::geometry::index::rstar<16>,
+                                        CloudClientIndexable> Tree;
+
+  typedef boost::intrusive::list<CloudClient,
+                                 boost::intrusive::constant_time_size<false>> List;
+
+  struct Shard {
+    mutable SharedMutex mutex;
+
+    /**
+     * A geospatial container of all clients in this tile.
+     */
+    Tree rtree;
+
+    /**
+     * A linked list of clients in this tile, sorted by last fix,
+     * with fresh items at the front.
+     */
+    List list;
+
+    ~Shard() {
+      list.clear();
+    }
+
+    void Insert(CloudClient &client) {
+      list.push_front(client);
+      rtree.insert(client.shared_from_this());
+    }
+
+    void Remove(CloudClient &client) {
+      list.erase(list.iterator_to(client));
+      rtree.remove(client.shared_from_this());
+    }
+
+    void Touch(CloudClient &client) {
+      list.erase(list.iterator_to(client));
+      list.push_front(client);
+    }
+  };
+
+  struct KeyPartition {
+    Mutex mutex;
+
+    /**
+     * Map (secret) key to #CloudClient.
+     */
+    std::unordered_map<uint64_t, CloudClientPtr> clients;
+  };
+
+  static constexpr unsigned N_KEY_PARTITIONS = 64;
+
+  std::array<Shard, CloudTiles::COUNT> shards;
+  std::array<KeyPartition, N_KEY_PARTITIONS> partitions;
+
+  /**
+   * The public id assigned to the next new #CloudClient.
+   */
+  std::atomic<unsigned> next_id;
+
+  std::atomic<unsigned> n_clients;
+
+public:
+  ShardedCloudClientContainer();
+  ~ShardedCloudClientContainer();
+
+  ShardedCloudClientContainer(const ShardedCloudClientContainer &) = delete;
+  ShardedCloudClientContainer &operator=(const ShardedCloudClientContainer &) = delete;
+
+  unsigned size() const {
+    return n_clients.load(std::memory_order_relaxed);
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * Create a new #CloudClient, or refresh the existing one (and move
+   * it to another tile if necessary).
+   *
+   * @return the public id of the client
+   */
+  unsigned Make(const boost::asio::ip::udp::endpoint &endpoint,
+                uint64_t key, const GeoPoint &location, int altitude);
+
+  /**
+   * Refresh the endpoint and the time stamp of an existing client.
+   *
+   * @return false if there is no such client
+   */
+  bool Refresh(uint64_t key, const boost::asio::ip::udp::endpoint &endpoint);
+
+  /**
+   * Look up a client by its secret key and invoke f(CloudClient &)
+   * while its tile is locked exclusively.
+   *
+   * @return false if there is no such client
+   */
+  template<typename F>
+  bool Visit(uint64_t key, F &&f) {
+    auto &partition = GetPartition(key);
+    const ScopeLock protect(partition.mutex);
+
+    auto i = partition.clients.find(key);
+    if (i == partition.clients.end())
+      return false;
+
+    CloudClient &client = *i->second;
+    Shard &shard = shards[CloudTiles::ToIndex(client.location)];
+    const ScopeExclusiveLock lock(shard.mutex);
+    f(client);
+    return true;
+  }
+
+  /**
+   * Invoke f(const CloudClient &) for each client within the given
+   * range.  Each tile is locked (shared) while its clients are
+   * visited.
+   */
+  template<typename F>
+  void VisitWithinRange(GeoPoint location, double range, F &&f) const {
+    const auto box = BoostRangeBox(location, range);
+    const auto q = boost::geometry::index::intersects(box);
+
+    CloudTiles::VisitBox(box, [this, &q, &f](unsigned index){
+        const Shard &shard = shards[index];
+        const ScopeSharedLock lock(shard.mutex);
+        for (auto i = shard.rtree.qbegin(q), end = shard.rtree.qend();
+             i != end; ++i)
+          f(**i);
+      });
+  }
+
+  /**
+   * Invoke f(const CloudClient &) for all clients, one tile at a
+   * time.
+   */
+  template<typename F>
+  void VisitAll(F &&f) const {
+    for (const auto &shard : shards) {
+      const ScopeSharedLock lock(shard.mutex);
+      for (const auto &client : shard.list)
+        f(client);
+    }
+  }
+
+  /**
+   * Remove all clients which have not submitted anything since the
+   * given time.  Each tile is processed separately.
+   */
+  void Expire(std::chrono::steady_clock::time_point before);
+
+  /**
+   * Serialise all clients in the #CloudClientContainer format.
+   * Tiles are locked one at a time.
+   */
+  void Save(Serialiser &s) const;
+
+  /**
+   * Load clients saved by Save() or by CloudClientContainer::Save().
+   * This is not thread-safe; call it before starting the workers.
+   */
+  void Load(Deserialiser &s);
+
+  /**
+   * Insert a client loaded from the journal, replacing an existing
+   * one with the same key.  Its id and time stamp are preserved.
+   * This is not thread-safe; call it before starting the workers.
+   */
+  void Restore(CloudClient &&client);
+
+private:
+  KeyPartition &GetPartition(uint64_t key) {
+    return partitions[CloudClient::KeyHash()(key) % N_KEY_PARTITIONS];
+  }
+
+  /**
+   * Insert a new client.  Caller must lock the key partition.
+   */
+  void Insert(KeyPartition &partition, CloudClientPtr &&client);
+};
+
+#endif
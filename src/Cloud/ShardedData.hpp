@@ -0,0 +1,47 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_SHARDED_DATA_HPP
+#define XCSOAR_CLOUD_SHARDED_DATA_HPP
+
+#include "ShardedClient.hpp"
+#include "ShardedThermal.hpp"
+
+class Serialiser;
+class Deserialiser;
+
+/**
+ * The thread-safe counterpart of #CloudData, shared by all workers of
+ * the cloud server.  It uses the same file format.
+ */
+struct ShardedCloudData {
+  ShardedCloudClientContainer clients;
+  ShardedCloudThermalContainer thermals;
+
+  void DumpClients() const;
+
+  void Save(Serialiser &s) const;
+  void Load(Deserialiser &s);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ShardedThermal.hpp"
+#include "Serialiser.hpp"
+
+void
+ShardedCloudThermalContainer::Insert(CloudThermalPtr &&thermal)
+{
+  Shard &shard = shards[CloudTiles::ToIndex(thermal->top_location)];
+  const ScopeExclusiveLock lock(shard.mutex);
+  shard.Insert(*thermal);
+}
+
+CloudThermalPtr
+ShardedCloudThermalContainer::Make(uint64_t client_key,
+                                   const AGeoPoint &bottom_location,
+                                   const AGeoPoint &top_location,
+                                   double lift)
+{
+  auto thermal = std::make_shared<CloudThermal>(client_key, bottom_location,
+                                                top_location, lift);
+  Insert(CloudThermalPtr(thermal));
+  return thermal;
+}
+
+void
+ShardedCloudThermalContainer::Expire(std::chrono::steady_clock::time_point before)
+{
+  for (auto &shard : shards) {
+    const ScopeExclusiveLock lock(shard.mutex);
+    while (!shard.list.empty() && shard.list.back().time < before)
+      shard.Remove(shard.list.back());
+  }
+}
+
+void
+ShardedCloudThermalContainer::Save(Serialiser &s) const
+{
+  s.Write8(1);
+
+  for (const auto &shard : shards) {
+    const ScopeSharedLock lock(shard.mutex);
+
+    /* oldest first, so Load() restores the expiry order */
+    for (auto i = shard.list.rbegin(), end = shard.list.rend();
+         i != end; ++i) {
+      s.Write8(1);
+      i->Save(s);
+    }
+  }
+
+  s.Write8(0);
+  s.Write8(0);
+}
+
+void
+ShardedCloudThermalContainer::Load(Deserialiser &s)
+{
+  s.Read8();
+
+  while (s.Read8() != 0)
+    Insert(std::make_shared<CloudThermal>(CloudThermal::Load(s)));
+
+  s.Read8();
+}
+
+void
+ShardedCloudThermalContainer::Restore(CloudThermal &&thermal)
+{
+  Shard &shard = shards[CloudTiles::ToIndex(thermal.top_location)];
+
+  {
+    const ScopeSharedLock lock(shard.mutex);
+    const auto q = boost::geometry::index::intersects(GeoPoint(thermal.top_location));
+    for (auto i = shard.rtree.qbegin(q), end = shard.rtree.qend();
+         i != end; ++i) {
+      const CloudThermal &other = **i;
+      if (other.client_key == thermal.client_key &&
+          other.bottom_location == thermal.bottom_location &&
+          other.lift == thermal.lift)
+        /* already known */
+        return;
+    }
+  }
+
+  Insert(std::make_shared<CloudThermal>(std::move(thermal)));
+}
@@ -0,0 +1,140 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_SHARDED_THERMAL_HPP
+#define XCSOAR_CLOUD_SHARDED_THERMAL_HPP
+
+#include "Thermal.hpp"
+#include "Tile.hpp"
+#include "Thread/SharedMutex.hpp"
+
+#include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/strategies/strategies.hpp>
+
+#include <array>
+
+class Serialiser;
+class Deserialiser;
+
+/**
+ * A thread-safe variant of #CloudThermalContainer, with one R-tree,
+ * one expiry list and one #SharedMutex per #CloudTiles tile.
+ * #CloudThermal objects are immutable after creation, so a
+ * #CloudThermalPtr may be used without holding a lock.
+ */
+class ShardedCloudThermalContainer {
+  typedef boost::geometry::index::rtree<CloudThermalPtr, boost::geometry::index::rstar<16>,
+                                        CloudThermalIndexable> Tree;
+
+  typedef boost::intrusive::list<CloudThermal,
+                                 boost::intrusive::constant_time_size<false>> List;
+
+  struct Shard {
+    mutable SharedMutex mutex;
+
+    Tree rtree;
+
+    /**
+     * A linked list of thermals in this tile, sorted by time, with
+     * newer items at the front.
+     */
+    List list;
+
+    ~Shard() {
+      list.clear();
+    }
+
+    void Insert(CloudThermal &thermal) {
+      list.push_front(thermal);
+      rtree.insert(thermal.shared_from_this());
+    }
+
+    void Remove(CloudThermal &thermal) {
+      list.erase(list.iterator_to(thermal));
+      rtree.remove(thermal.shared_from_this());
+    }
+  };
+
+  std::array<Shard, CloudTiles::COUNT> shards;
+
+public:
+  ShardedCloudThermalContainer() = default;
+
+  ShardedCloudThermalContainer(const ShardedCloudThermalContainer &) = delete;
+  ShardedCloudThermalContainer &operator=(const ShardedCloudThermalContainer &) = delete;
+
+  CloudThermalPtr Make(uint64_t client_key,
+                       const AGeoPoint &bottom_location,
+                       const AGeoPoint &top_location,
+                       double lift);
+
+  /**
+   * Invoke f(const CloudThermal &) for each thermal within the given
+   * range.  Each tile is locked (shared) while its thermals are
+   * visited.
+   */
+  template<typename F>
+  void VisitWithinRange(GeoPoint location, double range, F &&f) const {
+    const auto box = BoostRangeBox(location, range);
+    const auto q = boost::geometry::index::intersects(box);
+
+    CloudTiles::VisitBox(box, [this, &q, &f](unsigned index){
+        const Shard &shard = shards[index];
+        const ScopeSharedLock lock(shard.mutex);
+        for (auto i = shard.rtree.qbegin(q), end = shard.rtree.qend();
+             i != end; ++i)
+          f(**i);
+      });
+  }
+
+  /**
+   * Remove all thermals older than the given time.  Each tile is
+   * processed separately.
+   */
+  void Expire(std::chrono::steady_clock::time_point before);
+
+  /**
+   * Serialise all thermals in the #CloudThermalContainer format.
+   * Tiles are locked one at a time.
+   */
+  void Save(Serialiser &s) const;
+
+  /**
+   * Load thermals saved by Save() or by CloudThermalContainer::Save().
+   * This is not thread-safe; call it before starting the workers.
+   */
+  void Load(Deserialiser &s);
+
+  /**
+   * Insert a thermal loaded from the journal, unless an equal one
+   * (same client, location and lift) exists already, e.g. because it
+   * was also saved in the snapshot.  This is not thread-safe; call it
+   * before starting the workers.
+   */
+  void Restore(CloudThermal &&thermal);
+
+private:
+  void Insert(CloudThermalPtr &&thermal);
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_TILE_HPP
+#define XCSOAR_CLOUD_TILE_HPP
+
+#include "Geo/GeoPoint.hpp"
+#include "Geo/Boost/RangeBox.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+
+/**
+ * The cloud server divides the world into tiles of equal angular
+ * size.  Each tile is a shard with its own geographic index and its
+ * own lock.
+ */
+struct CloudTiles {
+  static constexpr unsigned SIZE_DEGREES = 5;
+  static constexpr unsigned N_COLUMNS = 360 / SIZE_DEGREES;
+  static constexpr unsigned N_ROWS = 180 / SIZE_DEGREES;
+  static constexpr unsigned COUNT = N_COLUMNS * N_ROWS;
+
+  gcc_const
+  static unsigned ToColumn(Angle longitude) {
+    int column = int((longitude.Degrees() + 180) / SIZE_DEGREES);
+    return std::min(std::max(column, 0), int(N_COLUMNS) - 1);
+  }
+
+  gcc_const
+  static unsigned ToRow(Angle latitude) {
+    int row = int((latitude.Degrees() + 90) / SIZE_DEGREES);
+    return std::min(std::max(row, 0), int(N_ROWS) - 1);
+  }
+
+  /**
+   * Determine the index of the tile which contains the given
+   * location.
+   */
+  gcc_const
+  static unsigned ToIndex(const GeoPoint &location) {
+    return ToRow(location.latitude) * N_COLUMNS + ToColumn(location.longitude);
+  }
+
+  /**
+   * Invoke f(index) for each tile which intersects the given
+   * BoostRangeBox().  A box which crosses the date line (west > east)
+   * wraps around.
+   */
+  template<typename F>
+  static void VisitBox(const boost::geometry::model::box<GeoPoint> &box,
+                       F &&f) {
+    const unsigned west = ToColumn(box.min_corner().longitude);
+    const unsigned east = ToColumn(box.max_corner().longitude);
+    const unsigned south = ToRow(box.min_corner().latitude);
+    const unsigned north = ToRow(box.max_corner().latitude);
+
+    for (unsigned row = south; row <= north; ++row) {
+      for (unsigned column = west;;
+           column = (column + 1) % N_COLUMNS) {
+        f(row * N_COLUMNS + column);
+        if (column == east)
+          break;
+      }
+    }
+  }
+};
+
+#endif
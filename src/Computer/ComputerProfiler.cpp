@@ -0,0 +1,164 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ComputerProfiler.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+static constexpr const char *stage_names[] = {
+  "air_data",
+  "trace",
+  "task",
+  "route",
+  "warnings",
+  "contest",
+  "statistics",
+  "other",
+};
+
+static_assert(sizeof(stage_names) / sizeof(stage_names[0]) ==
+              ComputerProfiler::N_STAGES, "Wrong number of stage names");
+
+const char *
+ComputerProfiler::GetStageName(Stage stage)
+{
+  return stage_names[unsigned(stage)];
+}
+
+void
+ComputerProfiler::Reset()
+{
+  const ScopeLock protect(mutex);
+
+  for (auto &i : stages) {
+    i.samples.clear();
+    i.count = 0;
+    i.total = 0;
+  }
+}
+
+void
+ComputerProfiler::Add(Stage stage, uint64_t duration_us)
+{
+  const unsigned value = std::min<uint64_t>(duration_us, unsigned(-1));
+
+  const ScopeLock protect(mutex);
+  StageData &data = stages[unsigned(stage)];
+  data.samples.push(value);
+  ++data.count;
+  data.total += duration_us;
+}
+
+void
+ComputerProfiler::Record(Stage stage, uint64_t duration_us)
+{
+  if (cycle_depth == 0) {
+    Add(stage, duration_us);
+    return;
+  }
+
+  cycle_totals[unsigned(stage)] += duration_us;
+  cycle_measured[unsigned(stage)] = true;
+}
+
+void
+ComputerProfiler::BeginCycle()
+{
+  if (cycle_depth++ > 0)
+    return;
+
+  std::fill_n(cycle_totals, N_STAGES, 0);
+  std::fill_n(cycle_measured, N_STAGES, false);
+}
+
+void
+ComputerProfiler::EndCycle()
+{
+  assert(cycle_depth > 0);
+
+  if (--cycle_depth > 0)
+    return;
+
+  for (unsigned i = 0; i < N_STAGES; ++i)
+    if (cycle_measured[i])
+      Add(Stage(i), cycle_totals[i]);
+}
+
+ComputerProfiler::Summary
+ComputerProfiler::GetSummary(Stage stage) const
+{
+  unsigned values[WINDOW];
+  unsigned n = 0;
+
+  Summary summary;
+
+  {
+    const ScopeLock protect(mutex);
+    const StageData &data = stages[unsigned(stage)];
+    for (const unsigned value : data.samples)
+      values[n++] = value;
+
+    summary.count = data.count;
+    summary.total = data.total;
+  }
+
+  summary.window = n;
+
+  if (n == 0) {
+    summary.min = summary.average = summary.p99 = summary.max = 0;
+    return summary;
+  }
+
+  uint64_t total = 0;
+  for (unsigned i = 0; i < n; ++i)
+    total += values[i];
+  summary.average = total / n;
+
+  const auto minmax = std::minmax_element(values, values + n);
+  summary.min = *minmax.first;
+  summary.max = *minmax.second;
+
+  unsigned *p99 = values + (n * 99) / 100;
+  std::nth_element(values, p99, values + n);
+  summary.p99 = *p99;
+
+  return summary;
+}
+
+void
+ComputerProfiler::Dump(FILE *file) const
+{
+  fprintf(file, "%-12s %8s %8s %8s %8s %8s %10s\n",
+          "stage", "count", "min", "avg", "p99", "max", "total_ms");
+
+  for (unsigned i = 0; i < N_STAGES; ++i) {
+    const Stage stage = Stage(i);
+    const Summary s = GetSummary(stage);
+    fprintf(file, "%-12s %8lu %8u %8u %8u %8u %10lu\n",
+            GetStageName(stage), s.count,
+            s.min, s.average, s.p99, s.max,
+            (unsigned long)(s.total / 1000));
+  }
+}
@@ -0,0 +1,221 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_COMPUTER_PROFILER_HPP
+#define XCSOAR_COMPUTER_PROFILER_HPP
+
+#include "Thread/Mutex.hpp"
+#include "Util/OverwritingRingBuffer.hpp"
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <atomic>
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Measures how long the sub-computers of the #GlideComputer take.
+ * It keeps the most recent durations of each stage in a ring buffer
+ * and calculates minimum, average and 99th percentile on request.
+ *
+ * Profiling is disabled by default; while disabled, a #Scope costs
+ * only one atomic load.
+ */
+class ComputerProfiler {
+public:
+  enum class Stage : uint8_t {
+    AIR_DATA,
+    TRACE,
+    TASK,
+    ROUTE,
+    WARNINGS,
+    CONTEST,
+    STATISTICS,
+    OTHER,
+    COUNT
+  };
+
+  static constexpr unsigned N_STAGES = unsigned(Stage::COUNT);
+
+  /**
+   * The number of recent samples per stage used for the summary.
+   */
+  static constexpr unsigned WINDOW = 256;
+
+  /**
+   * A summary of the recent durations of one stage, in microseconds.
+   */
+  struct Summary {
+    /**
+     * The total number of samples since the last Reset().
+     */
+    unsigned long count;
+
+    /**
+     * The sum of all samples since the last Reset().
+     */
+    uint64_t total;
+
+    /**
+     * The number of samples in the window.
+     */
+    unsigned window;
+
+    unsigned min, average, p99, max;
+  };
+
+  /**
+   * Measures the duration of a scope, if profiling is enabled.
+   */
+  class Scope {
+    ComputerProfiler &profiler;
+    const Stage stage;
+    const bool enabled;
+    uint64_t start;
+
+  public:
+    Scope(ComputerProfiler &_profiler, Stage _stage)
+      :profiler(_profiler), stage(_stage),
+       enabled(profiler.IsEnabled()) {
+      if (enabled)
+        start = MonotonicClockUS();
+    }
+
+    ~Scope() {
+      if (enabled)
+        profiler.Record(stage, MonotonicClockUS() - start);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+  };
+
+  /**
+   * One calculation cycle (e.g. GlideComputer::ProcessGPS()).  A stage
+   * may be measured by several #Scope instances during the cycle;
+   * their durations are summed up, and one sample per stage is
+   * recorded when the cycle ends.  Without a #Cycle, each #Scope
+   * records its own sample.
+   *
+   * The cycle and its scopes must run in the same thread.
+   */
+  class Cycle {
+    ComputerProfiler &profiler;
+
+  public:
+    explicit Cycle(ComputerProfiler &_profiler):profiler(_profiler) {
+      profiler.BeginCycle();
+    }
+
+    ~Cycle() {
+      profiler.EndCycle();
+    }
+
+    Cycle(const Cycle &) = delete;
+    Cycle &operator=(const Cycle &) = delete;
+  };
+
+private:
+  std::atomic<bool> enabled;
+
+  mutable Mutex mutex;
+
+  struct StageData {
+    /* one more than WINDOW, because the ring buffer leaves one
+       element unused */
+    OverwritingRingBuffer<unsigned, WINDOW + 1> samples;
+
+    unsigned long count;
+    uint64_t total;
+
+    StageData():count(0), total(0) {}
+  };
+
+  StageData stages[N_STAGES];
+
+  /**
+   * The nesting level of #Cycle instances.  Only the outermost one
+   * records samples.
+   */
+  unsigned cycle_depth;
+
+  /**
+   * The summed durations of the current cycle; not protected by
+   * #mutex, because only the thread which runs the cycle uses them.
+   */
+  uint64_t cycle_totals[N_STAGES];
+  bool cycle_measured[N_STAGES];
+
+public:
+  ComputerProfiler():enabled(false), cycle_depth(0) {}
+
+  ComputerProfiler(const ComputerProfiler &) = delete;
+  ComputerProfiler &operator=(const ComputerProfiler &) = delete;
+
+  bool IsEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  void SetEnabled(bool _enabled) {
+    enabled.store(_enabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * Discard all samples.
+   */
+  void Reset();
+
+  /**
+   * Record one sample.
+   */
+  void Add(Stage stage, uint64_t duration_us);
+
+private:
+  /**
+   * Record the duration of a #Scope: add it to the current cycle, or
+   * record it as a sample if there is no cycle.
+   */
+  void Record(Stage stage, uint64_t duration_us);
+
+  void BeginCycle();
+  void EndCycle();
+
+public:
+
+  gcc_pure
+  Summary GetSummary(Stage stage) const;
+
+  /**
+   * Returns a short ASCII identifier of the stage.
+   */
+  gcc_const
+  static const char *GetStageName(Stage stage);
+
+  /**
+   * Print a table of all stages.
+   */
+  void Dump(FILE *file) const;
+};
+
+#endif
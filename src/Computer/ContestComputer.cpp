@@ -24,12 +24,36 @@ Copyright_License {
 #include "ContestComputer.hpp"
 #include "Engine/Contest/Settings.hpp"
 
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#endif
+
+/**
+ * Is it worth solving independent contest solvers concurrently?  On
+ * single-core devices, the extra thread would only add overhead.
+ */
+static bool
+IsMultiCore()
+{
+#if defined(HAVE_POSIX) && defined(_SC_NPROCESSORS_ONLN)
+  return sysconf(_SC_NPROCESSORS_ONLN) > 1;
+#else
+  return false;
+#endif
+}
+
 ContestComputer::ContestComputer(const Trace &trace_full,
                                  const Trace &trace_triangle,
                                  const Trace &trace_sprint)
   :contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle, trace_sprint, true)
 {
   contest_manager.SetIncremental(true);
+  contest_manager.SetParallel(IsMultiCore());
+
+  /* the incremental triangle search resumes where it was suspended,
+     so a time limit only delays the result; it keeps one idle call
+     from blocking the calculation thread on slow devices */
+  contest_manager.SetTickBudget(0, std::chrono::milliseconds(200));
 }
 
 void
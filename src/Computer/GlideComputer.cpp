@@ -37,7 +37,8 @@ GlideComputer::GlideComputer(const ComputerSettings &_settings,
                              GlideComputerTaskEvents& events)
   :air_data_computer(_way_points),
    warning_computer(_settings.airspace.warnings, _airspace_database),
-   task_computer(task, _airspace_database, &warning_computer.GetManager()),
+   task_computer(task, _airspace_database, &warning_computer.GetManager(),
+                 profiler),
    waypoints(_way_points),
    retrospective(_way_points),
    team_code_ref_id(-1)
@@ -72,6 +73,9 @@ GlideComputer::Initialise()
 bool
 GlideComputer::ProcessGPS(bool force)
 {
+  /* several scopes measure the same stage; record their sum */
+  const ComputerProfiler::Cycle cycle(profiler);
+
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
   const ComputerSettings &settings = GetComputerSettings();
@@ -96,8 +100,12 @@ GlideComputer::ProcessGPS(bool force)
   calculated.Expire(basic.clock);
 
   // Process basic information
-  air_data_computer.ProcessBasic(Basic(), SetCalculated(),
-                                 settings);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::AIR_DATA);
+    air_data_computer.ProcessBasic(Basic(), SetCalculated(),
+                                   settings);
+  }
 
   // Process basic task information
   const bool last_finished = calculated.ordered_task_stats.task_finished;
@@ -114,20 +122,41 @@ GlideComputer::ProcessGPS(bool force)
   if (!last_finished && calculated.ordered_task_stats.task_finished)
     OnFinishTask();
 
-  // Check if everything is okay with the gps time and process it
-  air_data_computer.FlightTimes(Basic(), SetCalculated(),
-                                settings);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::AIR_DATA);
 
-  TakeoffLanding(last_flying);
+    // Check if everything is okay with the gps time and process it
+    air_data_computer.FlightTimes(Basic(), SetCalculated(),
+                                  settings);
 
-  task_computer.ProcessAutoTask(basic, calculated);
+    TakeoffLanding(last_flying);
+  }
 
-  // Process extended information
-  air_data_computer.ProcessVertical(Basic(),
-                                    SetCalculated(),
-                                    settings);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::TASK);
+    task_computer.ProcessAutoTask(basic, calculated);
+  }
 
-  stats_computer.ProcessClimbEvents(calculated);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::AIR_DATA);
+
+    // Process extended information
+    air_data_computer.ProcessVertical(Basic(),
+                                      SetCalculated(),
+                                      settings);
+  }
+
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::STATISTICS);
+    stats_computer.ProcessClimbEvents(calculated);
+  }
+
+  const ComputerProfiler::Scope scope(profiler,
+                                      ComputerProfiler::Stage::OTHER);
 
   cu_computer.Compute(basic, calculated, settings);
 
@@ -158,19 +187,30 @@ GlideComputer::ProcessGPS(bool force)
 void
 GlideComputer::ProcessIdle(bool exhaustive)
 {
+  const ComputerProfiler::Cycle cycle(profiler);
+
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
 
-  // Log GPS fixes for internal usage
-  // (snail trail, stats, olc, ...)
-  stats_computer.DoLogging(basic, calculated);
-  log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::STATISTICS);
+
+    // Log GPS fixes for internal usage
+    // (snail trail, stats, olc, ...)
+    stats_computer.DoLogging(basic, calculated);
+    log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  }
 
   task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
                             exhaustive);
 
-  warning_computer.Update(GetComputerSettings(), basic,
-                          calculated, calculated.airspace_warnings);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::WARNINGS);
+    warning_computer.Update(GetComputerSettings(), basic,
+                            calculated, calculated.airspace_warnings);
+  }
 
   // Calculate summary of flight
   if (basic.location_available)
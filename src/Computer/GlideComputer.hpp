@@ -33,6 +33,7 @@ Copyright_License {
 #include "LogComputer.hpp"
 #include "WarningComputer.hpp"
 #include "CuComputer.hpp"
+#include "ComputerProfiler.hpp"
 #include "Compiler.h"
 #include "Engine/Contest/Solvers/Retrospective.hpp"
 
@@ -47,6 +48,8 @@ class RasterTerrain;
 
 class GlideComputer : public GlideComputerBlackboard
 {
+  ComputerProfiler profiler;
+
   GlideComputerAirData air_data_computer;
   WarningComputer warning_computer;
   TaskComputer task_computer;
@@ -78,6 +81,14 @@ public:
 
   void SetTerrain(RasterTerrain *_terrain);
 
+  ComputerProfiler &GetProfiler() {
+    return profiler;
+  }
+
+  const ComputerProfiler &GetProfiler() const {
+    return profiler;
+  }
+
   void SetLogger(Logger *logger) {
     log_computer.SetLogger(logger);
   }
@@ -31,11 +31,33 @@ Copyright_License {
 
 #include <algorithm>
 
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#endif
+
+/**
+ * How many threads shall help expanding the reach fans?  The fans of
+ * one level rarely number more than a few dozen, so more than three
+ * helpers don't pay off.
+ */
+static unsigned
+GetReachWorkerCount()
+{
+#if defined(HAVE_POSIX) && defined(_SC_NPROCESSORS_ONLN)
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 1 ? std::min<unsigned>(n - 1, 3) : 0;
+#else
+  return 0;
+#endif
+}
+
 RouteComputer::RouteComputer(const Airspaces &airspace_database,
                              const ProtectedAirspaceWarningManager *warnings)
   :protected_route_planner(route_planner, airspace_database, warnings),
    terrain(NULL)
-{}
+{
+  route_planner.SetParallel(GetReachWorkerCount());
+}
 
 void
 RouteComputer::ResetFlight()
@@ -30,6 +30,7 @@ Copyright_License {
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 #include "Settings.hpp"
+#include "ComputerProfiler.hpp"
 
 #include <algorithm>
 
@@ -40,8 +41,9 @@ using std::max;
 
 TaskComputer::TaskComputer(ProtectedTaskManager &_task,
                            const Airspaces &airspace_database,
-                           const ProtectedAirspaceWarningManager *warnings)
-  :task(_task),
+                           const ProtectedAirspaceWarningManager *warnings,
+                           ComputerProfiler &_profiler)
+  :task(_task), profiler(_profiler),
    route(airspace_database, warnings),
    contest(trace.GetFull(), trace.GetContest(), trace.GetSprint())
 {
@@ -68,7 +70,14 @@ TaskComputer::ProcessBasicTask(const MoreData &basic,
                                const ComputerSettings &settings_computer,
                                bool force)
 {
-  trace.Update(settings_computer, basic, calculated);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::TRACE);
+    trace.Update(settings_computer, basic, calculated);
+  }
+
+  const ComputerProfiler::Scope scope(profiler,
+                                      ComputerProfiler::Stage::TASK);
 
   ProtectedTaskManager::ExclusiveLease _task(task);
 
@@ -109,10 +118,14 @@ TaskComputer::ProcessMoreTask(const MoreData &basic,
   const GlidePolar &glide_polar = settings_computer.polar.glide_polar_task;
   const GlidePolar &safety_polar = calculated.glide_polar_safety;
 
-  route.ProcessRoute(basic, calculated,
-                     settings_computer.task.glide,
-                     settings_computer.task.route_planner,
-                     glide_polar, safety_polar);
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::ROUTE);
+    route.ProcessRoute(basic, calculated,
+                       settings_computer.task.glide,
+                       settings_computer.task.route_planner,
+                       glide_polar, safety_polar);
+  }
 
   if (settings_computer.features.block_stf_enabled)
     calculated.V_stf = calculated.common_stats.V_block;
@@ -150,14 +163,22 @@ TaskComputer::ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
                           const ComputerSettings &settings_computer,
                           bool exhaustive)
 {
-  contest.SetPredicted(Predicted(settings_computer.contest, basic,
-                                 calculated.task_stats.current_leg));
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::CONTEST);
+
+    contest.SetPredicted(Predicted(settings_computer.contest, basic,
+                                   calculated.task_stats.current_leg));
+
+    if (exhaustive)
+      contest.SolveExhaustive(settings_computer.contest,
+                              calculated.contest_stats);
+    else
+      contest.Solve(settings_computer.contest, calculated.contest_stats);
+  }
 
-  if (exhaustive)
-    contest.SolveExhaustive(settings_computer.contest,
-                            calculated.contest_stats);
-  else
-    contest.Solve(settings_computer.contest, calculated.contest_stats);
+  const ComputerProfiler::Scope scope(profiler,
+                                      ComputerProfiler::Stage::TASK);
 
   const AircraftState as = ToAircraftState(basic, calculated);
 
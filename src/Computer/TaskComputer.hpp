@@ -33,11 +33,14 @@ Copyright_License {
 struct NMEAInfo;
 class ProtectedTaskManager;
 class ProtectedAirspaceWarningManager;
+class ComputerProfiler;
 
 class TaskComputer
 {
   ProtectedTaskManager &task;
 
+  ComputerProfiler &profiler;
+
   RouteComputer route;
 
   TraceComputer trace;
@@ -54,7 +57,8 @@ class TaskComputer
 public:
   TaskComputer(ProtectedTaskManager &_task,
                const Airspaces &airspace_database,
-               const ProtectedAirspaceWarningManager *warnings);
+               const ProtectedAirspaceWarningManager *warnings,
+               ComputerProfiler &_profiler);
 
   const ProtectedTaskManager &GetProtectedTaskManager() const {
     return task;
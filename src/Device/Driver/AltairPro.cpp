@@ -118,26 +118,27 @@ PTFRS(NMEAInputLine &line, NMEAInfo &info)
 bool
 AltairProDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
   // no propriatary sentence
 
-  if (StringIsEqual(type, "$PGRMZ")) {
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$PGRMZ"): {
     double value;
     if (ReadAltitude(line, value))
       info.ProvidePressureAltitude(value);
 
     return true;
-  } else if (StringIsEqual(type, "$PTFRS")) {
-    return PTFRS(line, info);
   }
 
-  return false;
+  case NMEASentenceHash("$PTFRS"):
+    return PTFRS(line, info);
+
+  default:
+    return false;
+  }
 }
 
 bool
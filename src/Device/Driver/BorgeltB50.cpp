@@ -122,14 +122,11 @@ PBB50(NMEAInputLine &line, NMEAInfo &info)
 bool
 B50Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PBB50"))
+  if (line.ReadSentenceHash() == NMEASentenceHash("$PBB50"))
     return PBB50(line, info);
   else
     return false;
@@ -144,21 +144,21 @@ cai_w(NMEAInputLine &line, NMEAInfo &info)
 bool
 CAI302Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PCAIB"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$PCAIB"):
     return cai_PCAIB(line, info);
 
-  if (StringIsEqual(type, "$PCAID"))
+  case NMEASentenceHash("$PCAID"):
     return cai_PCAID(line, info);
 
-  if (StringIsEqual(type, "!w"))
+  case NMEASentenceHash("!w"):
     return cai_w(line, info);
 
-  return false;
+  default:
+    return false;
+  }
 }
@@ -124,12 +124,10 @@ bool
 CProbeDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
-
-  if (!StringIsEqual(type, "$PCPROBE"))
+  if (line.ReadSentenceHash() != NMEASentenceHash("$PCPROBE"))
     return false;
 
+  char type[16];
   line.Read(type, 16);
   if (StringIsEqual(type, "T"))
     return ParseData(line, info);
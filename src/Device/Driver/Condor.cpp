@@ -99,14 +99,11 @@ cLXWP0(NMEAInputLine &line, NMEAInfo &info)
 bool
 CondorDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$LXWP0"))
+  if (line.ReadSentenceHash() == NMEASentenceHash("$LXWP0"))
     return cLXWP0(line, info);
 
   return false;
@@ -46,19 +46,20 @@ protected:
 bool
 EyeDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PEYA"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$PEYA"):
     return PEYA(line, info);
-  else if (StringIsEqual(type, "$PEYI"))
+
+  case NMEASentenceHash("$PEYI"):
     return PEYI(line, info);
-  else
+
+  default:
     return false;
+  }
 }
 
 bool
@@ -55,14 +55,11 @@ FlarmDevice::ParsePFLAC(NMEAInputLine &line)
 bool
 FlarmDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PFLAC"))
+  if (line.ReadSentenceHash() == NMEASentenceHash("$PFLAC"))
     return ParsePFLAC(line);
   else
     return false;
@@ -88,14 +88,11 @@ VARIO(NMEAInputLine &line, NMEAInfo &info)
 bool
 FlymasterF1Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$VARIO"))
+  if (line.ReadSentenceHash() == NMEASentenceHash("$VARIO"))
     return VARIO(line, info);
   else
     return false;
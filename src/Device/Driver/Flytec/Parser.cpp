@@ -246,19 +246,21 @@ FlytecDevice::ParseFLYSEN(NMEAInputLine &line, NMEAInfo &info)
 bool
 FlytecDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$BRSF"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$BRSF"):
     return FlytecParseBRSF(line, info);
-  else if (StringIsEqual(type, "$VMVABD"))
+
+  case NMEASentenceHash("$VMVABD"):
     return FlytecParseVMVABD(line, info);
-  else if (StringIsEqual(type, "$FLYSEN"))
+
+  case NMEASentenceHash("$FLYSEN"):
     return ParseFLYSEN(line, info);
-  else
+
+  default:
     return false;
+  }
 }
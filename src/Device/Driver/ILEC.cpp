@@ -83,14 +83,12 @@ ParsePDA1(NMEAInputLine &line, NMEAInfo &info)
 bool
 ILECDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, sizeof(type));
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PILC")) {
+  if (line.ReadSentenceHash() == NMEASentenceHash("$PILC")) {
+    char type[16];
     line.Read(type, sizeof(type));
     if (StringIsEqual(type, "PDA1"))
       return ParsePDA1(line, info);
@@ -66,14 +66,11 @@ ReadAltitude(NMEAInputLine &line, double &value_r)
 bool
 IMIDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PGRMZ")) {
+  if (line.ReadSentenceHash() == NMEASentenceHash("$PGRMZ")) {
     double value;
 
     /* The normal Garmin $PGRMZ line contains the "true" barometric
@@ -204,22 +204,23 @@ bool
 LeonardoDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
 
-  if (StringIsEqual(type, "$C") ||
-      StringIsEqual(type, "$c"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$C"):
+  case NMEASentenceHash("$c"):
     return LeonardoParseC(line, info);
 
-  else if (StringIsEqual(type, "$D") ||
-           StringIsEqual(type, "$d"))
+  case NMEASentenceHash("$D"):
+  case NMEASentenceHash("$d"):
     return LeonardoParseD(line, info);
 
-  else if (StringIsEqual(type, "$PDGFTL1") ||
-           StringIsEqual(type, "$PDGFTTL"))
+  case NMEASentenceHash("$PDGFTL1"):
+  case NMEASentenceHash("$PDGFTTL"):
     return PDGFTL1(line, info);
 
-  return false;
+  default:
+    return false;
+  }
 }
 
 static Device *
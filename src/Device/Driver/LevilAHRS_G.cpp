@@ -136,18 +136,19 @@ bool
 LevilDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
 
   if (error_reported) return false;
 
-  if (StringIsEqual(type, "$RPYL"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$RPYL"):
     return ParseRPYL(line, info);
 
-  if (StringIsEqual(type, "$APENV1"))
+  case NMEASentenceHash("$APENV1"):
     return ParseAPENV1(line, info);
 
-  return false;
+  default:
+    return false;
+  }
 }
 
 static Device *
@@ -156,21 +156,23 @@ VaulterDevice::PutBallast(double fraction, double overload, OperationEnvironment
 bool
 VaulterDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
-
   NMEAInputLine line(_line);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PITV3"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$PITV3"):
     return ParsePITV3(line, info);
-  else if (StringIsEqual(type, "$PITV4"))
+
+  case NMEASentenceHash("$PITV4"):
     return ParsePITV4(line, info);
-  else if (StringIsEqual(type, "$PITV5"))
+
+  case NMEASentenceHash("$PITV5"):
     return ParsePITV5(line, info);
-  else
+
+  default:
     return false;
+  }
 }
 
 static Device *
@@ -218,32 +218,42 @@ bool
 VegaDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  const StringView type = line.ReadView();
 
-  if (memcmp(type, "$PD", 3) == 0)
+  if (type.StartsWith("$PD"))
     detected = true;
 
-  if (StringIsEqual(type, "$PDSWC"))
+  switch (NMEASentenceHash(type)) {
+  case NMEASentenceHash("$PDSWC"):
     return PDSWC(line, info, volatile_data);
-  else if (StringIsEqual(type, "$PDAAV"))
+
+  case NMEASentenceHash("$PDAAV"):
     return PDAAV(line, info);
-  else if (StringIsEqual(type, "$PDVSC"))
+
+  case NMEASentenceHash("$PDVSC"):
     return PDVSC(line, info);
-  else if (StringIsEqual(type, "$PDVDV"))
+
+  case NMEASentenceHash("$PDVDV"):
     return PDVDV(line, info);
-  else if (StringIsEqual(type, "$PDVDS"))
+
+  case NMEASentenceHash("$PDVDS"):
     return PDVDS(line, info);
-  else if (StringIsEqual(type, "$PDVVT"))
+
+  case NMEASentenceHash("$PDVVT"):
     return PDVVT(line, info);
-  else if (StringIsEqual(type, "$PDVSD")) {
+
+  case NMEASentenceHash("$PDVSD"): {
     const auto message = line.Rest();
     StaticString<256> buffer;
     buffer.SetASCII(message.begin(), message.end());
     Message::AddMessage(buffer);
     return true;
-  } else if (StringIsEqual(type, "$PDTSM"))
+  }
+
+  case NMEASentenceHash("$PDTSM"):
     return PDTSM(line, info);
-  else
+
+  default:
     return false;
+  }
 }
@@ -62,14 +62,11 @@ vl_PGCS1(NMEAInputLine &line, NMEAInfo &info)
 bool
 VolksloggerDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PGCS"))
+  if (line.ReadSentenceHash() == NMEASentenceHash("$PGCS"))
     return vl_PGCS1(line, info);
   else
     return false;
@@ -137,20 +137,20 @@ PWES1(NMEAInputLine &line, NMEAInfo &info)
 bool
 WesterboerDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PWES0"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$PWES0"):
     return PWES0(line, info);
 
-  if (StringIsEqual(type, "$PWES1"))
+  case NMEASentenceHash("$PWES1"):
     return PWES1(line, info);
 
-  return false;
+  default:
+    return false;
+  }
 }
 
 bool
@@ -262,18 +262,18 @@ XCTracerDevice::XCTRC(NMEAInputLine &line, NMEAInfo &info)
 bool
 XCTracerDevice::ParseNMEA(const char *string, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(string))
-    return false;
-
   NMEAInputLine line(string);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$LXWP0"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$LXWP0"):
     return LXWP0(line, info);
 
-  if (StringIsEqual(type, "$XCTRC"))
+  case NMEASentenceHash("$XCTRC"):
     return XCTRC(line, info);
 
-  return false;
+  default:
+    return false;
+  }
 }
@@ -128,29 +128,29 @@ PZAN5(NMEAInputLine &line, NMEAInfo &info)
 bool
 ZanderDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
-
   NMEAInputLine line(String);
-  char type[16];
-  line.Read(type, 16);
+  if (!line.HasValidChecksum())
+    return false;
 
-  if (StringIsEqual(type, "$PZAN1"))
+  switch (line.ReadSentenceHash()) {
+  case NMEASentenceHash("$PZAN1"):
     return PZAN1(line, info);
 
-  if (StringIsEqual(type, "$PZAN2"))
+  case NMEASentenceHash("$PZAN2"):
     return PZAN2(line, info);
 
-  if (StringIsEqual(type, "$PZAN3"))
+  case NMEASentenceHash("$PZAN3"):
     return PZAN3(line, info);
 
-  if (StringIsEqual(type, "$PZAN4"))
+  case NMEASentenceHash("$PZAN4"):
     return PZAN4(line, info);
 
-  if (StringIsEqual(type, "$PZAN5"))
+  case NMEASentenceHash("$PZAN5"):
     return PZAN5(line, info);
 
-  return false;
+  default:
+    return false;
+  }
 }
 
 static Device *
@@ -26,7 +26,6 @@ Copyright_License {
 #include "Device/Parser.hpp"
 #include "Geo/Geoid.hpp"
 #include "NMEA/Info.hpp"
-#include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
 #include "Units/System.hpp"
 #include "Driver/FLARM/StaticParser.hpp"
@@ -53,66 +52,62 @@ NMEAParser::ParseLine(const char *string, NMEAInfo &info)
   if (string[0] != '$')
     return false;
 
-  if (!NMEAChecksum(string))
-    return false;
-
   NMEAInputLine line(string);
+  if (!line.HasValidChecksum())
+    return false;
 
-  char type[16];
-  line.Read(type, 16);
+  const StringView type = line.ReadView();
 
-  if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2])) {
-    if (StringIsEqual(type + 3, "GSA"))
+  if (type.size == 6 && IsAlphaASCII(type.data[1]) &&
+      IsAlphaASCII(type.data[2])) {
+    /* skip the talker id */
+    switch (NMEASentenceHash(type.data + 3, 3)) {
+    case NMEASentenceHash("GSA"):
       return GSA(line, info);
 
-    if (StringIsEqual(type + 3, "GLL"))
+    case NMEASentenceHash("GLL"):
       return GLL(line, info);
 
-    if (StringIsEqual(type + 3, "RMC"))
+    case NMEASentenceHash("RMC"):
       return RMC(line, info);
 
-    if (StringIsEqual(type + 3, "GGA"))
+    case NMEASentenceHash("GGA"):
       return GGA(line, info);
 
-    if (StringIsEqual(type + 3, "HDM"))
+    case NMEASentenceHash("HDM"):
       return HDM(line, info);
 
-    if (StringIsEqual(type + 3, "MWV"))
+    case NMEASentenceHash("MWV"):
       return MWV(line, info);
+    }
   }
 
   // if (proprietary sentence) ...
-  if (type[1] == 'P') {
+  switch (NMEASentenceHash(type)) {
     // Airspeed and vario sentence
-    if (StringIsEqual(type + 1, "PTAS1"))
-      return PTAS1(line, info);
+  case NMEASentenceHash("$PTAS1"):
+    return PTAS1(line, info);
 
     // FLARM sentences
-    if (StringIsEqual(type + 1, "PFLAE")) {
-      ParsePFLAE(line, info.flarm.error, info.clock);
-      return true;
-    }
+  case NMEASentenceHash("$PFLAE"):
+    ParsePFLAE(line, info.flarm.error, info.clock);
+    return true;
 
-    if (StringIsEqual(type + 1, "PFLAV")) {
-      ParsePFLAV(line, info.flarm.version, info.clock);
-      return true;
-    }
+  case NMEASentenceHash("$PFLAV"):
+    ParsePFLAV(line, info.flarm.version, info.clock);
+    return true;
 
-    if (StringIsEqual(type + 1, "PFLAA")) {
-      ParsePFLAA(line, info.flarm.traffic, info.clock);
-      return true;
-    }
+  case NMEASentenceHash("$PFLAA"):
+    ParsePFLAA(line, info.flarm.traffic, info.clock);
+    return true;
 
-    if (StringIsEqual(type + 1, "PFLAU")) {
-      ParsePFLAU(line, info.flarm.status, info.clock);
-      return true;
-    }
+  case NMEASentenceHash("$PFLAU"):
+    ParsePFLAU(line, info.flarm.status, info.clock);
+    return true;
 
     // Garmin altitude sentence
-    if (StringIsEqual(type + 1, "PGRMZ"))
-      return RMZ(line, info);
-
-    return false;
+  case NMEASentenceHash("$PGRMZ"):
+    return RMZ(line, info);
   }
 
   return false;
@@ -689,12 +684,6 @@ NMEAParser::RMZ(NMEAInputLine &line, NMEAInfo &info)
   return true;
 }
 
-bool
-NMEAParser::NMEAChecksum(const char *string)
-{
-  return VerifyNMEAChecksum(string);
-}
-
 bool
 NMEAParser::PTAS1(NMEAInputLine &line, NMEAInfo &info)
 {
@@ -0,0 +1,105 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TimingStatusPanel.hpp"
+#include "Computer/ComputerProfiler.hpp"
+#include "Interface.hpp"
+#include "Language/Language.hpp"
+#include "Util/StaticString.hxx"
+
+enum Controls {
+  ENABLED,
+  FIRST_STAGE,
+};
+
+void
+TimingStatusPanel::Refresh()
+{
+  StaticString<64> buffer;
+
+  for (unsigned i = 0; i < ComputerProfiler::N_STAGES; ++i) {
+    const auto summary =
+      profiler.GetSummary(ComputerProfiler::Stage(i));
+    if (summary.window == 0) {
+      ClearText(FIRST_STAGE + i);
+      continue;
+    }
+
+    /* min / average / 99th percentile in microseconds */
+    buffer.Format(_T("%u / %u / %u us"),
+                  summary.min, summary.average, summary.p99);
+    SetText(FIRST_STAGE + i, buffer);
+  }
+}
+
+void
+TimingStatusPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
+{
+  AddBoolean(_("Enabled"),
+             _("Measure how long each part of the glide computer takes.  "
+               "Shown are minimum, average and 99th percentile."),
+             profiler.IsEnabled(), this);
+
+  AddReadOnly(_("Air data"));
+  AddReadOnly(_("Trace"));
+  AddReadOnly(_("Task"));
+  AddReadOnly(_("Route"));
+  AddReadOnly(_("Airspace warnings"));
+  AddReadOnly(_("Contest"));
+  AddReadOnly(_("Statistics"));
+  AddReadOnly(_("Other"));
+}
+
+void
+TimingStatusPanel::Show(const PixelRect &rc)
+{
+  Refresh();
+  CommonInterface::GetLiveBlackboard().AddListener(rate_limiter);
+  StatusPanel::Show(rc);
+}
+
+void
+TimingStatusPanel::Hide()
+{
+  StatusPanel::Hide();
+  CommonInterface::GetLiveBlackboard().RemoveListener(rate_limiter);
+  rate_limiter.Cancel();
+}
+
+void
+TimingStatusPanel::OnModified(DataField &df)
+{
+  if (IsDataField(ENABLED, df)) {
+    const bool enabled = GetValueBoolean(ENABLED);
+    if (enabled && !profiler.IsEnabled())
+      profiler.Reset();
+    profiler.SetEnabled(enabled);
+  }
+}
+
+void
+TimingStatusPanel::OnCalculatedUpdate(const MoreData &basic,
+                                      const DerivedInfo &calculated)
+{
+  Refresh();
+}
@@ -0,0 +1,79 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TopographyStatusPanel.hpp"
+#include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyFile.hpp"
+#include "Formatter/ByteSizeFormatter.hpp"
+#include "Interface.hpp"
+#include "Util/StaticString.hxx"
+#include "Util/Macros.hpp"
+
+void
+TopographyStatusPanel::Refresh()
+{
+  StaticString<64> buffer;
+  TCHAR allocated[32], used[32];
+
+  for (unsigned i = 0; i < store.size(); ++i) {
+    const TopographyFile &file = store[i];
+
+    /* memory obtained from the heap / memory used by the loaded
+       shapes */
+    FormatByteSize(allocated, ARRAY_SIZE(allocated),
+                   file.GetMemoryUsage(), true);
+    FormatByteSize(used, ARRAY_SIZE(used), file.GetUsedMemory(), true);
+    buffer.Format(_T("%s / %s"), allocated, used);
+    SetText(i, buffer);
+  }
+}
+
+void
+TopographyStatusPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
+{
+  for (unsigned i = 0; i < store.size(); ++i)
+    AddReadOnly(store[i].GetName());
+}
+
+void
+TopographyStatusPanel::Show(const PixelRect &rc)
+{
+  Refresh();
+  CommonInterface::GetLiveBlackboard().AddListener(rate_limiter);
+  StatusPanel::Show(rc);
+}
+
+void
+TopographyStatusPanel::Hide()
+{
+  StatusPanel::Hide();
+  CommonInterface::GetLiveBlackboard().RemoveListener(rate_limiter);
+  rate_limiter.Cancel();
+}
+
+void
+TopographyStatusPanel::OnCalculatedUpdate(const MoreData &basic,
+                                          const DerivedInfo &calculated)
+{
+  Refresh();
+}
@@ -33,6 +33,10 @@ Copyright_License {
 #include "StatusPanels/RulesStatusPanel.hpp"
 #include "StatusPanels/SystemStatusPanel.hpp"
 #include "StatusPanels/TimesStatusPanel.hpp"
+#include "StatusPanels/TimingStatusPanel.hpp"
+#include "StatusPanels/TopographyStatusPanel.hpp"
+#include "Topography/TopographyStore.hpp"
+#include "Computer/GlideComputer.hpp"
 #include "Components.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Interface.hpp"
@@ -100,6 +104,17 @@ dlgStatusShowModal(int start_page)
   Widget *times_panel = new TimesStatusPanel(look);
   widget.AddTab(times_panel, _("Times"), TimesIcon);
 
+  if (glide_computer != nullptr) {
+    Widget *timing_panel =
+      new TimingStatusPanel(look, glide_computer->GetProfiler());
+    widget.AddTab(timing_panel, _("Timing"));
+  }
+
+  if (topography != nullptr && topography->size() > 0) {
+    Widget *topography_panel = new TopographyStatusPanel(look, *topography);
+    widget.AddTab(topography_panel, _("Topography"));
+  }
+
   /* restore previous page */
 
   if (start_page != -1) {
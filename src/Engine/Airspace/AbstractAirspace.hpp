@@ -239,6 +239,10 @@ public:
     days_of_operation = mask;
   }
 
+  const AirspaceActivity &GetDays() const {
+    return days_of_operation;
+  }
+
   /**
    * Get type of airspace
    *
@@ -372,7 +376,7 @@ public:
 
 protected:
   /** Project border */
-  void Project(const FlatProjection &tp);
+  virtual void Project(const FlatProjection &tp);
 
 private:
   /**
@@ -79,9 +79,19 @@ AirspacePolygon::GetCenter() const
   return GeoPoint(Angle::Native(lon), Angle::Native(lat));
 }
 
+void
+AirspacePolygon::Project(const FlatProjection &tp)
+{
+  AbstractAirspace::Project(tp);
+  index.Build(m_border, tp);
+}
+
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const
 {
+  if (index.IsDefined())
+    return index.IsInside(loc, m_border);
+
   return m_border.IsInside(loc);
 }
 
@@ -89,17 +99,28 @@ AirspaceIntersectionVector
 AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
                             const FlatProjection &projection) const
 {
-  const FlatRay ray(projection.ProjectInteger(start),
-                    projection.ProjectInteger(end));
+  const FlatGeoPoint flat_start = projection.ProjectInteger(start);
+  const FlatGeoPoint flat_end = projection.ProjectInteger(end);
+  const FlatRay ray(flat_start, flat_end);
 
   AirspaceIntersectSort sorter(start, *this);
 
-  for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
-
-    const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
+  const auto check_edge = [&ray, &sorter, &projection](FlatGeoPoint a,
+                                                       FlatGeoPoint b){
+    const FlatRay r_seg(a, b);
     auto t = ray.DistinctIntersection(r_seg);
     if (t >= 0)
       sorter.add(t, projection.Unproject(ray.Parametric(t)));
+  };
+
+  if (index.IsDefined()) {
+    index.VisitEdges(flat_start, flat_end,
+                     [&check_edge](unsigned, FlatGeoPoint a, FlatGeoPoint b){
+                       check_edge(a, b);
+                     });
+  } else {
+    for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it)
+      check_edge(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
   }
 
   return sorter.all();
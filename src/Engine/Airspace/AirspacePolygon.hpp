@@ -24,6 +24,7 @@
 #define AIRSPACEPOLYGON_HPP
 
 #include "AbstractAirspace.hpp"
+#include "AirspacePolygonIndex.hpp"
 #include <vector>
 
 #ifdef DO_PRINT
@@ -32,6 +33,13 @@
 
 /** General polygon form airspace */
 class AirspacePolygon final : public AbstractAirspace {
+  /**
+   * Speeds up Inside() and Intersects() on large polygons.  It is
+   * rebuilt each time the border is projected, i.e. by
+   * Airspaces::Optimise().
+   */
+  AirspacePolygonIndex index;
+
 public:
   /**
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -54,6 +62,9 @@ public:
   GeoPoint ClosestPoint(const GeoPoint &loc,
                         const FlatProjection &projection) const override;
 
+protected:
+  void Project(const FlatProjection &tp) override;
+
 public:
 #ifdef DO_PRINT
   friend std::ostream &operator<<(std::ostream &f,
@@ -0,0 +1,116 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspacePolygonIndex.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/ConvexHull/PolygonInterior.hpp"
+
+void
+AirspacePolygonIndex::Clear()
+{
+  xs.clear();
+  ys.clear();
+  slab_offsets.clear();
+  slab_edges.clear();
+}
+
+void
+AirspacePolygonIndex::Build(const SearchPointVector &border,
+                            const FlatProjection &_projection)
+{
+  Clear();
+
+  if (border.size() < MIN_VERTICES)
+    return;
+
+  projection = _projection;
+
+  const unsigned n_vertices = border.size();
+  const unsigned n_edges = n_vertices - 1;
+
+  xs.reserve(n_vertices);
+  ys.reserve(n_vertices);
+  for (const auto &i : border) {
+    const FlatGeoPoint &p = i.GetFlatLocation();
+    xs.push_back(p.x);
+    ys.push_back(p.y);
+  }
+
+  const auto y_range = std::minmax_element(ys.begin(), ys.end());
+  y_min = *y_range.first;
+  y_max = *y_range.second;
+
+  n_slabs = std::max(n_edges / EDGES_PER_SLAB, 1u);
+  slab_height = std::max(unsigned(y_max - y_min) / n_slabs + 1, 1u);
+
+  /* count the edges per slab, then fill the slabs */
+
+  slab_offsets.assign(n_slabs + 1, 0);
+  for (unsigned i = 0; i < n_edges; ++i) {
+    const unsigned first = GetSlab(std::min(ys[i], ys[i + 1]));
+    const unsigned last = GetSlab(std::max(ys[i], ys[i + 1]));
+    for (unsigned s = first; s <= last; ++s)
+      ++slab_offsets[s + 1];
+  }
+
+  for (unsigned s = 0; s < n_slabs; ++s)
+    slab_offsets[s + 1] += slab_offsets[s];
+
+  slab_edges.resize(slab_offsets[n_slabs]);
+
+  std::vector<unsigned> fill(slab_offsets.begin(), slab_offsets.end() - 1);
+  for (unsigned i = 0; i < n_edges; ++i) {
+    const unsigned first = GetSlab(std::min(ys[i], ys[i + 1]));
+    const unsigned last = GetSlab(std::max(ys[i], ys[i + 1]));
+    for (unsigned s = first; s <= last; ++s)
+      slab_edges[fill[s]++] = i;
+  }
+}
+
+bool
+AirspacePolygonIndex::IsInside(const GeoPoint &p,
+                               const SearchPointVector &border) const
+{
+  assert(IsDefined());
+  assert(border.size() == xs.size());
+
+  /* the projected y coordinate is a monotonic function of the
+     latitude, so an edge whose latitude range contains the point's
+     latitude always lies in the point's slab; all other edges do not
+     contribute to the winding number */
+  const int y = projection.ProjectInteger(p).y;
+  if (y < y_min || y > y_max)
+    return false;
+
+  const unsigned s = GetSlab(y);
+
+  int wn = 0;
+  for (unsigned j = slab_offsets[s], end = slab_offsets[s + 1];
+       j != end; ++j) {
+    const unsigned i = slab_edges[j];
+    wn += PolygonEdgeWinding(p, border[i].GetLocation(),
+                             border[i + 1].GetLocation());
+  }
+
+  return wn != 0;
+}
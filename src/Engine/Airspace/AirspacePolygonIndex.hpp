@@ -0,0 +1,158 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef AIRSPACE_POLYGON_INDEX_HPP
+#define AIRSPACE_POLYGON_INDEX_HPP
+
+#include "Geo/Flat/FlatProjection.hpp"
+#include "Geo/Flat/FlatGeoPoint.hpp"
+#include "Compiler.h"
+
+#include <vector>
+#include <algorithm>
+
+class SearchPointVector;
+struct GeoPoint;
+
+/**
+ * Acceleration structure for point-in-polygon and segment
+ * intersection tests on polygons with many vertices.
+ *
+ * The edges are stored in flat (projected) coordinates in a
+ * "structure of arrays" layout and are binned into horizontal slabs
+ * of equal height.  A query only looks at the edges of the slabs it
+ * touches, which is a small constant number for the typical
+ * border-following airspace.
+ *
+ * Edge i runs from border vertex i to vertex i+1.  The index must be
+ * rebuilt whenever the border is projected again.
+ */
+class AirspacePolygonIndex {
+  /**
+   * The projection the index was built with; it is used to locate
+   * query points in the slabs.
+   */
+  FlatProjection projection;
+
+  /**
+   * The projected border vertices.  The last one equals the first
+   * one.
+   */
+  std::vector<int> xs, ys;
+
+  int y_min, y_max;
+  unsigned slab_height;
+  unsigned n_slabs;
+
+  /**
+   * The edges of slab s are slab_edges[slab_offsets[s]] to
+   * slab_edges[slab_offsets[s + 1] - 1].
+   */
+  std::vector<unsigned> slab_offsets, slab_edges;
+
+public:
+  /**
+   * Polygons with fewer vertices are not indexed; a linear scan is
+   * just as fast.
+   */
+  static constexpr unsigned MIN_VERTICES = 32;
+
+  /**
+   * The desired average number of edges per slab.
+   */
+  static constexpr unsigned EDGES_PER_SLAB = 4;
+
+  bool IsDefined() const {
+    return !xs.empty();
+  }
+
+  void Clear();
+
+  /**
+   * Build the index from an already projected border.  Does nothing
+   * (apart from clearing the old index) if the border is too small to
+   * be worth indexing.
+   */
+  void Build(const SearchPointVector &border,
+             const FlatProjection &projection);
+
+  /**
+   * Equivalent to SearchPointVector::IsInside(GeoPoint) on the border
+   * this index was built from, but only evaluates the edges which
+   * may contribute to the winding number.
+   */
+  gcc_pure
+  bool IsInside(const GeoPoint &p, const SearchPointVector &border) const;
+
+  /**
+   * Invoke a function for each edge whose bounding box overlaps the
+   * bounding box of the segment from a to b.  Each edge is visited at
+   * most once.
+   *
+   * @param f a function taking the edge number and its two (flat)
+   * end points
+   */
+  template<typename F>
+  void VisitEdges(FlatGeoPoint a, FlatGeoPoint b, F &&f) const {
+    const int x0 = std::min(a.x, b.x), x1 = std::max(a.x, b.x);
+    const int y0 = std::min(a.y, b.y), y1 = std::max(a.y, b.y);
+    if (y1 < y_min || y0 > y_max)
+      return;
+
+    const unsigned first = GetSlab(y0), last = GetSlab(y1);
+
+    for (unsigned s = first; s <= last; ++s) {
+      for (unsigned j = slab_offsets[s], end = slab_offsets[s + 1];
+           j != end; ++j) {
+        const unsigned i = slab_edges[j];
+        const int ex0 = xs[i], ex1 = xs[i + 1];
+        const int ey0 = ys[i], ey1 = ys[i + 1];
+
+        const int e_y_min = std::min(ey0, ey1);
+
+        /* an edge spanning several slabs is listed in each of them;
+           visit it only in the first slab it shares with the
+           segment */
+        if (s != std::max(first, GetSlab(e_y_min)))
+          continue;
+
+        if (std::max(ex0, ex1) < x0 || std::min(ex0, ex1) > x1 ||
+            std::max(ey0, ey1) < y0 || e_y_min > y1)
+          continue;
+
+        f(i, FlatGeoPoint(ex0, ey0), FlatGeoPoint(ex1, ey1));
+      }
+    }
+  }
+
+private:
+  gcc_pure
+  unsigned GetSlab(int y) const {
+    if (y <= y_min)
+      return 0;
+
+    return std::min(unsigned(y - y_min) / slab_height, n_slabs - 1);
+  }
+};
+
+#endif
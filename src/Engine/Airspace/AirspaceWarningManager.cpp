@@ -27,6 +27,7 @@
 #include "AirspaceIntersectionVisitor.hpp"
 #include "AirspaceAircraftPerformance.hpp"
 #include "Task/Stats/TaskStats.hpp"
+#include "Util/Macros.hpp"
 
 #define CRUISE_FILTER_FACT 0.5
 
@@ -136,11 +137,36 @@ AirspaceWarningManager::Update(const AircraftState& state,
   for (auto &w : warnings)
     w.SaveState();
 
+  // update both filters even though we are using only one
+  cruise_filter.Update(state);
+  circling_filter.Update(state);
+
+  /* determine the end points of all predictions first, to be able
+     to collect the airspaces near all of them with only one tree
+     query */
+
+  const GeoPoint glide_predicted = glide_polar.IsValid()
+    ? state.GetPredictedState(prediction_time_glide).location
+    : GeoPoint::Invalid();
+
+  const GeoPoint filter_predicted = circling
+    ? circling_filter.GetPredictedState(prediction_time_filter).location
+    : cruise_filter.GetPredictedState(prediction_time_filter).location;
+
+  const GeoPoint task_predicted =
+    GetTaskPrediction(state, glide_polar, task_stats);
+
+  const GeoPoint ends[] = {
+    glide_predicted, filter_predicted, task_predicted,
+  };
+
+  CollectCandidates(state.location, ends, ARRAY_SIZE(ends));
+
   // check from strongest to weakest alerts
   UpdateInside(state, glide_polar);
-  UpdateGlide(state, glide_polar);
-  UpdateFilter(state, circling);
-  UpdateTask(state, glide_polar, task_stats);
+  UpdateGlide(state, glide_polar, glide_predicted);
+  UpdateFilter(state, circling, filter_predicted);
+  UpdateTask(state, glide_polar, task_stats, task_predicted);
 
   // action changes
   for (auto it = warnings.begin(), end = warnings.end(); it != end;) {
@@ -207,19 +233,19 @@ public:
     };
 
   /**
-   * Check whether this intersection should be added to, or updated in, the warning manager
+   * Check whether this intersection should be added to, or updated
+   * in, the warning manager.  The caller is responsible for checking
+   * whether the airspace is active and its class is enabled.
    *
    * @param airspace Airspace corresponding to current intersection
+   * @param warning the existing warning for this airspace or
+   * nullptr; it is updated if a new warning gets created
    */
-  void Intersection(const AbstractAirspace& airspace) {
-    if (!airspace.IsActive())
-      return; // ignore inactive airspaces completely
-
-    if (!warning_manager.GetConfig().IsClassEnabled(airspace.GetType()) ||
-        ExcludeAltitude(airspace))
+  void Intersection(const AbstractAirspace &airspace,
+                    AirspaceWarning *&warning) {
+    if (ExcludeAltitude(airspace))
       return;
 
-    AirspaceWarning *warning = warning_manager.GetWarningPtr(airspace);
     if (warning == nullptr || warning->IsStateAccepted(warning_state)) {
 
       AirspaceInterceptSolution solution;
@@ -243,8 +269,15 @@ public:
     }
   }
 
-  void Visit(const AbstractAirspace &as) override {
-    Intersection(as);
+  void Visit(const AbstractAirspace &airspace) override {
+    if (!airspace.IsActive())
+      return; // ignore inactive airspaces completely
+
+    if (!warning_manager.GetConfig().IsClassEnabled(airspace.GetType()))
+      return;
+
+    AirspaceWarning *warning = warning_manager.GetWarningPtr(airspace);
+    Intersection(airspace, warning);
   }
 
   /**
@@ -299,41 +332,80 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
                                              warning_state, max_time_limit,
                                              ceiling);
 
-  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+  const FlatProjection &projection = GetProjection();
+  const FlatGeoPoint flat_location =
+    projection.ProjectInteger(state.location);
+  FlatBoundingBox box(flat_location, flat_location);
+  box.Expand(projection.ProjectInteger(location_predicted));
+
+  for (auto &c : candidates) {
+    const Airspace &i = *c.airspace;
+    if (i.Overlaps(box) &&
+        visitor.SetIntersections(i.Intersects(state.location,
+                                              location_predicted,
+                                              projection)))
+      visitor.Intersection(i.GetAirspace(), c.warning);
+  }
 
   visitor.SetMode(true);
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    const AbstractAirspace &airspace = i.GetAirspace();
-    visitor.Visit(airspace);
-  }
+  for (auto &c : candidates)
+    if (c.inside)
+      visitor.Intersection(c.airspace->GetAirspace(), c.warning);
 
   return visitor.Found();
 }
 
 
-bool 
-AirspaceWarningManager::UpdateTask(const AircraftState &state,
-                                   const GlidePolar &glide_polar,
-                                   const TaskStats &task_stats)
+void
+AirspaceWarningManager::CollectCandidates(const GeoPoint &location,
+                                          const GeoPoint *ends,
+                                          unsigned n_ends)
+{
+  const FlatProjection &projection = GetProjection();
+  const FlatGeoPoint flat_location = projection.ProjectInteger(location);
+
+  FlatBoundingBox box(flat_location, flat_location);
+  for (unsigned i = 0; i < n_ends; ++i)
+    if (ends[i].IsValid())
+      box.Expand(projection.ProjectInteger(ends[i]));
+
+  candidates.clear();
+
+  for (const auto &i : airspaces.QueryIntersecting(box)) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    if (// ignore inactive airspaces
+        !airspace.IsActive() ||
+        !config.IsClassEnabled(airspace.GetType()))
+      continue;
+
+    const FlatBoundingBox &i_box = i;
+    const bool inside = i_box.IsInside(flat_location) &&
+      i.IsInside(location);
+
+    candidates.push_back({&i, GetWarningPtr(airspace), inside});
+  }
+}
+
+GeoPoint
+AirspaceWarningManager::GetTaskPrediction(const AircraftState &state,
+                                          const GlidePolar &glide_polar,
+                                          const TaskStats &task_stats) const
 {
   if (!glide_polar.IsValid())
-    return false;
+    return GeoPoint::Invalid();
 
   const ElementStat &current_leg = task_stats.current_leg;
 
   if (!task_stats.task_valid || !current_leg.location_remaining.IsValid())
-    return false;
+    return GeoPoint::Invalid();
 
   const GlideResult &solution = current_leg.solution_remaining;
   if (!solution.IsOk() || !solution.IsAchievable())
     /* glide solver failed, cannot continue */
-    return false;
+    return GeoPoint::Invalid();
 
-  const AirspaceAircraftPerformance perf_task(glide_polar,
-                                              current_leg.solution_remaining);
   GeoPoint location_tp = current_leg.location_remaining;
-  const auto time_remaining = solution.time_elapsed;
 
   const GeoVector vector(state.location, location_tp);
   auto max_distance = config.warning_time * glide_polar.GetVMax();
@@ -342,22 +414,32 @@ AirspaceWarningManager::UpdateTask(const AircraftState &state,
        the configured warning time */
     location_tp = state.location.IntermediatePoint(location_tp, max_distance);
 
-  return UpdatePredicted(state, location_tp, perf_task,
-                          AirspaceWarning::WARNING_TASK, time_remaining);
+  return location_tp;
 }
 
-
 bool 
-AirspaceWarningManager::UpdateFilter(const AircraftState& state, const bool circling)
+AirspaceWarningManager::UpdateTask(const AircraftState &state,
+                                   const GlidePolar &glide_polar,
+                                   const TaskStats &task_stats,
+                                   const GeoPoint &location_predicted)
 {
-  // update both filters even though we are using only one
-  cruise_filter.Update(state);
-  circling_filter.Update(state);
+  if (!location_predicted.IsValid())
+    /* no task prediction, see GetTaskPrediction() */
+    return false;
+
+  const GlideResult &solution = task_stats.current_leg.solution_remaining;
+  const AirspaceAircraftPerformance perf_task(glide_polar, solution);
+
+  return UpdatePredicted(state, location_predicted, perf_task,
+                          AirspaceWarning::WARNING_TASK, solution.time_elapsed);
+}
 
-  const GeoPoint location_predicted = circling?
-    circling_filter.GetPredictedState(prediction_time_filter).location:
-    cruise_filter.GetPredictedState(prediction_time_filter).location;
 
+bool 
+AirspaceWarningManager::UpdateFilter(const AircraftState& state,
+                                     const bool circling,
+                                     const GeoPoint &location_predicted)
+{
   if (circling) 
     return UpdatePredicted(state, location_predicted,
                            AirspaceAircraftPerformance(circling_filter),
@@ -371,14 +453,12 @@ AirspaceWarningManager::UpdateFilter(const AircraftState& state, const bool circ
 
 bool 
 AirspaceWarningManager::UpdateGlide(const AircraftState &state,
-                                    const GlidePolar &glide_polar)
+                                    const GlidePolar &glide_polar,
+                                    const GeoPoint &location_predicted)
 {
   if (!glide_polar.IsValid())
     return false;
 
-  const GeoPoint location_predicted = 
-    state.GetPredictedState(prediction_time_glide).location;
-
   const AirspaceAircraftPerformance perf_glide(glide_polar);
   return UpdatePredicted(state, location_predicted,
                           perf_glide,
@@ -394,24 +474,26 @@ AirspaceWarningManager::UpdateInside(const AircraftState& state,
 
   bool found = false;
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    const AbstractAirspace &airspace = i.GetAirspace();
+  const AirspaceAircraftPerformance perf_glide(glide_polar);
+
+  for (auto &c : candidates) {
+    if (!c.inside)
+      continue;
+
+    const AbstractAirspace &airspace = c.airspace->GetAirspace();
 
     const AltitudeState &altitude = state;
-    if (// ignore inactive airspaces
-        !airspace.IsActive() ||
-        !config.IsClassEnabled(airspace.GetType()) ||
-        !airspace.Inside(altitude))
+    if (!airspace.Inside(altitude))
       continue;
 
-    AirspaceWarning *warning = GetWarningPtr(airspace);
+    AirspaceWarning *&warning = c.warning;
 
     if (warning == nullptr ||
         warning->IsStateAccepted(AirspaceWarning::WARNING_INSIDE)) {
-      GeoPoint c = airspace.ClosestPoint(state.location, GetProjection());
-      const AirspaceAircraftPerformance perf_glide(glide_polar);
+      const GeoPoint closest =
+        airspace.ClosestPoint(state.location, GetProjection());
       const AirspaceInterceptSolution solution =
-        airspace.Intercept(state, c, GetProjection(), perf_glide);
+        airspace.Intercept(state, closest, GetProjection(), perf_glide);
 
       if (warning == nullptr)
         warning = GetNewWarningPtr(airspace);
@@ -28,10 +28,13 @@
 #include "Compiler.h"
 
 #include <list>
+#include <vector>
 
+struct GeoPoint;
 class TaskStats;
 class GlidePolar;
 class Airspaces;
+class Airspace;
 class FlatProjection;
 class AirspaceAircraftPerformance;
 
@@ -61,6 +64,33 @@ class AirspaceWarningManager {
 
   AirspaceWarningList warnings;
 
+  /**
+   * An airspace near the aircraft which may be subject to a warning.
+   * The list of candidates is collected with one tree query per
+   * Update() call and is then shared by all predictors.
+   */
+  struct Candidate {
+    const Airspace *airspace;
+
+    /**
+     * The warning for this airspace, or nullptr if there is none
+     * (yet).  Caching it here avoids searching the warning list
+     * again for each predictor.
+     */
+    AirspaceWarning *warning;
+
+    /**
+     * Is the aircraft inside the lateral boundary of this airspace?
+     */
+    bool inside;
+  };
+
+  /**
+   * The candidates of the current Update() call.  This is a
+   * member only to reuse its allocation.
+   */
+  std::vector<Candidate> candidates;
+
   /**
    * This number is incremented each time this object is modified.
    */
@@ -261,10 +291,29 @@ public:
   bool IsActive(const AbstractAirspace &airspace) const;
 
 private:
+  /**
+   * Collect all active and enabled airspaces whose bounding box
+   * overlaps the bounding box of the given location and the end
+   * points of all predictions into #candidates.
+   *
+   * @param ends the end points of all predictions; invalid ones are
+   * ignored
+   */
+  void CollectCandidates(const GeoPoint &location,
+                         const GeoPoint *ends, unsigned n_ends);
+
+  gcc_pure
+  GeoPoint GetTaskPrediction(const AircraftState &state,
+                             const GlidePolar &glide_polar,
+                             const TaskStats &task_stats) const;
+
   bool UpdateTask(const AircraftState &state, const GlidePolar &glide_polar,
-                  const TaskStats &task_stats);
-  bool UpdateFilter(const AircraftState& state, const bool circling);
-  bool UpdateGlide(const AircraftState& state, const GlidePolar &glide_polar);
+                  const TaskStats &task_stats,
+                  const GeoPoint &location_predicted);
+  bool UpdateFilter(const AircraftState& state, const bool circling,
+                    const GeoPoint &location_predicted);
+  bool UpdateGlide(const AircraftState& state, const GlidePolar &glide_polar,
+                   const GeoPoint &location_predicted);
   bool UpdateInside(const AircraftState& state, const GlidePolar &glide_polar);
 
   bool UpdatePredicted(const AircraftState& state, 
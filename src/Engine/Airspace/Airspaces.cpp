@@ -58,6 +58,16 @@ Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b) const
   return {airspace_tree.qbegin(bgi::intersects(line)), airspace_tree.qend()};
 }
 
+Airspaces::const_iterator_range
+Airspaces::QueryIntersecting(const FlatBoundingBox &box) const
+{
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  return {airspace_tree.qbegin(bgi::intersects(box)), airspace_tree.qend()};
+}
+
 void
 Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
                              bool include_inside,
@@ -102,9 +112,21 @@ Airspaces::Optimise()
     airspace_tree.clear();
   }
 
-  for (AbstractAirspace *i : tmp_as) {
-    Airspace as(*i, task_projection);
-    airspace_tree.insert(as);
+  if (bulk_load && tmp_as.size() >= airspace_tree.size()) {
+    /* bulk-load the whole tree with the packing algorithm; this is
+       much faster than inserting one by one, and yields a tree with
+       less overlap */
+    AirspaceVector v = AsVector();
+    v.reserve(v.size() + tmp_as.size());
+    for (AbstractAirspace *i : tmp_as)
+      v.emplace_back(*i, task_projection);
+
+    BulkLoad(v);
+  } else {
+    for (AbstractAirspace *i : tmp_as) {
+      Airspace as(*i, task_projection);
+      airspace_tree.insert(as);
+    }
   }
 
   tmp_as.clear();
@@ -112,6 +134,41 @@ Airspaces::Optimise()
   ++serial;
 }
 
+boost::geometry::index::dynamic_rstar
+Airspaces::MakeTreeParameters(unsigned max_elements)
+{
+  /* boost requires at least 4 elements per node; beyond 64, the
+     linear scan within a node dominates */
+  if (max_elements < 4)
+    max_elements = 4;
+  else if (max_elements > 64)
+    max_elements = 64;
+
+  return bgi::dynamic_rstar(max_elements);
+}
+
+void
+Airspaces::SetTreeFanOut(unsigned max_elements)
+{
+  const auto parameters = MakeTreeParameters(max_elements);
+  if (parameters.get_max_elements() == GetTreeFanOut())
+    return;
+
+  /* move all airspaces back to the temporary list; the next
+     Optimise() call bulk-loads them into the new tree */
+  for (const auto &i : QueryAll())
+    tmp_as.push_back(&i.GetAirspace());
+
+  airspace_tree = AirspaceTree(parameters);
+}
+
+void
+Airspaces::BulkLoad(const AirspaceVector &v)
+{
+  airspace_tree = AirspaceTree(v.begin(), v.end(),
+                               airspace_tree.parameters());
+}
+
 void
 Airspaces::Add(AbstractAirspace *airspace)
 {
@@ -250,10 +307,8 @@ Airspaces::SynchroniseInRange(const Airspaces &master,
 
   for (auto &i : QueryAll())
     i.ClearClearance();
-  airspace_tree.clear();
 
-  for (const auto &i : contents_master)
-    airspace_tree.insert(i);
+  BulkLoad(contents_master);
 
   ++serial;
 
@@ -51,6 +51,12 @@ class Airspaces : public AirspacesInterface {
 
   std::deque<AbstractAirspace *> tmp_as;
 
+  /**
+   * Build the tree with the packing algorithm when (re)building it
+   * as a whole?  Only disabled for benchmarks.
+   */
+  bool bulk_load = true;
+
   /**
    * This attribute keeps track of changes to this project.  It is
    * used by the renderer cache.
@@ -68,7 +74,8 @@ public:
    * @return empty Airspaces class.
    */
   Airspaces(bool _owns_children=true)
-    :qnh(AtmosphericPressure::Zero()), owns_children(_owns_children) {}
+    :qnh(AtmosphericPressure::Zero()), owns_children(_owns_children),
+     airspace_tree(MakeTreeParameters(DEFAULT_TREE_FAN_OUT)) {}
 
   Airspaces(const Airspaces &) = delete;
 
@@ -97,9 +104,32 @@ public:
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
    * any searches, but can be done once after a batch insert/delete.
+   *
+   * If the batch is at least as large as the tree, the whole tree is
+   * bulk-loaded with the packing algorithm; smaller batches are
+   * inserted one by one.
    */
   void Optimise();
 
+  /**
+   * Set the maximum number of elements per R-tree node.  The tree
+   * is rebuilt by the next Optimise() call.
+   */
+  void SetTreeFanOut(unsigned max_elements);
+
+  gcc_pure
+  unsigned GetTreeFanOut() const {
+    return airspace_tree.parameters().get_max_elements();
+  }
+
+  /**
+   * Enable or disable bulk loading in Optimise() (enabled by
+   * default).  This is only useful for benchmarks.
+   */
+  void SetBulkLoad(bool _bulk_load) {
+    bulk_load = _bulk_load;
+  }
+
   /**
    * Clear the airspace store, deleting airspace objects if m_owner is true
    */
@@ -170,6 +200,13 @@ public:
   const_iterator_range QueryIntersecting(const GeoPoint &a,
                                          const GeoPoint &b) const;
 
+  /**
+   * Query airspaces whose bounding box overlaps the given (projected)
+   * bounding box.  The result is in no specific order.
+   */
+  gcc_pure
+  const_iterator_range QueryIntersecting(const FlatBoundingBox &box) const;
+
   /**
    * Call visitor class on airspaces intersected by vector.
    * Note that the visitor is not instantiated separately for each match
@@ -230,6 +267,16 @@ public:
                           const AirspacePredicate &condition);
 
 private:
+  gcc_const
+  static boost::geometry::index::dynamic_rstar
+  MakeTreeParameters(unsigned max_elements);
+
+  /**
+   * Replace the tree with a packed one containing the given
+   * airspaces.
+   */
+  void BulkLoad(const AirspaceVector &v);
+
   gcc_pure
   AirspaceVector AsVector() const;
 };
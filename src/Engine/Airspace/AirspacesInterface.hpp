@@ -46,9 +46,17 @@ public:
   typedef std::vector<Airspace> AirspaceVector; /**< Vector of airspaces (used internally) */
 
   /**
-   * Type of KD-tree data structure for airspace container
+   * Default maximum number of elements per R-tree node.
    */
-  typedef boost::geometry::index::rtree<Airspace, boost::geometry::index::rstar<16>,
+  static constexpr unsigned DEFAULT_TREE_FAN_OUT = 16;
+
+  /**
+   * Type of KD-tree data structure for airspace container.  The
+   * parameters are dynamic, so the node fan-out can be tuned at
+   * runtime.
+   */
+  typedef boost::geometry::index::rtree<Airspace,
+                                        boost::geometry::index::dynamic_rstar,
                                         AirspaceIndexable> AirspaceTree;
 
   typedef AirspaceTree::const_query_iterator const_iterator;
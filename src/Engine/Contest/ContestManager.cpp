@@ -21,6 +21,7 @@
  */
 
 #include "ContestManager.hpp"
+#include "ContestWorker.hpp"
 
 ContestManager::ContestManager(const Contest _contest,
                                const Trace &trace_full,
@@ -44,6 +45,8 @@ ContestManager::ContestManager(const Contest _contest,
   Reset();
 }
 
+ContestManager::~ContestManager() = default;
+
 void
 ContestManager::SetIncremental(bool incremental)
 {
@@ -59,6 +62,24 @@ ContestManager::SetIncremental(bool incremental)
   net_coupe.SetIncremental(incremental);
 }
 
+void
+ContestManager::SetParallel(bool parallel)
+{
+  if (!parallel)
+    worker.reset();
+  else if (!worker)
+    worker.reset(new ContestWorker());
+}
+
+void
+ContestManager::SetTickBudget(unsigned iterations,
+                              std::chrono::steady_clock::duration duration)
+{
+  olc_fai.SetTickBudget(iterations, duration);
+  xcontest_triangle.SetTickBudget(iterations, duration);
+  dhv_xc_triangle.SetTickBudget(iterations, duration);
+}
+
 void
 ContestManager::SetPredicted(const TracePoint &predicted)
 {
@@ -93,14 +114,14 @@ ContestManager::SetHandicap(unsigned handicap)
   net_coupe.SetHandicap(handicap);
 }
 
+/**
+ * Copy the best result of a solver which has returned
+ * SolverResult::VALID.
+ */
 static bool
-RunContest(AbstractContest &_contest,
-           ContestResult &result, ContestTraceVector &solution,
-           bool exhaustive)
+StoreContest(SolverResult r, const AbstractContest &_contest,
+             ContestResult &result, ContestTraceVector &solution)
 {
-  // run solver, return immediately if further processing is required
-  // by subsequent calls
-  SolverResult r = _contest.Solve(exhaustive);
   if (r != SolverResult::VALID)
     return false;
 
@@ -116,6 +137,39 @@ RunContest(AbstractContest &_contest,
   return true;
 }
 
+static bool
+RunContest(AbstractContest &_contest,
+           ContestResult &result, ContestTraceVector &solution,
+           bool exhaustive)
+{
+  // run solver, return immediately if further processing is required
+  // by subsequent calls
+  return StoreContest(_contest.Solve(exhaustive), _contest,
+                      result, solution);
+}
+
+bool
+ContestManager::RunContestPair(AbstractContest &a, unsigned a_index,
+                               AbstractContest &b, unsigned b_index,
+                               bool exhaustive)
+{
+  if (!worker)
+    return RunContest(a, stats.result[a_index],
+                      stats.solution[a_index], exhaustive) |
+      RunContest(b, stats.result[b_index],
+                 stats.solution[b_index], exhaustive);
+
+  worker->Start(b, exhaustive);
+
+  const bool a_result = RunContest(a, stats.result[a_index],
+                                   stats.solution[a_index], exhaustive);
+  const bool b_result = StoreContest(worker->Wait(), b,
+                                     stats.result[b_index],
+                                     stats.solution[b_index]);
+
+  return a_result || b_result;
+}
+
 bool
 ContestManager::UpdateIdle(bool exhaustive)
 {
@@ -151,11 +205,7 @@ ContestManager::UpdateIdle(bool exhaustive)
     break;
 
   case Contest::OLC_PLUS:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(olc_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContestPair(olc_classic, 0, olc_fai, 1, exhaustive);
 
     if (retval) {
       olc_plus.Feed(stats.result[0], stats.solution[0],
@@ -173,17 +223,11 @@ ContestManager::UpdateIdle(bool exhaustive)
     break;
 
   case Contest::XCONTEST:
-    retval = RunContest(xcontest_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(xcontest_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContestPair(xcontest_free, 0, xcontest_triangle, 1, exhaustive);
     break;
 
   case Contest::DHV_XC:
-    retval = RunContest(dhv_xc_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(dhv_xc_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunContestPair(dhv_xc_free, 0, dhv_xc_triangle, 1, exhaustive);
     break;
 
   case Contest::SIS_AT:
@@ -36,7 +36,11 @@
 #include "Solvers/NetCoupe.hpp"
 #include "ContestStatistics.hpp"
 
+#include <memory>
+#include <chrono>
+
 class Trace;
+class ContestWorker;
 
 /**
  * Special task holder for Online Contest calculations
@@ -62,6 +66,13 @@ class ContestManager
   OLCSISAT sis_at;
   NetCoupe net_coupe;
 
+  /**
+   * If set, then the second of two independent solvers of the
+   * selected contest is solved in this one background thread, while
+   * the calling thread solves the first one.
+   */
+  std::unique_ptr<ContestWorker> worker;
+
 public:
   /**
    * Base constructor.
@@ -83,8 +94,36 @@ public:
                  const Trace &trace_sprint,
                  bool predict_triangle=false);
 
+  ~ContestManager();
+
   void SetIncremental(bool incremental);
 
+  /**
+   * Enable or disable concurrent solving.  When enabled, solvers
+   * which do not depend on each other's results (e.g. the free and
+   * triangle parts of XContest) are split between one background
+   * worker thread and the calling thread.  UpdateIdle() still blocks until all of
+   * them are done, and each solver writes to its own result slot,
+   * so the results are identical to the sequential mode.
+   *
+   * This is disabled by default; it is only useful on multi-core
+   * machines.
+   */
+  void SetParallel(bool parallel);
+
+  bool IsParallel() const {
+    return worker != nullptr;
+  }
+
+  /**
+   * Limit each incremental (non-exhaustive) UpdateIdle() call of the
+   * triangle solvers.
+   *
+   * @see OLCTriangle::SetTickBudget()
+   */
+  void SetTickBudget(unsigned iterations,
+                     std::chrono::steady_clock::duration duration);
+
   /**
    * @see ContestDijkstra::SetPredicted()
    */
@@ -130,6 +169,18 @@ public:
   const ContestStatistics &GetStats() const {
     return stats;
   }
+
+private:
+  /**
+   * Run two independent solvers, concurrently if a worker is
+   * available, and store their results in the given slots of
+   * #stats.
+   *
+   * @return true if at least one of them found a new solution
+   */
+  bool RunContestPair(AbstractContest &a, unsigned a_index,
+                      AbstractContest &b, unsigned b_index,
+                      bool exhaustive);
 };
 
 #endif
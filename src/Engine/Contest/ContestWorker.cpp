@@ -0,0 +1,76 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ContestWorker.hpp"
+#include "Solvers/AbstractContest.hpp"
+
+ContestWorker::ContestWorker()
+  :StandbyThread("Contest"),
+   contest(nullptr) {}
+
+ContestWorker::~ContestWorker()
+{
+  LockStop();
+}
+
+void
+ContestWorker::Start(AbstractContest &_contest, bool _exhaustive)
+{
+  const ScopeLock protect(mutex);
+  assert(contest == nullptr);
+
+  contest = &_contest;
+  exhaustive = _exhaustive;
+  result = SolverResult::FAILED;
+
+  Trigger();
+}
+
+SolverResult
+ContestWorker::Wait()
+{
+  const ScopeLock protect(mutex);
+  WaitDone();
+
+  assert(contest == nullptr);
+  return result;
+}
+
+void
+ContestWorker::Tick()
+{
+  if (contest == nullptr || IsStopped())
+    return;
+
+  AbstractContest &c = *contest;
+
+  SolverResult r;
+
+  {
+    const ScopeUnlock unlock(mutex);
+    r = c.Solve(exhaustive);
+  }
+
+  result = r;
+  contest = nullptr;
+}
@@ -0,0 +1,70 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CONTEST_WORKER_HPP
+#define XCSOAR_CONTEST_WORKER_HPP
+
+#include "Thread/StandbyThread.hpp"
+#include "PathSolvers/SolverResult.hpp"
+
+class AbstractContest;
+
+/**
+ * One background thread which runs the solver of an #AbstractContest
+ * on behalf of #ContestManager, while the calling thread solves an
+ * independent one.  This is not a pool: there is only this one
+ * worker, because a contest never has more than two independent
+ * solvers.
+ *
+ * The caller must not modify the solver or its trace between
+ * Start() and Wait().
+ */
+class ContestWorker final : private StandbyThread {
+  AbstractContest *contest;
+  bool exhaustive;
+
+  SolverResult result;
+
+public:
+  ContestWorker();
+  ~ContestWorker();
+
+  /**
+   * Begin solving the given contest in the worker thread.  Must be
+   * paired with a call to Wait().
+   */
+  void Start(AbstractContest &_contest, bool _exhaustive);
+
+  /**
+   * Wait for the job submitted by Start() to complete.
+   *
+   * @return the return value of AbstractContest::Solve()
+   */
+  SolverResult Wait();
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() override;
+};
+
+#endif
@@ -63,6 +63,8 @@ OLCTriangle::OLCTriangle(const Trace &_trace,
    is_fai(_is_fai), predict(_predict),
    is_closed(false),
    is_complete(false),
+   max_tick_iterations(0),
+   max_tick_duration(std::chrono::steady_clock::duration::zero()),
    max_iterations(1e6),
    max_tree_size(5e5)
 {
@@ -80,6 +82,7 @@ OLCTriangle::Reset()
   tick_iterations = 1000;
 
   closing_pairs.Clear();
+  search_point_tree.clear();
   ClearTrace();
 
   ResetBranchAndBound();
@@ -90,6 +93,7 @@ void
 OLCTriangle::ResetBranchAndBound()
 {
   running = false;
+  searched_points = 0;
   branch_and_bound.clear();
 }
 
@@ -112,22 +116,26 @@ OLCTriangle::UpdateTrace(bool force)
 {
   if (IsMasterAppended()) return; /* unmodified */
 
-  if (force || IsMasterUpdated(false)) {
+  if (!force && incremental && !trace.empty() && !CheckMasterSerial()) {
+    /* points were only appended: keep the closing pairs, the best
+       distance and the search tree, and continue with the new
+       points */
+    const unsigned old_size = n_points;
+    if (UpdateTraceTail()) {
+      is_complete = false;
+      is_closed = FindClosingPairs(old_size);
+    }
+  } else if (force || IsMasterUpdated(false)) {
     UpdateTraceFull();
 
     is_complete = false;
 
     best_d = 0;
 
+    ResetBranchAndBound();
+
     closing_pairs.Clear();
     is_closed = FindClosingPairs(0);
-
-   } else if (is_complete && incremental) {
-    const unsigned old_size = n_points;
-    if (UpdateTraceTail()) {
-      is_complete = false;
-      is_closed = FindClosingPairs(old_size);
-    }
   }
 
   /**
@@ -137,7 +145,9 @@ OLCTriangle::UpdateTrace(bool force)
    * Using n_points^2 / 8 as number of iterations per tick should allow
    * the algorithm to finish in about 10 to 15 ticks in most cases.
    */
-  tick_iterations = n_points * n_points / 8;
+  tick_iterations = max_tick_iterations > 0
+    ? max_tick_iterations
+    : n_points * n_points / 8;
 }
 
 
@@ -150,8 +160,9 @@ OLCTriangle::Solve(bool exhaustive)
     return SolverResult::FAILED;
   }
 
-  if (!running) {
-    // branch and bound is currently in finished state, update trace
+  if (!running || incremental || exhaustive) {
+    // an incremental search can merge new points into its tree, a
+    // non-incremental one has to finish first
     UpdateTrace(exhaustive);
   }
 
@@ -181,6 +192,7 @@ OLCTriangle::SolveTriangle(bool exhaustive)
            tp3 = 0,
            start = 0,
            finish = 0;
+  bool improved = false;
 
   if (exhaustive || !predict) {
     ClosingPairs relaxed_pairs;
@@ -218,9 +230,8 @@ OLCTriangle::SolveTriangle(bool exhaustive)
 
     for (const auto relaxed_pair : relaxed_pairs.closing_pairs) {
 
-      std::tuple<unsigned, unsigned, unsigned, unsigned> triangle;
-
-      triangle = RunBranchAndBound(relaxed_pair.first, relaxed_pair.second, best_d, exhaustive);
+      const Triangle triangle = SolveRange(relaxed_pair.first,
+                                           relaxed_pair.second, best_d);
 
       if (std::get<3>(triangle) > best_d) {
         // solution is better than best_d
@@ -236,6 +247,7 @@ OLCTriangle::SolveTriangle(bool exhaustive)
           finish = unrelaxed.second;
 
           best_d = std::get<3>(triangle);
+          improved = true;
         } else {
           // otherwise we should solve the triangle again for every unrelaxed pair
           // contained inside the current relaxed pair. *damn!*
@@ -249,11 +261,9 @@ OLCTriangle::SolveTriangle(bool exhaustive)
     }
 
     for (const auto &close_look_pair : close_look.closing_pairs) {
-      std::tuple<unsigned, unsigned, unsigned, unsigned> triangle;
-
-      triangle = RunBranchAndBound(close_look_pair.first,
-                                   close_look_pair.second,
-                                   best_d, exhaustive);
+      const Triangle triangle = SolveRange(close_look_pair.first,
+                                           close_look_pair.second,
+                                           best_d);
 
       if (std::get<3>(triangle) > best_d) {
         // solution is better than best_d
@@ -265,6 +275,7 @@ OLCTriangle::SolveTriangle(bool exhaustive)
         finish = close_look_pair.second;
 
         best_d = std::get<3>(triangle);
+        improved = true;
       }
     }
 
@@ -272,11 +283,24 @@ OLCTriangle::SolveTriangle(bool exhaustive)
     /**
      * We're currently running in predictive, non-exhaustive mode, so we use
      * one closing pair only (0 -> n_points-1) which allows us to suspend the
-     * solver...
+     * solver and to resume it with a larger trace: points appended since the
+     * last call only add candidate sets with the last turn point among them,
+     * everything else is still in the tree or bounded by best_d.
      */
-    std::tuple<unsigned, unsigned, unsigned, unsigned> triangle;
+    if (searched_points < n_points) {
+      AddCandidates(branch_and_bound, 0, n_points - 1,
+                    searched_points, best_d);
+      searched_points = n_points;
+    }
+
+    const auto deadline =
+      max_tick_duration > std::chrono::steady_clock::duration::zero()
+      ? std::chrono::steady_clock::now() + max_tick_duration
+      : std::chrono::steady_clock::time_point::max();
 
-    triangle = RunBranchAndBound(0, n_points - 1, best_d, false);
+    const Triangle triangle = RunBranchAndBound(branch_and_bound, 0, best_d,
+                                                tick_iterations, deadline);
+    running = !branch_and_bound.empty();
 
     if (std::get<3>(triangle) > best_d) {
       // solution is better than best_d
@@ -288,10 +312,11 @@ OLCTriangle::SolveTriangle(bool exhaustive)
       finish = n_points - 1;
 
       best_d = std::get<3>(triangle);
+      improved = true;
     }
   }
 
-  if (best_d > 0) {
+  if (improved) {
     solution.resize(5);
 
     solution[0] = TraceManager::GetPoint(start);
@@ -299,21 +324,42 @@ OLCTriangle::SolveTriangle(bool exhaustive)
     solution[2] = TraceManager::GetPoint(tp2);
     solution[3] = TraceManager::GetPoint(tp3);
     solution[4] = TraceManager::GetPoint(finish);
+  }
 
+  if (best_d > 0)
     is_complete = true;
-  }
 }
 
 
-std::tuple<unsigned, unsigned, unsigned, unsigned>
-OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, bool exhaustive)
+/**
+ * The flat distance used for the relaxed large triangle checks.
+ *
+ * Note: this is _not_ the breakepoint between small and large
+ * triangles, but a slightly lower value.
+ */
+gcc_pure
+static unsigned
+GetLargeTriangleCheck(const Trace &trace, const GeoPoint &location)
 {
-  /* Some general information about the branch and bound method can be found here:
-   * http://eaton.math.rpi.edu/faculty/Mitchell/papers/leeejem.html
-   *
-   * How to use this method for solving FAI triangles is described here:
-   * http://www.penguin.cz/~ondrap/algorithm.pdf
-   */
+  return trace.ProjectRange(location, 500000) * 0.99;
+}
+
+OLCTriangle::Triangle
+OLCTriangle::SolveRange(unsigned from, unsigned to, unsigned worst_d)
+{
+  CandidateTree tree;
+  AddCandidates(tree, from, to, from, worst_d);
+
+  return RunBranchAndBound(tree, from, worst_d, max_iterations,
+                           std::chrono::steady_clock::time_point::max());
+}
+
+void
+OLCTriangle::AddCandidates(CandidateTree &tree, unsigned from, unsigned to,
+                           unsigned tp3_min, unsigned worst_d) const
+{
+  assert(from <= tp3_min);
+  assert(tp3_min <= to);
 
   // Return early if this tp-range can't beat the current best_d...
   // Assume a maximum speed of 100 m/s
@@ -322,7 +368,34 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
     trace_master.ProjectRange(GetPoint(from).GetLocation(), fastskiprange);
 
   if (fastskiprange_flat < worst_d)
-    return std::tuple<unsigned, unsigned, unsigned, unsigned>(0, 0, 0, 0);
+    return;
+
+  const unsigned large_triangle_check =
+    GetLargeTriangleCheck(trace_master, GetPoint(from).GetLocation());
+
+  // the candidate set covering all triangles with tp3 in
+  // [tp3_min, to] (note: Candidate set interval is [min, max))
+  const TurnPointRange all(*this, from, to + 1);
+  const CandidateSet candidates(all, all,
+                                tp3_min == from
+                                ? all
+                                : TurnPointRange(*this, tp3_min, to + 1));
+  if (candidates.IsFeasible(is_fai, large_triangle_check) &&
+      candidates.df_max >= worst_d)
+    tree.insert(std::make_pair(candidates.df_max, candidates));
+}
+
+OLCTriangle::Triangle
+OLCTriangle::RunBranchAndBound(CandidateTree &branch_and_bound, unsigned from,
+                               unsigned worst_d, unsigned iteration_limit,
+                               std::chrono::steady_clock::time_point deadline)
+{
+  /* Some general information about the branch and bound method can be found here:
+   * http://eaton.math.rpi.edu/faculty/Mitchell/papers/leeejem.html
+   *
+   * How to use this method for solving FAI triangles is described here:
+   * http://www.penguin.cz/~ondrap/algorithm.pdf
+   */
 
   bool integral_feasible = false;
   unsigned best_d = 0,
@@ -331,26 +404,14 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
            tp3 = 0;
   unsigned iterations = 0;
 
-  // note: this is _not_ the breakepoint between small and large triangles,
-  // but a slightly lower value used for relaxed large triangle checking.
-  const unsigned large_triangle_check =
-    trace_master.ProjectRange(GetPoint(from).GetLocation(), 500000) * 0.99;
-
-  if (!running) {
-    // initiate algorithm. otherwise continue unfinished run
-    running = true;
+  if (branch_and_bound.empty())
+    return Triangle(0, 0, 0, 0);
 
-    // initialize bound-and-branch tree with root node (note: Candidate set interval is [min, max))
-    CandidateSet root_candidates(*this, from, to + 1);
-    if (root_candidates.IsFeasible(is_fai, large_triangle_check) &&
-        root_candidates.df_max >= worst_d)
-      branch_and_bound.insert(std::pair<unsigned, CandidateSet>(root_candidates.df_max, root_candidates));
-  }
+  const unsigned large_triangle_check =
+    GetLargeTriangleCheck(trace_master, GetPoint(from).GetLocation());
 
-  // set max_iterations only if non-exhaustive and predictive solving is enabled.
-  // otherwise use predefined value.
-  if (!exhaustive && predict)
-    max_iterations = tick_iterations;
+  const bool check_deadline =
+    deadline != std::chrono::steady_clock::time_point::max();
 
   while (!branch_and_bound.empty()) {
     /* now loop over the tree, branching each found candidate set, adding the branch if it's feasible.
@@ -360,9 +421,18 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
 
     iterations++;
 
-    // break loop if max_iterations or max_tree_size exceeded
-    if (iterations > max_iterations || branch_and_bound.size() > max_tree_size)
+    // break loop if the iteration limit or the deadline is reached;
+    // the search can be resumed with the remaining tree
+    if (iterations > iteration_limit ||
+        (check_deadline && iterations % 64 == 0 &&
+         std::chrono::steady_clock::now() >= deadline))
+      break;
+
+    // give up if the tree grows too big
+    if (branch_and_bound.size() > max_tree_size) {
+      branch_and_bound.clear();
       break;
+    }
 
     // first clean up tree, removeing all nodes with d_max < worst_d
     branch_and_bound.erase(branch_and_bound.begin(), branch_and_bound.lower_bound(worst_d));
@@ -376,7 +446,7 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
      * this is a mixed depht-first/breadth-first approach, the latter
      * beeing faster, but the first a lot more memory efficient.
      */
-    std::multimap<unsigned, CandidateSet>::iterator node;
+    CandidateTree::iterator node;
 
     if (branch_and_bound.size() > n_points * 4 && iterations % 16 != 0) {
       node = branch_and_bound.upper_bound(branch_and_bound.rbegin()->first / 2);
@@ -472,17 +542,14 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
   }
 
 
-  if (branch_and_bound.empty())
-    running = false;
-
   if (integral_feasible) {
     if (tp1 > tp2) std::swap(tp1, tp2);
     if (tp2 > tp3) std::swap(tp2, tp3);
     if (tp1 > tp2) std::swap(tp1, tp2);
 
-    return std::tuple<unsigned, unsigned, unsigned, unsigned>(tp1, tp2, tp3, best_d);
+    return Triangle(tp1, tp2, tp3, best_d);
   } else {
-    return std::tuple<unsigned, unsigned, unsigned, unsigned>(0, 0, 0, 0);
+    return Triangle(0, 0, 0, 0);
   }
 }
 
@@ -519,25 +586,12 @@ OLCTriangle::FindClosingPairs(unsigned old_size)
     return closing_pairs.Insert(ClosingPair(0, n_points-1));
   }
 
-  struct TracePointNode {
-    const TracePoint *point;
-    unsigned index;
-  };
-
-  struct TracePointNodeAccessor {
-    gcc_pure
-    int GetX(const TracePointNode &node) const {
-      return node.point->GetFlatLocation().x;
-    }
-
-    gcc_pure
-    int GetY(const TracePointNode &node) const {
-      return node.point->GetFlatLocation().y;
-    }
-  };
-
-  QuadTree<TracePointNode, TracePointNodeAccessor> search_point_tree;
+  if (old_size == 0)
+    search_point_tree.clear();
 
+  /* the tree already contains all points below old_size; a new
+     point may still close a loop which was started before, so the
+     search below visits all of them */
   for (unsigned i = old_size; i < n_points; ++i) {
     TracePointNode node;
     node.point = &GetPoint(i);
@@ -546,7 +600,9 @@ OLCTriangle::FindClosingPairs(unsigned old_size)
     search_point_tree.insert(node);
   }
 
-  search_point_tree.Optimise();
+  /* rebuild the tree only if a new point was outside of its bounds */
+  if (search_point_tree.IsFlat())
+    search_point_tree.Optimise();
 
   bool new_pair = false;
 
@@ -27,8 +27,11 @@
 #include "TraceManager.hpp"
 #include "Trace/Point.hpp"
 #include "Geo/Flat/FlatBoundingBox.hpp"
+#include "Util/QuadTree.hpp"
 
 #include <map>
+#include <tuple>
+#include <chrono>
 
 /**
  * Specialisation of AbstractContest for OLC Triangle (triangle) rules
@@ -75,16 +78,39 @@ private:
   bool is_complete;
 
   /**
-   * True if the branch and bound algorithm is running
+   * True if the branch and bound algorithm is running, i.e. the
+   * incremental (non-exhaustive, predictive) search was suspended
+   * and #branch_and_bound still contains candidate sets.
    */
   bool running;
 
+  /**
+   * The number of trace points which have already been added to the
+   * incremental search tree.  Triangles whose turn points all lie
+   * below this index are covered by #branch_and_bound (or have
+   * already been evaluated); new points only add candidate sets
+   * with the last turn point in the new tail.
+   */
+  unsigned searched_points;
+
   /**
    * Number of iterations per tick (only for non-exhaustive,
    * predictive runs)
    */
   unsigned tick_iterations;
 
+  /**
+   * Fixed number of iterations per tick, overriding the automatic
+   * #tick_iterations.  Zero means automatic.
+   */
+  unsigned max_tick_iterations;
+
+  /**
+   * Maximum wall time per tick (only for non-exhaustive, predictive
+   * runs).  Zero means no limit.
+   */
+  std::chrono::steady_clock::duration max_tick_duration;
+
   /**
    * Hard limits for number of iterations and tree size.
    */
@@ -140,6 +166,30 @@ private:
 
   ClosingPairs closing_pairs;
 
+  struct TracePointNode {
+    const TracePoint *point;
+    unsigned index;
+  };
+
+  struct TracePointNodeAccessor {
+    gcc_pure
+    int GetX(const TracePointNode &node) const {
+      return node.point->GetFlatLocation().x;
+    }
+
+    gcc_pure
+    int GetY(const TracePointNode &node) const {
+      return node.point->GetFlatLocation().y;
+    }
+  };
+
+  /**
+   * All trace points which have been searched for closing pairs (only
+   * for non-predictive runs).  This is kept while points are only
+   * appended, so FindClosingPairs() has to insert just the new ones.
+   */
+  QuadTree<TracePointNode, TracePointNodeAccessor> search_point_tree;
+
   /**
    * A bounding box around a range of trace points.
    */
@@ -329,7 +379,15 @@ private:
     }
   };
 
-  std::multimap<unsigned, CandidateSet> branch_and_bound;
+  typedef std::multimap<unsigned, CandidateSet> CandidateTree;
+
+  /**
+   * The search tree of the incremental (non-exhaustive, predictive)
+   * search, which is kept between Solve() calls.
+   */
+  CandidateTree branch_and_bound;
+
+  typedef std::tuple<unsigned, unsigned, unsigned, unsigned> Triangle;
 
 public:
   OLCTriangle(const Trace &_trace,
@@ -345,8 +403,34 @@ protected:
   bool FindClosingPairs(unsigned old_size);
   void SolveTriangle(bool exhaustive);
 
-  std::tuple<unsigned, unsigned, unsigned, unsigned>
-  RunBranchAndBound(unsigned from, unsigned to, unsigned best_d, bool exhaustive);
+  /**
+   * Solve one closing pair from scratch with the hard limits
+   * #max_iterations and #max_tree_size.
+   */
+  Triangle SolveRange(unsigned from, unsigned to, unsigned worst_d);
+
+  /**
+   * Add the root candidate set for all triangles in [from, to] whose
+   * last turn point is at or after #tp3_min to the given tree.
+   */
+  void AddCandidates(CandidateTree &tree, unsigned from, unsigned to,
+                     unsigned tp3_min, unsigned worst_d) const;
+
+  /**
+   * Continue the branch and bound search in the given tree.  Returns
+   * when the tree is exhausted, when the iteration limit is reached
+   * or when the deadline has passed; in the latter cases, the tree
+   * can be passed again to resume the search.
+   *
+   * @param from the first trace point of the search range; used for
+   * the flat projection of distance thresholds
+   * @return the best triangle (sorted turn point indices and flat
+   * distance) found during this call, all zero if none better than
+   * #worst_d was found
+   */
+  Triangle RunBranchAndBound(CandidateTree &tree, unsigned from,
+                             unsigned worst_d, unsigned iteration_limit,
+                             std::chrono::steady_clock::time_point deadline);
 
   void UpdateTrace(bool force) override;
   void ResetBranchAndBound();
@@ -360,6 +444,21 @@ public:
     max_tree_size = _max_tree_size;
   };
 
+  /**
+   * Set the budget of one non-exhaustive Solve() call in predictive
+   * mode.  The search is suspended when either limit is reached and
+   * resumed by the next call, keeping its tree and lower bound.
+   *
+   * @param iterations the number of branch and bound iterations; zero
+   * chooses a value depending on the trace size
+   * @param duration the maximum wall time; zero means no limit
+   */
+  void SetTickBudget(unsigned iterations,
+                     std::chrono::steady_clock::duration duration) {
+    max_tick_iterations = iterations;
+    max_tick_duration = duration;
+  }
+
   /* virtual methods from AbstractContest */
   void Reset() override;
   SolverResult Solve(bool exhaustive) override;
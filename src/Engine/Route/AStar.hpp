@@ -27,7 +27,7 @@ Copyright_License {
 #include "Util/ReservablePriorityQueue.hpp"
 #include "Compiler.h"
 
-#include <unordered_map>
+#include "Util/FlatHashMap.hpp"
 
 struct AStarPriorityValue
 {
@@ -75,25 +75,32 @@ template <class Node, class Hash=std::hash<Node>,
           bool m_min=true>
 class AStar
 {
-  typedef std::unordered_map<Node, AStarPriorityValue, Hash, KeyEqual> node_value_map;
-
-  typedef typename node_value_map::iterator node_value_iterator;
-  typedef typename node_value_map::const_iterator node_value_const_iterator;
+  /**
+   * The best value found so far for a node, and the predecessor it
+   * was reached from.
+   */
+  struct NodeData {
+    AStarPriorityValue value;
+    Node parent;
 
-  typedef std::unordered_map<Node, Node, Hash, KeyEqual> node_parent_map;
+    constexpr NodeData(const AStarPriorityValue &_value, const Node &_parent)
+      :value(_value), parent(_parent) {}
+  };
 
-  typedef typename node_parent_map::iterator node_parent_iterator;
-  typedef typename node_parent_map::const_iterator node_parent_const_iterator;
+  typedef FlatHashMap<Node, NodeData, Hash, KeyEqual> NodeMap;
+  typedef typename NodeMap::size_type node_index;
 
   struct NodeValue {
     AStarPriorityValue priority;
 
-    node_value_iterator iterator;
+    /**
+     * The index of the node in #nodes.
+     */
+    node_index index;
 
     constexpr
-    NodeValue(const AStarPriorityValue &_priority,
-              node_value_iterator _iterator)
-      :priority(_priority), iterator(_iterator) {}
+    NodeValue(const AStarPriorityValue &_priority, node_index _index)
+      :priority(_priority), index(_index) {}
   };
 
   struct Rank: public std::binary_function<NodeValue, NodeValue, bool>
@@ -105,24 +112,17 @@ class AStar
   };
 
   /**
-   * Stores the value of each node.  It is updated by push(), if a
-   * value lower than the current one is found.
+   * Stores the value and the predecessor of each node.  The value is
+   * updated by Push(), if a value lower than the current one is
+   * found.  Its memory is reused by subsequent searches.
    */
-  node_value_map node_values;
-
-  /**
-   * Stores the predecessor of each node.  It is maintained by
-   * set_predecessor().
-   */
-  node_parent_map node_parents;
+  NodeMap nodes;
 
   /**
    * A sorted list of all possible node paths, lowest distance first.
    */
   reservable_priority_queue<NodeValue, std::vector<NodeValue>, Rank> q;
 
-  node_value_iterator cur;
-
 public:
   static constexpr unsigned DEFAULT_QUEUE_SIZE = 1024;
 
@@ -163,10 +163,8 @@ public:
     // Clear the search queue
     q.clear();
 
-    // Clear the node_parent_map
-    node_parents.clear();
-    // Clear the node_value_map
-    node_values.clear();
+    // Clear the node map, but keep its memory
+    nodes.clear();
   }
 
   /**
@@ -194,15 +192,15 @@ public:
    *
    * @return Node for processing
    */
-  const Node &Pop() {
-    cur = q.top().iterator;
+  Node Pop() {
+    const node_index cur = q.top().index;
 
     do { // remove this item
       q.pop();
-    } while (!q.empty() && (q.top().priority > q.top().iterator->second));
+    } while (!q.empty() && (q.top().priority > nodes[q.top().index].value.value));
     // and all lower rank than this
 
-    return cur->first;
+    return nodes[cur].key;
   }
 
   /**
@@ -227,9 +225,9 @@ public:
    */
   gcc_pure
   Node GetPredecessor(const Node &node) const {
-    // Try to find the given node in the node_parent_map
-    node_parent_const_iterator it = node_parents.find(node);
-    if (it == node_parents.end())
+    // Try to find the given node in the node map
+    const node_index i = nodes.Find(node);
+    if (i == NodeMap::NOT_FOUND)
       // first entry
       // If the node wasn't found
       // -> Return the given node itself
@@ -237,7 +235,15 @@ public:
 
     // If the node was found
     // -> Return the parent node
-    return it->second;
+    return nodes[i].value.parent;
+  }
+
+  /**
+   * Returns the number of (re)allocations of the node map, for
+   * statistics.
+   */
+  unsigned long GetAllocationCount() const {
+    return nodes.GetAllocationCount();
   }
 
   /** Reserve queue size (if available) */
@@ -251,14 +257,11 @@ public:
    */
   gcc_pure
   AStarPriorityValue GetNodeValue(const Node &node) const {
-    node_value_const_iterator it = node_values.find(node);
-    if (cur->first == node)
-      return cur->second;
-
-    if (it == node_values.end())
+    const node_index i = nodes.Find(node);
+    if (i == NodeMap::NOT_FOUND)
       return AStarPriorityValue(0);
 
-    return it->second;
+    return nodes[i].value.value;
   }
 
 private:
@@ -271,39 +274,22 @@ private:
    */
   void Push(const Node &node, const Node &parent,
             const AStarPriorityValue &edge_value) {
-    // Try to find the given node n in the node_value_map
-    node_value_iterator it = node_values.find(node);
-    if (it == node_values.end()) {
-      // first entry
-      // If the node wasn't found
-      // -> Insert a new node into the node_value_map
-      it = node_values.insert(std::make_pair(node, edge_value)).first;
-
-      // Remember the parent node
-      SetPredecessor(node, parent);
-    } else if (it->second > edge_value) {
-      // If the node was found and the new value is smaller
-      // -> Replace the value with the new one
-      it->second = edge_value;
-      // replace, it's bigger
-
-      // Remember the new parent node
-      SetPredecessor(node, parent);
-    } else
-      // If the node was found but the value is higher or equal
-      // -> Don't use this new leg
-      return;
-
-    q.push(NodeValue(edge_value, it));
-  }
+    // Try to insert the given node n into the node map
+    const auto result = nodes.Insert(node, NodeData(edge_value, parent));
+    if (!result.second) {
+      NodeData &data = nodes[result.first].value;
+      if (data.value > edge_value) {
+        // If the node was found and the new value is smaller
+        // -> Replace the value and the parent node with the new ones
+        data.value = edge_value;
+        data.parent = parent;
+      } else
+        // If the node was found but the value is higher or equal
+        // -> Don't use this new leg
+        return;
+    }
 
-  void SetPredecessor(const Node &node, const Node &parent) {
-    // Try to find the given node in the node_parent_map
-    auto result = node_parents.insert(std::make_pair(node, parent));
-    if (!result.second)
-      // If the node was found
-      // -> Replace the according parent node with the new one
-      result.first->second = parent;
+    q.push(NodeValue(edge_value, result.first));
   }
 };
 
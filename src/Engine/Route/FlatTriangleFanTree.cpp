@@ -24,6 +24,7 @@
 #include "RouteLink.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "ReachFanParms.hpp"
+#include "ReachWorkerPool.hpp"
 #include "Util/GlobalSliceAllocator.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 
@@ -81,6 +82,69 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin,
   CalcBB();
 }
 
+void
+FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin,
+                               ReachFanParms &parms, ReachWorkerPool &pool)
+{
+  gaps_filled = false;
+
+  FillReach(origin, 0, ROUTEPOLAR_POINTS, parms);
+
+  std::vector<FlatTriangleFanTree *> nodes;
+  std::vector<ChildVector> gaps;
+
+  for (parms.set_depth = 0; parms.set_depth < REACH_MAX_DEPTH;
+       ++parms.set_depth) {
+    nodes.clear();
+    CollectDepth(parms.set_depth, nodes);
+
+    /* search the gaps of all fans of this level concurrently; this
+       only reads the fans and the (const) parameters */
+    gaps.clear();
+    gaps.resize(nodes.size());
+    pool.ForEach(nodes.size(), [&nodes, &gaps, &origin, &parms](unsigned i){
+        if (!nodes[i]->gaps_filled)
+          nodes[i]->CollectGaps(origin, parms, gaps[i]);
+      });
+
+    /* merge in the order and with the limits of FillDepth() */
+    bool stop = false;
+    for (unsigned i = 0, n = nodes.size(); i < n; ++i) {
+      FlatTriangleFanTree &node = *nodes[i];
+      if (node.gaps_filled)
+        continue;
+      node.gaps_filled = true;
+
+      if (parms.vertex_counter > REACH_MAX_VERTICES ||
+          parms.fan_counter > REACH_MAX_FANS) {
+        stop = true;
+        break;
+      }
+
+      for (auto &child : gaps[i])
+        node.AddChild(std::move(child), parms);
+    }
+
+    if (stop)
+      // stop searching
+      break;
+  }
+
+  // this boundingbox update visits the tree recursively
+  CalcBB();
+}
+
+void
+FlatTriangleFanTree::CollectDepth(const unsigned char set_depth,
+                                  std::vector<FlatTriangleFanTree *> &nodes)
+{
+  if (depth == set_depth)
+    nodes.push_back(this);
+  else if (depth < set_depth)
+    for (auto &child : children)
+      child.CollectDepth(set_depth, nodes);
+}
+
 void
 FlatTriangleFanTree::DummyReach(const AFlatGeoPoint &ao)
 {
@@ -148,6 +212,27 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin, const int index_low,
 
 void
 FlatTriangleFanTree::FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms)
+{
+  ChildVector result;
+  CollectGaps(origin, parms, result);
+
+  for (auto &child : result)
+    AddChild(std::move(child), parms);
+}
+
+void
+FlatTriangleFanTree::AddChild(FlatTriangleFanTree &&child,
+                              ReachFanParms &parms)
+{
+  parms.vertex_counter += child.vs.size();
+  parms.fan_counter++;
+  children.emplace_back(std::move(child));
+}
+
+void
+FlatTriangleFanTree::CollectGaps(const AFlatGeoPoint &origin,
+                                 const ReachFanParms &parms,
+                                 ChildVector &result) const
 {
   // worth checking for gaps?
   if (vs.size() > 2 && parms.rpolars.IsTurningReachEnabled()) {
@@ -162,7 +247,7 @@ FlatTriangleFanTree::FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms)
 
       const RouteLink e(RoutePoint(*x, 0), origin, parms.projection);
       // check if children need to be added
-      CheckGap(origin, e_last, e, parms);
+      CheckGap(origin, e_last, e, parms, result);
 
       e_last = e;
     }
@@ -198,7 +283,8 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint o,
 
 bool
 FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
-                              const RouteLink &e_2, ReachFanParms &parms)
+                              const RouteLink &e_2, const ReachFanParms &parms,
+                              ChildVector &result) const
 {
   const bool side = (e_1.d > e_2.d);
   const RouteLink &e_long = (side ? e_1 : e_2);
@@ -238,9 +324,7 @@ FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
 
     FlatTriangleFanTree child(depth + 1);
     if (child.FillReach(x, index_left, index_right, parms)) {
-      parms.vertex_counter += child.vs.size();
-      parms.fan_counter++;
-      children.emplace_back(std::move(child));
+      result.emplace_back(std::move(child));
       return true;
     }
   }
@@ -28,12 +28,14 @@
 #include "FlatTriangleFan.hpp"
 
 #include <list>
+#include <vector>
 
 class FlatProjection;
 struct GeoPoint;
 struct RouteLink;
 struct AFlatGeoPoint;
 struct ReachFanParms;
+class ReachWorkerPool;
 template<typename T> struct ConstBuffer;
 
 class FlatTriangleFanVisitor {
@@ -80,6 +82,16 @@ public:
   }
 
   void FillReach(const AFlatGeoPoint &origin, ReachFanParms &parms);
+
+  /**
+   * Same as FillReach(), but search the gaps of all fans of one tree
+   * level concurrently on the given pool.  The children are merged in
+   * the same order and with the same limits as the sequential
+   * version, so the resulting tree is identical.
+   */
+  void FillReach(const AFlatGeoPoint &origin, ReachFanParms &parms,
+                 ReachWorkerPool &pool);
+
   void DummyReach(const AFlatGeoPoint &origin);
 
   /**
@@ -103,8 +115,30 @@ public:
   bool FillDepth(const AFlatGeoPoint &origin, ReachFanParms &parms);
   void FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms);
 
+private:
+  typedef std::vector<FlatTriangleFanTree> ChildVector;
+
+  /**
+   * Append all nodes of the given depth to the list, in the order in
+   * which FillDepth() visits them.
+   */
+  void CollectDepth(unsigned char set_depth,
+                    std::vector<FlatTriangleFanTree *> &nodes);
+
+  /**
+   * Search the gaps of this fan for new children without modifying
+   * this object.  This may be called from a worker thread.
+   */
+  void CollectGaps(const AFlatGeoPoint &origin, const ReachFanParms &parms,
+                   ChildVector &result) const;
+
   bool CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
-                const RouteLink &e_2, ReachFanParms &parms);
+                const RouteLink &e_2, const ReachFanParms &parms,
+                ChildVector &result) const;
+
+  void AddChild(FlatTriangleFanTree &&child, ReachFanParms &parms);
+
+public:
 
   bool FindPositiveArrival(FlatGeoPoint n,
                            const ReachFanParms &parms,
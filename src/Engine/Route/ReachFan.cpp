@@ -36,7 +36,8 @@ ReachFan::Reset()
 
 bool
 ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
-                const RasterMap* terrain, const bool do_solve)
+                const RasterMap* terrain, const bool do_solve,
+                ReachWorkerPool *pool)
 {
   Reset();
 
@@ -61,10 +62,12 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
     return false;
   }
 
-  if (do_solve)
-    root.FillReach(ao, parms);
-  else
+  if (!do_solve)
     root.DummyReach(ao);
+  else if (pool != nullptr)
+    root.FillReach(ao, parms, *pool);
+  else
+    root.FillReach(ao, parms);
 
   if (!h.IsInvalid()) {
     parms.terrain_base = h2;
@@ -29,6 +29,7 @@
 class RoutePolars;
 class RasterMap;
 class GeoBounds;
+class ReachWorkerPool;
 struct ReachResult;
 
 class ReachFan
@@ -52,8 +53,13 @@ public:
 
   void Reset();
 
+  /**
+   * @param pool if not nullptr, then the fan levels are expanded
+   * concurrently on this pool
+   */
   bool Solve(const AGeoPoint origin, const RoutePolars &rpolars,
-             const RasterMap *terrain, const bool do_solve = true);
+             const RasterMap *terrain, const bool do_solve = true,
+             ReachWorkerPool *pool = nullptr);
 
   bool FindPositiveArrival(const AGeoPoint dest, const RoutePolars &rpolars,
                            ReachResult &result_r) const;
@@ -0,0 +1,126 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ReachWorkerPool.hpp"
+#include "Thread/StandbyThread.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include <assert.h>
+
+struct ReachWorkerPool::Job {
+  const std::function<void(unsigned)> &f;
+  const unsigned n;
+
+  /**
+   * The next index to be processed; shared by all threads.
+   */
+  std::atomic<unsigned> next;
+
+  Job(const std::function<void(unsigned)> &_f, unsigned _n)
+    :f(_f), n(_n), next(0) {}
+
+  void Run() {
+    for (unsigned i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;)
+      f(i);
+  }
+};
+
+class ReachWorkerPool::Worker final : private StandbyThread {
+  Job *job = nullptr;
+
+public:
+  Worker():StandbyThread("Reach") {}
+
+  ~Worker() {
+    LockStop();
+  }
+
+  /**
+   * Begin helping with the given job.  Must be paired with a call to
+   * Wait().
+   */
+  void Start(Job &_job) {
+    const ScopeLock protect(mutex);
+    assert(job == nullptr);
+
+    job = &_job;
+    Trigger();
+  }
+
+  /**
+   * Wait until this worker has finished its share of the job
+   * submitted by Start().
+   */
+  void Wait() {
+    const ScopeLock protect(mutex);
+    WaitDone();
+
+    assert(job == nullptr);
+  }
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() override {
+    if (job == nullptr || IsStopped())
+      return;
+
+    Job &j = *job;
+
+    {
+      const ScopeUnlock unlock(mutex);
+      j.Run();
+    }
+
+    job = nullptr;
+  }
+};
+
+ReachWorkerPool::ReachWorkerPool(unsigned n_workers)
+{
+  workers.reserve(n_workers);
+  for (unsigned i = 0; i < n_workers; ++i)
+    workers.emplace_back(new Worker());
+}
+
+ReachWorkerPool::~ReachWorkerPool() {}
+
+void
+ReachWorkerPool::ForEach(unsigned n, const std::function<void(unsigned)> &f)
+{
+  if (n == 0)
+    return;
+
+  Job job(f, n);
+
+  /* don't wake up more workers than there are jobs left for the
+     calling thread to share */
+  const unsigned n_workers = std::min<unsigned>(workers.size(), n - 1);
+  for (unsigned i = 0; i < n_workers; ++i)
+    workers[i]->Start(job);
+
+  job.Run();
+
+  for (unsigned i = 0; i < n_workers; ++i)
+    workers[i]->Wait();
+}
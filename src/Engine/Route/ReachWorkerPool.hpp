@@ -0,0 +1,67 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_REACH_WORKER_POOL_HPP
+#define XCSOAR_REACH_WORKER_POOL_HPP
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * A small set of threads which help #FlatTriangleFanTree to expand
+ * the fans of one tree level concurrently.
+ *
+ * The pool is not thread-safe: only one thread may call ForEach() at
+ * a time.
+ */
+class ReachWorkerPool {
+  struct Job;
+  class Worker;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+public:
+  /**
+   * @param n_workers the number of worker threads; the calling
+   * thread participates in ForEach(), too
+   */
+  explicit ReachWorkerPool(unsigned n_workers);
+  ~ReachWorkerPool();
+
+  ReachWorkerPool(const ReachWorkerPool &) = delete;
+  ReachWorkerPool &operator=(const ReachWorkerPool &) = delete;
+
+  unsigned GetWorkerCount() const {
+    return workers.size();
+  }
+
+  /**
+   * Invoke the function for each index in [0, n), distributed over
+   * the worker threads and the calling thread, and wait until all
+   * invocations have returned.  The function must be safe to call
+   * concurrently for different indices.
+   */
+  void ForEach(unsigned n, const std::function<void(unsigned)> &f);
+};
+
+#endif
@@ -21,9 +21,31 @@
  */
 
 #include "RoutePlanner.hpp"
+#include "ReachWorkerPool.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 
+#include <stdlib.h>
+
+/**
+ * Altitude changes (m) of the search destination (the aircraft) up to
+ * this value do not trigger a new search if its location did not
+ * change.
+ */
+static constexpr int REPLAN_ALTITUDE_TOLERANCE = 5;
+
+/**
+ * Is the new search destination close enough to the previous one to
+ * keep the previous solution?
+ */
+gcc_pure
+static bool
+IsNearlySame(const AFlatGeoPoint &a, const AFlatGeoPoint &b)
+{
+  return (const FlatGeoPoint &)a == (const FlatGeoPoint &)b &&
+    abs(a.altitude - b.altitude) <= REPLAN_ALTITUDE_TOLERANCE;
+}
+
 RoutePlanner::RoutePlanner()
   :terrain(NULL), planner(0),
    unique_links(50000),
@@ -32,6 +54,17 @@ RoutePlanner::RoutePlanner()
   Reset();
 }
 
+RoutePlanner::~RoutePlanner() {}
+
+void
+RoutePlanner::SetParallel(unsigned n_workers)
+{
+  if (n_workers == 0)
+    reach_pool.reset();
+  else if (!reach_pool || reach_pool->GetWorkerCount() != n_workers)
+    reach_pool.reset(new ReachWorkerPool(n_workers));
+}
+
 void
 RoutePlanner::ClearReach()
 {
@@ -51,6 +84,7 @@ RoutePlanner::Reset()
   h_min = -1;
   h_max = 0;
   search_hull.clear();
+  terrain_cache.Clear();
   ClearReach();
 }
 
@@ -62,7 +96,8 @@ RoutePlanner::SolveReachTerrain(const AGeoPoint &origin,
   rpolars_reach.SetConfig(config, origin.altitude, h_ceiling);
   reach_polar_mode = config.reach_polar_mode;
 
-  return reach_terrain.Solve(origin, rpolars_reach, terrain, do_solve);
+  return reach_terrain.Solve(origin, rpolars_reach, terrain, do_solve,
+                            reach_pool.get());
 }
 
 bool
@@ -73,7 +108,8 @@ RoutePlanner::SolveReachWorking(const AGeoPoint &origin,
   rpolars_reach_working.SetConfig(config, origin.altitude, h_ceiling);
   // reach_polar_mode previously set by SolveReachTerrain
 
-  return reach_working.Solve(origin, rpolars_reach_working, terrain, do_solve);
+  return reach_working.Solve(origin, rpolars_reach_working, terrain,
+                            do_solve, reach_pool.get());
 }
 
 bool
@@ -81,6 +117,7 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
                     const RoutePlannerConfig &config, const int h_ceiling)
 {
   OnSolve(origin, destination);
+  terrain_cache.Validate(terrain, projection);
   rpolars_route.SetConfig(config, std::max(destination.altitude, origin.altitude),
                           h_ceiling);
 
@@ -91,7 +128,8 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
     const AFlatGeoPoint s_destination(projection.ProjectInteger(destination),
                                       destination.altitude);
 
-    if (!(s_origin == origin_last) || !(s_destination == destination_last))
+    if (!(s_origin == origin_last) ||
+        !IsNearlySame(s_destination, destination_last))
       dirty = true;
 
     if (IsTrivial())
@@ -409,7 +447,7 @@ RoutePlanner::CheckClearanceTerrain(const RouteLink &e, RoutePoint& inp) const
     return true;
 
   count_terrain++;
-  return rpolars_route.CheckClearance(e, terrain, projection, inp);
+  return terrain_cache.CheckClearance(rpolars_route, e, projection, inp);
 }
 
 void
@@ -30,13 +30,16 @@
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Geo/SearchPointVector.hpp"
 #include "ReachFan.hpp"
+#include "TerrainClearanceCache.hpp"
 
 #include <utility>
 #include <unordered_set>
+#include <memory>
 
 #include <limits.h>
 
 class GlidePolar;
+class ReachWorkerPool;
 
 /**
  * RoutePlanner is an abstract class for planning paths (routes) through
@@ -112,6 +115,8 @@ protected:
   RoutePolars rpolars_reach_working;
   /** Terrain raster */
   const RasterMap *terrain;
+  /** Terrain intersection results of previous searches */
+  mutable TerrainClearanceCache terrain_cache;
   /** Minimum height scanned during solution (m) */
   int h_min;
   /** Maxmimum height scanned during solution (m) */
@@ -146,6 +151,12 @@ private:
   ReachFan reach_terrain;
   ReachFan reach_working;
 
+  /**
+   * If set, then the reach fans are expanded concurrently on this
+   * pool.
+   */
+  std::unique_ptr<ReachWorkerPool> reach_pool;
+
   RoutePlannerConfig::Polar reach_polar_mode;
 
   mutable unsigned long count_dij;
@@ -166,6 +177,7 @@ public:
    * after initialisation.
    */
   RoutePlanner();
+  ~RoutePlanner();
 
   /**
    * Set terrain database
@@ -173,6 +185,23 @@ public:
    */
   void SetTerrain(const RasterMap *_terrain) {
     terrain = _terrain;
+    terrain_cache.Clear();
+  }
+
+  const TerrainClearanceCache &GetTerrainCache() const {
+    return terrain_cache;
+  }
+
+  /**
+   * Enable or disable concurrent reach calculation.
+   *
+   * @param n_workers the number of additional threads; 0 solves the
+   * reach in the calling thread only
+   */
+  void SetParallel(unsigned n_workers);
+
+  bool IsParallel() const {
+    return reach_pool != nullptr;
   }
 
   bool IsTerrainReachEmpty() const {
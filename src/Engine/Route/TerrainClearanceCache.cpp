@@ -0,0 +1,103 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TerrainClearanceCache.hpp"
+#include "RoutePolars.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+size_t
+TerrainClearanceCache::KeyHasher::operator()(const Key &key) const
+{
+  auto hash_point = [](const RoutePoint &p) -> size_t {
+    return (p.x * size_t(104729) + p.y) * size_t(31) + p.altitude;
+  };
+
+  uint64_t vheight_bits;
+  static_assert(sizeof(vheight_bits) == sizeof(key.vheight), "");
+  memcpy(&vheight_bits, &key.vheight, sizeof(vheight_bits));
+
+  size_t h = hash_point(key.link.first) * size_t(27644437) +
+    hash_point(key.link.second);
+  h = h * size_t(31) + size_t(vheight_bits ^ (vheight_bits >> 32));
+  h = h * size_t(31) + key.climb_ceiling;
+  return h * size_t(31) + key.safety_height;
+}
+
+void
+TerrainClearanceCache::Validate(const RasterMap *_terrain,
+                                const FlatProjection &projection)
+{
+  const GeoPoint &_center = projection.GetCenter();
+
+  if (_terrain == terrain && _center == center &&
+      (terrain == nullptr || terrain->GetSerial() == terrain_serial))
+    return;
+
+  map.clear();
+  terrain = _terrain;
+  if (terrain != nullptr)
+    terrain_serial = terrain->GetSerial();
+  center = _center;
+}
+
+bool
+TerrainClearanceCache::CheckClearance(const RoutePolars &rpolars,
+                                      const RouteLink &e,
+                                      const FlatProjection &projection,
+                                      RoutePoint &inp)
+{
+  assert(terrain != nullptr);
+  assert(projection.GetCenter() == center);
+
+  if (!rpolars.IsTerrainEnabled())
+    return true;
+
+  const Key key{e, rpolars.CalcVHeight(e),
+      rpolars.climb_ceiling, rpolars.GetSafetyHeight()};
+
+  auto i = map.find(key);
+  if (i != map.end()) {
+    ++hits;
+    if (!i->second.clear)
+      inp = i->second.intersection;
+    return i->second.clear;
+  }
+
+  ++misses;
+
+  Value value;
+  value.clear = rpolars.CheckClearance(e, terrain, projection,
+                                       value.intersection);
+
+  if (map.size() >= MAX_SIZE)
+    map.clear();
+  map.emplace(key, value);
+
+  if (!value.clear)
+    inp = value.intersection;
+  return value.clear;
+}
@@ -0,0 +1,142 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_CLEARANCE_CACHE_HPP
+#define XCSOAR_TERRAIN_CLEARANCE_CACHE_HPP
+
+#include "RouteLink.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Util/Serial.hpp"
+#include "Compiler.h"
+
+#include <unordered_map>
+
+class RoutePolars;
+class RasterMap;
+class FlatProjection;
+
+/**
+ * Remembers the results of RoutePolars::CheckClearance() across
+ * RoutePlanner::Solve() calls.  Between two fixes, most link
+ * candidates of the search are the same, and the terrain intersection
+ * is the most expensive part of the search.
+ *
+ * The key contains the link end points and all #RoutePolars values
+ * which affect the intersection test, so polar, wind or ceiling
+ * changes do not need to invalidate the cache explicitly.  The cache
+ * is flushed when the terrain or the projection changes.
+ */
+class TerrainClearanceCache {
+  /**
+   * Flush the cache when it has grown this large.
+   */
+  static constexpr unsigned MAX_SIZE = 16384;
+
+  struct Key {
+    RouteLinkBase link;
+
+    /**
+     * The glide height of the link, as returned by
+     * RoutePolars::CalcVHeight().
+     */
+    double vheight;
+
+    int climb_ceiling;
+    int safety_height;
+
+    bool operator==(const Key &other) const {
+      return link == other.link && vheight == other.vheight &&
+        climb_ceiling == other.climb_ceiling &&
+        safety_height == other.safety_height;
+    }
+  };
+
+  struct KeyHasher {
+    gcc_pure
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Value {
+    /**
+     * The return value of RoutePolars::CheckClearance().
+     */
+    bool clear;
+
+    /**
+     * The clearance point after the intersection; only valid if
+     * #clear is false.
+     */
+    RoutePoint intersection;
+  };
+
+  std::unordered_map<Key, Value, KeyHasher> map;
+
+  const RasterMap *terrain = nullptr;
+  Serial terrain_serial;
+  GeoPoint center = GeoPoint::Invalid();
+
+  unsigned long hits = 0, misses = 0;
+
+public:
+  void Clear() {
+    map.clear();
+    terrain = nullptr;
+    center.SetInvalid();
+  }
+
+  /**
+   * Flush the cache if the terrain or the projection has changed
+   * since the last call.  The caller must hold the terrain lock.
+   */
+  void Validate(const RasterMap *terrain, const FlatProjection &projection);
+
+  /**
+   * Cached version of RoutePolars::CheckClearance().  Validate()
+   * must have been called with the same terrain and projection.
+   */
+  bool CheckClearance(const RoutePolars &rpolars, const RouteLink &e,
+                      const FlatProjection &projection, RoutePoint &inp);
+
+  unsigned long GetHits() const {
+    return hits;
+  }
+
+  unsigned long GetMisses() const {
+    return misses;
+  }
+
+  /**
+   * @return the fraction of CheckClearance() calls which were served
+   * from the cache
+   */
+  gcc_pure
+  double GetHitRate() const {
+    const unsigned long total = hits + misses;
+    return total > 0 ? double(hits) / total : 0;
+  }
+
+  void ResetStatistics() {
+    hits = misses = 0;
+  }
+};
+
+#endif
@@ -226,8 +226,7 @@ public:
    * @param wp Waypoint that is visited
    */
   void Visit(const WaypointPtr &wp) override {
-    if (wp->IsLandable())
-      vector.emplace_back(wp);
+    vector.emplace_back(wp);
   }
 };
 
@@ -264,8 +263,8 @@ AbortTask::UpdateSample(const AircraftState &state,
   approx_waypoints.reserve(128);
 
   WaypointVisitorVector wvv(approx_waypoints);
-  waypoints.VisitWithinRange(state.location,
-                             GetAbortRange(state, glide_polar), wvv);
+  waypoints.VisitLandableWithinRange(state.location,
+                                     GetAbortRange(state, glide_polar), wvv);
   if (approx_waypoints.empty()) {
     /** @todo increase range */
     return false;
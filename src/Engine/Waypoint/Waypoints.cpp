@@ -125,19 +125,28 @@ Waypoints::Waypoints()
 void
 Waypoints::Optimise()
 {
-  if (waypoint_tree.IsEmpty() || waypoint_tree.HaveBounds())
-    /* empty or already optimised */
+  if (waypoint_tree.IsEmpty())
     return;
 
-  task_projection.Update();
+  if (!waypoint_tree.HaveBounds()) {
+    task_projection.Update();
 
-  for (auto &i : waypoint_tree) {
-    // TODO: eliminate this const_cast hack
-    Waypoint &w = const_cast<Waypoint &>(*i);
-    w.Project(task_projection);
+    for (auto &i : waypoint_tree) {
+      // TODO: eliminate this const_cast hack
+      Waypoint &w = const_cast<Waypoint &>(*i);
+      w.Project(task_projection);
+    }
+
+    waypoint_tree.Optimise();
   }
 
-  waypoint_tree.Optimise();
+  if (waypoint_index.empty()) {
+    waypoint_index.Build(waypoint_tree.begin(), waypoint_tree.end());
+    landable_index.BuildIf(waypoint_tree.begin(), waypoint_tree.end(),
+                           [](const WaypointPtr &wp){
+                             return wp->IsLandable();
+                           });
+  }
 }
 
 void
@@ -158,6 +167,7 @@ Waypoints::Append(WaypointPtr wp)
   task_projection.Scan(w.location);
   w.id = next_id++;
 
+  ClearIndex();
   waypoint_tree.Add(wp);
   name_tree.Add(wp);
 
@@ -171,8 +181,15 @@ Waypoints::GetNearest(const GeoPoint &loc, double range) const
     return nullptr;
 
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
-  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  if (!waypoint_index.empty()) {
+    const WaypointIndex::Point point(flat_location.x, flat_location.y);
+    const WaypointPtr *found = waypoint_index.FindNearest(point, mrange);
+    return found != nullptr ? *found : nullptr;
+  }
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const auto found = waypoint_tree.FindNearest(point, mrange);
 
   if (found.first == waypoint_tree.end())
@@ -190,7 +207,15 @@ IsLandable(const Waypoint &wp)
 WaypointPtr
 Waypoints::GetNearestLandable(const GeoPoint &loc, double range) const
 {
-  return GetNearestIf(loc, range, IsLandable);
+  if (waypoint_index.empty())
+    /* not optimised yet */
+    return GetNearestIf(loc, range, IsLandable);
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const WaypointIndex::Point point(flat_location.x, flat_location.y);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+  const WaypointPtr *found = landable_index.FindNearest(point, mrange);
+  return found != nullptr ? *found : nullptr;
 }
 
 WaypointPtr
@@ -201,12 +226,19 @@ Waypoints::GetNearestIf(const GeoPoint &loc, double range,
     return nullptr;
 
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
-  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
-  const auto found = waypoint_tree.FindNearestIf(point, mrange,
-                                                 [predicate](const WaypointPtr &ptr){
-                                                   return predicate(*ptr);
-                                                 });
+  const auto p = [predicate](const WaypointPtr &ptr){
+    return predicate(*ptr);
+  };
+
+  if (!waypoint_index.empty()) {
+    const WaypointIndex::Point point(flat_location.x, flat_location.y);
+    const WaypointPtr *found = waypoint_index.FindNearestIf(point, mrange, p);
+    return found != nullptr ? *found : nullptr;
+  }
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  const auto found = waypoint_tree.FindNearestIf(point, mrange, p);
 
   if (found.first == waypoint_tree.end())
     return nullptr;
@@ -278,14 +310,72 @@ Waypoints::VisitWithinRange(const GeoPoint &loc, const double range,
     return; // nothing to do
 
   const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
-  const WaypointTree::Point point(flat_location.x, flat_location.y);
   const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
 
   WaypointEnvelopeVisitor wve(&visitor);
 
+  if (!waypoint_index.empty()) {
+    const WaypointIndex::Point point(flat_location.x, flat_location.y);
+    waypoint_index.VisitWithinRange(point, mrange, wve);
+    return;
+  }
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
   waypoint_tree.VisitWithinRange(point, mrange, wve);
 }
 
+void
+Waypoints::VisitLandableWithinRange(const GeoPoint &loc, const double range,
+                                    WaypointVisitor &visitor) const
+{
+  if (IsEmpty())
+    return; // nothing to do
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  if (!landable_index.empty()) {
+    WaypointEnvelopeVisitor wve(&visitor);
+    const WaypointIndex::Point point(flat_location.x, flat_location.y);
+    landable_index.VisitWithinRange(point, mrange, wve);
+    return;
+  }
+
+  /* not optimised yet */
+  auto v = [&visitor](const WaypointPtr &wp){
+    if (wp->IsLandable())
+      visitor.Visit(wp);
+  };
+
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  waypoint_tree.VisitWithinRange(point, mrange, v);
+}
+
+void
+Waypoints::VisitNearest(const GeoPoint &loc, double range,
+                        unsigned max_results, WaypointVisitor &visitor) const
+{
+  VisitNearestIf(loc, range, max_results,
+                 [](const Waypoint &){ return true; }, visitor);
+}
+
+void
+Waypoints::VisitNearestLandable(const GeoPoint &loc, double range,
+                                unsigned max_results,
+                                WaypointVisitor &visitor) const
+{
+  if (waypoint_index.empty()) {
+    /* not optimised yet */
+    VisitNearestIf(loc, range, max_results, IsLandable, visitor);
+    return;
+  }
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const WaypointIndex::Point point(flat_location.x, flat_location.y);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+  landable_index.VisitNearest(point, mrange, max_results, visitor);
+}
+
 void
 Waypoints::VisitNamePrefix(const TCHAR *prefix,
                            WaypointVisitor& visitor) const
@@ -299,6 +389,7 @@ Waypoints::Clear()
   ++serial;
   home = nullptr;
   name_tree.Clear();
+  ClearIndex();
   waypoint_tree.clear();
   next_id = 1;
 }
@@ -316,6 +407,7 @@ Waypoints::Erase(WaypointPtr &&wp)
   assert(f.first != waypoint_tree.end());
 
   name_tree.Remove(std::move(wp));
+  ClearIndex();
   waypoint_tree.erase(f.first);
   ++serial;
 }
@@ -323,6 +415,8 @@ Waypoints::Erase(WaypointPtr &&wp)
 void
 Waypoints::EraseUserMarkers()
 {
+  ClearIndex();
+
   waypoint_tree.EraseIf([this](const WaypointPtr &wp){
       if (wp->origin == WaypointOrigin::USER &&
           wp->type == Waypoint::Type::MARKER) {
@@ -364,6 +458,7 @@ Waypoints::Replace(const WaypointPtr &orig, Waypoint &&replacement)
                                        });
   assert(f.first != waypoint_tree.end());
 
+  ClearIndex();
   waypoint_tree.Replace(f.first, std::move(new_ptr));
 
   ++serial;
@@ -24,12 +24,15 @@
 
 #include "Util/RadixTree.hpp"
 #include "Util/QuadTree.hpp"
+#include "Util/PackedKDTree.hpp"
 #include "Util/Serial.hpp"
 #include "Ptr.hpp"
 #include "Waypoint.hpp"
+#include "WaypointVisitor.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 
-class WaypointVisitor;
+#include <vector>
+#include <algorithm>
 
 /**
  * Container for waypoints using kd-tree representation internally for
@@ -57,6 +60,11 @@ class Waypoints {
    */
   typedef QuadTree<WaypointPtr, WaypointAccessor> WaypointTree;
 
+  /**
+   * Type of the read-only search index built by Optimise()
+   */
+  typedef PackedKDTree<WaypointPtr, WaypointAccessor> WaypointIndex;
+
   class WaypointNameTree : public RadixTree<WaypointPtr> {
   public:
     WaypointPtr Get(const TCHAR *name) const;
@@ -75,11 +83,31 @@ class Waypoints {
   unsigned next_id;
 
   WaypointTree waypoint_tree;
+
+  /**
+   * A packed copy of #waypoint_tree which answers the spatial
+   * queries.  It is built by Optimise() and cleared by each
+   * modification; until the next Optimise() call, the queries fall
+   * back to #waypoint_tree.
+   */
+  WaypointIndex waypoint_index;
+
+  /**
+   * Like #waypoint_index, but only the landable waypoints.  It is
+   * valid if #waypoint_index is not empty.
+   */
+  WaypointIndex landable_index;
+
   WaypointNameTree name_tree;
   TaskProjection task_projection;
 
   WaypointPtr home;
 
+  void ClearIndex() {
+    waypoint_index.clear();
+    landable_index.clear();
+  }
+
 public:
   typedef WaypointTree::const_iterator const_iterator;
 
@@ -169,6 +197,7 @@ public:
    * Prepare and enable the next Optimise() call.
    */
   void ScheduleOptimise() {
+    ClearIndex();
     waypoint_tree.Flatten();
     waypoint_tree.ClearBounds();
   }
@@ -297,6 +326,85 @@ public:
   void VisitWithinRange(const GeoPoint &loc, double range,
                         WaypointVisitor &visitor) const;
 
+  /**
+   * Like VisitWithinRange(), but skip waypoints which are not
+   * landable.
+   */
+  void VisitLandableWithinRange(const GeoPoint &loc, double range,
+                                WaypointVisitor &visitor) const;
+
+  /**
+   * Call visitor function on the nearest waypoints within range,
+   * nearest first.  Performs search according to flat-earth
+   * internal representation, so is approximate.
+   *
+   * @param loc Location from which to search
+   * @param range Distance in meters of search radius
+   * @param max_results The maximum number of waypoints to be visited
+   * @param visitor Visitor to be called on the waypoints
+   */
+  void VisitNearest(const GeoPoint &loc, double range, unsigned max_results,
+                    WaypointVisitor &visitor) const;
+
+  /**
+   * Like VisitNearest(), but skip waypoints which are not landable.
+   */
+  void VisitNearestLandable(const GeoPoint &loc, double range,
+                            unsigned max_results,
+                            WaypointVisitor &visitor) const;
+
+  /**
+   * Like VisitNearest(), but skip waypoints which don't match the
+   * predicate.  They don't count towards #max_results.
+   *
+   * @param predicate Function object which checks whether the
+   * waypoint is suitable for the request
+   */
+  template<typename P>
+  void VisitNearestIf(const GeoPoint &loc, double range,
+                      unsigned max_results, const P &predicate,
+                      WaypointVisitor &visitor) const {
+    if (IsEmpty() || max_results == 0)
+      return;
+
+    const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+    const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+    auto p = [&predicate](const WaypointPtr &wp){
+      return predicate(*wp);
+    };
+
+    if (!waypoint_index.empty()) {
+      const WaypointIndex::Point point(flat_location.x, flat_location.y);
+      waypoint_index.VisitNearestIf(point, mrange, max_results, p, visitor);
+      return;
+    }
+
+    /* not optimised yet: sort the result of a range query */
+    typedef std::pair<WaypointTree::distance_type, WaypointPtr> Candidate;
+    const WaypointTree::Point point(flat_location.x, flat_location.y);
+    std::vector<Candidate> found;
+    auto collect = [&found, &point, &p](const WaypointPtr &wp){
+      if (p(wp))
+        found.emplace_back(WaypointTree::GetPosition(wp)
+                           .SquareDistanceTo(point), wp);
+    };
+    waypoint_tree.VisitWithinRange(point, mrange, collect);
+
+    const auto compare = [](const Candidate &a, const Candidate &b){
+      return a.first < b.first;
+    };
+    if (found.size() > max_results) {
+      std::partial_sort(found.begin(), found.begin() + max_results,
+                        found.end(), compare);
+      found.resize(max_results);
+    } else
+      std::sort(found.begin(), found.end(), compare);
+
+    for (const auto &i : found)
+      visitor.Visit(i.second);
+  }
+
   /**
    * Call visitor function on waypoints with the specified name
    * prefix.
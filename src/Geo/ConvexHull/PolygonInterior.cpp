@@ -59,6 +59,33 @@ isLeft( const FlatGeoPoint &P0, const FlatGeoPoint &P1, const FlatGeoPoint &P2 )
 
 //===================================================================
 
+int
+PolygonEdgeWinding(const GeoPoint &P, const GeoPoint &a, const GeoPoint &b)
+{
+  // edge from current to next
+  if (a.latitude <= P.latitude) {
+    // start y <= P.latitude
+
+    if (b.latitude > P.latitude)
+      // an upward crossing
+      if (isLeft(a, b, P) > 0)
+        // P left of edge
+        // have a valid up intersect
+        return 1;
+  } else {
+    // start y > P.latitude (no test needed)
+
+    if (b.latitude <= P.latitude)
+      // a downward crossing
+      if (isLeft(a, b, P) < 0)
+        // P right of edge
+        // have a valid down intersect
+        return -1;
+  }
+
+  return 0;
+}
+
 // PolygonInterior(): winding number interior test for a point in a polygon
 //      Input:   P = a point,
 //               V[] = vertex points of a polygon V[n+1] with V[n]=V[0]
@@ -76,28 +103,9 @@ PolygonInterior(const GeoPoint &P,
 
   // loop through all edges of the polygon
   for (auto i = begin, next = std::next(i); next != end;
-       i = next, next = std::next(i)) {
-    // edge from current to next
-    if (i->GetLocation().latitude <= P.latitude) {
-      // start y <= P.latitude
+       i = next, next = std::next(i))
+    wn += PolygonEdgeWinding(P, i->GetLocation(), next->GetLocation());
 
-      if (next->GetLocation().latitude > P.latitude)
-        // an upward crossing
-        if (isLeft(i->GetLocation(), next->GetLocation(), P) > 0)
-          // P left of edge
-          // have a valid up intersect
-          ++wn;
-    } else {
-      // start y > P.latitude (no test needed)
-
-      if (next->GetLocation().latitude <= P.latitude)
-        // a downward crossing
-        if (isLeft(i->GetLocation(), next->GetLocation(), P) < 0)
-          // P right of edge
-          // have a valid down intersect
-          --wn;
-    }
-  }
   return wn != 0;
 }
 
@@ -29,6 +29,17 @@ struct GeoPoint;
 struct FlatGeoPoint;
 class SearchPoint;
 
+/**
+ * Calculate the contribution of one polygon edge (from a to b) to
+ * the winding number of the point p.  This is the building block of
+ * PolygonInterior(), for callers which select the edges themselves.
+ *
+ * @return 1 for an upward crossing with p on the left, -1 for a
+ * downward crossing with p on the right, 0 otherwise
+ */
+gcc_pure int
+PolygonEdgeWinding(const GeoPoint &p, const GeoPoint &a, const GeoPoint &b);
+
 /**
  * Note that this expects the vector to be closed, that is, starting point
  * and ending point are the same
@@ -0,0 +1,95 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_FIX_BATCH_HPP
+#define XCSOAR_IGC_FIX_BATCH_HPP
+
+#include "Geo/GeoPoint.hpp"
+
+#include <stdint.h>
+
+/**
+ * A batch of IGC "B" records in columnar layout, filled by
+ * IGCReader::Read().  Each column is a plain array, so loops over
+ * one of them (e.g. altitude statistics) touch only the memory they
+ * need and can be vectorised by the compiler.
+ *
+ * Extensions are not decoded into the batch; use IGCReader::Next()
+ * if they are needed.
+ */
+struct IGCFixBatch {
+  static constexpr unsigned CAPACITY = 1024;
+
+  unsigned size;
+
+  /**
+   * Time of the fix [seconds of day, UTC].
+   */
+  uint32_t time[CAPACITY];
+
+  /**
+   * Latitude and longitude in the native IGC resolution [1/60000
+   * degrees], negative for south/west.
+   */
+  int32_t latitude[CAPACITY], longitude[CAPACITY];
+
+  /**
+   * Altitudes [m].
+   */
+  int32_t pressure_altitude[CAPACITY], gps_altitude[CAPACITY];
+
+  /**
+   * Was this a 3D GPS fix ('A')?  Otherwise, the location is only
+   * a 2D fix or the last known one ('V').
+   */
+  bool gps_valid[CAPACITY];
+
+  bool empty() const {
+    return size == 0;
+  }
+
+  bool full() const {
+    return size == CAPACITY;
+  }
+
+  void clear() {
+    size = 0;
+  }
+
+  gcc_pure
+  static Angle ToAngle(int32_t value) {
+    const uint32_t magnitude = value < 0 ? -value : value;
+    Angle angle = Angle::Degrees(magnitude / 60000 +
+                                 (magnitude % 60000) / 60000.);
+    if (value < 0)
+      angle.Flip();
+    return angle;
+  }
+
+  gcc_pure
+  GeoPoint GetLocation(unsigned i) const {
+    return GeoPoint(ToAngle(longitude[i]), ToAngle(latitude[i]));
+  }
+};
+
+#endif
@@ -0,0 +1,350 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGCReader.hpp"
+#include "IGCFixBatch.hpp"
+#include "IGCParser.hpp"
+#include "IGCExtensions.hpp"
+#include "Util/StringAPI.hxx"
+#include "Compiler.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+/**
+ * The length of the fixed-width part of a "B" record:
+ * BHHMMSSDDMMmmmNDDDMMmmmEVPPPPPGGGGG
+ */
+static constexpr size_t B_RECORD_LENGTH = 35;
+
+/**
+ * The fixed-width part of a "B" record, decoded.
+ */
+struct RawFix {
+  unsigned time;
+  int32_t latitude, longitude;
+  int pressure_altitude, gps_altitude;
+  bool gps_valid;
+};
+
+/**
+ * Parse exactly N decimal digits.  The loop has no early exit, so the
+ * compiler can unroll it completely.
+ *
+ * @return the value or -1 if there is a non-digit character
+ */
+template<unsigned N>
+static inline int
+ParseDigits(const char *p)
+{
+  unsigned value = 0;
+  bool error = false;
+
+  for (unsigned i = 0; i < N; ++i) {
+    const unsigned digit = (unsigned char)p[i] - (unsigned)'0';
+    error |= digit > 9;
+    value = value * 10 + digit;
+  }
+
+  return gcc_likely(!error) ? int(value) : -1;
+}
+
+/**
+ * Parse a five-character altitude column, which may be negative
+ * ("-0012").
+ */
+static inline bool
+ParseAltitude(const char *p, int &value_r)
+{
+  int value;
+  if (*p == '-') {
+    value = ParseDigits<4>(p + 1);
+    if (value < 0)
+      return false;
+
+    value = -value;
+  } else {
+    value = ParseDigits<5>(p);
+    if (value < 0)
+      return false;
+  }
+
+  value_r = value;
+  return true;
+}
+
+/**
+ * Decode a latitude (N=2) or longitude (N=3) in the format
+ * DDMMmmm[NS] / DDDMMmmm[EW] to 1/60000 degrees.
+ */
+template<unsigned N>
+static inline bool
+ParseCoordinate(const char *p, unsigned max_degrees,
+                char positive, char negative, int32_t &value_r)
+{
+  const int degrees = ParseDigits<N>(p);
+  const int minutes = ParseDigits<5>(p + N);
+  if (degrees < 0 || unsigned(degrees) >= max_degrees ||
+      minutes < 0 || minutes >= 60000)
+    return false;
+
+  int32_t value = degrees * 60000 + minutes;
+
+  const char hemisphere = p[N + 5];
+  if (hemisphere == negative)
+    value = -value;
+  else if (hemisphere != positive)
+    return false;
+
+  value_r = value;
+  return true;
+}
+
+/**
+ * Decode the fixed-width part of a "B" record.  The caller must
+ * ensure that at least #B_RECORD_LENGTH characters are available.
+ *
+ * This is stricter than the sscanf() based IGCParseFix(), which is
+ * still used by the line-based callers: every column must have
+ * exactly its specified width.  Well-formed records yield the same
+ * values.
+ */
+static bool
+DecodeFix(const char *p, RawFix &fix)
+{
+  const int hour = ParseDigits<2>(p + 1);
+  const int minute = ParseDigits<2>(p + 3);
+  const int second = ParseDigits<2>(p + 5);
+  if (hour < 0 || hour >= 24 || minute < 0 || minute >= 60 ||
+      second < 0 || second >= 60)
+    return false;
+
+  fix.time = hour * 3600 + minute * 60 + second;
+
+  if (!ParseCoordinate<2>(p + 7, 90, 'N', 'S', fix.latitude) ||
+      !ParseCoordinate<3>(p + 15, 180, 'E', 'W', fix.longitude))
+    return false;
+
+  switch (p[24]) {
+  case 'A':
+    fix.gps_valid = true;
+    break;
+
+  case 'V':
+    fix.gps_valid = false;
+    break;
+
+  default:
+    return false;
+  }
+
+  return ParseAltitude(p + 25, fix.pressure_altitude) &&
+    ParseAltitude(p + 30, fix.gps_altitude);
+}
+
+/**
+ * Parse an unsigned integer column of an extension.
+ *
+ * @return the value or -1 on error
+ */
+static int
+ParseUnsigned(const char *p, const char *end)
+{
+  unsigned value = 0;
+
+  for (; p < end; ++p) {
+    const unsigned digit = (unsigned char)*p - (unsigned)'0';
+    if (digit > 9)
+      return -1;
+
+    value = value * 10 + digit;
+  }
+
+  return value;
+}
+
+const char *
+IGCReader::NextLine(size_t &length_r)
+{
+  if (position >= finish)
+    return nullptr;
+
+  const char *line = position;
+  const char *eol = (const char *)memchr(line, '\n', finish - line);
+  if (eol != nullptr) {
+    position = eol + 1;
+  } else {
+    eol = finish;
+    position = finish;
+  }
+
+  if (eol > line && eol[-1] == '\r')
+    --eol;
+
+  length_r = eol - line;
+  return line;
+}
+
+void
+IGCReader::SetExtensions(const IGCExtensions &src)
+{
+  extensions.clear();
+
+  for (const IGCExtension &i : src) {
+    int16_t IGCFix::*value;
+    uint16_t n = 0;
+
+    if (StringIsEqual(i.code, "ENL"))
+      value = &IGCFix::enl;
+    else if (StringIsEqual(i.code, "RPM"))
+      value = &IGCFix::rpm;
+    else if (StringIsEqual(i.code, "HDM"))
+      value = &IGCFix::hdm;
+    else if (StringIsEqual(i.code, "HDT"))
+      value = &IGCFix::hdt;
+    else if (StringIsEqual(i.code, "TRM"))
+      value = &IGCFix::trm;
+    else if (StringIsEqual(i.code, "TRT"))
+      value = &IGCFix::trt;
+    else if (StringIsEqual(i.code, "GSP")) {
+      value = &IGCFix::gsp;
+      n = 3;
+    } else if (StringIsEqual(i.code, "IAS")) {
+      value = &IGCFix::ias;
+      n = 3;
+    } else if (StringIsEqual(i.code, "TAS")) {
+      value = &IGCFix::tas;
+      n = 3;
+    } else if (StringIsEqual(i.code, "SIU"))
+      value = &IGCFix::siu;
+    else
+      continue;
+
+    Extension &x = extensions.append();
+    x.offset = i.start - 1;
+    x.length = i.finish - i.start + 1;
+    x.n = n;
+    x.value = value;
+  }
+}
+
+void
+IGCReader::HandleOther(const char *line, size_t length)
+{
+  if (*line != 'H' && *line != 'I')
+    return;
+
+  /* these records are rare; copy them to a null-terminated buffer
+     for the line-based parser */
+  char buffer[256];
+  length = std::min(length, sizeof(buffer) - 1);
+  memcpy(buffer, line, length);
+  buffer[length] = 0;
+
+  if (*line == 'H') {
+    BrokenDate new_date;
+    if (IGCParseDateRecord(buffer, new_date))
+      date = new_date;
+  } else {
+    IGCExtensions new_extensions;
+    if (IGCParseExtensions(buffer, new_extensions))
+      SetExtensions(new_extensions);
+  }
+}
+
+bool
+IGCReader::Next(IGCFix &fix)
+{
+  size_t length;
+  const char *line;
+  while ((line = NextLine(length)) != nullptr) {
+    if (*line != 'B') {
+      if (length > 0)
+        HandleOther(line, length);
+      continue;
+    }
+
+    RawFix raw;
+    if (length < B_RECORD_LENGTH || !DecodeFix(line, raw))
+      continue;
+
+    fix.time = BrokenTime::FromSecondOfDay(raw.time);
+    fix.location = GeoPoint(IGCFixBatch::ToAngle(raw.longitude),
+                            IGCFixBatch::ToAngle(raw.latitude));
+    fix.gps_valid = raw.gps_valid;
+    fix.pressure_altitude = raw.pressure_altitude;
+    fix.gps_altitude = raw.gps_altitude;
+
+    fix.ClearExtensions();
+
+    for (const Extension &x : extensions) {
+      if (x.offset + x.length > length)
+        /* exceeds the input line length */
+        continue;
+
+      if (x.n > 0 && x.n > x.length)
+        /* column is too short */
+        continue;
+
+      const char *p = line + x.offset;
+      const int value = ParseUnsigned(p, p + (x.n > 0 ? x.n : x.length));
+      if (value >= 0)
+        fix.*x.value = value;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+unsigned
+IGCReader::Read(IGCFixBatch &batch)
+{
+  batch.clear();
+
+  size_t length;
+  const char *line;
+  while (!batch.full() && (line = NextLine(length)) != nullptr) {
+    if (*line != 'B') {
+      if (length > 0)
+        HandleOther(line, length);
+      continue;
+    }
+
+    RawFix raw;
+    if (length < B_RECORD_LENGTH || !DecodeFix(line, raw))
+      continue;
+
+    const unsigned i = batch.size++;
+    batch.time[i] = raw.time;
+    batch.latitude[i] = raw.latitude;
+    batch.longitude[i] = raw.longitude;
+    batch.pressure_altitude[i] = raw.pressure_altitude;
+    batch.gps_altitude[i] = raw.gps_altitude;
+    batch.gps_valid[i] = raw.gps_valid;
+  }
+
+  return batch.size;
+}
@@ -0,0 +1,192 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_READER_HPP
+#define XCSOAR_IGC_READER_HPP
+
+#include "IGCFix.hpp"
+#include "Time/BrokenDate.hpp"
+#include "Util/StringView.hxx"
+#include "Util/TrivialArray.hxx"
+
+#include <iterator>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct IGCFixBatch;
+struct IGCExtensions;
+
+/**
+ * Reads "B" records from an IGC file which is in memory as a whole,
+ * usually mapped with #FileMapping.  Unlike IGCParseFix(), the
+ * buffer is never copied and does not need to be null-terminated,
+ * and the fixed-width part of each record is decoded at constant
+ * offsets without sscanf().
+ *
+ * "HFDTE" and "I" records are evaluated while scanning; the latest
+ * date can be obtained with GetDate().
+ */
+class IGCReader {
+  /**
+   * An extension from the "I" record, resolved to its position in
+   * the "B" record and the #IGCFix attribute it is stored in.
+   */
+  struct Extension {
+    /**
+     * Offset of the first character in the "B" record.
+     */
+    uint16_t offset;
+
+    uint16_t length;
+
+    /**
+     * Parse only this many characters (see ParseExtensionValueN() in
+     * IGCParser.cpp); 0 means the whole column.
+     */
+    uint16_t n;
+
+    int16_t IGCFix::*value;
+  };
+
+  const char *const start, *const finish;
+
+  const char *position;
+
+  BrokenDate date;
+
+  TrivialArray<Extension, 16> extensions;
+
+public:
+  explicit IGCReader(StringView buffer)
+    :start(buffer.begin()), finish(buffer.end()), position(start),
+     date(BrokenDate::Invalid()) {
+    extensions.clear();
+  }
+
+  /**
+   * Returns the total size of the buffer in bytes.
+   */
+  size_t GetSize() const {
+    return finish - start;
+  }
+
+  /**
+   * Returns the number of bytes consumed so far.
+   */
+  size_t Tell() const {
+    return position - start;
+  }
+
+  /**
+   * Returns the date from the most recent "HFDTE" record, or
+   * BrokenDate::Invalid() if none was seen yet.
+   */
+  const BrokenDate &GetDate() const {
+    return date;
+  }
+
+  /**
+   * Read the next valid "B" record, including its extensions.
+   *
+   * @return false at the end of the buffer
+   */
+  bool Next(IGCFix &fix);
+
+  /**
+   * Fill the batch with the following valid "B" records (without
+   * extensions) until it is full or the end of the buffer has been
+   * reached.
+   *
+   * @return the number of fixes in the batch; 0 at the end of the
+   * buffer
+   */
+  unsigned Read(IGCFixBatch &batch);
+
+  /**
+   * Iterates over the remaining fixes, as returned by Next().
+   */
+  class const_iterator {
+    IGCReader *reader;
+    IGCFix fix;
+
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef IGCFix value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const IGCFix *pointer;
+    typedef const IGCFix &reference;
+
+    const_iterator():reader(nullptr) {}
+
+    explicit const_iterator(IGCReader &_reader):reader(&_reader) {
+      ++*this;
+    }
+
+    const_iterator &operator++() {
+      if (!reader->Next(fix))
+        reader = nullptr;
+      return *this;
+    }
+
+    reference operator*() const {
+      return fix;
+    }
+
+    pointer operator->() const {
+      return &fix;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return reader == other.reader;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return reader != other.reader;
+    }
+  };
+
+  const_iterator begin() {
+    return const_iterator(*this);
+  }
+
+  const_iterator end() {
+    return const_iterator();
+  }
+
+private:
+  /**
+   * Returns the next line (without the line terminator), or nullptr
+   * at the end of the buffer.
+   */
+  const char *NextLine(size_t &length_r);
+
+  /**
+   * Evaluate a record which is not a "B" record.
+   */
+  void HandleOther(const char *line, size_t length);
+
+  void SetExtensions(const IGCExtensions &src);
+};
+
+#endif
@@ -25,6 +25,7 @@ Copyright_License {
 #define XCSOAR_CSV_LINE_HPP
 
 #include "Util/Range.hpp"
+#include "Util/StringView.hxx"
 
 #include <stddef.h>
 
@@ -35,6 +36,9 @@ class CSVLine {
 protected:
   const char *data, *end;
 
+  CSVLine(const char *_data, const char *_end)
+    :data(_data), end(_end) {}
+
 public:
   CSVLine(const char *line);
 
@@ -61,6 +65,16 @@ public:
       Skip();
   }
 
+  /**
+   * Read a column without copying it.  The returned string is not
+   * null-terminated.
+   */
+  StringView ReadView() {
+    const char *start = data;
+    size_t length = Skip();
+    return StringView(start, length);
+  }
+
   char ReadFirstChar();
 
   /**
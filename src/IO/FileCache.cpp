@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "FileCache.hpp"
 #include "OS/FileUtil.hpp"
+#include "OS/FileMapping.hpp"
 #include "Compiler.h"
 
 #include <stdint.h>
@@ -35,7 +36,16 @@ Copyright_License {
 #include <windows.h>
 #endif
 
-static constexpr unsigned FILE_CACHE_MAGIC = 0xab352f8a;
+/**
+ * The header magic.  It was changed when the number of original
+ * files was added to the header.
+ */
+static constexpr unsigned FILE_CACHE_MAGIC = 0xab352f8b;
+
+/**
+ * The maximum number of original files a cache may depend on.
+ */
+static constexpr unsigned MAX_ORIGINALS = 8;
 
 #ifndef HAVE_POSIX
 
@@ -106,49 +116,110 @@ FileCache::Flush(const TCHAR *name)
 FILE *
 FileCache::Load(const TCHAR *name, Path original_path)
 {
-  FileInfo original_info;
-  if (!GetRegularFileInfo(original_path, original_info))
+  return Load(name, ConstBuffer<Path>(&original_path, 1));
+}
+
+FILE *
+FileCache::Load(const TCHAR *name, ConstBuffer<Path> original_paths)
+{
+  FileInfo original_info[MAX_ORIGINALS];
+  if (original_paths.size > MAX_ORIGINALS)
     return nullptr;
 
+  for (unsigned i = 0; i < original_paths.size; ++i)
+    if (!GetRegularFileInfo(original_paths[i], original_info[i]))
+      return nullptr;
+
   const auto path = MakeCachePath(name);
 
   FileInfo cached_info;
   if (!GetRegularFileInfo(path, cached_info))
     return nullptr;
 
-  /* if the original file is newer than the cache, discard the cache -
+  /* if an original file is newer than the cache, discard the cache -
      unless the system clock is skewed (origina file's modification
      time is in the future) */
-  if (original_info.mtime > cached_info.mtime && !original_info.IsFuture()) {
-    File::Delete(path);
-    return nullptr;
+  for (unsigned i = 0; i < original_paths.size; ++i) {
+    if (original_info[i].mtime > cached_info.mtime &&
+        !original_info[i].IsFuture()) {
+      File::Delete(path);
+      return nullptr;
+    }
   }
 
   FILE *file = _tfopen(path.c_str(), _T("rb"));
   if (file == nullptr)
     return nullptr;
 
-  unsigned magic;
-  struct FileInfo old_info;
+  unsigned magic, n_originals;
   if (fread(&magic, sizeof(magic), 1, file) != 1 ||
       magic != FILE_CACHE_MAGIC ||
-      fread(&old_info, sizeof(old_info), 1, file) != 1 ||
-      old_info != original_info) {
+      fread(&n_originals, sizeof(n_originals), 1, file) != 1 ||
+      n_originals != original_paths.size) {
     fclose(file);
     File::Delete(path);
     return nullptr;
   }
 
+  for (unsigned i = 0; i < original_paths.size; ++i) {
+    struct FileInfo old_info;
+    if (fread(&old_info, sizeof(old_info), 1, file) != 1 ||
+        old_info != original_info[i]) {
+      fclose(file);
+      File::Delete(path);
+      return nullptr;
+    }
+  }
+
   return file;
 }
 
+FileMapping *
+FileCache::Map(const TCHAR *name, Path original_path, size_t &offset_r)
+{
+  return Map(name, ConstBuffer<Path>(&original_path, 1), offset_r);
+}
+
+FileMapping *
+FileCache::Map(const TCHAR *name, ConstBuffer<Path> original_paths,
+               size_t &offset_r)
+{
+  FILE *file = Load(name, original_paths);
+  if (file == nullptr)
+    return nullptr;
+
+  const long offset = ftell(file);
+  fclose(file);
+  if (offset < 0)
+    return nullptr;
+
+  FileMapping *mapping = new FileMapping(MakeCachePath(name));
+  if (mapping->error() || mapping->size() < size_t(offset)) {
+    delete mapping;
+    return nullptr;
+  }
+
+  offset_r = offset;
+  return mapping;
+}
+
 FILE *
 FileCache::Save(const TCHAR *name, Path original_path)
 {
-  FileInfo original_info;
-  if (!GetRegularFileInfo(original_path, original_info))
+  return Save(name, ConstBuffer<Path>(&original_path, 1));
+}
+
+FILE *
+FileCache::Save(const TCHAR *name, ConstBuffer<Path> original_paths)
+{
+  FileInfo original_info[MAX_ORIGINALS];
+  if (original_paths.size > MAX_ORIGINALS)
     return nullptr;
 
+  for (unsigned i = 0; i < original_paths.size; ++i)
+    if (!GetRegularFileInfo(original_paths[i], original_info[i]))
+      return nullptr;
+
   Directory::Create(cache_path);
 
   const auto path = MakeCachePath(name);
@@ -158,8 +229,11 @@ FileCache::Save(const TCHAR *name, Path original_path)
   if (file == nullptr)
     return nullptr;
 
+  const unsigned n_originals = original_paths.size;
   if (fwrite(&FILE_CACHE_MAGIC, sizeof(FILE_CACHE_MAGIC), 1, file) != 1 ||
-      fwrite(&original_info, sizeof(original_info), 1, file) != 1) {
+      fwrite(&n_originals, sizeof(n_originals), 1, file) != 1 ||
+      fwrite(original_info, sizeof(original_info[0]), original_paths.size,
+             file) != original_paths.size) {
     fclose(file);
     File::Delete(path);
     return nullptr;
@@ -25,10 +25,13 @@ Copyright_License {
 #define XCSOAR_FILE_CACHE_HPP
 
 #include "OS/Path.hpp"
+#include "Util/ConstBuffer.hxx"
 
 #include <stdio.h>
 #include <tchar.h>
 
+class FileMapping;
+
 class FileCache {
   AllocatedPath cache_path;
 
@@ -45,7 +48,28 @@ public:
   void Flush(const TCHAR *name);
   FILE *Load(const TCHAR *name, Path original_path);
 
+  /**
+   * Like Load(), but the cache depends on several original files.
+   * It is discarded if any of them has been modified, or if the list
+   * of files has changed.
+   */
+  FILE *Load(const TCHAR *name, ConstBuffer<Path> original_paths);
+
+  /**
+   * Like Load(), but map the cache file into memory instead of
+   * opening a stream.
+   *
+   * @param offset_r on success, the offset of the cached data within
+   * the mapping is returned here
+   * @return a new #FileMapping (to be deleted by the caller) or
+   * nullptr on error
+   */
+  FileMapping *Map(const TCHAR *name, Path original_path, size_t &offset_r);
+  FileMapping *Map(const TCHAR *name, ConstBuffer<Path> original_paths,
+                   size_t &offset_r);
+
   FILE *Save(const TCHAR *name, Path original_path);
+  FILE *Save(const TCHAR *name, ConstBuffer<Path> original_paths);
   bool Commit(const TCHAR *name, FILE *file);
   void Cancel(const TCHAR *name, FILE *file);
 };
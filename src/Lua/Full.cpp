@@ -40,6 +40,7 @@ Copyright_License {
 #include "Settings.hpp"
 #include "Wind.hpp"
 #include "Logger.hpp"
+#include "Timing.hpp"
 #include "Tracking.hpp"
 #include "Replay.hpp"
 #include "InputEvent.hpp"
@@ -61,6 +62,7 @@ Lua::NewFullState()
   InitSettings(L);
   InitWind(L);
   InitLogger(L);
+  InitTiming(L);
   InitTracking(L);
   InitReplay(L);
   InitInputEvent(L);
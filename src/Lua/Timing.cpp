@@ -0,0 +1,148 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Timing.hpp"
+#include "Util.hxx"
+#include "Util/StringAPI.hxx"
+#include "Components.hpp"
+#include "Computer/GlideComputer.hpp"
+
+extern "C" {
+#include <lauxlib.h>
+}
+
+static ComputerProfiler *
+GetProfiler()
+{
+  return glide_computer != nullptr
+    ? &glide_computer->GetProfiler()
+    : nullptr;
+}
+
+/**
+ * Push a table with the summary of one stage; all durations are in
+ * microseconds.
+ */
+static void
+PushSummary(lua_State *L, const ComputerProfiler::Summary &summary)
+{
+  lua_newtable(L);
+  Lua::SetField(L, -2, "count", (int)summary.count);
+  Lua::SetField(L, -2, "min", (int)summary.min);
+  Lua::SetField(L, -2, "avg", (int)summary.average);
+  Lua::SetField(L, -2, "p99", (int)summary.p99);
+  Lua::SetField(L, -2, "max", (int)summary.max);
+}
+
+static int
+l_timing_index(lua_State *L)
+{
+  const ComputerProfiler *profiler = GetProfiler();
+  if (profiler == nullptr)
+    return 0;
+
+  const char *name = lua_tostring(L, 2);
+  if (name == nullptr)
+    return 0;
+  else if (StringIsEqual(name, "enabled")) {
+    Lua::Push(L, profiler->IsEnabled());
+    return 1;
+  }
+
+  /* all other names are stages, e.g. "contest" */
+  for (unsigned i = 0; i < ComputerProfiler::N_STAGES; ++i) {
+    const auto stage = ComputerProfiler::Stage(i);
+    if (StringIsEqual(name, ComputerProfiler::GetStageName(stage))) {
+      PushSummary(L, profiler->GetSummary(stage));
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static int
+l_timing_enable(lua_State *L)
+{
+  if (lua_gettop(L) != 0)
+    return luaL_error(L, "Invalid parameters");
+
+  ComputerProfiler *profiler = GetProfiler();
+  if (profiler != nullptr && !profiler->IsEnabled()) {
+    profiler->Reset();
+    profiler->SetEnabled(true);
+  }
+
+  return 0;
+}
+
+static int
+l_timing_disable(lua_State *L)
+{
+  if (lua_gettop(L) != 0)
+    return luaL_error(L, "Invalid parameters");
+
+  ComputerProfiler *profiler = GetProfiler();
+  if (profiler != nullptr)
+    profiler->SetEnabled(false);
+
+  return 0;
+}
+
+static int
+l_timing_reset(lua_State *L)
+{
+  if (lua_gettop(L) != 0)
+    return luaL_error(L, "Invalid parameters");
+
+  ComputerProfiler *profiler = GetProfiler();
+  if (profiler != nullptr)
+    profiler->Reset();
+
+  return 0;
+}
+
+static constexpr struct luaL_Reg timing_funcs[] = {
+  {"enable", l_timing_enable},
+  {"disable", l_timing_disable},
+  {"reset", l_timing_reset},
+  {nullptr, nullptr}
+};
+
+void
+Lua::InitTiming(lua_State *L)
+{
+  lua_getglobal(L, "xcsoar");
+
+  lua_newtable(L);
+
+  lua_newtable(L);
+  SetField(L, -2, "__index", l_timing_index);
+  lua_setmetatable(L, -2);
+
+  luaL_setfuncs(L, timing_funcs, 0);
+
+  lua_setfield(L, -2, "timing");
+
+  lua_pop(L, 1);
+}
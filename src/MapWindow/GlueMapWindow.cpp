@@ -133,9 +133,11 @@ GlueMapWindow::ExchangeBlackboard()
   /* copy device_blackboard to MapWindow */
 
   {
-    const ScopeLock lock(device_blackboard->mutex);
-    ReadBlackboard(device_blackboard->Basic(),
-                   device_blackboard->Calculated());
+    const SnapshotBuffer<MoreData>::Reader
+      basic(device_blackboard->GetPublishedBasic());
+    const SnapshotBuffer<DerivedInfo>::Reader
+      calculated(device_blackboard->GetPublishedCalculated());
+    ReadBlackboard(*basic, *calculated);
   }
 
 #ifndef ENABLE_OPENGL
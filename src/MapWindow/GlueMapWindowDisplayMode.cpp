@@ -115,8 +115,15 @@ GlueMapWindow::UpdateScreenBounds()
 
   if (topography_thread != nullptr &&
       visible_projection.IsValid() &&
-      CommonInterface::GetMapSettings().topography_enabled)
-    topography_thread->Trigger(visible_projection);
+      CommonInterface::GetMapSettings().topography_enabled) {
+    /* let the thread load the region ahead of the aircraft */
+    const NMEAInfo &basic = CommonInterface::Basic();
+    if (basic.track_available && basic.MovementDetected())
+      topography_thread->Trigger(visible_projection,
+                                 basic.track, basic.ground_speed);
+    else
+      topography_thread->Trigger(visible_projection);
+  }
 
   /* always service terrain even if it's not used by the map, because
      it's used by other calculations, therefore don't check if terrain
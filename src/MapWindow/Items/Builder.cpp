@@ -114,7 +114,8 @@ void
 MapItemListBuilder::AddWaypoints(const Waypoints &waypoints)
 {
   WaypointListBuilderVisitor waypoint_list_builder(list);
-  waypoints.VisitWithinRange(location, range, waypoint_list_builder);
+  waypoints.VisitNearest(location, range, list.capacity() - list.size(),
+                         waypoint_list_builder);
 }
 
 void
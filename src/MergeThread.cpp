@@ -49,13 +49,27 @@ MergeThread::Process()
     device_blackboard.GetComputerSettings();
 
   computer.Fill(device_blackboard.SetMoreData(), settings_computer);
-  computer.Compute(device_blackboard.SetMoreData(), last_any, last_fix,
-                   device_blackboard.Calculated());
+
+  {
+    const SnapshotBuffer<DerivedInfo>::Reader
+      calculated(device_blackboard.GetPublishedCalculated());
+    computer.Compute(device_blackboard.SetMoreData(), last_any, last_fix,
+                     *calculated);
+  }
 
   flarm_computer.Process(device_blackboard.SetBasic().flarm,
                          last_fix.flarm, basic);
 }
 
+void
+MergeThread::FirstRun()
+{
+  assert(!IsDefined());
+
+  Process();
+  device_blackboard.PublishBasic();
+}
+
 void
 MergeThread::Tick()
 {
@@ -67,7 +81,8 @@ MergeThread::Tick()
 #endif
 
   {
-    ScopeLock protect(device_blackboard.mutex);
+    const TimedScopeLock protect(device_blackboard.mutex,
+                                 device_blackboard.statistics.merge_lock);
 
     Process();
 
@@ -101,6 +116,10 @@ MergeThread::Tick()
       last_fix = basic;
   }
 
+  /* this thread is the only one which modifies the merged data, so
+     it can be copied to the readers without holding the lock */
+  device_blackboard.PublishBasic();
+
 #ifdef HAVE_PCM_PLAYER
   if (vario_available)
     AudioVarioGlue::SetValue(vario);
@@ -60,11 +60,7 @@ public:
    * This method is called during XCSoar startup, for the initial run
    * of the MergeThread.
    */
-  void FirstRun() {
-    assert(!IsDefined());
-
-    Process();
-  }
+  void FirstRun();
 
   bool Start(bool suspended=false) {
     if (!WorkerThread::Start(suspended))
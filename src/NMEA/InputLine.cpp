@@ -23,12 +23,53 @@ Copyright_License {
 
 #include "NMEA/InputLine.hpp"
 
-#include <string.h>
+#include <stdlib.h>
+
+/**
+ * Parse the hexadecimal checksum after the asterisk, like
+ * VerifyNMEAChecksum() does.
+ *
+ * @return the checksum or -1 if it is malformed
+ */
+static int
+ParseChecksum(const char *p)
+{
+  char *endptr;
+  unsigned long value = strtoul(p, &endptr, 16);
+  if (endptr == p || *endptr != 0 || value >= 0x100)
+    return -1;
+
+  return value;
+}
 
 NMEAInputLine::NMEAInputLine(const char* line):
-  CSVLine(line)
+  CSVLine(line, line)
 {
-  const char* asterisk = strchr(line, '*');
-  if (asterisk != NULL)
-    end = asterisk;
+  const char *p = line;
+
+  /* skip the dollar sign at the beginning (the exclamation mark is
+     used by CAI302); see NMEAChecksum() */
+  if (*p == '$' || *p == '!')
+    ++p;
+
+  /* the data ends at the first asterisk, but the checksum follows the
+     last one */
+  const char *first_asterisk = nullptr, *last_asterisk = nullptr;
+  uint8_t checksum = 0, checksum_before_asterisk = 0;
+
+  for (; *p != 0; ++p) {
+    if (*p == '*') {
+      if (first_asterisk == nullptr)
+        first_asterisk = p;
+
+      last_asterisk = p;
+      checksum_before_asterisk = checksum;
+    }
+
+    checksum ^= *p;
+  }
+
+  end = first_asterisk != nullptr ? first_asterisk : p;
+  valid_checksum = last_asterisk != nullptr &&
+    ParseChecksum(last_asterisk + 1) == checksum_before_asterisk;
 }
@@ -25,13 +25,36 @@ Copyright_License {
 #define XCSOAR_NMEA_INPUT_LINE_HPP
 
 #include "IO/CSVLine.hpp"
+#include "NMEA/SentenceHash.hpp"
 
 /**
  * A helper class which can dissect a NMEA input line.
+ *
+ * The constructor scans the line only once: it locates the end of
+ * the data (the asterisk) and verifies the checksum at the same time,
+ * so parsers do not need to call VerifyNMEAChecksum() separately.
  */
 class NMEAInputLine: public CSVLine {
+  bool valid_checksum;
+
 public:
   NMEAInputLine(const char* line);
+
+  /**
+   * Does the line end with a correct checksum?  This has the same
+   * semantics as VerifyNMEAChecksum().
+   */
+  bool HasValidChecksum() const {
+    return valid_checksum;
+  }
+
+  /**
+   * Read the first column (the sentence identifier including the
+   * '$') and return its NMEASentenceHash().
+   */
+  uint64_t ReadSentenceHash() {
+    return NMEASentenceHash(ReadView());
+  }
 };
 
 #endif
@@ -0,0 +1,82 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_NMEA_SENTENCE_HASH_HPP
+#define XCSOAR_NMEA_SENTENCE_HASH_HPP
+
+#include "Util/StringView.hxx"
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Pack an NMEA sentence identifier (the first column, e.g.
+ * "$GPRMC") into an integer.  Identifiers with up to 8 characters
+ * map to distinct non-zero values, i.e. this is a perfect hash for
+ * all sentence identifiers we know.  It can be evaluated at compile
+ * time, which allows dispatching with a "switch" statement instead
+ * of a chain of string comparisons:
+ *
+ *   switch (line.ReadSentenceHash()) {
+ *   case NMEASentenceHash("$PFLAU"):
+ *     ...
+ *   }
+ *
+ * The compiler builds the lookup table, and it rejects duplicate
+ * "case" labels.
+ *
+ * @return the hash, or 0 if the identifier is empty or longer than
+ * 8 characters (which never equals a valid hash)
+ */
+constexpr uint64_t
+NMEASentenceHash(const char *p, size_t length)
+{
+  if (length == 0 || length > 8)
+    return 0;
+
+  uint64_t hash = 0;
+  for (size_t i = 0; i < length; ++i)
+    hash = (hash << 8) | (uint8_t)p[i];
+
+  return hash;
+}
+
+static inline uint64_t
+NMEASentenceHash(StringView id)
+{
+  return NMEASentenceHash(id.data, id.size);
+}
+
+/**
+ * Overload for string literals; it refuses to compile identifiers
+ * which do not fit.
+ */
+template<size_t N>
+constexpr uint64_t
+NMEASentenceHash(const char (&id)[N])
+{
+  static_assert(N >= 2 && N <= 9, "Unsupported NMEA sentence identifier");
+  return NMEASentenceHash(id, N - 1);
+}
+
+#endif
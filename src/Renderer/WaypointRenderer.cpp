@@ -389,6 +389,13 @@ public:
     task_valid = true;
   }
 
+  /**
+   * The number of waypoints which can still be added.
+   */
+  unsigned GetRemaining() const {
+    return waypoints.capacity() - waypoints.size();
+  }
+
   void CalculateRoute(const ProtectedRoutePlanner &route_planner) {
     const ProtectedRoutePlanner::Lease lease(route_planner);
 
@@ -483,8 +490,15 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
       atask->AcceptTaskPointVisitor(v);
   }
 
-  way_points->VisitWithinRange(projection.GetGeoScreenCenter(),
-                                 projection.GetScreenDistanceMeters(), v);
+  /* if there are more waypoints on the screen than we can draw,
+     prefer the ones near the screen center */
+  way_points->VisitNearestIf(projection.GetGeoScreenCenter(),
+                             projection.GetScreenDistanceMeters(),
+                             v.GetRemaining(),
+                             [&projection](const Waypoint &wp){
+                               return projection.WaypointInScaleFilter(wp) &&
+                                 projection.GeoVisible(wp.location);
+                             }, v);
 
   v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
 
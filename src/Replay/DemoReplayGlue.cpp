@@ -34,19 +34,31 @@ DemoReplayGlue::DemoReplayGlue(ProtectedTaskManager &_task_manager)
   ProtectedTaskManager::ExclusiveLease protected_task_manager(*task_manager);
   const TaskAccessor ta(protected_task_manager, 0);
   parms.SetRealistic();
-  parms.start_alt = device_blackboard->Basic().nav_altitude;
-  DemoReplay::Start(ta, device_blackboard->Basic().location);
+  {
+    const SnapshotBuffer<MoreData>::Reader
+      basic(device_blackboard->GetPublishedBasic());
+    parms.start_alt = basic->nav_altitude;
+    DemoReplay::Start(ta, basic->location);
+  }
 
   // get wind from aircraft
-  aircraft.GetState().wind = device_blackboard->Calculated().GetWindOrZero();
+  {
+    const SnapshotBuffer<DerivedInfo>::Reader
+      calculated(device_blackboard->GetPublishedCalculated());
+    aircraft.GetState().wind = calculated->GetWindOrZero();
+  }
 }
 
 bool
 DemoReplayGlue::Update(NMEAInfo &data)
 {
   double floor_alt = 300;
-  if (device_blackboard->Calculated().terrain_valid) {
-    floor_alt += device_blackboard->Calculated().terrain_altitude;
+
+  {
+    const SnapshotBuffer<DerivedInfo>::Reader
+      calculated(device_blackboard->GetPublishedCalculated());
+    if (calculated->terrain_valid)
+      floor_alt += calculated->terrain_altitude;
   }
 
   bool retval;
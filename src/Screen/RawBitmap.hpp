@@ -161,6 +161,18 @@ public:
 #endif
   }
 
+  /**
+   * Returns a pointer to the specified row.
+   */
+  RawColor *GetRow(unsigned y) {
+#ifndef USE_GDI
+    return GetBuffer() + y * corrected_width;
+#else
+    /* in WIN32 bitmaps, the bottom-most row comes first */
+    return GetBuffer() + (height - 1 - y) * corrected_width;
+#endif
+  }
+
   /**
    * Returns a pointer to the row below the current one.
    */
@@ -332,7 +332,7 @@ Startup()
 
   // Read the topography file(s)
   topography = new TopographyStore();
-  LoadConfiguredTopography(*topography, operation);
+  LoadConfiguredTopography(*topography, operation, file_cache);
 
   // Read the waypoint files
   WaypointGlue::LoadWaypoints(way_points, terrain, operation);
@@ -348,6 +348,7 @@ Startup()
 
   // ReSynchronise the blackboards here since SetHome touches them
   device_blackboard->Merge();
+  device_blackboard->PublishBasic();
   CommonInterface::ReadBlackboardBasic(device_blackboard->Basic());
 
   // Scan for weather forecast
@@ -357,12 +358,13 @@ Startup()
 
   // Reads the airspace files
   ReadAirspace(airspace_database, terrain, computer_settings.pressure,
-               operation);
+               operation, file_cache);
 
   {
+    const SnapshotBuffer<DerivedInfo>::Reader
+      calculated(device_blackboard->GetPublishedCalculated());
     const AircraftState aircraft_state =
-      ToAircraftState(device_blackboard->Basic(),
-                      device_blackboard->Calculated());
+      ToAircraftState(device_blackboard->Basic(), *calculated);
     ProtectedAirspaceWarningManager::ExclusiveLease lease(glide_computer->GetAirspaceWarnings());
     lease->Reset(aircraft_state);
   }
@@ -562,6 +564,8 @@ Shutdown()
     calculation_thread = nullptr;
   }
 
+  device_blackboard->statistics.Log();
+
   //  Wait for the drawing thread to finish
 #ifndef ENABLE_OPENGL
   LogFormat("Waiting for draw thread");
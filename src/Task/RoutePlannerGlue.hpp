@@ -38,6 +38,13 @@ public:
 
   void SetTerrain(const RasterTerrain *terrain);
 
+  /**
+   * @see RoutePlanner::SetParallel()
+   */
+  void SetParallel(unsigned n_workers) {
+    planner.SetParallel(n_workers);
+  }
+
   void UpdatePolar(const GlideSettings &settings,
                    const RoutePlannerConfig &config,
                    const GlidePolar &polar,
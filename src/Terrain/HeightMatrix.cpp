@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "HeightMatrix.hpp"
 #include "RasterMap.hpp"
+#include "Screen/Point.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
@@ -30,7 +31,11 @@ Copyright_License {
 #include "Projection/WindowProjection.hpp"
 #endif
 
+#include <algorithm>
+#include <cstdlib>
+
 #include <assert.h>
+#include <string.h>
 
 void
 HeightMatrix::SetSize(size_t _size)
@@ -96,4 +101,74 @@ HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
   }
 }
 
+void
+HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
+                   unsigned quantisation_pixels, const PixelRect &rect,
+                   bool interpolate)
+{
+  const unsigned screen_width = projection.GetScreenWidth();
+
+  assert(width ==
+         (screen_width + quantisation_pixels - 1) / quantisation_pixels);
+  assert(height ==
+         (projection.GetScreenHeight() + quantisation_pixels - 1) /
+         quantisation_pixels);
+  assert(rect.left >= 0 && rect.left < rect.right);
+  assert(rect.top >= 0 && rect.top < rect.bottom);
+  assert(unsigned(rect.right) <= width);
+  assert(unsigned(rect.bottom) <= height);
+
+  /* use the same end point as the full Fill() for the right-most
+     column, so the sample positions match */
+  const int x1 = rect.left * quantisation_pixels;
+  const int x2 = unsigned(rect.right) == width
+    ? screen_width
+    : rect.right * quantisation_pixels;
+  const unsigned n = rect.right - rect.left;
+
+  auto p = data.begin() + rect.top * width + rect.left;
+  for (int y = rect.top * quantisation_pixels,
+         end = rect.bottom * quantisation_pixels;
+       y < end; y += quantisation_pixels, p += width) {
+    if (n == 1) {
+      /* RasterMap::ScanLine() needs at least two samples */
+      TerrainHeight buffer[2];
+      map.ScanLine(projection.ScreenToGeo(x1, y),
+                   projection.ScreenToGeo(x1 + 2 * quantisation_pixels, y),
+                   buffer, 2, interpolate);
+      *p = buffer[0];
+    } else
+      map.ScanLine(projection.ScreenToGeo(x1, y),
+                   projection.ScreenToGeo(x2, y),
+                   p, n, interpolate);
+  }
+}
+
 #endif
+
+void
+HeightMatrix::Shift(int dx, int dy)
+{
+  if (unsigned(std::abs(dx)) >= width || unsigned(std::abs(dy)) >= height)
+    /* nothing to preserve */
+    return;
+
+  const unsigned n = width - std::abs(dx);
+  const unsigned dest_column = std::max(-dx, 0);
+  const unsigned src_column = std::max(dx, 0);
+  const unsigned rows = height - std::abs(dy);
+
+  if (dy > 0) {
+    /* moving up: copy top to bottom */
+    auto dest = data.begin() + dest_column;
+    auto src = data.begin() + dy * width + src_column;
+    for (unsigned i = 0; i < rows; ++i, dest += width, src += width)
+      memmove(dest, src, n * sizeof(*dest));
+  } else {
+    /* moving down: copy bottom to top */
+    auto dest = data.begin() + (height - 1) * width + dest_column;
+    auto src = data.begin() + (rows - 1) * width + src_column;
+    for (unsigned i = 0; i < rows; ++i, dest -= width, src -= width)
+      memmove(dest, src, n * sizeof(*dest));
+  }
+}
@@ -28,6 +28,7 @@ Copyright_License {
 #include "Util/AllocatedArray.hxx"
 
 class RasterMap;
+struct PixelRect;
 
 #ifdef ENABLE_OPENGL
 class GeoBounds;
@@ -63,8 +64,25 @@ public:
    */
   void Fill(const RasterMap &map, const WindowProjection &map_projection,
             unsigned quantisation_pixels, bool interpolate);
+
+  /**
+   * Like Fill(), but fill only the specified rectangle (in cells) and
+   * leave all other cells alone.  The matrix size must match the
+   * projection's screen size.
+   */
+  void Fill(const RasterMap &map, const WindowProjection &map_projection,
+            unsigned quantisation_pixels, const PixelRect &rect,
+            bool interpolate);
 #endif
 
+  /**
+   * Move all cells by the specified offset: afterwards, cell (x,y)
+   * contains what was previously in cell (x+dx,y+dy).  The cells
+   * which have no source are undefined and must be filled by the
+   * caller.
+   */
+  void Shift(int dx, int dy);
+
   unsigned GetWidth() const {
     return width;
   }
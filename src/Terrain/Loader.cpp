@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Loader.hpp"
 #include "RasterTileCache.hpp"
+#include "RasterTileStore.hpp"
 #include "RasterProjection.hpp"
 #include "ZzipStream.hpp"
 #include "WorldFile.hpp"
@@ -164,6 +165,9 @@ TerrainLoader::SetSize(unsigned _width, unsigned _height,
   if (scan_overview)
     raster_tile_cache.SetSize(_width, _height, _tile_width, _tile_height,
                               tile_columns, tile_rows);
+
+  if (store_writer != nullptr)
+    store_writer->Begin(tile_columns, tile_rows);
 }
 
 void
@@ -176,6 +180,9 @@ TerrainLoader::PutTileData(unsigned index,
     raster_tile_cache.PutOverviewTile(index, start_x, start_y,
                                       end_x, end_y, m);
 
+  if (store_writer != nullptr)
+    store_writer->PutTile(index, m);
+
   if (scan_tiles) {
     const ScopeExclusiveLock lock(mutex);
     raster_tile_cache.PutTileData(index, m);
@@ -298,12 +305,14 @@ LoadTerrainOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
-                    OperationEnvironment &env)
+                    OperationEnvironment &env,
+                    RasterTileStoreWriter *store_writer)
 {
   /* fake a mutex - we don't need it for LoadTerrainOverview() */
   SharedMutex mutex;
 
-  TerrainLoader loader(mutex, raster_tile_cache, true, all, env);
+  TerrainLoader loader(mutex, raster_tile_cache, true, all, env,
+                       store_writer);
   return loader.LoadOverview(dir, path, world_file);
 }
 
@@ -313,7 +322,13 @@ TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
 {
   assert(!scan_overview);
 
-  if (!raster_tile_cache.PollTiles(x, y, radius))
+  if (raster_tile_cache.HasTileStore()) {
+    /* the tiles are memory-mapped; activating them is cheap, there's
+       nothing to decode, except for tiles missing in the store */
+    const ScopeExclusiveLock lock(mutex);
+    if (!raster_tile_cache.MapTiles(x, y, radius))
+      return true;
+  } else if (!raster_tile_cache.PollTiles(x, y, radius))
     /* nothing to do */
     return true;
 
@@ -29,6 +29,7 @@ Copyright_License {
 struct zzip_dir;
 struct GeoPoint;
 class RasterTileCache;
+class RasterTileStoreWriter;
 class RasterProjection;
 class OperationEnvironment;
 
@@ -41,6 +42,12 @@ class TerrainLoader {
 
   OperationEnvironment &env;
 
+  /**
+   * If set, then all tiles decoded while scanning the overview are
+   * also written to this uncompressed tile store.
+   */
+  RasterTileStoreWriter *const store_writer;
+
   /**
    * The number of remaining segments after the current one.
    */
@@ -49,11 +56,12 @@ class TerrainLoader {
 public:
   TerrainLoader(SharedMutex &_mutex, RasterTileCache &_rtc,
                 bool _scan_overview, bool _scan_all,
-                OperationEnvironment &_env)
+                OperationEnvironment &_env,
+                RasterTileStoreWriter *_store_writer=nullptr)
     :mutex(_mutex), raster_tile_cache(_rtc),
      scan_overview(_scan_overview),
      scan_tiles(!_scan_overview || _scan_all),
-     env(_env) {}
+     env(_env), store_writer(_store_writer) {}
 
   bool LoadOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file);
@@ -87,21 +95,25 @@ private:
  * @param all load not only overview, but all tiles?  On large files,
  * this is a very expensive operation.  This option was designed for
  * small RASP files only.
+ * @param store_writer if not nullptr, then all decoded tiles are
+ * written to this tile store
  */
 bool
 LoadTerrainOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
-                    OperationEnvironment &env);
+                    OperationEnvironment &env,
+                    RasterTileStoreWriter *store_writer=nullptr);
 
 static inline bool
 LoadTerrainOverview(struct zzip_dir *dir,
                     RasterTileCache &tile_cache,
-                    OperationEnvironment &env)
+                    OperationEnvironment &env,
+                    RasterTileStoreWriter *store_writer=nullptr)
 {
   return LoadTerrainOverview(dir, "terrain.jp2", "terrain.j2w",
-                             tile_cache, false, env);
+                             tile_cache, false, env, store_writer);
 }
 
 bool
@@ -34,6 +34,9 @@ RasterBuffer::Resize(unsigned _width, unsigned _height)
   assert(_width > 0 && _height > 0);
 
   data.GrowDiscard(_width, _height);
+  pixels = data.begin();
+  width = _width;
+  height = _height;
 }
 
 TerrainHeight
@@ -263,7 +266,7 @@ TerrainHeight
 RasterBuffer::GetMaximum() const
 {
   return IsDefined()
-    ? *std::max_element(data.begin(), data.end(),
+    ? *std::max_element(pixels, pixels + width * height,
                         [](TerrainHeight a, TerrainHeight b) {
                           return a.GetValue() < b.GetValue();
                         })
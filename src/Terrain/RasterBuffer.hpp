@@ -29,29 +29,48 @@ Copyright_License {
 #include "Util/AllocatedGrid.hxx"
 #include "Compiler.h"
 
+#include <assert.h>
 #include <stdint.h>
 
 class RasterBuffer {
   AllocatedGrid<TerrainHeight> data;
 
+  /**
+   * Points to the first pixel.  This is either the beginning of
+   * #data or read-only memory owned by somebody else (see
+   * SetExternal()).
+   */
+  const TerrainHeight *pixels = nullptr;
+
+  unsigned width = 0, height = 0;
+
 public:
   RasterBuffer() = default;
   RasterBuffer(unsigned _width, unsigned _height)
-    :data(_width, _height) {}
+    :data(_width, _height), pixels(data.begin()),
+     width(_width), height(_height) {}
 
   RasterBuffer(const RasterBuffer &) = delete;
   RasterBuffer &operator=(const RasterBuffer &) = delete;
 
   bool IsDefined() const {
-    return data.IsDefined();
+    return pixels != nullptr;
+  }
+
+  /**
+   * Does this object refer to external memory instead of owning the
+   * pixels?
+   */
+  bool IsExternal() const {
+    return pixels != nullptr && !data.IsDefined();
   }
 
   unsigned GetWidth() const {
-    return data.GetWidth();
+    return width;
   }
 
   unsigned GetHeight() const {
-    return data.GetHeight();
+    return height;
   }
 
   unsigned GetFineWidth() const {
@@ -63,23 +82,46 @@ public:
   }
 
   TerrainHeight *GetData() {
+    assert(!IsExternal());
+
     return data.begin();
   }
 
   const TerrainHeight *GetData() const {
-    return data.begin();
+    return pixels;
   }
 
   const TerrainHeight *GetDataAt(unsigned x, unsigned y) const {
-    return data.GetPointerAt(x, y);
+    assert(x < width);
+    assert(y < height);
+
+    return pixels + y * width + x;
   }
 
   void Reset() {
     data.Reset();
+    pixels = nullptr;
+    width = height = 0;
   }
 
   void Resize(unsigned _width, unsigned _height);
 
+  /**
+   * Let this object refer to a read-only pixel array owned by
+   * somebody else, e.g. a memory-mapped file.  The caller is
+   * responsible for keeping it alive until Reset() is called.
+   */
+  void SetExternal(const TerrainHeight *_pixels,
+                   unsigned _width, unsigned _height) {
+    assert(_pixels != nullptr);
+    assert(_width > 0 && _height > 0);
+
+    data.Reset();
+    pixels = _pixels;
+    width = _width;
+    height = _height;
+  }
+
   gcc_pure
   TerrainHeight GetInterpolated(unsigned lx, unsigned ly,
                                 unsigned ix, unsigned iy) const;
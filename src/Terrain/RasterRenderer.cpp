@@ -23,8 +23,10 @@ Copyright_License {
 
 #include "Terrain/RasterRenderer.hpp"
 #include "Terrain/RasterMap.hpp"
+#include "Terrain/SlopeShading.hpp"
 #include "Math/FastMath.hpp"
 #include "Util/Clamp.hpp"
+#include "Util/Macros.hpp"
 #include "Screen/Ramp.hpp"
 #include "Screen/Layout.hpp"
 #include "Screen/Color.hpp"
@@ -34,8 +36,11 @@ Copyright_License {
 #include "Asset.hpp"
 #include "Event/Idle.hpp"
 
+#include <cstdlib>
+
 #include <assert.h>
 #include <stdint.h>
+#include <string.h>
 
 /**
  * Interpolate between x and y with i/128, i.e. i/(1 << 7).
@@ -113,6 +118,7 @@ RasterRenderer::~RasterRenderer()
   delete[] color_table;
   delete image;
   delete[] contour_column_base;
+  delete[] slope_row;
 }
 
 #ifdef ENABLE_OPENGL
@@ -149,7 +155,8 @@ RasterRenderer::BindAndGetTexture() const
 #endif
 
 void
-RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection)
+RasterRenderer::UpdateEffectiveQuantisation(const RasterMap &map,
+                                            const WindowProjection &projection)
 {
   // Coordinates of the MapWindow center
   unsigned x = projection.GetScreenWidth() / 2;
@@ -184,6 +191,12 @@ RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection
   } else
     /* disable slope shading when zoomed out very far (too tiny) */
     quantisation_effective = 0;
+}
+
+void
+RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection)
+{
+  UpdateEffectiveQuantisation(map, projection);
 
 #ifdef ENABLE_OPENGL
   bounds = projection.GetScreenBounds().Scale(1.5);
@@ -197,9 +210,131 @@ RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection
   last_quantisation_pixels = quantisation_pixels;
 #else
   height_matrix.Fill(map, projection, quantisation_pixels, true);
+
+  scanned_projection = projection;
+  scanned = true;
+  scroll_pending = false;
 #endif
 }
 
+#ifndef ENABLE_OPENGL
+
+/**
+ * Divide and round to the nearest integer.
+ */
+gcc_const
+static int
+RoundingDivide(int a, int b)
+{
+  assert(b > 0);
+
+  return (a >= 0 ? a + b / 2 : a - b / 2) / b;
+}
+
+bool
+RasterRenderer::ScrollMap(const RasterMap &map,
+                          const WindowProjection &projection)
+{
+  if (!scanned || image == nullptr ||
+      projection.GetScreenWidth() != scanned_projection.GetScreenWidth() ||
+      projection.GetScreenHeight() != scanned_projection.GetScreenHeight() ||
+      projection.GetScale() != scanned_projection.GetScale() ||
+      projection.GetScreenAngle() != scanned_projection.GetScreenAngle())
+    return false;
+
+  const int width = height_matrix.GetWidth();
+  const int height = height_matrix.GetHeight();
+  const int q = quantisation_pixels;
+
+  const int screen_width = projection.GetScreenWidth();
+  const int screen_height = projection.GetScreenHeight();
+  const PixelPoint corners[] = {
+    {0, 0}, {screen_width, 0}, {0, screen_height},
+    {screen_width, screen_height},
+  };
+
+  /* where are the new screen corners in the old projection?  The
+     average of all four corners compensates for the rounding errors
+     of the projection */
+  int sum_x = 0, sum_y = 0;
+  for (const auto &corner : corners) {
+    const auto p =
+      scanned_projection.GeoToScreen(projection.ScreenToGeo(corner));
+    sum_x += p.x - corner.x;
+    sum_y += p.y - corner.y;
+  }
+
+  /* round the offset to whole cells */
+  const int n_corners = ARRAY_SIZE(corners);
+  const int dx = RoundingDivide(sum_x, n_corners * q);
+  const int dy = RoundingDivide(sum_y, n_corners * q);
+
+  if (abs(dx) >= width / 2 || abs(dy) >= height / 2)
+    /* too much to gain from reusing the rest */
+    return false;
+
+  /* the old projection, moved by the rounded offset */
+  WindowProjection shifted = scanned_projection;
+  shifted.SetScreenOrigin(scanned_projection.GetScreenOrigin().x - dx * q,
+                          scanned_projection.GetScreenOrigin().y - dy * q);
+  shifted.UpdateScreenBounds();
+
+  /* the new projection must match it within one cell (the resolution
+     of the image) plus one pixel (rounding errors of the projection),
+     which rules out everything but a translation */
+  const double tolerance = q + 1;
+  for (const auto &corner : corners) {
+    const double distance = shifted.ScreenToGeo(corner)
+      .DistanceS(projection.ScreenToGeo(corner));
+    if (shifted.DistanceMetersToPixels(distance) > tolerance)
+      return false;
+  }
+
+  /* the scale is the same, so #pixel_size and
+     #quantisation_effective are kept; recalculating them would yield
+     slightly different values due to rounding errors, and then the
+     slope shading of the new strips would not match the rest */
+
+  height_matrix.Shift(dx, dy);
+
+  /* scan the newly exposed rows and columns */
+
+  int top = 0, bottom = height;
+  if (dy > 0) {
+    bottom -= dy;
+    height_matrix.Fill(map, shifted, quantisation_pixels,
+                       PixelRect(0, bottom, width, height), true);
+  } else if (dy < 0) {
+    top = -dy;
+    height_matrix.Fill(map, shifted, quantisation_pixels,
+                       PixelRect(0, 0, width, top), true);
+  }
+
+  if (dx > 0)
+    height_matrix.Fill(map, shifted, quantisation_pixels,
+                       PixelRect(width - dx, top, width, bottom), true);
+  else if (dx < 0)
+    height_matrix.Fill(map, shifted, quantisation_pixels,
+                       PixelRect(0, top, -dx, bottom), true);
+
+  scanned_projection = shifted;
+
+  if (scroll_pending) {
+    /* GenerateImage() has not been called since the last
+       ScrollMap() */
+    scroll_x += dx;
+    scroll_y += dy;
+  } else {
+    scroll_x = dx;
+    scroll_y = dy;
+    scroll_pending = true;
+  }
+
+  return true;
+}
+
+#endif
+
 void
 RasterRenderer::GenerateImage(bool do_shading,
                               unsigned height_scale,
@@ -215,6 +350,14 @@ RasterRenderer::GenerateImage(bool do_shading,
 
     delete[] contour_column_base;
     contour_column_base = new unsigned char[height_matrix.GetWidth()];
+
+    delete[] slope_row;
+    slope_row = new int8_t[height_matrix.GetWidth()];
+
+#ifndef ENABLE_OPENGL
+    /* the new image is empty, there's nothing to scroll */
+    scroll_pending = false;
+#endif
   }
 
   if (quantisation_effective == 0) {
@@ -222,35 +365,129 @@ RasterRenderer::GenerateImage(bool do_shading,
     do_contour = false;
   }
 
+  const ImageParameters parameters{
+    do_shading, do_contour, height_scale, contrast, brightness, sunazimuth,
+    quantisation_effective,
+  };
+
   const unsigned contour_height_scale = do_contour? height_scale * 2 : 16;
 
   ContourStart(contour_height_scale);
 
-  if (do_shading)
-    GenerateSlopeImage(height_scale, contrast, brightness,
-                       sunazimuth, contour_height_scale);
-  else
-    GenerateUnshadedImage(height_scale, contour_height_scale);
+#ifndef ENABLE_OPENGL
+  /* contour lines depend on the previous row and column, so the image
+     can only be scrolled without them */
+  if (scroll_pending && !do_contour && parameters == image_parameters) {
+    scroll_pending = false;
+    ScrollImage(contour_height_scale);
+    image->SetDirty();
+    return;
+  }
+
+  scroll_pending = false;
+#endif
+
+  image_parameters = parameters;
+  GenerateImage(PixelRect(PixelSize(height_matrix.GetWidth(),
+                                    height_matrix.GetHeight())),
+                contour_height_scale);
 
   image->SetDirty();
 }
 
+void
+RasterRenderer::GenerateImage(const PixelRect &rect,
+                              const unsigned contour_height_scale)
+{
+  if (image_parameters.do_shading)
+    GenerateSlopeImage(image_parameters.height_scale,
+                       image_parameters.contrast, image_parameters.brightness,
+                       image_parameters.sunazimuth, contour_height_scale,
+                       rect);
+  else
+    GenerateUnshadedImage(image_parameters.height_scale,
+                          contour_height_scale, rect);
+}
+
+#ifndef ENABLE_OPENGL
+
+void
+RasterRenderer::ScrollImage(const unsigned contour_height_scale)
+{
+  const int width = height_matrix.GetWidth();
+  const int height = height_matrix.GetHeight();
+  const int dx = scroll_x, dy = scroll_y;
+
+  /* pixels near the edges are shaded with one-sided slopes; those
+     along the old and new edges must be regenerated */
+  const int margin = image_parameters.do_shading
+    ? (int)quantisation_effective
+    : 0;
+
+  const int top = dy < 0 ? margin - dy : (dy > 0 ? margin : 0);
+  const int bottom = dy > 0 ? margin + dy : (dy < 0 ? margin : 0);
+  const int left = dx < 0 ? margin - dx : (dx > 0 ? margin : 0);
+  const int right = dx > 0 ? margin + dx : (dx < 0 ? margin : 0);
+
+  if (top + bottom >= height || left + right >= width) {
+    GenerateImage(PixelRect(PixelSize(width, height)), contour_height_scale);
+    return;
+  }
+
+  /* move the pixels which are still valid */
+
+  const unsigned n = width - abs(dx);
+  const unsigned dest_column = std::max(-dx, 0);
+  const unsigned src_column = std::max(dx, 0);
+  const unsigned rows = height - abs(dy);
+
+  if (dy > 0) {
+    for (unsigned y = 0; y < rows; ++y)
+      memmove(image->GetRow(y) + dest_column,
+              image->GetRow(y + dy) + src_column,
+              n * sizeof(RawColor));
+  } else {
+    for (unsigned y = height; y-- > unsigned(height) - rows;)
+      memmove(image->GetRow(y) + dest_column,
+              image->GetRow(y + dy) + src_column,
+              n * sizeof(RawColor));
+  }
+
+  /* generate the rest */
+
+  if (top > 0)
+    GenerateImage(PixelRect(0, 0, width, top), contour_height_scale);
+
+  if (bottom > 0)
+    GenerateImage(PixelRect(0, height - bottom, width, height),
+                  contour_height_scale);
+
+  if (left > 0)
+    GenerateImage(PixelRect(0, top, left, height - bottom),
+                  contour_height_scale);
+
+  if (right > 0)
+    GenerateImage(PixelRect(width - right, top, width, height - bottom),
+                  contour_height_scale);
+}
+
+#endif
+
 void
 RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
-                                      const unsigned contour_height_scale)
+                                      const unsigned contour_height_scale,
+                                      const PixelRect &rect)
 {
-  const auto *src = height_matrix.GetData();
   const RawColor *oColorBuf = color_table + 64 * 256;
-  RawColor *dest = image->GetTopRow();
 
-  for (unsigned y = height_matrix.GetHeight(); y > 0; --y) {
-    RawColor *p = dest;
-    dest = image->GetNextRow(dest);
+  for (unsigned y = rect.top; y < unsigned(rect.bottom); ++y) {
+    const auto *src = height_matrix.GetRow(y) + rect.left;
+    RawColor *p = image->GetRow(y) + rect.left;
 
     unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    unsigned char *contour_this_column_base = contour_column_base + rect.left;
 
-    for (unsigned x = height_matrix.GetWidth(); x > 0; --x) {
+    for (unsigned x = rect.right - rect.left; x > 0; --x) {
       const auto e = *src++;
       if (gcc_likely(!e.IsSpecial())) {
         unsigned h = std::max(0, (int)e.GetValue());
@@ -280,26 +517,6 @@ RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
   }
 }
 
-/**
- * Clip the difference between two adjacent terrain height values to
- * sane bounds.  This works around integer overflows in the
- * GenerateSlopeImage() formula when the map file is broken, avoiding
- * the sqrt() call with a negative argument.
- */
-gcc_const
-static int
-ClipHeightDelta(int d)
-{
-  return Clamp(d, -512, 512);
-}
-
-gcc_const
-static int
-ClipHeightDelta(TerrainHeight a, TerrainHeight b)
-{
-  return ClipHeightDelta(a.GetValue() - b.GetValue());
-}
-
 // JMW: if zoomed right in (e.g. one unit is larger than terrain
 // grid), then increase the step size to be equal to the terrain
 // grid for purposes of calculating slope, to avoid shading problems
@@ -309,7 +526,8 @@ void
 RasterRenderer::GenerateSlopeImage(unsigned height_scale,
                                    int contrast,
                                    const int sx, const int sy, const int sz,
-                                   const unsigned contour_height_scale)
+                                   const unsigned contour_height_scale,
+                                   const PixelRect &rect)
 {
   assert(quantisation_effective > 0);
 
@@ -326,12 +544,19 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
              square will not overflow */
           8192u / (quantisation_effective * quantisation_effective));
 
-  const auto *src = height_matrix.GetData();
+  const SlopeShadingParameters shading{
+    sx, sy, sz, contrast, height_slope_factor,
+  };
+
   const RawColor *oColorBuf = color_table + 64 * 256;
 
-  RawColor *dest = image->GetTopRow();
+  /* the range of columns within #rect which are not at the left or
+     right edge */
+  const int interior_left = std::max(border.left, rect.left);
+  const int interior_right = std::min(border.right, rect.right);
 
-  for (unsigned y = 0; y < height_matrix.GetHeight(); ++y) {
+  for (unsigned y = rect.top; y < unsigned(rect.bottom); ++y) {
+    const auto *src = height_matrix.GetRow(y) + rect.left;
     const unsigned row_plus_index = y < (unsigned)border.bottom
       ? quantisation_effective
       : height_matrix.GetHeight() - 1 - y;
@@ -343,13 +568,26 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 
     const unsigned p31 = row_plus_index + row_minus_index;
 
-    RawColor *p = dest;
-    dest = image->GetNextRow(dest);
+    if (interior_right > interior_left && p31 > 0) {
+      /* calculate the shading of all pixels which are not at the left
+         or right edge in one pass; this is the hot loop, and it uses
+         SIMD instructions if available */
+      const auto *interior = src + interior_left - rect.left;
+      CalculateSlopeShadeRow(shading, 2 * quantisation_effective, p31,
+                             interior - row_minus_offset,
+                             interior + row_plus_offset,
+                             interior - quantisation_effective,
+                             interior + quantisation_effective,
+                             slope_row + interior_left,
+                             interior_right - interior_left);
+    }
+
+    RawColor *p = image->GetRow(y) + rect.left;
 
     unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    unsigned char *contour_this_column_base = contour_column_base + rect.left;
 
-    for (unsigned x = 0; x < height_matrix.GetWidth(); ++x, ++src) {
+    for (unsigned x = rect.left; x < unsigned(rect.right); ++x, ++src) {
       const auto e = *src;
       if (gcc_likely(!e.IsSpecial())) {
         unsigned h = std::max(0, (int)e.GetValue());
@@ -404,25 +642,13 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
           continue;
         }
 
-        const int p32 = ClipHeightDelta(h_above, h_below);
-        const int p22 = ClipHeightDelta(h_right, h_left);
-
-        const unsigned p20 = column_plus_index + column_minus_index;
-
-        const int dd0 = p22 * int(p31);
-        const int dd1 = int(p20) * p32;
-        const unsigned dd2 = p20 * p31 * height_slope_factor;
-        const int num = (int(dd2) * sz + dd0 * sx + dd1 * sy);
-        const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
-        const unsigned mag = (unsigned)sqrt(square_mag);
-        /* this is a workaround for a SIGFPE (division by zero)
-           observed by our users on some Android devices (e.g. Nexus
-           7), even though we did our best to make sure that the
-           integer arithmetics above can't overflow */
-        /* TODO: debug this problem and replace this workaround */
-        const int sval = num / int(mag|1);
-        const int sindex = (sval - sz) * contrast / 128;
-        *p++ = oColorBuf[int(h) + 256 * Clamp(sindex, -63, 63)];
+        const int sindex = x >= (unsigned)border.left &&
+          x < (unsigned)border.right && p31 > 0
+          ? slope_row[x]
+          : CalculateSlopeShade(shading,
+                                column_plus_index + column_minus_index, p31,
+                                h_above, h_below, h_left, h_right);
+        *p++ = oColorBuf[int(h) + 256 * sindex];
       } else if (e.IsWater()) {
         // we're in the water, so look up the color for water
         *p++ = oColorBuf[255];
@@ -440,7 +666,8 @@ void
 RasterRenderer::GenerateSlopeImage(unsigned height_scale,
                                    int contrast, int brightness,
                                    const Angle sunazimuth,
-                                   const unsigned contour_height_scale)
+                                   const unsigned contour_height_scale,
+                                   const PixelRect &rect)
 {
   const Angle fudgeelevation = Angle::Degrees(10) +
     Angle::Degrees(80.0 / 255.0) * brightness;
@@ -450,7 +677,7 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
   const int sz = (int)(255 * fudgeelevation.fastsine());
 
   GenerateSlopeImage(height_scale, contrast,
-                     sx, sy, sz, contour_height_scale);
+                     sx, sy, sz, contour_height_scale, rect);
 }
 
 void
@@ -25,20 +25,25 @@ Copyright_License {
 #define XCSOAR_RASTER_RENDERER_HPP
 
 #include "Terrain/HeightMatrix.hpp"
+#include "Math/Angle.hpp"
+
+#include <stdint.h>
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
+#else
+#include "Projection/WindowProjection.hpp"
 #endif
 
 #define NUM_COLOR_RAMP_LEVELS 13
 
-class Angle;
 class Canvas;
 class RasterMap;
 class WindowProjection;
 class RawBitmap;
 struct RawColor;
 struct ColorRamp;
+struct PixelRect;
 
 #ifdef ENABLE_OPENGL
 class GLTexture;
@@ -69,13 +74,70 @@ class RasterRenderer {
    * texture has to be redrawn.
    */
   GeoBounds bounds = GeoBounds::Invalid();
+#else
+  /**
+   * The projection which describes the current contents of the
+   * #HeightMatrix.  After ScrollMap(), this is the previous
+   * projection with its screen origin moved by the scroll offset,
+   * which may differ slightly from the projection passed to
+   * ScrollMap().
+   */
+  WindowProjection scanned_projection;
+
+  /**
+   * Is #scanned_projection valid, i.e. may ScrollMap() reuse the
+   * #HeightMatrix contents?
+   */
+  bool scanned = false;
+
+  /**
+   * The offset (in #HeightMatrix cells) applied by the last
+   * ScrollMap() call which has not yet been applied to the #image
+   * by GenerateImage().
+   */
+  int scroll_x, scroll_y;
+
+  /**
+   * Has ScrollMap() been called since the last GenerateImage() call?
+   */
+  bool scroll_pending = false;
 #endif
 
+  /**
+   * The parameters which were used to generate the current #image.
+   * GenerateImage() may scroll the #image only if they did not
+   * change.
+   */
+  struct ImageParameters {
+    bool do_shading;
+    bool do_contour;
+    unsigned height_scale;
+    int contrast, brightness;
+    Angle sunazimuth;
+    unsigned quantisation_effective;
+
+    bool operator==(const ImageParameters &other) const {
+      return do_shading == other.do_shading &&
+        do_contour == other.do_contour &&
+        height_scale == other.height_scale &&
+        contrast == other.contrast &&
+        brightness == other.brightness &&
+        sunazimuth == other.sunazimuth &&
+        quantisation_effective == other.quantisation_effective;
+    }
+  } image_parameters;
+
   HeightMatrix height_matrix;
   RawBitmap *image = nullptr;
 
   unsigned char *contour_column_base = nullptr;
 
+  /**
+   * The illumination index of each pixel in the current row.  This
+   * is a buffer used by GenerateSlopeImage().
+   */
+  int8_t *slope_row = nullptr;
+
   double pixel_size;
 
   RawColor *color_table = nullptr;
@@ -117,6 +179,24 @@ public:
   }
 
   const GLTexture &BindAndGetTexture() const;
+#else
+  /**
+   * Discard the #HeightMatrix contents, i.e. the next ScrollMap()
+   * call will fail.
+   */
+  void Invalidate() {
+    scanned = false;
+    scroll_pending = false;
+  }
+
+  /**
+   * Returns the projection which describes the current
+   * #HeightMatrix contents.  Only valid after ScanMap() or a
+   * successful ScrollMap().
+   */
+  const WindowProjection &GetScannedProjection() const {
+    return scanned_projection;
+  }
 #endif
 
   /**
@@ -132,6 +212,23 @@ public:
    */
   void ScanMap(const RasterMap &map, const WindowProjection &projection);
 
+#ifndef ENABLE_OPENGL
+  /**
+   * Update the height matrix incrementally: if the new projection is
+   * just a translation of the previous one (e.g. panning, or flying
+   * with a north-up map), the matrix is shifted and only the newly
+   * exposed strips are scanned, and the following GenerateImage()
+   * call shades only those strips.
+   *
+   * The caller is responsible for checking that the map contents
+   * did not change since the last ScanMap() call.
+   *
+   * @return false if the height matrix cannot be reused; the caller
+   * must call ScanMap() then
+   */
+  bool ScrollMap(const RasterMap &map, const WindowProjection &projection);
+#endif
+
   /**
    * Convert the height matrix into the image.
    */
@@ -152,14 +249,16 @@ protected:
    * Convert the height matrix into the image, without shading.
    */
   void GenerateUnshadedImage(unsigned height_scale,
-                             const unsigned contour_height_scale);
+                             const unsigned contour_height_scale,
+                             const PixelRect &rect);
 
   /**
    * Convert the height matrix into the image, with slope shading.
    */
   void GenerateSlopeImage(unsigned height_scale, int contrast,
                           const int sx, const int sy, const int sz,
-                          const unsigned contour_height_scale);
+                          const unsigned contour_height_scale,
+                          const PixelRect &rect);
 
   /**
    * Convert the height matrix into the image, with slope shading.
@@ -167,9 +266,31 @@ protected:
   void GenerateSlopeImage(unsigned height_scale,
                           int contrast, int brightness,
                           const Angle sunazimuth,
-                          const unsigned contour_height_scale);
+                          const unsigned contour_height_scale,
+                          const PixelRect &rect);
 
 private:
+  /**
+   * Calculate #pixel_size and #quantisation_effective for the given
+   * projection.
+   */
+  void UpdateEffectiveQuantisation(const RasterMap &map,
+                                   const WindowProjection &projection);
+
+  /**
+   * Generate the specified rectangle (in #HeightMatrix cells) of the
+   * image.
+   */
+  void GenerateImage(const PixelRect &rect,
+                     const unsigned contour_height_scale);
+
+#ifndef ENABLE_OPENGL
+  /**
+   * Apply the pending scroll offset to the #image and regenerate the
+   * parts which have become invalid.
+   */
+  void ScrollImage(const unsigned contour_height_scale);
+#endif
 
   void ContourStart(const unsigned contour_height_scale);
 };
@@ -23,14 +23,17 @@ Copyright_License {
 
 #include "RasterTerrain.hpp"
 #include "Loader.hpp"
+#include "RasterTileStore.hpp"
 #include "Profile/Profile.hpp"
 #include "IO/ZipArchive.hpp"
 #include "IO/FileCache.hpp"
 #include "OS/ConvertPathName.hpp"
+#include "OS/FileMapping.hpp"
 #include "Operation/Operation.hpp"
 #include "Util/ConvertString.hpp"
 
 static const TCHAR *const terrain_cache_name = _T("terrain");
+static const TCHAR *const terrain_tiles_cache_name = _T("terrain_tiles");
 
 inline bool
 RasterTerrain::LoadCache(FileCache &cache, Path path)
@@ -63,20 +66,61 @@ RasterTerrain::SaveCache(FileCache &cache, Path path) const
   return success;
 }
 
+inline bool
+RasterTerrain::LoadTileStore(FileCache &cache, Path path)
+{
+  size_t offset;
+  FileMapping *mapping = cache.Map(terrain_tiles_cache_name, path, offset);
+  if (mapping == nullptr)
+    return false;
+
+  auto store = std::make_unique<RasterTileStore>(mapping, offset);
+  if (!map.GetTileCache().SetTileStore(std::move(store))) {
+    cache.Flush(terrain_tiles_cache_name);
+    return false;
+  }
+
+  return true;
+}
+
 inline bool
 RasterTerrain::Load(Path path, FileCache *cache,
                     OperationEnvironment &operation)
 {
-  if (LoadCache(cache, path))
+  if (LoadCache(cache, path)) {
+    /* the tile store is optional; without it, tiles are decoded
+       from the JPEG2000 file on demand */
+    LoadTileStore(*cache, path);
     return true;
+  }
 
-  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation))
+  /* while the JPEG2000 file gets decoded for the overview, write
+     all tiles to an uncompressed store, so we never need to decode
+     them again */
+  FILE *store_file = cache != nullptr
+    ? cache->Save(terrain_tiles_cache_name, path)
+    : nullptr;
+  RasterTileStoreWriter store_writer(store_file);
+
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation,
+                           store_file != nullptr ? &store_writer : nullptr)) {
+    if (store_file != nullptr)
+      cache->Cancel(terrain_tiles_cache_name, store_file);
     return false;
+  }
 
   map.UpdateProjection();
 
-  if (cache != nullptr)
+  if (cache != nullptr) {
+    if (store_file != nullptr) {
+      if (!store_writer.Finish())
+        cache->Cancel(terrain_tiles_cache_name, store_file);
+      else if (cache->Commit(terrain_tiles_cache_name, store_file))
+        LoadTileStore(*cache, path);
+    }
+
     SaveCache(*cache, path);
+  }
 
   return true;
 }
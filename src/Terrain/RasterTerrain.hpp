@@ -91,6 +91,12 @@ private:
 
   bool SaveCache(FileCache &cache, Path path) const;
 
+  /**
+   * Attach the memory-mapped tile store from the cache (if one
+   * exists).
+   */
+  bool LoadTileStore(FileCache &cache, Path path);
+
   bool Load(Path path, FileCache *cache,
             OperationEnvironment &operation);
 };
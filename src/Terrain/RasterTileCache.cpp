@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "RasterTileCache.hpp"
+#include "RasterTileStore.hpp"
 #include "Math/Angle.hpp"
 #include "Math/FastMath.hpp"
 
@@ -160,6 +161,67 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius)
   return num_activate > 0;
 }
 
+bool
+RasterTileCache::SetTileStore(std::unique_ptr<RasterTileStore> &&_store)
+{
+  assert(_store != nullptr);
+
+  if (!IsValid() || !_store->IsValid(tiles.GetWidth(), tiles.GetHeight()))
+    return false;
+
+  /* tiles which were decoded previously may be replaced with mapped
+     ones */
+  for (auto &tile : tiles)
+    tile.Disable();
+
+  store = std::move(_store);
+  ++serial;
+  return true;
+}
+
+bool
+RasterTileCache::MapTiles(int x, int y, unsigned radius)
+{
+  assert(store != nullptr);
+
+  /* see PollTiles() */
+  radius += 256;
+
+  bool modified = false;
+  request_tiles.clear();
+
+  for (unsigned i = 0, n = tiles.GetSize(); i < n; ++i) {
+    RasterTile &tile = tiles.GetLinear(i);
+    if (!tile.VisibilityChanged(x, y, radius))
+      continue;
+
+    if ((unsigned)tile.GetDistance() > radius) {
+      /* out of range: release the pointer, and let the kernel evict
+         the pages whenever it likes */
+      tile.Disable();
+      modified = true;
+    } else if (!tile.IsEnabled()) {
+      const TerrainHeight *data = store->GetTile(i, tile.width, tile.height);
+      if (data != nullptr) {
+        tile.buffer.SetExternal(data, tile.width, tile.height);
+        modified = true;
+      } else if (!request_tiles.full()) {
+        /* broken store entry; decode this tile from the JPEG2000
+           file */
+        tile.SetRequest();
+        request_tiles.append(i);
+      }
+    }
+  }
+
+  dirty = false;
+
+  if (modified)
+    ++serial;
+
+  return !request_tiles.empty();
+}
+
 TerrainHeight
 RasterTileCache::GetHeight(unsigned px, unsigned py) const
 {
@@ -243,6 +305,20 @@ RasterTileCache::Reset()
 
   for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
     it->Disable();
+
+  /* the tiles don't refer to the store anymore; it can be freed
+     now */
+  store.reset();
+}
+
+RasterTileCache::RasterTileCache()
+{
+  Reset();
+}
+
+RasterTileCache::~RasterTileCache()
+{
+  Reset();
 }
 
 const RasterTileCache::MarkerSegmentInfo *
@@ -31,6 +31,8 @@ Copyright_License {
 #include "Util/StaticArray.hxx"
 #include "Util/Serial.hpp"
 
+#include <memory>
+
 #include <assert.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -39,6 +41,7 @@ Copyright_License {
 
 struct jas_matrix;
 struct GridLocation;
+class RasterTileStore;
 
 class RasterTileCache {
   static constexpr unsigned MAX_RTC_TILES = 4096;
@@ -101,7 +104,7 @@ protected:
   };
 
   struct CacheHeader {
-    static constexpr unsigned VERSION = 0xb;
+    static constexpr unsigned VERSION = 0xc;
 
     unsigned version;
     unsigned width, height;
@@ -137,10 +140,16 @@ protected:
    */
   StaticArray<uint16_t, MAX_RTC_TILES> request_tiles;
 
+  /**
+   * An optional memory-mapped store of uncompressed tiles.  If
+   * present, tiles are activated from here instead of being decoded
+   * from the JPEG2000 file.
+   */
+  std::unique_ptr<RasterTileStore> store;
+
 public:
-  RasterTileCache() {
-    Reset();
-  }
+  RasterTileCache();
+  ~RasterTileCache();
 
   RasterTileCache(const RasterTileCache &) = delete;
   RasterTileCache &operator=(const RasterTileCache &) = delete;
@@ -276,6 +285,33 @@ public:
 
   bool PollTiles(int x, int y, unsigned radius);
 
+  /**
+   * Attach a tile store.  It is ignored if it does not match the
+   * tile grid of this object.
+   *
+   * @return true if the store has been attached
+   */
+  bool SetTileStore(std::unique_ptr<RasterTileStore> &&_store);
+
+  bool HasTileStore() const {
+    return store != nullptr;
+  }
+
+  /**
+   * The #RasterTileStore counterpart of PollTiles(): activate all
+   * tiles within range by pointing them at the mapped store, and
+   * deactivate all others.  Unlike PollTiles(), this is not limited
+   * by #MAX_ACTIVE_TILES, because mapped tiles don't occupy heap
+   * memory.  The caller must hold an exclusive lock.
+   *
+   * Tiles which are missing from the store (or whose store entry is
+   * broken) are requested like PollTiles() does, to be decoded from
+   * the JPEG2000 file instead.
+   *
+   * @return true if tiles have been requested
+   */
+  bool MapTiles(int x, int y, unsigned radius);
+
   void PutTileData(unsigned index, const struct jas_matrix &m);
 
   void FinishTileUpdate();
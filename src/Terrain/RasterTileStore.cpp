@@ -0,0 +1,184 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "RasterTileStore.hpp"
+#include "OS/FileMapping.hpp"
+
+extern "C" {
+#include "jasper/jas_seq.h"
+}
+
+#include <algorithm>
+
+#include <assert.h>
+#include <string.h>
+
+using namespace RasterTileStoreFormat;
+
+void
+RasterTileStoreWriter::Begin(unsigned tile_columns, unsigned tile_rows)
+{
+  if (started || failed)
+    return;
+
+  started = true;
+
+  base = ftell(file);
+  if (base < 0) {
+    failed = true;
+    return;
+  }
+
+  const unsigned n = tile_columns * tile_rows;
+  entries.ResizeDiscard(n);
+  std::fill(entries.begin(), entries.end(), Entry{0, 0, 0});
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.tile_columns = tile_columns;
+  header.tile_rows = tile_rows;
+
+  /* write the tile table now to reserve space; it will be
+     overwritten with the real values by Finish() */
+  if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+      fwrite(entries.begin(), sizeof(Entry), n, file) != n) {
+    failed = true;
+    return;
+  }
+
+  position = sizeof(header) + uint64_t(n) * sizeof(Entry);
+}
+
+void
+RasterTileStoreWriter::PutTile(unsigned index, const struct jas_matrix &m)
+{
+  if (!started || failed || index >= entries.size() ||
+      entries[index].offset != 0)
+    return;
+
+  const unsigned width = m.numcols_, height = m.numrows_;
+  if (width == 0 || height == 0)
+    return;
+
+  row.GrowDiscard(width);
+
+  for (unsigned y = 0; y != height; ++y) {
+    const jas_seqent_t *gcc_restrict src = m.rows_[y];
+    TerrainHeight *gcc_restrict dest = row.begin();
+
+    for (unsigned x = 0; x < width; ++x)
+      dest[x] = TerrainHeight(src[x]);
+
+    if (fwrite(dest, sizeof(*dest), width, file) != width) {
+      failed = true;
+      return;
+    }
+  }
+
+  Entry &entry = entries[index];
+  entry.offset = position;
+  entry.width = width;
+  entry.height = height;
+
+  position += uint64_t(width) * height * sizeof(TerrainHeight);
+}
+
+bool
+RasterTileStoreWriter::Finish()
+{
+  if (!started || failed)
+    return false;
+
+  const unsigned n = entries.size();
+  return fseek(file, base + sizeof(Header), SEEK_SET) == 0 &&
+    fwrite(entries.begin(), sizeof(Entry), n, file) == n &&
+    fseek(file, 0, SEEK_END) == 0;
+}
+
+RasterTileStore::RasterTileStore(FileMapping *_mapping, size_t offset)
+  :mapping(_mapping),
+   base((const uint8_t *)mapping->at(offset)),
+   size(mapping->size() - offset)
+{
+  assert(offset <= mapping->size());
+
+  if (size < sizeof(Header))
+    return;
+
+  /* use memcpy() because the header may be misaligned within the
+     mapping */
+  Header header;
+  memcpy(&header, base, sizeof(header));
+
+  if (header.magic != MAGIC || header.version != VERSION ||
+      header.tile_columns == 0 || header.tile_rows == 0 ||
+      header.tile_columns > 1024 || header.tile_rows > 1024)
+    return;
+
+  const unsigned n = header.tile_columns * header.tile_rows;
+  if (size < sizeof(header) + size_t(n) * sizeof(Entry))
+    return;
+
+  tile_columns = header.tile_columns;
+  tile_rows = header.tile_rows;
+}
+
+RasterTileStore::~RasterTileStore()
+{
+  delete mapping;
+}
+
+bool
+RasterTileStore::IsValid(unsigned _tile_columns, unsigned _tile_rows) const
+{
+  return tile_columns > 0 &&
+    tile_columns == _tile_columns && tile_rows == _tile_rows;
+}
+
+const TerrainHeight *
+RasterTileStore::GetTile(unsigned index,
+                         unsigned width, unsigned height) const
+{
+  if (index >= tile_columns * tile_rows)
+    return nullptr;
+
+  Entry entry;
+  memcpy(&entry, base + sizeof(Header) + index * sizeof(Entry),
+         sizeof(entry));
+
+  if (entry.offset == 0 || entry.width != width || entry.height != height)
+    return nullptr;
+
+  const uint64_t end = entry.offset +
+    uint64_t(width) * height * sizeof(TerrainHeight);
+  if (end > size)
+    return nullptr;
+
+  const uint8_t *p = base + entry.offset;
+  if ((uintptr_t)p % alignof(TerrainHeight) != 0)
+    return nullptr;
+
+  return (const TerrainHeight *)p;
+}
@@ -0,0 +1,167 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_RASTER_TILE_STORE_HPP
+#define XCSOAR_RASTER_TILE_STORE_HPP
+
+#include "Height.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Compiler.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+struct jas_matrix;
+class FileMapping;
+
+/**
+ * The on-disk layout of an uncompressed terrain tile store.  It is a
+ * header, followed by one #Entry per tile, followed by the raw
+ * (native byte order) #TerrainHeight values of all tiles.
+ *
+ * This file is generated once while the JPEG2000 overview is being
+ * decoded, and is later memory-mapped by #RasterTileStore, which
+ * turns tile activation into a pointer setup.
+ */
+namespace RasterTileStoreFormat {
+  static constexpr uint32_t MAGIC = 0x58545453;
+  static constexpr uint32_t VERSION = 1;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tile_columns, tile_rows;
+  };
+
+  struct Entry {
+    /**
+     * The position of the pixels, relative to the beginning of the
+     * #Header.  0 means the tile is not present.
+     */
+    uint64_t offset;
+
+    uint32_t width, height;
+  };
+}
+
+/**
+ * Writes a tile store (see #RasterTileStoreFormat) while the
+ * JPEG2000 file is being decoded.
+ */
+class RasterTileStoreWriter {
+  FILE *const file;
+
+  /**
+   * The file position of the #RasterTileStoreFormat::Header.
+   */
+  long base;
+
+  AllocatedArray<RasterTileStoreFormat::Entry> entries;
+
+  /**
+   * The offset of the next tile, relative to #base.
+   */
+  uint64_t position;
+
+  AllocatedArray<TerrainHeight> row;
+
+  bool started = false, failed = false;
+
+public:
+  explicit RasterTileStoreWriter(FILE *_file):file(_file) {}
+
+  RasterTileStoreWriter(const RasterTileStoreWriter &) = delete;
+  RasterTileStoreWriter &operator=(const RasterTileStoreWriter &) = delete;
+
+  /**
+   * Write the header and reserve space for the tile table.  Called
+   * by #TerrainLoader as soon as the image geometry is known.
+   */
+  void Begin(unsigned tile_columns, unsigned tile_rows);
+
+  /**
+   * Append the pixels of a decoded tile.
+   */
+  void PutTile(unsigned index, const struct jas_matrix &m);
+
+  /**
+   * Write the tile table.  The caller is responsible for closing the
+   * file afterwards.
+   *
+   * @return true if the whole store has been written successfully
+   */
+  bool Finish();
+};
+
+/**
+ * A read-only, memory-mapped tile store (see
+ * #RasterTileStoreFormat).
+ */
+class RasterTileStore {
+  FileMapping *const mapping;
+
+  /**
+   * The beginning of the #RasterTileStoreFormat::Header within the
+   * mapping.
+   */
+  const uint8_t *const base;
+
+  const size_t size;
+
+  /**
+   * The dimensions of the tile grid; zero if the header is invalid.
+   */
+  unsigned tile_columns = 0, tile_rows = 0;
+
+public:
+  /**
+   * @param mapping the file mapping; this object takes over
+   * ownership
+   * @param offset the offset of the store within the mapping
+   */
+  RasterTileStore(FileMapping *_mapping, size_t offset);
+  ~RasterTileStore();
+
+  RasterTileStore(const RasterTileStore &) = delete;
+  RasterTileStore &operator=(const RasterTileStore &) = delete;
+
+  /**
+   * Check whether the header is valid and matches the given tile
+   * grid.
+   */
+  gcc_pure
+  bool IsValid(unsigned tile_columns, unsigned tile_rows) const;
+
+  /**
+   * Obtain a pointer to the pixels of the specified tile.
+   *
+   * @return nullptr if the tile is not present or its dimensions do
+   * not match
+   */
+  gcc_pure
+  const TerrainHeight *GetTile(unsigned index,
+                               unsigned width, unsigned height) const;
+};
+
+#endif
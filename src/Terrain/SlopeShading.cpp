@@ -0,0 +1,97 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "SlopeShading.hpp"
+
+#ifdef __SSE2__
+#include "SlopeShadingSSE2.hpp"
+#endif
+
+#ifdef __ARM_NEON__
+#include "SlopeShadingNEON.hpp"
+#endif
+
+#include <assert.h>
+
+void
+CalculateSlopeShadeRowPortable(const SlopeShadingParameters &s,
+                               unsigned dx, unsigned dy,
+                               const TerrainHeight *gcc_restrict above,
+                               const TerrainHeight *gcc_restrict below,
+                               const TerrainHeight *gcc_restrict left,
+                               const TerrainHeight *gcc_restrict right,
+                               int8_t *gcc_restrict dest, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i)
+    dest[i] = CalculateSlopeShade(s, dx, dy,
+                                  above[i], below[i], left[i], right[i]);
+}
+
+void
+CalculateSlopeShadeRow(const SlopeShadingParameters &s,
+                       unsigned dx, unsigned dy,
+                       const TerrainHeight *gcc_restrict above,
+                       const TerrainHeight *gcc_restrict below,
+                       const TerrainHeight *gcc_restrict left,
+                       const TerrainHeight *gcc_restrict right,
+                       int8_t *gcc_restrict dest, unsigned n)
+{
+  assert(dx > 0 && dx <= 50);
+  assert(dy > 0 && dy <= 50);
+
+#if defined(__SSE2__) || defined(__ARM_NEON__)
+  /* the optimised implementation handles blocks of 8 pixels, and
+     the portable one does the odd remainder */
+  const unsigned no = n & ~7u;
+
+#ifdef __SSE2__
+  const SSE2SlopeShading optimised(s, dx, dy);
+#else
+  const NEONSlopeShading optimised(s, dx, dy);
+#endif
+
+  optimised.ShadeRow(above, below, left, right, dest, no);
+
+  above += no;
+  below += no;
+  left += no;
+  right += no;
+  dest += no;
+  n -= no;
+#endif
+
+  CalculateSlopeShadeRowPortable(s, dx, dy, above, below, left, right,
+                                 dest, n);
+}
+
+const char *
+GetSlopeShadingImplementation()
+{
+#if defined(__SSE2__)
+  return "SSE2";
+#elif defined(__ARM_NEON__)
+  return "NEON";
+#else
+  return "portable";
+#endif
+}
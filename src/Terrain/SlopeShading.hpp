@@ -0,0 +1,144 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SLOPE_SHADING_HPP
+#define XCSOAR_TERRAIN_SLOPE_SHADING_HPP
+
+#include "Height.hpp"
+#include "Util/Clamp.hpp"
+#include "Compiler.h"
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * Parameters for the terrain slope shading calculation.
+ */
+struct SlopeShadingParameters {
+  /**
+   * The light source vector, scaled to 255.
+   */
+  int sx, sy, sz;
+
+  int contrast;
+
+  unsigned height_slope_factor;
+};
+
+/**
+ * Clip the difference between two adjacent terrain height values to
+ * sane bounds.  This works around integer overflows in the
+ * CalculateSlopeShade() formula when the map file is broken, avoiding
+ * the sqrt() call with a negative argument.
+ */
+gcc_const
+static inline int
+ClipHeightDelta(int d)
+{
+  return Clamp(d, -512, 512);
+}
+
+gcc_const
+static inline int
+ClipHeightDelta(TerrainHeight a, TerrainHeight b)
+{
+  return ClipHeightDelta(a.GetValue() - b.GetValue());
+}
+
+/**
+ * Calculate the illumination index (-63..63) of one pixel.  This is
+ * the portable reference implementation; the optimised versions
+ * must return exactly the same values.
+ *
+ * @param dx the horizontal distance between the "left" and "right"
+ * samples
+ * @param dy the vertical distance between the "above" and "below"
+ * samples
+ */
+gcc_const
+static inline int
+CalculateSlopeShade(const SlopeShadingParameters &s, unsigned dx, unsigned dy,
+                    TerrainHeight above, TerrainHeight below,
+                    TerrainHeight left, TerrainHeight right)
+{
+  const int p32 = ClipHeightDelta(above, below);
+  const int p22 = ClipHeightDelta(right, left);
+
+  const int dd0 = p22 * int(dy);
+  const int dd1 = int(dx) * p32;
+  const unsigned dd2 = dx * dy * s.height_slope_factor;
+  const int num = (int(dd2) * s.sz + dd0 * s.sx + dd1 * s.sy);
+  const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
+  const unsigned mag = (unsigned)sqrt(square_mag);
+  /* this is a workaround for a SIGFPE (division by zero)
+     observed by our users on some Android devices (e.g. Nexus
+     7), even though we did our best to make sure that the
+     integer arithmetics above can't overflow */
+  /* TODO: debug this problem and replace this workaround */
+  const int sval = num / int(mag|1);
+  const int sindex = (sval - s.sz) * s.contrast / 128;
+  return Clamp(sindex, -63, 63);
+}
+
+/**
+ * Calculate the illumination index of a row of pixels which all have
+ * the same sample distances.  Pixel i is calculated from above[i],
+ * below[i], left[i] and right[i].
+ *
+ * This is the portable reference implementation.
+ */
+void
+CalculateSlopeShadeRowPortable(const SlopeShadingParameters &s,
+                               unsigned dx, unsigned dy,
+                               const TerrainHeight *gcc_restrict above,
+                               const TerrainHeight *gcc_restrict below,
+                               const TerrainHeight *gcc_restrict left,
+                               const TerrainHeight *gcc_restrict right,
+                               int8_t *gcc_restrict dest, unsigned n);
+
+/**
+ * Same as CalculateSlopeShadeRowPortable(), but uses SIMD
+ * instructions (SSE2 or ARM NEON) if the target supports them.  The
+ * result is bit-exact.
+ *
+ * @param dx the horizontal sample distance; must be 1..50
+ * @param dy the vertical sample distance; must be 1..50
+ */
+void
+CalculateSlopeShadeRow(const SlopeShadingParameters &s,
+                       unsigned dx, unsigned dy,
+                       const TerrainHeight *gcc_restrict above,
+                       const TerrainHeight *gcc_restrict below,
+                       const TerrainHeight *gcc_restrict left,
+                       const TerrainHeight *gcc_restrict right,
+                       int8_t *gcc_restrict dest, unsigned n);
+
+/**
+ * Returns the name of the instruction set used by
+ * CalculateSlopeShadeRow().  Used for diagnostics and benchmarks.
+ */
+gcc_const
+const char *
+GetSlopeShadingImplementation();
+
+#endif
@@ -0,0 +1,186 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SLOPE_SHADING_NEON_HPP
+#define XCSOAR_TERRAIN_SLOPE_SHADING_NEON_HPP
+
+#include "SlopeShading.hpp"
+
+#ifndef __ARM_NEON__
+#error ARM NEON required
+#endif
+
+#include <arm_neon.h>
+
+/**
+ * Implementation of CalculateSlopeShadeRow() using ARM NEON
+ * instructions.
+ *
+ * ARMv7 NEON has neither double precision nor a division
+ * instruction.  The square root and the division are therefore
+ * approximated with single precision reciprocal estimates, and then
+ * corrected with exact integer arithmetic, to get the same results as
+ * the integer reference implementation.
+ */
+class NEONSlopeShading {
+  int16x8_t v_dx, v_dy;
+  int16_t sx, sy;
+  int32x4_t v_num_base, v_sz, v_contrast;
+  uint32x4_t v_dd2_square;
+
+public:
+  NEONSlopeShading(const SlopeShadingParameters &s, unsigned dx, unsigned dy)
+    :sx(s.sx), sy(s.sy) {
+    const unsigned dd2 = dx * dy * s.height_slope_factor;
+
+    v_dx = vdupq_n_s16(dx);
+    v_dy = vdupq_n_s16(dy);
+    v_num_base = vdupq_n_s32(int(dd2) * s.sz);
+    v_sz = vdupq_n_s32(s.sz);
+    v_contrast = vdupq_n_s32(s.contrast);
+    v_dd2_square = vdupq_n_u32(dd2 * dd2);
+  }
+
+private:
+  gcc_hot gcc_always_inline
+  static int16x8_t Load8(const TerrainHeight *p) {
+    return vld1q_s16((const int16_t *)p);
+  }
+
+  gcc_hot gcc_always_inline
+  static int16x8_t ClipHeightDelta8(int16x8_t a, int16x8_t b) {
+    /* saturating subtraction; the clipped result is the same as with
+       a 32 bit subtraction */
+    const int16x8_t d = vqsubq_s16(a, b);
+    return vminq_s16(vmaxq_s16(d, vdupq_n_s16(-512)), vdupq_n_s16(512));
+  }
+
+  /**
+   * Integer square root, rounded down, i.e. the same as
+   * (unsigned)sqrt(x).  x must not be zero.
+   */
+  gcc_hot gcc_always_inline
+  static uint32x4_t SquareRoot4(uint32x4_t x) {
+    const float32x4_t f = vcvtq_f32_u32(x);
+
+    /* reciprocal square root estimate with two Newton-Raphson
+       steps */
+    float32x4_t e = vrsqrteq_f32(f);
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(f, e), e));
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(f, e), e));
+
+    uint32x4_t m = vcvtq_u32_f32(vmulq_f32(f, e));
+
+    /* the estimate may be off by one in either direction; the
+       comparison masks are all-ones (i.e. -1) where true */
+    m = vaddq_u32(m, vcgtq_u32(vmulq_u32(m, m), x));
+    const uint32x4_t m1 = vaddq_u32(m, vdupq_n_u32(1));
+    m = vsubq_u32(m, vcleq_u32(vmulq_u32(m1, m1), x));
+    return m;
+  }
+
+  /**
+   * Signed division, truncating towards zero like the C "/"
+   * operator.  The divisor must be positive and small enough to
+   * make the float reciprocal accurate to at least one unit.
+   */
+  gcc_hot gcc_always_inline
+  static int32x4_t Divide4(int32x4_t a, uint32x4_t b) {
+    const int32x4_t sign = vshrq_n_s32(a, 31);
+    const uint32x4_t abs_a = vreinterpretq_u32_s32(vabsq_s32(a));
+
+    const float32x4_t fb = vcvtq_f32_u32(b);
+    float32x4_t r = vrecpeq_f32(fb);
+    r = vmulq_f32(r, vrecpsq_f32(fb, r));
+    r = vmulq_f32(r, vrecpsq_f32(fb, r));
+
+    uint32x4_t q = vcvtq_u32_f32(vmulq_f32(vcvtq_f32_u32(abs_a), r));
+
+    /* correct the estimate with the exact remainder */
+    const int32x4_t rem = vsubq_s32(vreinterpretq_s32_u32(abs_a),
+                                    vreinterpretq_s32_u32(vmulq_u32(q, b)));
+    q = vaddq_u32(q, vcltq_s32(rem, vdupq_n_s32(0)));
+    q = vsubq_u32(q, vcgeq_s32(rem, vreinterpretq_s32_u32(b)));
+
+    /* restore the sign */
+    const int32x4_t sq = vreinterpretq_s32_u32(q);
+    return vsubq_s32(veorq_s32(sq, sign), sign);
+  }
+
+  gcc_hot gcc_always_inline
+  int16x4_t Shade4(int16x4_t dd0, int16x4_t dd1) const {
+    /* dd0*dd0 + dd1*dd1 + dd2*dd2 */
+    const int32x4_t square = vmlal_s16(vmull_s16(dd0, dd0), dd1, dd1);
+    const uint32x4_t square_mag =
+      vaddq_u32(vreinterpretq_u32_s32(square), v_dd2_square);
+
+    /* dd2*sz + dd0*sx + dd1*sy */
+    const int32x4_t num = vmlal_n_s16(vmlal_n_s16(v_num_base, dd0, sx),
+                                      dd1, sy);
+
+    const uint32x4_t mag = SquareRoot4(square_mag);
+    const int32x4_t sval = Divide4(num, vorrq_u32(mag, vdupq_n_u32(1)));
+
+    /* (sval - sz) * contrast / 128, rounding towards zero */
+    const int32x4_t x = vmulq_s32(vsubq_s32(sval, v_sz), v_contrast);
+    const int32x4_t bias = vandq_s32(vshrq_n_s32(x, 31), vdupq_n_s32(127));
+    return vqmovn_s32(vshrq_n_s32(vaddq_s32(x, bias), 7));
+  }
+
+public:
+  gcc_hot gcc_always_inline
+  void Shade8(const TerrainHeight *gcc_restrict above,
+              const TerrainHeight *gcc_restrict below,
+              const TerrainHeight *gcc_restrict left,
+              const TerrainHeight *gcc_restrict right,
+              int8_t *gcc_restrict dest) const {
+    const int16x8_t p32 = ClipHeightDelta8(Load8(above), Load8(below));
+    const int16x8_t p22 = ClipHeightDelta8(Load8(right), Load8(left));
+
+    /* these fit in 16 bits: 512 * 50 */
+    const int16x8_t dd0 = vmulq_s16(p22, v_dy);
+    const int16x8_t dd1 = vmulq_s16(p32, v_dx);
+
+    int16x8_t sindex = vcombine_s16(Shade4(vget_low_s16(dd0),
+                                           vget_low_s16(dd1)),
+                                    Shade4(vget_high_s16(dd0),
+                                           vget_high_s16(dd1)));
+    sindex = vminq_s16(vmaxq_s16(sindex, vdupq_n_s16(-63)),
+                       vdupq_n_s16(63));
+
+    vst1_s8(dest, vqmovn_s16(sindex));
+  }
+
+  gcc_hot gcc_flatten gcc_nonnull_all
+  void ShadeRow(const TerrainHeight *gcc_restrict above,
+                const TerrainHeight *gcc_restrict below,
+                const TerrainHeight *gcc_restrict left,
+                const TerrainHeight *gcc_restrict right,
+                int8_t *gcc_restrict dest, unsigned n) const {
+    for (unsigned i = 0; i < n / 8; ++i, above += 8, below += 8,
+           left += 8, right += 8, dest += 8)
+      Shade8(above, below, left, right, dest);
+  }
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SLOPE_SHADING_SSE2_HPP
+#define XCSOAR_TERRAIN_SLOPE_SHADING_SSE2_HPP
+
+#include "SlopeShading.hpp"
+
+#ifndef __SSE2__
+#error SSE2 required
+#endif
+
+#include <emmintrin.h>
+
+#if CLANG_OR_GCC_VERSION(4,8)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+#endif
+
+/**
+ * Implementation of CalculateSlopeShadeRow() using Intel SSE2
+ * instructions.  The 16 bit parts are calculated with 8 lanes; the
+ * square root and the divisions are done with double precision
+ * (which is exact for the value ranges used here, and therefore
+ * yields the same results as the integer reference implementation).
+ */
+class SSE2SlopeShading {
+  /* the values which are constant for the whole row */
+  __m128i v_dx, v_dy, v_sxsy, v_num_base;
+  __m128d v_dd2_square, v_sz, v_contrast;
+
+public:
+  SSE2SlopeShading(const SlopeShadingParameters &s, unsigned dx, unsigned dy) {
+    const unsigned dd2 = dx * dy * s.height_slope_factor;
+
+    v_dx = _mm_set1_epi16(dx);
+    v_dy = _mm_set1_epi16(dy);
+
+    /* interleaved to match the (dd0, dd1) pairs; see Shade8() */
+    v_sxsy = _mm_set_epi16(s.sy, s.sx, s.sy, s.sx,
+                           s.sy, s.sx, s.sy, s.sx);
+
+    v_num_base = _mm_set1_epi32(int(dd2) * s.sz);
+    v_dd2_square = _mm_set1_pd(double(dd2) * double(dd2));
+    v_sz = _mm_set1_pd(s.sz);
+    v_contrast = _mm_set1_pd(s.contrast / 128.);
+  }
+
+private:
+  gcc_hot gcc_always_inline
+  static __m128i Load8(const TerrainHeight *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+  }
+
+  gcc_hot gcc_always_inline
+  static __m128i ClipHeightDelta8(__m128i a, __m128i b) {
+    /* saturating subtraction; the clipped result is the same as with
+       a 32 bit subtraction */
+    const __m128i d = _mm_subs_epi16(a, b);
+    return _mm_min_epi16(_mm_max_epi16(d, _mm_set1_epi16(-512)),
+                         _mm_set1_epi16(512));
+  }
+
+  /**
+   * Finish the calculation for the two lower 32 bit lanes of
+   * #square and #num.  Returns the illumination index in the two
+   * lower 32 bit lanes.
+   */
+  gcc_hot gcc_always_inline
+  __m128i Finish2(__m128i square, __m128i num) const {
+    const __m128d square_mag = _mm_add_pd(_mm_cvtepi32_pd(square),
+                                          v_dd2_square);
+    const __m128i mag = _mm_cvttpd_epi32(_mm_sqrt_pd(square_mag));
+    const __m128i divisor = _mm_or_si128(mag, _mm_set1_epi32(1));
+
+    const __m128d sval =
+      _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(num),
+                                                  _mm_cvtepi32_pd(divisor))));
+
+    /* multiplying with contrast/128 is exact because 128 is a power
+       of two; truncation matches the integer division */
+    return _mm_cvttpd_epi32(_mm_mul_pd(_mm_sub_pd(sval, v_sz), v_contrast));
+  }
+
+  gcc_hot gcc_always_inline
+  __m128i Finish4(__m128i square, __m128i num) const {
+    const __m128i lo = Finish2(square, num);
+    const __m128i hi = Finish2(_mm_unpackhi_epi64(square, square),
+                               _mm_unpackhi_epi64(num, num));
+    return _mm_unpacklo_epi64(lo, hi);
+  }
+
+public:
+  gcc_hot gcc_always_inline
+  void Shade8(const TerrainHeight *gcc_restrict above,
+              const TerrainHeight *gcc_restrict below,
+              const TerrainHeight *gcc_restrict left,
+              const TerrainHeight *gcc_restrict right,
+              int8_t *gcc_restrict dest) const {
+    const __m128i p32 = ClipHeightDelta8(Load8(above), Load8(below));
+    const __m128i p22 = ClipHeightDelta8(Load8(right), Load8(left));
+
+    /* these fit in 16 bits: 512 * 50 */
+    const __m128i dd0 = _mm_mullo_epi16(p22, v_dy);
+    const __m128i dd1 = _mm_mullo_epi16(p32, v_dx);
+
+    const __m128i lo = _mm_unpacklo_epi16(dd0, dd1);
+    const __m128i hi = _mm_unpackhi_epi16(dd0, dd1);
+
+    /* dd0*dd0 + dd1*dd1 */
+    const __m128i square_lo = _mm_madd_epi16(lo, lo);
+    const __m128i square_hi = _mm_madd_epi16(hi, hi);
+
+    /* dd2*sz + dd0*sx + dd1*sy */
+    const __m128i num_lo = _mm_add_epi32(_mm_madd_epi16(lo, v_sxsy),
+                                         v_num_base);
+    const __m128i num_hi = _mm_add_epi32(_mm_madd_epi16(hi, v_sxsy),
+                                         v_num_base);
+
+    __m128i sindex = _mm_packs_epi32(Finish4(square_lo, num_lo),
+                                     Finish4(square_hi, num_hi));
+    sindex = _mm_min_epi16(_mm_max_epi16(sindex, _mm_set1_epi16(-63)),
+                           _mm_set1_epi16(63));
+
+    _mm_storel_epi64((__m128i *)dest, _mm_packs_epi16(sindex, sindex));
+  }
+
+  gcc_hot gcc_flatten gcc_nonnull_all
+  void ShadeRow(const TerrainHeight *gcc_restrict above,
+                const TerrainHeight *gcc_restrict below,
+                const TerrainHeight *gcc_restrict left,
+                const TerrainHeight *gcc_restrict right,
+                int8_t *gcc_restrict dest, unsigned n) const {
+    for (unsigned i = 0; i < n / 8; ++i, above += 8, below += 8,
+           left += 8, right += 8, dest += 8)
+      Shade8(above, below, left, right, dest);
+  }
+};
+
+#if CLANG_OR_GCC_VERSION(4,8)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -343,7 +343,9 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
     /* no change since previous frame */
     return true;
 
-  compare_projection = CompareProjection(map_projection);
+  /* the height matrix may be scrolled only if the terrain has not
+     changed */
+  const bool terrain_changed = terrain_serial != terrain.GetSerial();
 #endif
 
   terrain_serial = terrain.GetSerial();
@@ -363,12 +365,26 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
   if (color_ramp != last_color_ramp) {
     raster_renderer.PrepareColorTable(color_ramp, do_water,
                                       height_scale, interp_levels);
+    raster_renderer.Invalidate();
     last_color_ramp = color_ramp;
   }
 
   {
     RasterTerrain::Lease map(terrain);
+
+#ifdef ENABLE_OPENGL
     raster_renderer.ScanMap(map, map_projection);
+#else
+    /* on a pure translation (panning, or flying with a north-up map),
+       only the newly exposed strips need to be scanned and shaded */
+    if (terrain_changed || !raster_renderer.ScrollMap(map, map_projection))
+      raster_renderer.ScanMap(map, map_projection);
+
+    /* compare with the projection which was really used, to avoid
+       accumulating rounding errors */
+    compare_projection =
+      CompareProjection(raster_renderer.GetScannedProjection());
+#endif
   }
 
   raster_renderer.GenerateImage(do_shading, height_scale,
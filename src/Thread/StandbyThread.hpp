@@ -123,6 +123,20 @@ protected:
     return pending || busy;
   }
 
+  /**
+   * Was Trigger() called again since Tick() has started?  A
+   * long-running Tick() implementation may use this to cancel
+   * low-priority work.
+   *
+   * Caller must lock the mutex.
+   */
+  gcc_pure
+  bool IsPending() const {
+    assert(mutex.IsLockedByCurrent());
+
+    return pending;
+  }
+
   /**
    * Was the thread asked to stop?  The Tick() implementation should
    * use this to check whether to cancel the operation.
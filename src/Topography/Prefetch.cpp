@@ -0,0 +1,66 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Prefetch.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/Math.hpp"
+#include "Util/Clamp.hpp"
+
+GeoBounds
+GetPrefetchBounds(const GeoBounds &screen, Angle track, double ground_speed)
+{
+  GeoBounds result = screen;
+  if (ground_speed <= 0)
+    return result;
+
+  const GeoPoint center = screen.GetCenter();
+  const GeoPoint ahead =
+    FindLatitudeLongitude(center, track, ground_speed * PREFETCH_SECONDS);
+  if (!ahead.IsValid())
+    return result;
+
+  const Angle width = screen.GetWidth(), height = screen.GetHeight();
+  const Angle dx = Clamp((ahead.longitude - center.longitude).AsDelta(),
+                         -width, width);
+  const Angle dy = Clamp(ahead.latitude - center.latitude, -height, height);
+
+  result.Extend(GeoPoint(screen.GetWest() + dx, screen.GetNorth() + dy));
+  result.Extend(GeoPoint(screen.GetEast() + dx, screen.GetSouth() + dy));
+  return result;
+}
+
+GeoBounds
+GetThresholdBounds(const GeoBounds &screen, const GeoPoint &location,
+                   double ratio)
+{
+  if (ratio > 1)
+    ratio = 1;
+
+  const Angle half_width = screen.GetWidth() * (ratio / 2);
+  const Angle half_height = screen.GetHeight() * (ratio / 2);
+
+  return GeoBounds(GeoPoint(location.longitude - half_width,
+                            location.latitude + half_height),
+                   GeoPoint(location.longitude + half_width,
+                            location.latitude - half_height));
+}
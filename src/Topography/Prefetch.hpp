@@ -0,0 +1,64 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TOPOGRAPHY_PREFETCH_HPP
+#define XCSOAR_TOPOGRAPHY_PREFETCH_HPP
+
+#include "Compiler.h"
+
+class Angle;
+struct GeoPoint;
+class GeoBounds;
+
+/**
+ * How many seconds of flight along the current track shall be
+ * loaded ahead of the screen?
+ */
+static constexpr double PREFETCH_SECONDS = 120;
+
+/**
+ * Calculate the region to be loaded speculatively: the screen,
+ * extended by where it will be after #PREFETCH_SECONDS.  The
+ * extension is limited to one screen size.
+ *
+ * @param ground_speed the ground speed [m/s]; zero or negative
+ * returns the screen bounds unmodified
+ */
+gcc_pure
+GeoBounds
+GetPrefetchBounds(const GeoBounds &screen, Angle track, double ground_speed);
+
+/**
+ * Calculate the region which will be visible after zooming in to a
+ * smaller map scale: the screen, shrunk by the ratio of the two
+ * scales, centered on the given location (usually the aircraft).
+ *
+ * @param ratio the new map scale divided by the current one; values
+ * larger than 1 are treated as 1
+ */
+gcc_pure
+GeoBounds
+GetThresholdBounds(const GeoBounds &screen, const GeoPoint &location,
+                   double ratio);
+
+#endif
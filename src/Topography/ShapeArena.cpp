@@ -0,0 +1,176 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ShapeArena.hpp"
+
+#include <new>
+
+#include <assert.h>
+#include <stdlib.h>
+
+/**
+ * The header of each page, followed by the allocations.
+ */
+struct alignas(alignof(max_align_t)) ShapeArena::Page {
+  Page *prev, *next;
+
+  /**
+   * The size of this page including this header.
+   */
+  size_t size;
+
+  /**
+   * The offset of the next allocation within this page.
+   */
+  size_t position;
+
+  /**
+   * The number of allocations which have not been freed yet.
+   */
+  unsigned n_live;
+};
+
+/**
+ * The header of each allocation.
+ */
+struct alignas(alignof(max_align_t)) ShapeArena::Chunk {
+  Page *page;
+  size_t size;
+};
+
+static constexpr size_t
+AlignUp(size_t size)
+{
+  return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
+
+ShapeArena::~ShapeArena()
+{
+  assert(used_size == 0);
+
+  while (head != nullptr) {
+    Page *next = head->next;
+    free(head);
+    head = next;
+  }
+}
+
+ShapeArena::Page *
+ShapeArena::NewPage(size_t size)
+{
+  Page *page = (Page *)malloc(size);
+  if (page == nullptr)
+    throw std::bad_alloc();
+
+  page->prev = nullptr;
+  page->next = head;
+  if (head != nullptr)
+    head->prev = page;
+  head = page;
+
+  page->size = size;
+  page->position = sizeof(Page);
+  page->n_live = 0;
+
+  allocated_size += size;
+  ++n_pages;
+  return page;
+}
+
+void
+ShapeArena::DeletePage(Page *page)
+{
+  assert(page->n_live == 0);
+  assert(page != current);
+
+  if (page->prev != nullptr)
+    page->prev->next = page->next;
+  else
+    head = page->next;
+
+  if (page->next != nullptr)
+    page->next->prev = page->prev;
+
+  allocated_size -= page->size;
+  --n_pages;
+  free(page);
+}
+
+void *
+ShapeArena::Allocate(size_t size)
+{
+  const size_t need = sizeof(Chunk) + AlignUp(size);
+
+  const ScopeLock protect(mutex);
+
+  Page *page;
+  if (need > MAX_SMALL) {
+    page = NewPage(sizeof(Page) + need);
+  } else {
+    if (current == nullptr || current->position + need > current->size) {
+      Page *old = current;
+      current = NewPage(PAGE_SIZE);
+
+      if (old != nullptr && old->n_live == 0)
+        DeletePage(old);
+    }
+
+    page = current;
+  }
+
+  Chunk *chunk = (Chunk *)((char *)page + page->position);
+  chunk->page = page;
+  chunk->size = need;
+
+  page->position += need;
+  ++page->n_live;
+  used_size += need;
+
+  return chunk + 1;
+}
+
+void
+ShapeArena::Free(void *p)
+{
+  if (p == nullptr)
+    return;
+
+  Chunk *chunk = (Chunk *)p - 1;
+  Page *page = chunk->page;
+
+  const ScopeLock protect(mutex);
+
+  assert(page->n_live > 0);
+  assert(used_size >= chunk->size);
+
+  used_size -= chunk->size;
+
+  if (--page->n_live > 0)
+    return;
+
+  if (page == current)
+    /* reuse the current page from the beginning */
+    page->position = sizeof(Page);
+  else
+    DeletePage(page);
+}
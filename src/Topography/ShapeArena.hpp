@@ -0,0 +1,170 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TOPOGRAPHY_SHAPE_ARENA_HPP
+#define XCSOAR_TOPOGRAPHY_SHAPE_ARENA_HPP
+
+#include "Thread/Mutex.hpp"
+#include "Compiler.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <stddef.h>
+
+/**
+ * A page based allocator for #XShape objects and their arrays.
+ *
+ * Allocations are carved sequentially from 32 kB pages, which
+ * replaces hundreds of thousands of small heap blocks with few large
+ * ones.  Each page counts its live allocations; a page is returned
+ * to the heap as soon as its last allocation is freed.  Since shapes
+ * which are loaded together are usually evicted together (they are
+ * near each other), eviction frees whole pages.
+ *
+ * Large allocations get a page of their own.
+ *
+ * This class is thread-safe: shapes are loaded and evicted by the
+ * #TopographyThread, while OpenGL indices are built by the renderer.
+ */
+class ShapeArena {
+  static constexpr size_t PAGE_SIZE = 32768;
+
+  /**
+   * Allocations larger than this get a page of their own.
+   */
+  static constexpr size_t MAX_SMALL = PAGE_SIZE / 4;
+
+  struct Page;
+  struct Chunk;
+
+  mutable Mutex mutex;
+
+  /**
+   * A doubly linked list of all pages.
+   */
+  Page *head = nullptr;
+
+  /**
+   * The page where small allocations are carved from.
+   */
+  Page *current = nullptr;
+
+  /**
+   * The total size of all pages [bytes].
+   */
+  size_t allocated_size = 0;
+
+  /**
+   * The total size of all live allocations [bytes].
+   */
+  size_t used_size = 0;
+
+  unsigned n_pages = 0;
+
+public:
+  ShapeArena() = default;
+  ShapeArena(const ShapeArena &) = delete;
+  ShapeArena &operator=(const ShapeArena &) = delete;
+
+  /**
+   * Frees all pages.  All allocations must have been freed already.
+   */
+  ~ShapeArena();
+
+  gcc_malloc
+  void *Allocate(size_t size);
+
+  void Free(void *p);
+
+  template<typename T>
+  T *NewArray(size_t n) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Destructors are not called");
+
+    static_assert(std::is_nothrow_default_constructible<T>::value,
+                  "Partially constructed arrays are not cleaned up");
+
+    /* construct each element separately; an array placement-new
+       may add a cookie which does not fit in the allocation */
+    T *array = (T *)Allocate(n * sizeof(T));
+    for (size_t i = 0; i < n; ++i)
+      ::new(array + i) T;
+    return array;
+  }
+
+  template<typename T, typename... Args>
+  T *New(Args&&... args) {
+    void *p = Allocate(sizeof(T));
+    try {
+      return ::new(p) T(std::forward<Args>(args)...);
+    } catch (...) {
+      Free(p);
+      throw;
+    }
+  }
+
+  /**
+   * Destroy and free an object allocated with New().  nullptr is
+   * ignored.
+   */
+  template<typename T>
+  void Delete(const T *p) {
+    if (p == nullptr)
+      return;
+
+    p->~T();
+    Free(const_cast<T *>(p));
+  }
+
+  /**
+   * @return the total size of all pages obtained from the heap
+   */
+  gcc_pure
+  size_t GetAllocatedSize() const {
+    const ScopeLock protect(mutex);
+    return allocated_size;
+  }
+
+  /**
+   * @return the total size of all live allocations
+   */
+  gcc_pure
+  size_t GetUsedSize() const {
+    const ScopeLock protect(mutex);
+    return used_size;
+  }
+
+  gcc_pure
+  unsigned GetPageCount() const {
+    const ScopeLock protect(mutex);
+    return n_pages;
+  }
+
+private:
+  Page *NewPage(size_t size);
+  void DeletePage(Page *page);
+};
+
+#endif
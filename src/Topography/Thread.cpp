@@ -23,12 +23,31 @@ Copyright_License {
 
 #include "Thread.hpp"
 #include "TopographyStore.hpp"
+#include "Prefetch.hpp"
+#include "Time/TimeoutClock.hpp"
+
+/**
+ * The maximum time [ms] spent on speculative loading per update, so
+ * prefetching never delays the next update of the visible region
+ * for long.
+ */
+static constexpr unsigned PREFETCH_BUDGET_MS = 50;
+
+/**
+ * The maximum number of shapes loaded by one speculative
+ * TopographyFile::Update() call.  This keeps a single dense file from
+ * exceeding #PREFETCH_BUDGET_MS; the rest is loaded by the next
+ * call.
+ */
+static constexpr unsigned PREFETCH_MAX_SHAPES = 256;
 
 TopographyThread::TopographyThread(TopographyStore &_store,
                                    std::function<void()> &&_callback)
   :StandbyThread("Topography"),
    store(_store),
    callback(std::move(_callback)),
+   next_prefetch_bounds(GeoBounds::Invalid()),
+   next_threshold_bounds(GeoBounds::Invalid()),
    last_bounds(GeoBounds::Invalid()) {}
 
 TopographyThread::~TopographyThread()
@@ -36,7 +55,8 @@ TopographyThread::~TopographyThread()
 }
 
 void
-TopographyThread::Trigger(const WindowProjection &_projection)
+TopographyThread::Trigger(const WindowProjection &_projection,
+                          Angle track, double ground_speed)
 {
   assert(_projection.IsValid());
 
@@ -55,9 +75,23 @@ TopographyThread::Trigger(const WindowProjection &_projection)
   last_bounds = new_bounds.Scale(1.1);
   scale_threshold = store.GetNextScaleThreshold(_projection.GetMapScale());
 
+  const GeoBounds prefetch_bounds =
+    GetPrefetchBounds(new_bounds, track, ground_speed);
+
+  /* at the next scale threshold, only the region which would be
+     visible after zooming in is loaded; the whole current screen
+     might contain far too many shapes of a dense file */
+  const GeoBounds threshold_bounds = scale_threshold > 0
+    ? GetThresholdBounds(new_bounds, _projection.GetGeoLocation(),
+                         scale_threshold / _projection.GetMapScale())
+    : GeoBounds::Invalid();
+
   {
     const ScopeLock protect(mutex);
     next_projection = _projection;
+    next_prefetch_bounds = prefetch_bounds;
+    next_threshold_bounds = threshold_bounds;
+    next_threshold_scale = scale_threshold;
     StandbyThread::Trigger();
   }
 }
@@ -81,4 +115,29 @@ TopographyThread::Tick()
     const ScopeUnlock unlock(mutex);
     callback();
   }
+
+  /* now that the visible region is complete, load the region ahead
+     and the next scale threshold, within the time budget; a new
+     Trigger() call interrupts this, because the visible region has
+     priority */
+  const TimeoutClock budget(PREFETCH_BUDGET_MS);
+  Prefetch(budget, next_prefetch_bounds, next_projection.GetMapScale());
+  Prefetch(budget, next_threshold_bounds, next_threshold_scale);
+}
+
+void
+TopographyThread::Prefetch(const TimeoutClock &budget,
+                           const GeoBounds &_bounds, double map_scale)
+{
+  bool again = true;
+  while (_bounds.IsValid() && again && !IsStopped() &&
+         !IsPending() && !budget.HasExpired()) {
+    /* copy the bounds, because Trigger() may modify the attribute
+       while the mutex is unlocked */
+    const GeoBounds bounds = _bounds;
+
+    const ScopeUnlock unlock(mutex);
+    again = store.ScanVisibility(bounds, map_scale, 1,
+                                 PREFETCH_MAX_SHAPES) > 0;
+  }
 }
@@ -27,10 +27,12 @@ Copyright_License {
 #include "Thread/StandbyThread.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "Geo/GeoBounds.hpp"
+#include "Math/Angle.hpp"
 
 #include <functional>
 
 class TopographyStore;
+class TimeoutClock;
 
 /**
  * A thread that loads topography files asynchronously.
@@ -42,6 +44,25 @@ class TopographyThread final : private StandbyThread {
 
   WindowProjection next_projection;
 
+  /**
+   * The region which shall be loaded speculatively after the visible
+   * one: the screen extended along the current track.
+   */
+  GeoBounds next_prefetch_bounds;
+
+  /**
+   * The region which shall be loaded speculatively at
+   * #next_threshold_scale: what will be visible around the aircraft
+   * after zooming in.  Invalid if there is no such threshold.
+   */
+  GeoBounds next_threshold_bounds;
+
+  /**
+   * The next (smaller) scale threshold, so files which appear when
+   * zooming in are ready.
+   */
+  double next_threshold_scale;
+
   GeoBounds last_bounds;
   double scale_threshold;
 
@@ -51,9 +72,24 @@ public:
 
   using StandbyThread::LockStop;
 
-  void Trigger(const WindowProjection &_projection);
+  /**
+   * @param track the aircraft's current track
+   * @param ground_speed the aircraft's current ground speed [m/s];
+   * zero disables prefetching along the track
+   */
+  void Trigger(const WindowProjection &_projection,
+               Angle track=Angle::Zero(), double ground_speed=0);
 
 private:
+  /**
+   * Load the given region speculatively until it is complete, the
+   * budget has expired or the visible region needs an update.
+   *
+   * Caller must lock the mutex.
+   */
+  void Prefetch(const TimeoutClock &budget,
+                const GeoBounds &bounds, double map_scale);
+
   /* virtual methods from class StandbyThread*/
   void Tick() override;
 };
@@ -23,13 +23,38 @@ Copyright_License {
 
 #include "Topography/TopographyFile.hpp"
 #include "Topography/XShape.hpp"
+#include "Topography/TopographyFileStore.hpp"
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileMapping.hpp"
+#include "Util/StaticString.hxx"
+#include "Util/CRC.hpp"
+#include "Compatibility/path.h"
+
+#ifdef ENABLE_OPENGL
+#include "Screen/Layout.hpp"
+#include "Geo/FAISphere.hpp"
+#endif
+
+#ifdef _UNICODE
+#include "Util/ConvertString.hpp"
+#endif
 
 #include <zzip/lib.h>
 
 #include <algorithm>
 
+#include <string.h>
+
+gcc_pure
+static const char *
+GetBaseName(const char *path)
+{
+  const char *slash = strrchr(path, DIR_SEPARATOR);
+  return slash != nullptr ? slash + 1 : path;
+}
+
 TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                double _threshold,
                                double _label_threshold,
@@ -37,7 +62,8 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                const Color _color,
                                int _label_field,
                                ResourceId _icon, ResourceId _big_icon,
-                               unsigned _pen_width)
+                               unsigned _pen_width,
+                               FileCache *cache, Path original_path)
   :dir(_dir), first(nullptr),
    label_field(_label_field), icon(_icon), big_icon(_big_icon),
    pen_width(_pen_width),
@@ -46,6 +72,10 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
    important_label_threshold(_important_label_threshold),
    cache_bounds(GeoBounds::Invalid())
 {
+  const char *base = GetBaseName(filename);
+  const char *dot = strrchr(base, '.');
+  name.SetASCII(base, dot != nullptr ? dot : base + strlen(base));
+
   if (msShapefileOpen(&file, "rb", dir, filename, 0) == -1)
     return;
 
@@ -66,6 +96,11 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
   shapes.ResizeDiscard(file.numshapes);
   std::fill(shapes.begin(), shapes.end(), ShapeList(nullptr));
 
+  if (cache != nullptr && !original_path.IsNull() &&
+      OpenStore(*cache, original_path, filename))
+    /* everything is loaded from the store from now on */
+    msShapefileClose(&file);
+
   if (dir != nullptr)
     ++dir->refcount;
 
@@ -90,62 +125,153 @@ void
 TopographyFile::ClearCache()
 {
   for (auto i = shapes.begin(), end = shapes.end(); i != end; ++i) {
-    delete i->shape;
+    arena.Delete(i->shape);
     i->shape = nullptr;
   }
 
   first = nullptr;
 }
 
-static XShape *
-LoadShape(shapefileObj *file, const GeoPoint &center, int i,
-          int label_field)
+bool
+TopographyFile::OpenStore(FileCache &cache, Path original_path,
+                          const char *shpname)
 {
-  return new XShape(file, center, i, label_field);
+  /* the cache entry is named after the shapefile, without the
+     directory, and a checksum of the map file path, because
+     different maps contain shapefiles with the same names */
+  shpname = GetBaseName(shpname);
+
+  const uint16_t map_id =
+    UpdateCRC16CCITT(original_path.c_str(),
+                     _tcslen(original_path.c_str()) * sizeof(TCHAR),
+                     0);
+
+  StaticString<128> name;
+#ifdef _UNICODE
+  UTF8ToWideConverter wshpname(shpname);
+  if (!wshpname.IsValid())
+    return false;
+
+  name.Format(_T("topography-%04x-%s"), map_id, wshpname.c_str());
+#else
+  name.Format("topography-%04x-%s", map_id, shpname);
+#endif
+
+  const unsigned threshold = unsigned(scale_threshold);
+
+  for (unsigned attempt = 0; attempt < 2; ++attempt) {
+    size_t offset;
+    FileMapping *mapping = cache.Map(name, original_path, offset);
+    if (mapping != nullptr) {
+      auto s = std::make_unique<TopographyFileStore>(mapping, offset);
+      if (s->IsValid(file.numshapes, label_field, threshold)) {
+        store = std::move(s);
+        return true;
+      }
+
+      cache.Flush(name);
+    }
+
+    if (attempt > 0)
+      break;
+
+    /* (re)generate the store */
+
+    FILE *out = cache.Save(name, original_path);
+    if (out == nullptr)
+      return false;
+
+    float min_distance[TopographyFileStoreFormat::THINNING_LEVELS];
+#ifdef ENABLE_OPENGL
+    for (unsigned level = 0; level < TopographyFileStoreFormat::THINNING_LEVELS; ++level)
+      min_distance[level] = GetMinimumShapeDistance(level);
+#else
+    std::fill_n(min_distance, TopographyFileStoreFormat::THINNING_LEVELS, 0);
+#endif
+
+    const TopographyFileStoreWriter writer(file, center, label_field,
+                                           threshold);
+    if (!writer.Write(out, min_distance)) {
+      cache.Cancel(name, out);
+      return false;
+    }
+
+    if (!cache.Commit(name, out))
+      return false;
+  }
+
+  return false;
+}
+
+XShape *
+TopographyFile::LoadShape(unsigned i)
+{
+  return store != nullptr
+    ? arena.New<XShape>(*store, i, &arena)
+    : arena.New<XShape>(&file, center, i, label_field, &arena);
 }
 
 bool
 TopographyFile::Update(const WindowProjection &map_projection)
+{
+  return Update(map_projection.GetScreenBounds(),
+                map_projection.GetMapScale());
+}
+
+bool
+TopographyFile::Update(const GeoBounds &screenRect, double map_scale,
+                       unsigned max_shapes)
 {
   if (IsEmpty())
     return false;
 
-  if (map_projection.GetMapScale() > scale_threshold)
+  if (map_scale > scale_threshold)
     /* not visible, don't update cache now */
     return false;
 
-  const GeoBounds screenRect =
-    map_projection.GetScreenBounds();
   if (cache_bounds.IsValid() && cache_bounds.IsInside(screenRect))
     /* the cache is still fresh */
     return false;
 
   cache_bounds = screenRect.Scale(2);
 
-  rectObj deg_bounds = ConvertRect(cache_bounds);
-
-  // Test which shapes are inside the given bounds and save the
-  // status to file.status
-  switch (msShapefileWhichShapes(&file, dir, deg_bounds, 0)) {
-  case MS_FAILURE:
-    ClearCache();
-    return false;
-
-  case MS_DONE:
-    /* screen is outside of map bounds */
-    return false;
+  if (store != nullptr) {
+    // Test which shapes are inside the given bounds using the
+    // store's spatial index
+    if (!store->FindShapes(cache_bounds, store_status))
+      /* screen is outside of map bounds */
+      return false;
+  } else {
+    rectObj deg_bounds = ConvertRect(cache_bounds);
+
+    // Test which shapes are inside the given bounds and save the
+    // status to file.status
+    switch (msShapefileWhichShapes(&file, dir, deg_bounds, 0)) {
+    case MS_FAILURE:
+      ClearCache();
+      return false;
+
+    case MS_DONE:
+      /* screen is outside of map bounds */
+      return false;
+
+    case MS_SUCCESS:
+      break;
+    }
 
-  case MS_SUCCESS:
-    break;
+    assert(file.status != nullptr);
   }
 
-  assert(file.status != nullptr);
-
   // Iterate through the shapefile entries
+  unsigned n_loaded = 0;
+  bool complete = true;
   const ShapeList **current = &first;
   auto it = shapes.begin();
   for (int i = 0; i < file.numshapes; ++i, ++it) {
-    if (!msGetBit(file.status, i)) {
+    const bool inside = store != nullptr
+      ? bool(store_status[i])
+      : msGetBit(file.status, i);
+    if (!inside) {
       // If the shape is outside the bounds
       // delete the shape from the cache
       if (it->shape != nullptr) {
@@ -160,7 +286,7 @@ TopographyFile::Update(const WindowProjection &map_projection)
 
         /* now it's unreachable, and we can delete the XShape without
            holding a lock */
-        delete it->shape;
+        arena.Delete(it->shape);
         it->shape = nullptr;
       }
     } else {
@@ -168,8 +294,17 @@ TopographyFile::Update(const WindowProjection &map_projection)
       if (it->shape == nullptr) {
         assert(*current != it);
 
+        if (n_loaded >= max_shapes) {
+          /* enough work for this call; leave the shape out of the
+             list, the next call will load it */
+          complete = false;
+          continue;
+        }
+
+        ++n_loaded;
+
         // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(&file, center, i, label_field);
+        it->shape = LoadShape(i);
         it->next = *current;
 
         /* insert into linked list (protected) */
@@ -186,6 +321,10 @@ TopographyFile::Update(const WindowProjection &map_projection)
   // end of list marker
   assert(*current == nullptr);
 
+  if (!complete)
+    /* force the next call to continue */
+    cache_bounds.SetInvalid();
+
   return true;
 }
 
@@ -193,12 +332,18 @@ void
 TopographyFile::LoadAll()
 {
   // Iterate through the shapefile entries
+  unsigned n_loaded = 0;
+  bool complete = true;
   const ShapeList **current = &first;
   auto it = shapes.begin();
   for (int i = 0; i < file.numshapes; ++i, ++it) {
+    if (store != nullptr && !store->IsShapeValid(i))
+      /* broken store entry: leave it out */
+      continue;
+
     if (it->shape == nullptr)
       // shape isn't cached yet -> cache the shape
-      it->shape = LoadShape(&file, center, i, label_field);
+      it->shape = LoadShape(i);
     // update list pointer
     *current = it;
     current = &it->next;
@@ -250,4 +395,11 @@ TopographyFile::GetMinimumPointDistance(unsigned level) const
   return 1;
 }
 
+ShapeScalar
+TopographyFile::GetMinimumShapeDistance(unsigned level) const
+{
+  return ShapeScalar(GetMinimumPointDistance(level))
+    / (Layout::Scale(1) * FAISphere::REARTH);
+}
+
 #endif
@@ -32,15 +32,25 @@ Copyright_License {
 #include "Screen/Color.hpp"
 #include "ResourceId.hpp"
 #include "Thread/Mutex.hpp"
+#include "OS/Path.hpp"
+#include "ShapeArena.hpp"
+#include "Util/StaticString.hxx"
 
 #ifdef ENABLE_OPENGL
 #include "XShapePoint.hpp"
 #endif
 
+#include <memory>
+#include <vector>
+
 #include <assert.h>
+#include <limits.h>
+#include <tchar.h>
 
 class WindowProjection;
 class XShape;
+class TopographyFileStore;
+class FileCache;
 struct zzip_dir;
 
 class TopographyFile {
@@ -62,6 +72,30 @@ class TopographyFile {
 
   shapefileObj file;
 
+  /**
+   * The name of the shapefile without directory and suffix, for
+   * display.
+   */
+  StaticString<32> name;
+
+  /**
+   * All #XShape objects of this file and their arrays are allocated
+   * here.
+   */
+  ShapeArena arena;
+
+  /**
+   * The preprocessed and memory-mapped version of #file.  If this is
+   * set, shapes are loaded from here, and #file has been closed
+   * already.
+   */
+  std::unique_ptr<TopographyFileStore> store;
+
+  /**
+   * Which shapes are inside #cache_bounds?  Only used with #store.
+   */
+  std::vector<bool> store_status;
+
   /**
    * The center of shapefileObj::bounds.
    */
@@ -160,6 +194,10 @@ public:
    * @param label_threshold the zoom threshold for label rendering
    * @param important_label_threshold labels below this zoom threshold will
    * be rendered in default style
+   * @param cache if not nullptr, then a preprocessed version of the
+   * shapefile is generated once, cached there and memory-mapped
+   * @param original_path the file the shapefile was loaded from (the
+   * map file); the cache is discarded when it gets modified
    * @return
    */
   TopographyFile(zzip_dir *dir, const char *shpname,
@@ -169,7 +207,9 @@ public:
                  int label_field=-1,
                  ResourceId icon=ResourceId::Null(),
                  ResourceId big_icon=ResourceId::Null(),
-                 unsigned pen_width=1);
+                 unsigned pen_width=1,
+                 FileCache *cache=nullptr,
+                 Path original_path=nullptr);
 
   TopographyFile(const TopographyFile &) = delete;
 
@@ -192,6 +232,36 @@ public:
     return shapes.empty();
   }
 
+  const TCHAR *GetName() const {
+    return name;
+  }
+
+  /**
+   * @return the number of bytes obtained from the heap for the
+   * currently loaded shapes
+   */
+  gcc_pure
+  size_t GetMemoryUsage() const {
+    return arena.GetAllocatedSize();
+  }
+
+  /**
+   * @return the number of bytes actually used by the currently
+   * loaded shapes; the difference to GetMemoryUsage() is
+   * fragmentation
+   */
+  gcc_pure
+  size_t GetUsedMemory() const {
+    return arena.GetUsedSize();
+  }
+
+  /**
+   * Are the shapes loaded from a preprocessed #TopographyFileStore?
+   */
+  bool HasStore() const {
+    return store != nullptr;
+  }
+
   bool IsVisible(double map_scale) const {
     return map_scale <= scale_threshold;
   }
@@ -275,6 +345,13 @@ public:
    */
   gcc_pure
   unsigned GetMinimumPointDistance(unsigned level) const;
+
+  /**
+   * @return GetMinimumPointDistance() converted from display pixels
+   * to ShapePoint coordinates
+   */
+  gcc_pure
+  ShapeScalar GetMinimumShapeDistance(unsigned level) const;
 #endif
 
   /**
@@ -282,6 +359,19 @@ public:
    */
   bool Update(const WindowProjection &map_projection);
 
+  /**
+   * Load all shapes inside the given bounds (plus a margin), if this
+   * file is visible at the given map scale.  This can be used to
+   * load a region before it is actually displayed.
+   *
+   * @param max_shapes the maximum number of shapes loaded by this
+   * call; if there are more, the cache remains incomplete, and the
+   * next call continues loading
+   * @return true if new data from the topography file has been loaded
+   */
+  bool Update(const GeoBounds &screen_bounds, double map_scale,
+              unsigned max_shapes=UINT_MAX);
+
   /**
    * Load all shapes into memory.  For debugging purposes.
    */
@@ -289,6 +379,17 @@ public:
 
 protected:
   void ClearCache();
+
+private:
+  /**
+   * Map the preprocessed shapefile from the cache, and generate it
+   * first if it is missing or stale.
+   *
+   * @return true if #store has been set up
+   */
+  bool OpenStore(FileCache &cache, Path original_path, const char *shpname);
+
+  XShape *LoadShape(unsigned i);
 };
 
 #endif
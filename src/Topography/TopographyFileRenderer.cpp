@@ -34,7 +34,6 @@ Copyright_License {
 #include "Util/AllocatedArray.hxx"
 #include "Util/tstring.hpp"
 #include "Geo/GeoClip.hpp"
-#include "Geo/FAISphere.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Screen/OpenGL/VertexPointer.hpp"
@@ -236,9 +235,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 
 #ifdef ENABLE_OPENGL
   const unsigned level = file.GetThinningLevel(map_scale);
-  const ShapeScalar min_distance =
-    ShapeScalar(file.GetMinimumPointDistance(level))
-    / (Layout::Scale(1) * FAISphere::REARTH);
+  const ShapeScalar min_distance = file.GetMinimumShapeDistance(level);
 
 #ifdef HAVE_GLES
   const float *const opengl_matrix = nullptr;
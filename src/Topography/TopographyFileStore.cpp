@@ -0,0 +1,470 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TopographyFileStore.hpp"
+#include "XShape.hpp"
+#include "Convert.hpp"
+#include "OS/FileMapping.hpp"
+#include "shapelib/mapserver.h"
+
+#include <algorithm>
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+using namespace TopographyFileStoreFormat;
+
+static constexpr uint64_t
+AlignUp(uint64_t offset)
+{
+  return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+/**
+ * Choose the grid dimension (columns and rows), aiming at a few
+ * shapes per cell.
+ */
+gcc_const
+static unsigned
+GridSize(unsigned n_shapes)
+{
+  return n_shapes >= 4 * 256 * 256
+    ? 256
+    : std::max(unsigned(sqrt(n_shapes / 4)), 1u);
+}
+
+namespace {
+
+/**
+ * Maps geographic coordinates to grid cells.  A grid crossing the
+ * date line degenerates to one cell.
+ */
+struct Grid {
+  double west, south;
+  double cell_width, cell_height;
+  unsigned columns, rows;
+
+  Grid(const Header &header)
+    :west(header.west), south(header.south),
+     columns(header.grid_columns), rows(header.grid_rows) {
+    cell_width = (header.east - west) / columns;
+    cell_height = (header.north - south) / rows;
+  }
+
+  gcc_pure
+  static unsigned Clamp(double value, unsigned n) {
+    return value <= 0 ? 0 : std::min(unsigned(value), n - 1);
+  }
+
+  /**
+   * Calculate the range of cells (inclusive) overlapping the given
+   * bounds.
+   */
+  void GetRange(double b_west, double b_south, double b_east, double b_north,
+                unsigned &column0, unsigned &row0,
+                unsigned &column1, unsigned &row1) const {
+    if (b_west > b_east || cell_width <= 0) {
+      /* wraps around the date line: check all columns */
+      column0 = 0;
+      column1 = columns - 1;
+    } else {
+      column0 = Clamp((b_west - west) / cell_width, columns);
+      column1 = Clamp((b_east - west) / cell_width, columns);
+    }
+
+    if (cell_height <= 0) {
+      row0 = 0;
+      row1 = rows - 1;
+    } else {
+      row0 = Clamp((b_south - south) / cell_height, rows);
+      row1 = Clamp((b_north - south) / cell_height, rows);
+    }
+  }
+};
+
+}
+
+template<typename T>
+static bool
+WriteSection(FILE *out, uint64_t &position, const std::vector<T> &v)
+{
+  static constexpr char padding[ALIGNMENT] = {};
+
+  const size_t pad = AlignUp(position) - position;
+  if (pad > 0 && fwrite(padding, 1, pad, out) != pad)
+    return false;
+
+  position += pad;
+
+  if (!v.empty() && fwrite(v.data(), sizeof(T), v.size(), out) != v.size())
+    return false;
+
+  position += v.size() * sizeof(T);
+  return true;
+}
+
+bool
+TopographyFileStoreWriter::Write(FILE *out, const float *min_distance) const
+{
+  const unsigned n_shapes = file.numshapes;
+
+  std::vector<Shape> shapes(n_shapes);
+  std::vector<uint16_t> lines;
+  std::vector<TopographyFileStore::Point> points;
+  std::vector<TCHAR> labels;
+  std::vector<uint16_t> indices;
+
+  /* pass 1: load and convert all shapes with the regular XShape
+     code, so the store contains exactly what XShape would have
+     produced */
+
+  for (unsigned i = 0; i < n_shapes; ++i) {
+    Shape &s = shapes[i];
+    memset(&s, 0, sizeof(s));
+    s.label = NONE;
+    std::fill_n(s.indices, THINNING_LEVELS, NONE);
+
+    const XShape shape(&file, center, i, label_field);
+
+    const GeoBounds &bounds = shape.get_bounds();
+    if (!bounds.Check() || shape.GetPoints() == nullptr) {
+      /* malformed or unsupported: an empty shape which is not
+         listed in the spatial index */
+      s.west = s.east = s.south = s.north = NAN;
+      continue;
+    }
+
+    s.west = bounds.GetWest().Native();
+    s.south = bounds.GetSouth().Native();
+    s.east = bounds.GetEast().Native();
+    s.north = bounds.GetNorth().Native();
+    s.type = shape.get_type();
+
+    const auto shape_lines = shape.GetLines();
+    s.num_lines = shape_lines.size;
+    s.first_line = lines.size();
+    s.first_point = points.size();
+
+    unsigned n_points = 0;
+    for (uint16_t n : shape_lines) {
+      lines.push_back(n);
+      n_points += n;
+    }
+
+    points.insert(points.end(), shape.GetPoints(),
+                  shape.GetPoints() + n_points);
+
+    const TCHAR *label = shape.GetLabel();
+    if (label != nullptr) {
+      s.label = labels.size();
+      labels.insert(labels.end(), label, label + _tcslen(label) + 1);
+    }
+
+#ifdef ENABLE_OPENGL
+    if (s.type == MS_SHAPE_LINE || s.type == MS_SHAPE_POLYGON) {
+      for (unsigned level = 0; level < THINNING_LEVELS; ++level) {
+        const uint16_t *count;
+        const uint16_t *idx = shape.GetIndices(level, min_distance[level],
+                                               count);
+        if (idx == nullptr)
+          continue;
+
+        const unsigned n_counts = s.type == MS_SHAPE_LINE ? s.num_lines : 1;
+        unsigned n_indices = 0;
+        for (unsigned j = 0; j < n_counts; ++j)
+          n_indices += count[j];
+
+        assert(idx == count + n_counts);
+
+        s.indices[level] = indices.size();
+        indices.insert(indices.end(), count, count + n_counts + n_indices);
+      }
+    }
+#else
+    (void)min_distance;
+#endif
+  }
+
+  /* pass 2: the spatial index */
+
+  const GeoBounds file_bounds = ImportRect(file.bounds);
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.flavour = MakeFlavour();
+  header.n_shapes = n_shapes;
+  header.label_field = label_field;
+  header.scale_threshold = scale_threshold;
+  header.west = file_bounds.GetWest().Native();
+  header.south = file_bounds.GetSouth().Native();
+  header.east = file_bounds.GetEast().Native();
+  header.north = file_bounds.GetNorth().Native();
+  header.grid_columns = header.grid_rows = GridSize(n_shapes);
+#ifdef ENABLE_OPENGL
+  std::copy_n(min_distance, THINNING_LEVELS, header.min_distance);
+#endif
+
+  const Grid grid(header);
+  const unsigned n_cells = header.grid_columns * header.grid_rows;
+
+  const auto visit_cells = [&grid, &header](const Shape &s, auto f){
+    unsigned column0, row0, column1, row1;
+    grid.GetRange(s.west, s.south, s.east, s.north,
+                  column0, row0, column1, row1);
+
+    for (unsigned row = row0; row <= row1; ++row)
+      for (unsigned column = column0; column <= column1; ++column)
+        f(row * header.grid_columns + column);
+  };
+
+  /* count the shapes of each cell, then fill the cells */
+
+  std::vector<uint32_t> cells(n_cells + 1, 0);
+  for (const auto &s : shapes)
+    if (!std::isnan(s.west))
+      visit_cells(s, [&cells](unsigned cell){ ++cells[cell + 1]; });
+
+  for (unsigned cell = 0; cell < n_cells; ++cell)
+    cells[cell + 1] += cells[cell];
+
+  std::vector<uint32_t> cell_shapes(cells[n_cells]);
+  std::vector<uint32_t> fill(cells.begin(), cells.end() - 1);
+  for (unsigned i = 0; i < n_shapes; ++i)
+    if (!std::isnan(shapes[i].west))
+      visit_cells(shapes[i], [&cell_shapes, &fill, i](unsigned cell){
+          cell_shapes[fill[cell]++] = i;
+        });
+
+  header.n_cell_shapes = cell_shapes.size();
+  header.n_line_entries = lines.size();
+  header.n_points = points.size();
+  header.n_index_entries = indices.size();
+  header.labels_size = labels.size();
+
+  /* pass 3: write everything */
+
+  uint64_t position = sizeof(header);
+  header.shapes = position = AlignUp(position);
+  position += shapes.size() * sizeof(Shape);
+  header.cells = position = AlignUp(position);
+  position += cells.size() * sizeof(uint32_t);
+  header.cell_shapes = position = AlignUp(position);
+  position += cell_shapes.size() * sizeof(uint32_t);
+  header.lines = position = AlignUp(position);
+  position += lines.size() * sizeof(uint16_t);
+  header.points = position = AlignUp(position);
+  position += points.size() * sizeof(points.front());
+  header.labels = position = AlignUp(position);
+  position += labels.size() * sizeof(TCHAR);
+  header.indices = position = AlignUp(position);
+
+  /* the header itself is aligned within the file, so the sections
+     are aligned within the (page aligned) mapping */
+  const long base = ftell(out);
+  if (base < 0)
+    return false;
+
+  uint64_t file_position = base;
+  if (!WriteSection(out, file_position, std::vector<char>()) ||
+      fwrite(&header, sizeof(header), 1, out) != 1)
+    return false;
+
+  position = sizeof(header);
+  return WriteSection(out, position, shapes) &&
+    WriteSection(out, position, cells) &&
+    WriteSection(out, position, cell_shapes) &&
+    WriteSection(out, position, lines) &&
+    WriteSection(out, position, points) &&
+    WriteSection(out, position, labels) &&
+    WriteSection(out, position, indices);
+}
+
+TopographyFileStore::TopographyFileStore(FileMapping *_mapping, size_t offset)
+  :mapping(_mapping),
+   base((const uint8_t *)mapping->at(std::min<size_t>(AlignUp(offset),
+                                                      mapping->size()))),
+   size(mapping->size() - std::min<size_t>(AlignUp(offset),
+                                           mapping->size()))
+{
+  assert(offset <= mapping->size());
+
+  memset(&header, 0, sizeof(header));
+
+  if (size < sizeof(header))
+    return;
+
+  memcpy(&header, base, sizeof(header));
+
+  if (header.magic != MAGIC || header.version != VERSION ||
+      header.flavour != MakeFlavour() ||
+      header.grid_columns == 0 || header.grid_rows == 0 ||
+      header.grid_columns > 256 || header.grid_rows > 256)
+    return;
+
+  const unsigned n_cells = header.grid_columns * header.grid_rows;
+
+  /* check the section bounds */
+  if (header.shapes < sizeof(header) ||
+      header.shapes + uint64_t(header.n_shapes) * sizeof(Shape) > header.cells ||
+      header.cells + uint64_t(n_cells + 1) * sizeof(uint32_t) > header.cell_shapes ||
+      header.cell_shapes + uint64_t(header.n_cell_shapes) * sizeof(uint32_t) > header.lines ||
+      header.lines + uint64_t(header.n_line_entries) * sizeof(uint16_t) > header.points ||
+      header.points + uint64_t(header.n_points) * sizeof(Point) > header.labels ||
+      header.labels + header.labels_size * sizeof(TCHAR) > header.indices ||
+      header.indices + uint64_t(header.n_index_entries) * sizeof(uint16_t) > size ||
+      header.shapes % ALIGNMENT != 0 || header.points % ALIGNMENT != 0)
+    return;
+
+  /* check the bounds of the grid cells; the shapes and the cell
+     entries are checked when they are accessed, so opening a store
+     does not have to read all of it */
+  const uint32_t *cells = At<uint32_t>(header.cells);
+  if (cells[n_cells] != header.n_cell_shapes)
+    return;
+
+  for (unsigned i = 0; i < n_cells; ++i)
+    if (cells[i] > cells[i + 1])
+      return;
+
+  shape_status.assign(header.n_shapes, ShapeStatus::UNKNOWN);
+
+  valid = true;
+}
+
+TopographyFileStore::~TopographyFileStore()
+{
+  delete mapping;
+}
+
+bool
+TopographyFileStore::CheckShape(unsigned i) const
+{
+  const Shape &s = GetShape(i);
+
+  if (s.first_line + uint64_t(s.num_lines) > header.n_line_entries)
+    return false;
+
+  uint64_t n_points = 0;
+  const uint16_t *lines = GetLines(s);
+  for (unsigned l = 0; l < s.num_lines; ++l)
+    n_points += lines[l];
+
+  if (s.first_point + n_points > header.n_points)
+    return false;
+
+  if (s.label != NONE) {
+    if (s.label >= header.labels_size)
+      return false;
+
+    /* the label must be null-terminated within the section */
+    const TCHAR *labels = At<TCHAR>(header.labels);
+    if (std::find(labels + s.label, labels + header.labels_size,
+                  TCHAR(0)) == labels + header.labels_size)
+      return false;
+  }
+
+  for (unsigned level = 0; level < THINNING_LEVELS; ++level) {
+    if (s.indices[level] == NONE)
+      continue;
+
+    const unsigned n_counts = s.type == MS_SHAPE_LINE ? s.num_lines : 1;
+    if (s.indices[level] + uint64_t(n_counts) > header.n_index_entries)
+      return false;
+
+    const uint16_t *count = At<uint16_t>(header.indices) + s.indices[level];
+    uint64_t n_indices = 0;
+    for (unsigned j = 0; j < n_counts; ++j)
+      n_indices += count[j];
+
+    if (s.indices[level] + n_counts + n_indices > header.n_index_entries)
+      return false;
+
+    const uint16_t *idx = count + n_counts;
+    for (uint64_t j = 0; j < n_indices; ++j)
+      if (idx[j] >= n_points)
+        return false;
+  }
+
+  return true;
+}
+
+bool
+TopographyFileStore::IsShapeValid(unsigned i) const
+{
+  ShapeStatus &status = shape_status[i];
+  if (status == ShapeStatus::UNKNOWN)
+    status = CheckShape(i) ? ShapeStatus::VALID : ShapeStatus::INVALID;
+
+  return status == ShapeStatus::VALID;
+}
+
+bool
+TopographyFileStore::IsValid(unsigned n_shapes, int label_field,
+                             unsigned scale_threshold) const
+{
+  return valid && header.n_shapes == n_shapes &&
+    header.label_field == label_field &&
+    header.scale_threshold == scale_threshold;
+}
+
+bool
+TopographyFileStore::FindShapes(const GeoBounds &bounds,
+                                std::vector<bool> &result) const
+{
+  assert(valid);
+
+  const GeoBounds store_bounds(GeoPoint(Angle::Native(header.west),
+                                        Angle::Native(header.north)),
+                               GeoPoint(Angle::Native(header.east),
+                                        Angle::Native(header.south)));
+  if (!store_bounds.Overlaps(bounds))
+    return false;
+
+  result.assign(header.n_shapes, false);
+
+  const Grid grid(header);
+  unsigned column0, row0, column1, row1;
+  grid.GetRange(bounds.GetWest().Native(), bounds.GetSouth().Native(),
+                bounds.GetEast().Native(), bounds.GetNorth().Native(),
+                column0, row0, column1, row1);
+
+  const uint32_t *cells = At<uint32_t>(header.cells);
+  const uint32_t *cell_shapes = At<uint32_t>(header.cell_shapes);
+
+  for (unsigned row = row0; row <= row1; ++row) {
+    for (unsigned column = column0; column <= column1; ++column) {
+      const unsigned cell = row * header.grid_columns + column;
+      for (unsigned j = cells[cell], end = cells[cell + 1]; j != end; ++j) {
+        const unsigned i = cell_shapes[j];
+        if (i < header.n_shapes && !result[i] &&
+            GetBounds(GetShape(i)).Overlaps(bounds) && IsShapeValid(i))
+          result[i] = true;
+      }
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,322 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TOPOGRAPHY_FILE_STORE_HPP
+#define XCSOAR_TOPOGRAPHY_FILE_STORE_HPP
+
+#include "shapelib/mapserver.h"
+#include "Geo/GeoBounds.hpp"
+#include "Compiler.h"
+
+#ifdef ENABLE_OPENGL
+#include "XShapePoint.hpp"
+#endif
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <tchar.h>
+
+class FileMapping;
+
+/**
+ * The on-disk layout of a preprocessed topography file.  It is
+ * generated once from a shapefile and cached with #FileCache; later,
+ * it is memory-mapped by #TopographyFileStore, and #XShape objects
+ * are merely views into the mapping.
+ *
+ * The store begins with a #Header, followed by these sections, each
+ * aligned to #ALIGNMENT:
+ *
+ * - one #Shape per shape
+ * - the spatial index: a grid of cells over the file bounds; for
+ *   each cell, the range of its shape numbers ("cells", n+1 uint32_t
+ *   offsets) and the shape numbers ("cell_shapes", uint32_t)
+ * - the point counts of all lines (uint16_t)
+ * - all points, already converted to the type #XShape uses
+ * - all labels (null-terminated TCHAR strings)
+ * - OpenGL only: the pre-thinned index arrays of all shapes and
+ *   thinning levels (uint16_t)
+ *
+ * Points and labels are stored in the native (build specific)
+ * representation; Header::flavour identifies it.
+ */
+namespace TopographyFileStoreFormat {
+  static constexpr uint32_t MAGIC = 0x504f5458;
+  static constexpr uint32_t VERSION = 1;
+
+  static constexpr unsigned ALIGNMENT = 8;
+
+  static constexpr unsigned THINNING_LEVELS = 4;
+
+  static constexpr uint32_t NONE = 0xffffffff;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+
+    /**
+     * Describes the build specific representation of points and
+     * labels; see MakeFlavour().
+     */
+    uint32_t flavour;
+
+    uint32_t n_shapes;
+
+    /**
+     * The label field and the scale threshold this store was
+     * generated with; labels and thinned indices depend on them.
+     */
+    int32_t label_field;
+    uint32_t scale_threshold;
+
+    /**
+     * The bounds of the grid (in radians).
+     */
+    double west, south, east, north;
+
+    uint32_t grid_columns, grid_rows;
+
+    /**
+     * OpenGL only: the minimum point distance (#ShapeScalar) each
+     * thinning level was built with.
+     */
+    float min_distance[THINNING_LEVELS];
+
+    uint32_t n_cell_shapes, n_line_entries, n_points, n_index_entries;
+    uint64_t labels_size;
+
+    /**
+     * Section offsets, relative to the beginning of the header.
+     */
+    uint64_t shapes, cells, cell_shapes, lines, points, labels, indices;
+  };
+
+  struct Shape {
+    /**
+     * The bounds of this shape (in radians).
+     */
+    double west, south, east, north;
+
+    uint32_t first_point;
+    uint32_t first_line;
+
+    /**
+     * Offset of the label within the labels section (in TCHAR
+     * units), or #NONE.
+     */
+    uint32_t label;
+
+    uint8_t type;
+    uint8_t num_lines;
+    uint8_t reserved[2];
+
+    /**
+     * OpenGL only: the position of the index count array for each
+     * thinning level within the indices section (see
+     * XShape::GetIndices()), or #NONE.
+     */
+    uint32_t indices[THINNING_LEVELS];
+  };
+
+  gcc_const
+  static inline uint32_t
+  MakeFlavour() {
+#ifdef ENABLE_OPENGL
+    return sizeof(ShapePoint) | (sizeof(TCHAR) << 8) | (1 << 16);
+#else
+    return sizeof(GeoPoint) | (sizeof(TCHAR) << 8);
+#endif
+  }
+}
+
+/**
+ * Generates a topography store (see #TopographyFileStoreFormat) from
+ * a shapefile.
+ */
+class TopographyFileStoreWriter {
+  shapefileObj &file;
+  const GeoPoint center;
+  const int label_field;
+  const unsigned scale_threshold;
+
+public:
+  /**
+   * @param center the center used for relative #ShapePoint
+   * coordinates
+   * @param scale_threshold the scale threshold of the
+   * #TopographyFile, used to pre-thin the shapes
+   */
+  TopographyFileStoreWriter(shapefileObj &_file, const GeoPoint &_center,
+                            int _label_field, unsigned _scale_threshold)
+    :file(_file), center(_center), label_field(_label_field),
+     scale_threshold(_scale_threshold) {}
+
+  /**
+   * Read all shapes and write the store to the given file.  The
+   * caller is responsible for closing the file afterwards.
+   *
+   * @param min_distance the minimum point distance (#ShapeScalar)
+   * for each thinning level (OpenGL only)
+   * @return true on success
+   */
+  bool Write(FILE *out, const float *min_distance) const;
+};
+
+/**
+ * A read-only, memory-mapped topography store (see
+ * #TopographyFileStoreFormat).
+ */
+class TopographyFileStore {
+  FileMapping *const mapping;
+
+  /**
+   * The beginning of the #TopographyFileStoreFormat::Header within
+   * the mapping.
+   */
+  const uint8_t *const base;
+
+  const size_t size;
+
+  TopographyFileStoreFormat::Header header;
+
+  enum class ShapeStatus : uint8_t {
+    UNKNOWN, VALID, INVALID,
+  };
+
+  /**
+   * The result of CheckShape() for each shape, filled on demand by
+   * FindShapes().
+   */
+  mutable std::vector<ShapeStatus> shape_status;
+
+  bool valid = false;
+
+public:
+#ifdef ENABLE_OPENGL
+  typedef ShapePoint Point;
+#else
+  typedef GeoPoint Point;
+#endif
+
+  /**
+   * @param mapping the file mapping; this object takes over
+   * ownership
+   * @param offset the offset of the store within the mapping (the
+   * store itself begins at the next #ALIGNMENT boundary)
+   */
+  TopographyFileStore(FileMapping *_mapping, size_t offset);
+  ~TopographyFileStore();
+
+  TopographyFileStore(const TopographyFileStore &) = delete;
+  TopographyFileStore &operator=(const TopographyFileStore &) = delete;
+
+  /**
+   * Check whether the store header and its spatial index are intact
+   * and whether it was generated with the given parameters.  The
+   * shapes are checked later, when FindShapes() finds them.
+   */
+  gcc_pure
+  bool IsValid(unsigned n_shapes, int label_field,
+               unsigned scale_threshold) const;
+
+  unsigned size_shapes() const {
+    return header.n_shapes;
+  }
+
+  gcc_pure
+  const TopographyFileStoreFormat::Shape &GetShape(unsigned i) const {
+    return At<TopographyFileStoreFormat::Shape>(header.shapes)[i];
+  }
+
+  gcc_pure
+  static GeoBounds GetBounds(const TopographyFileStoreFormat::Shape &shape) {
+    return GeoBounds(GeoPoint(Angle::Native(shape.west),
+                              Angle::Native(shape.north)),
+                     GeoPoint(Angle::Native(shape.east),
+                              Angle::Native(shape.south)));
+  }
+
+  const uint16_t *GetLines(const TopographyFileStoreFormat::Shape &shape) const {
+    return At<uint16_t>(header.lines) + shape.first_line;
+  }
+
+  const Point *GetPoints(const TopographyFileStoreFormat::Shape &shape) const {
+    return At<Point>(header.points) + shape.first_point;
+  }
+
+  const TCHAR *GetLabel(const TopographyFileStoreFormat::Shape &shape) const {
+    return shape.label != TopographyFileStoreFormat::NONE
+      ? At<TCHAR>(header.labels) + shape.label
+      : nullptr;
+  }
+
+  /**
+   * Obtain the pre-thinned index count array (followed by the
+   * indices, see XShape::GetIndices()) of the given shape.
+   *
+   * @return nullptr if there are none or if they were built with a
+   * different minimum distance
+   */
+  const uint16_t *GetIndices(const TopographyFileStoreFormat::Shape &shape,
+                             unsigned level, float min_distance) const {
+    return shape.indices[level] != TopographyFileStoreFormat::NONE &&
+      header.min_distance[level] == min_distance
+      ? At<uint16_t>(header.indices) + shape.indices[level]
+      : nullptr;
+  }
+
+  /**
+   * Check (once) whether the data of the given shape is intact.  Not
+   * thread-safe, see FindShapes().
+   */
+  bool IsShapeValid(unsigned i) const;
+
+  /**
+   * Look up all shapes whose bounds overlap the given bounds in the
+   * spatial index.
+   *
+   * Shapes whose data is broken are never found.  This method is
+   * not thread-safe, because it remembers which shapes have been
+   * checked.
+   *
+   * @param result an array of #size_shapes() elements; the elements
+   * of matching shapes are set to true, all others to false
+   * @return false if the bounds do not overlap this store at all (in
+   * which case #result is left untouched)
+   */
+  bool FindShapes(const GeoBounds &bounds, std::vector<bool> &result) const;
+
+private:
+  template<typename T>
+  const T *At(uint64_t offset) const {
+    return (const T *)(base + offset);
+  }
+
+  gcc_pure
+  bool CheckShape(unsigned i) const;
+};
+
+#endif
@@ -30,6 +30,7 @@ Copyright_License {
 #include "IO/MapFile.hpp"
 #include "IO/ZipArchive.hpp"
 #include "IO/ZipLineReader.hpp"
+#include "OS/Path.hpp"
 
 /**
  * Load topography from the map file (ZIP), load the other files from
@@ -37,14 +38,17 @@ Copyright_License {
  */
 static bool
 LoadConfiguredTopographyZip(TopographyStore &store,
-                            OperationEnvironment &operation)
+                            OperationEnvironment &operation,
+                            FileCache *cache)
 try {
   auto archive = OpenMapFile();
   if (!archive)
     return false;
 
+  const auto path = Profile::GetPath(ProfileKeys::MapFile);
+
   ZipLineReaderA reader(archive->get(), "topology.tpl");
-  store.Load(operation, reader, nullptr, archive->get());
+  store.Load(operation, reader, nullptr, archive->get(), cache, path);
   return true;
 } catch (const std::runtime_error &e) {
   LogError("No topography in map file", e);
@@ -53,10 +57,11 @@ try {
 
 bool
 LoadConfiguredTopography(TopographyStore &store,
-                         OperationEnvironment &operation)
+                         OperationEnvironment &operation,
+                         FileCache *cache)
 {
   LogFormat("Loading Topography File...");
   operation.SetText(_("Loading Topography File..."));
 
-  return LoadConfiguredTopographyZip(store, operation);
+  return LoadConfiguredTopographyZip(store, operation, cache);
 }
@@ -26,9 +26,14 @@ Copyright_License {
 
 class TopographyStore;
 class OperationEnvironment;
+class FileCache;
 
+/**
+ * @param cache an optional cache for preprocessed shapefiles
+ */
 bool
 LoadConfiguredTopography(TopographyStore &store,
-                         OperationEnvironment &operation);
+                         OperationEnvironment &operation,
+                         FileCache *cache=nullptr);
 
 #endif
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Topography/TopographyStore.hpp"
 #include "Topography/TopographyFile.hpp"
+#include "Projection/WindowProjection.hpp"
 #include "Util/StringAPI.hxx"
 #include "Util/StringCompare.hxx"
 #include "Util/ConvertString.hpp"
@@ -108,6 +109,14 @@ TopographyStore::GetNextScaleThreshold(double map_scale) const
 unsigned
 TopographyStore::ScanVisibility(const WindowProjection &m_projection,
                               unsigned max_update)
+{
+  return ScanVisibility(m_projection.GetScreenBounds(),
+                        m_projection.GetMapScale(), max_update);
+}
+
+unsigned
+TopographyStore::ScanVisibility(const GeoBounds &bounds, double map_scale,
+                              unsigned max_update, unsigned max_shapes)
 {
   // check if any needs to have cache updates because wasnt
   // visible previously when bounds moved
@@ -116,7 +125,7 @@ TopographyStore::ScanVisibility(const WindowProjection &m_projection,
   // to make sure eventually everything gets refreshed
   unsigned num_updated = 0;
   for (auto *file : files) {
-    if (file->Update(m_projection)) {
+    if (file->Update(bounds, map_scale, max_shapes)) {
       ++num_updated;
       if (num_updated >= max_update)
         break;
@@ -143,7 +152,8 @@ TopographyStore::~TopographyStore()
 
 void
 TopographyStore::Load(OperationEnvironment &operation, NLineReader &reader,
-                      const TCHAR *directory, struct zzip_dir *zdir)
+                      const TCHAR *directory, struct zzip_dir *zdir,
+                      FileCache *cache, Path original_path)
 {
   Reset();
 
@@ -289,7 +299,8 @@ TopographyStore::Load(OperationEnvironment &operation, NLineReader &reader,
                                               Color(red, green, blue),
 #endif
                                               shape_field, icon, big_icon,
-                                              pen_width);
+                                              pen_width,
+                                              cache, original_path);
     if (file->IsEmpty())
       // If the shape file could not be read -> skip this line/file
       delete file;
@@ -26,14 +26,18 @@ Copyright_License {
 
 #include "Util/NonCopyable.hpp"
 #include "Util/StaticArray.hxx"
+#include "OS/Path.hpp"
 #include "Compiler.h"
 
+#include <limits.h>
 #include <tchar.h>
 
 class WindowProjection;
+class GeoBounds;
 class TopographyFile;
 class NLineReader;
 class OperationEnvironment;
+class FileCache;
 struct zzip_dir;
 
 /**
@@ -86,14 +90,33 @@ public:
   unsigned ScanVisibility(const WindowProjection &m_projection,
                           unsigned max_update=1024);
 
+  /**
+   * Like ScanVisibility(const WindowProjection &, unsigned), but
+   * with explicit bounds and map scale.  This is used to load a
+   * region speculatively, before it becomes visible.
+   *
+   * @param max_shapes the maximum number of shapes loaded per file,
+   * see TopographyFile::Update()
+   */
+  unsigned ScanVisibility(const GeoBounds &bounds, double map_scale,
+                          unsigned max_update=1024,
+                          unsigned max_shapes=UINT_MAX);
+
   /**
    * Load all shapes of all files into memory.  For debugging
    * purposes.
    */
   void LoadAll();
 
+  /**
+   * @param cache if not nullptr, then preprocessed shapefiles are
+   * stored there and memory-mapped, see #TopographyFileStore
+   * @param original_path the path of the file which contains the
+   * shapefiles; required for the cache
+   */
   void Load(OperationEnvironment &operation, NLineReader &reader,
-            const TCHAR *directory, struct zzip_dir *zdir = nullptr);
+            const TCHAR *directory, struct zzip_dir *zdir = nullptr,
+            FileCache *cache = nullptr, Path original_path = nullptr);
   void Reset();
 };
 
@@ -22,7 +22,10 @@ Copyright_License {
 */
 
 #include "Topography/XShape.hpp"
+#include "Topography/TopographyFileStore.hpp"
+#include "Topography/ShapeArena.hpp"
 #include "Convert.hpp"
+#include "Util/AllocatedString.hxx"
 #include "Util/StringAPI.hxx"
 #include "Util/UTF8.hpp"
 #include "Util/StringUtil.hpp"
@@ -63,6 +66,37 @@ ImportLabel(const char *src)
 #endif
 }
 
+template<typename T>
+static T *
+AllocateArray(ShapeArena *arena, size_t n)
+{
+  return arena != nullptr
+    ? arena->NewArray<T>(n)
+    : new T[n];
+}
+
+template<typename T>
+static void
+FreeArray(ShapeArena *arena, const T *p)
+{
+  if (arena != nullptr)
+    arena->Free(const_cast<T *>(p));
+  else
+    delete[] p;
+}
+
+static const TCHAR *
+StoreLabel(ShapeArena *arena, AllocatedString<TCHAR> &&src)
+{
+  if (arena == nullptr || src.IsNull())
+    return src.Steal();
+
+  const size_t size = _tcslen(src.c_str()) + 1;
+  TCHAR *dest = arena->NewArray<TCHAR>(size);
+  std::copy_n(src.c_str(), size, dest);
+  return dest;
+}
+
 /**
  * Returns the minimum number of points for each line of this shape
  * type.  Returns -1 if the shape type is not supported.
@@ -88,8 +122,9 @@ GetMinPointsForShapeType(int shapelib_type)
 }
 
 XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
-               int label_field)
-  :label(nullptr)
+               int label_field, ShapeArena *_arena)
+  :type(MS_SHAPE_NULL), num_lines(0), label(nullptr), store(nullptr),
+   arena(_arena)
 {
 #ifdef ENABLE_OPENGL
   std::fill_n(index_count, THINNING_LEVELS, nullptr);
@@ -136,13 +171,13 @@ XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
   /* OpenGL: convert GeoPoints to ShapePoints, make them relative to
      the map's boundary center */
 
-  points = new ShapePoint[num_points];
-  ShapePoint *p = points;
+  ShapePoint *p = AllocateArray<ShapePoint>(arena, num_points);
+  points = p;
 #else // !ENABLE_OPENGL
   /* convert all points of all lines to GeoPoints */
 
-  points = new GeoPoint[num_points];
-  GeoPoint *p = points;
+  GeoPoint *p = AllocateArray<GeoPoint>(arena, num_points);
+  points = p;
 #endif
   for (unsigned l = 0; l < num_lines; ++l) {
     const pointObj *src = shape.line[l].point;
@@ -163,17 +198,40 @@ XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
 
   if (label_field >= 0) {
     const char *src = msDBFReadStringAttribute(shpfile->hDBF, i, label_field);
-    label = ImportLabel(src);
+    label = StoreLabel(arena, ImportLabel(src));
   }
 }
 
+XShape::XShape(const TopographyFileStore &_store, unsigned i,
+               ShapeArena *_arena)
+  :store(&_store), store_index(i), arena(_arena)
+{
+#ifdef ENABLE_OPENGL
+  std::fill_n(index_count, THINNING_LEVELS, nullptr);
+  std::fill_n(indices, THINNING_LEVELS, nullptr);
+#endif
+
+  const auto &shape = store->GetShape(i);
+
+  bounds = TopographyFileStore::GetBounds(shape);
+  type = shape.type;
+  num_lines = std::min(unsigned(shape.num_lines), (unsigned)MAX_LINES);
+  std::copy_n(store->GetLines(shape), num_lines, lines);
+  points = store->GetPoints(shape);
+  label = store->GetLabel(shape);
+}
+
 XShape::~XShape()
 {
-  delete[] points;
+  if (store == nullptr) {
+    FreeArray(arena, points);
+    FreeArray(arena, label);
+  }
+
 #ifdef ENABLE_OPENGL
   // Note: index_count and indices share one buffer
   for (unsigned i = 0; i < THINNING_LEVELS; i++)
-    delete[] index_count[i];
+    FreeArray(arena, index_count[i]);
 #endif
 }
 
@@ -194,7 +252,7 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance)
     if (num_points <= 2)
       return false;  // line cannot be simplified, so don't create indices
     index_count[thinning_level] = idx_count =
-      new GLushort[num_lines + num_points];
+      AllocateArray<GLushort>(arena, num_lines + num_points);
     indices[thinning_level] = idx = idx_count + num_lines;
 
     const uint16_t *end_l = lines + num_lines;
@@ -224,7 +282,8 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance)
     return true;
   } else if (type == MS_SHAPE_POLYGON) {
     index_count[thinning_level] = idx_count =
-      new GLushort[1 + 3*(num_points-2) + 2*(num_lines-1)];
+      AllocateArray<GLushort>(arena,
+                              1 + 3*(num_points-2) + 2*(num_lines-1));
     indices[thinning_level] = idx = idx_count + 1;
 
     *idx_count = 0;
@@ -254,6 +313,18 @@ XShape::GetIndices(int thinning_level, ShapeScalar min_distance,
                    const uint16_t *&count) const
 {
   if (indices[thinning_level] == nullptr) {
+    if (store != nullptr) {
+      /* use the pre-thinned indices if they were built with the same
+         minimum distance */
+      const uint16_t *c =
+        store->GetIndices(store->GetShape(store_index), thinning_level,
+                          min_distance);
+      if (c != nullptr) {
+        count = c;
+        return c + (type == MS_SHAPE_LINE ? num_lines : 1);
+      }
+    }
+
     XShape &deconst = const_cast<XShape &>(*this);
     if (!deconst.BuildIndices(thinning_level, min_distance))
       return nullptr;
@@ -26,7 +26,6 @@ Copyright_License {
 #define TOPOGRAPHY_XSHAPE_HPP
 
 #include "Util/ConstBuffer.hxx"
-#include "Util/AllocatedString.hxx"
 #include "Geo/GeoBounds.hpp"
 #include "shapelib/mapserver.h"
 #include "shapelib/mapshape.h"
@@ -38,13 +37,17 @@ Copyright_License {
 #include <stdint.h>
 
 struct GeoPoint;
+class TopographyFileStore;
+class ShapeArena;
 
 class XShape {
+public:
   static constexpr unsigned MAX_LINES = 32;
 #ifdef ENABLE_OPENGL
   static constexpr unsigned THINNING_LEVELS = 4;
 #endif
 
+private:
   GeoBounds bounds;
 
   uint8_t type;
@@ -65,7 +68,7 @@ class XShape {
    * All points of all lines.
    */
 #ifdef ENABLE_OPENGL
-  ShapePoint *points;
+  const ShapePoint *points;
 
   /**
    * Indices of polygon triangles or lines with reduced number of vertices.
@@ -86,14 +89,39 @@ class XShape {
    */
   mutable unsigned offset;
 #else // !ENABLE_OPENGL
-  GeoPoint *points;
+  const GeoPoint *points;
 #endif
 
-  AllocatedString<TCHAR> label;
+  const TCHAR *label;
+
+  /**
+   * If this is not nullptr, then this object is a view of a shape in
+   * the given #TopographyFileStore and does not own #points and
+   * #label.
+   */
+  const TopographyFileStore *store;
+  unsigned store_index;
+
+  /**
+   * The allocator for all arrays owned by this object.  If nullptr,
+   * they are allocated on the heap.
+   */
+  ShapeArena *const arena;
 
 public:
+  /**
+   * @param arena if not nullptr, then all arrays are allocated there;
+   * it must outlive this object
+   */
   XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
-         int label_field=-1);
+         int label_field=-1, ShapeArena *arena=nullptr);
+
+  /**
+   * Construct a view of a shape in a memory-mapped
+   * #TopographyFileStore.  The store must outlive this object.
+   */
+  XShape(const TopographyFileStore &store, unsigned i,
+         ShapeArena *arena=nullptr);
 
   XShape(const XShape &) = delete;
 
@@ -138,7 +166,7 @@ public:
   }
 
   const TCHAR *GetLabel() const {
-    return label.c_str();
+    return label;
   }
 };
 
@@ -28,12 +28,37 @@ Copyright_License {
 #include "OS/ByteOrder.hpp"
 #include "Util/CRC.hpp"
 
+#include <stdexcept>
+
+#ifdef __linux__
+#include <boost/system/system_error.hpp>
+
+#include <algorithm>
+
+#include <sys/socket.h>
+#include <poll.h>
+#include <errno.h>
+#endif
+
 namespace SkyLinesTracking {
 
 Server::Server(boost::asio::io_service &io_service,
-               boost::asio::ip::udp::endpoint endpoint)
-  :socket(io_service, endpoint)
+               boost::asio::ip::udp::endpoint endpoint,
+               bool reuse_port)
+  :socket(io_service, endpoint.protocol())
 {
+  if (reuse_port) {
+#ifdef SO_REUSEPORT
+    using ReusePort =
+      boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+    socket.set_option(ReusePort(true));
+#else
+    throw std::runtime_error("SO_REUSEPORT is not supported");
+#endif
+  }
+
+  socket.bind(endpoint);
+
   AsyncReceive();
 }
 
@@ -58,6 +83,67 @@ Server::SendBuffer(const boost::asio::ip::udp::endpoint &endpoint,
   }
 }
 
+void
+Server::SendBatch(const Datagram *datagrams, size_t n)
+{
+#ifdef __linux__
+  static constexpr size_t CHUNK_SIZE = 64;
+
+  struct mmsghdr msgs[CHUNK_SIZE];
+  struct iovec iov[CHUNK_SIZE];
+
+  const int fd = socket.native_handle();
+
+  while (n > 0) {
+    const size_t chunk = std::min(n, CHUNK_SIZE);
+
+    for (size_t i = 0; i < chunk; ++i) {
+      const auto &d = datagrams[i];
+      iov[i].iov_base =
+        const_cast<void *>(boost::asio::buffer_cast<const void *>(d.data));
+      iov[i].iov_len = boost::asio::buffer_size(d.data);
+
+      auto &h = msgs[i].msg_hdr;
+      h.msg_name = const_cast<void *>((const void *)d.endpoint->data());
+      h.msg_namelen = d.endpoint->size();
+      h.msg_iov = &iov[i];
+      h.msg_iovlen = 1;
+      h.msg_control = nullptr;
+      h.msg_controllen = 0;
+      h.msg_flags = 0;
+    }
+
+    int result = sendmmsg(fd, msgs, chunk, 0);
+    if (result < 0) {
+      const int e = errno;
+      if (e == EINTR)
+        continue;
+
+      if (e == EAGAIN || e == EWOULDBLOCK) {
+        /* asio may have switched the socket to non-blocking mode;
+           wait until the kernel has room for more */
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLOUT;
+        poll(&pfd, 1, -1);
+        continue;
+      }
+
+      /* the first datagram of this chunk has failed; skip it */
+      const boost::system::error_code ec(e, boost::system::system_category());
+      OnSendError(*datagrams[0].endpoint, boost::system::system_error(ec));
+      result = 1;
+    }
+
+    datagrams += result;
+    n -= result;
+  }
+#else
+  for (size_t i = 0; i < n; ++i)
+    SendBuffer(*datagrams[i].endpoint, datagrams[i].data);
+#endif
+}
+
 void
 Server::OnPing(const Client &client, unsigned id)
 {
@@ -28,6 +28,7 @@ Copyright_License {
 
 #include <chrono>
 
+#include <stddef.h>
 #include <stdint.h>
 
 struct GeoPoint;
@@ -51,12 +52,26 @@ public:
     uint64_t key;
   };
 
+  /**
+   * One element of a SendBatch() call.
+   */
+  struct Datagram {
+    const boost::asio::ip::udp::endpoint *endpoint;
+    boost::asio::const_buffer data;
+  };
+
 private:
   Client client_buffer;
 
 public:
+  /**
+   * @param reuse_port set SO_REUSEPORT, which allows several
+   * #Server instances (e.g. one per thread) to bind to the same port;
+   * the kernel distributes the incoming datagrams among them
+   */
   Server(boost::asio::io_service &io_service,
-         boost::asio::ip::udp::endpoint endpoint);
+         boost::asio::ip::udp::endpoint endpoint,
+         bool reuse_port=false);
 
   ~Server();
 
@@ -83,6 +98,14 @@ public:
     SendBuffer(endpoint, boost::asio::buffer(&packet, sizeof(packet)));
   }
 
+  /**
+   * Send many datagrams at once.  On Linux, this needs only one
+   * sendmmsg() system call per chunk of datagrams.  A failure is
+   * reported to OnSendError(), and the remaining datagrams are still
+   * sent.
+   */
+  void SendBatch(const Datagram *datagrams, size_t n);
+
 private:
   void OnDatagramReceived(Client &&client, void *data, size_t length);
   void OnReceive(const boost::system::error_code &ec, size_t size);
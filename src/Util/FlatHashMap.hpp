@@ -0,0 +1,213 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLAT_HASH_MAP_HPP
+#define XCSOAR_FLAT_HASH_MAP_HPP
+
+#include "Compiler.h"
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A hash map with open addressing (linear probing).  The items are
+ * stored contiguously in insertion order and are addressed by their
+ * index, which remains valid until clear() is called; the hash table
+ * itself only contains indices.
+ *
+ * Items cannot be removed individually.  clear() keeps the allocated
+ * memory, so a map which is cleared and refilled repeatedly (e.g. by
+ * a search algorithm) does not allocate after the first run.
+ */
+template<typename K, typename V,
+         typename Hash=std::hash<K>, typename KeyEqual=std::equal_to<K>>
+class FlatHashMap {
+public:
+  typedef unsigned size_type;
+
+  static constexpr size_type NOT_FOUND = ~size_type(0);
+
+  struct Item {
+    K key;
+    V value;
+
+    Item(const K &_key, const V &_value):key(_key), value(_value) {}
+  };
+
+private:
+  static constexpr size_type MIN_SLOTS = 64;
+
+  std::vector<Item> items;
+
+  /**
+   * The hash table: an index into #items or #NOT_FOUND.  Its size
+   * is a power of two, and it is at most half full.
+   */
+  std::vector<size_type> slots;
+
+  /**
+   * The number of bits of the hash which select a slot.
+   */
+  unsigned slot_bits = 0;
+
+  /**
+   * The number of times the storage has been (re)allocated; for
+   * statistics.
+   */
+  unsigned long n_allocations = 0;
+
+  Hash hash;
+  KeyEqual key_equal;
+
+public:
+  size_type size() const {
+    return items.size();
+  }
+
+  bool empty() const {
+    return items.empty();
+  }
+
+  /**
+   * Remove all items, but keep the allocated memory.
+   */
+  void clear() {
+    items.clear();
+    std::fill(slots.begin(), slots.end(), size_type(NOT_FOUND));
+  }
+
+  /**
+   * Make sure that the given number of items fits without
+   * allocating.
+   */
+  void reserve(size_type n) {
+    ReserveItems(n);
+    if (n * 2 > slots.size())
+      Rehash(n * 2);
+  }
+
+  Item &operator[](size_type i) {
+    assert(i < items.size());
+
+    return items[i];
+  }
+
+  const Item &operator[](size_type i) const {
+    assert(i < items.size());
+
+    return items[i];
+  }
+
+  /**
+   * @return the index of the item with the given key, or #NOT_FOUND
+   */
+  gcc_pure
+  size_type Find(const K &key) const {
+    if (slots.empty())
+      return NOT_FOUND;
+
+    const size_type mask = slots.size() - 1;
+    for (size_type slot = GetSlot(key);; slot = (slot + 1) & mask) {
+      const size_type i = slots[slot];
+      if (i == NOT_FOUND || key_equal(items[i].key, key))
+        return i;
+    }
+  }
+
+  /**
+   * Insert a new item unless the key exists already.
+   *
+   * @return the index of the item with the given key, and true if
+   * it was inserted (false if an item with this key existed, which
+   * is left unmodified)
+   */
+  std::pair<size_type, bool> Insert(const K &key, const V &value) {
+    if ((items.size() + 1) * 2 > slots.size())
+      Rehash(std::max<size_type>(slots.size() * 2, size_type(MIN_SLOTS)));
+
+    const size_type mask = slots.size() - 1;
+    size_type slot = GetSlot(key);
+    for (;; slot = (slot + 1) & mask) {
+      const size_type i = slots[slot];
+      if (i == NOT_FOUND)
+        break;
+
+      if (key_equal(items[i].key, key))
+        return std::make_pair(i, false);
+    }
+
+    const size_type i = items.size();
+    ReserveItems(i + 1);
+    items.emplace_back(key, value);
+    slots[slot] = i;
+    return std::make_pair(i, true);
+  }
+
+  unsigned long GetAllocationCount() const {
+    return n_allocations;
+  }
+
+private:
+  gcc_pure
+  size_type GetSlot(const K &key) const {
+    /* Fibonacci hashing: spread poor hash functions (such as the
+       identity for integers) over the whole table */
+    const uint64_t h = uint64_t(hash(key)) * 0x9e3779b97f4a7c15ull;
+    return size_type(h >> (64 - slot_bits));
+  }
+
+  void ReserveItems(size_type n) {
+    if (n > items.capacity()) {
+      items.reserve(std::max<size_type>(n, items.capacity() * 2));
+      ++n_allocations;
+    }
+  }
+
+  /**
+   * Resize the hash table to at least the given number of slots and
+   * insert all items again.
+   */
+  void Rehash(size_type n) {
+    unsigned bits = 1;
+    while ((size_type(1) << bits) < n)
+      ++bits;
+
+    slot_bits = bits;
+    slots.assign(size_type(1) << bits, size_type(NOT_FOUND));
+    ++n_allocations;
+
+    const size_type mask = slots.size() - 1;
+    for (size_type i = 0, end = items.size(); i < end; ++i) {
+      size_type slot = GetSlot(items[i].key);
+      while (slots[slot] != NOT_FOUND)
+        slot = (slot + 1) & mask;
+      slots[slot] = i;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,408 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_PACKED_KD_TREE_HPP
+#define XCSOAR_PACKED_KD_TREE_HPP
+
+#include "Compiler.h"
+
+#include <vector>
+#include <algorithm>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A static two-dimensional KD tree which is stored in one contiguous
+ * array.  It is built at once from a range of values and cannot be
+ * modified afterwards, only rebuilt.
+ *
+ * The tree is implicit: the median of each range (split alternately
+ * by the X and the Y coordinate) is at the middle index, the lower
+ * half is on the left and the upper half on the right.  Ranges which
+ * have no more than #LEAF_SIZE elements are scanned linearly.  No
+ * child pointers are needed, and each query touches only a few
+ * cache lines per level.
+ *
+ * The Accessor provides the integer coordinates of a value with
+ * GetX() and GetY(), just like the one of #QuadTree.
+ */
+template<typename T, typename Accessor>
+class PackedKDTree {
+  struct AlwaysTrue {
+    constexpr
+    bool operator()(const T &) const {
+      return true;
+    }
+  };
+
+  /**
+   * Ranges up to this size are not split any further.
+   */
+  static constexpr unsigned LEAF_SIZE = 8;
+
+public:
+  typedef unsigned size_type;
+  typedef int position_type;
+  typedef unsigned distance_type;
+
+  /**
+   * Square distances are calculated with 64 bit, so they cannot
+   * overflow even when the points are on opposite sides of the
+   * projection.
+   */
+  typedef uint64_t square_distance_type;
+
+  constexpr
+  static square_distance_type Square(int64_t x) {
+    return x * x;
+  }
+
+  /**
+   * A location on the plane.
+   */
+  struct Point {
+    position_type x, y;
+
+    constexpr
+    Point(position_type _x, position_type _y):x(_x), y(_y) {}
+
+    constexpr
+    square_distance_type SquareDistanceTo(const Point &other) const {
+      return Square(int64_t(other.x) - x) + Square(int64_t(other.y) - y);
+    }
+
+    constexpr
+    position_type Get(unsigned axis) const {
+      return axis == 0 ? x : y;
+    }
+  };
+
+private:
+  struct Node {
+    Point position;
+    T value;
+
+    Node(const Point &_position, const T &_value)
+      :position(_position), value(_value) {}
+  };
+
+  /**
+   * A search result of VisitNearestIf().  The heap is ordered by
+   * distance, and then by index to make the result deterministic.
+   */
+  struct Candidate {
+    square_distance_type square_distance;
+    size_type index;
+
+    constexpr
+    bool operator<(const Candidate &other) const {
+      return square_distance != other.square_distance
+        ? square_distance < other.square_distance
+        : index < other.index;
+    }
+  };
+
+  std::vector<Node> nodes;
+
+  Accessor accessor;
+
+public:
+  size_type size() const {
+    return nodes.size();
+  }
+
+  bool empty() const {
+    return nodes.empty();
+  }
+
+  void clear() {
+    nodes.clear();
+  }
+
+  gcc_pure
+  Point GetPosition(const T &value) const {
+    return Point(accessor.GetX(value), accessor.GetY(value));
+  }
+
+  /**
+   * Discard the current contents and build a new tree from the
+   * specified range.
+   */
+  template<typename I>
+  void Build(I first, I last) {
+    BuildIf(first, last, AlwaysTrue());
+  }
+
+  /**
+   * Like Build(), but include only the values which match the
+   * predicate.
+   */
+  template<typename I, typename P>
+  void BuildIf(I first, I last, const P &predicate) {
+    nodes.clear();
+    for (; first != last; ++first)
+      if (predicate(*first))
+        nodes.emplace_back(GetPosition(*first), *first);
+
+    Split(0, nodes.size(), 0);
+  }
+
+  /**
+   * Find the item nearest to the given location which matches the
+   * predicate.
+   *
+   * @param range the maximum distance (inclusive)
+   * @return a pointer to the item, or nullptr if there is none
+   */
+  template<typename P>
+  gcc_pure
+  const T *FindNearestIf(const Point location, distance_type range,
+                         const P &predicate) const {
+    size_type nearest = size();
+    square_distance_type nearest_square_distance = Square(range) + 1;
+    FindNearestIf(0, size(), 0, location, predicate,
+                  nearest, nearest_square_distance);
+
+    return nearest < size()
+      ? &nodes[nearest].value
+      : nullptr;
+  }
+
+  gcc_pure
+  const T *FindNearest(const Point location, distance_type range) const {
+    return FindNearestIf(location, range, AlwaysTrue());
+  }
+
+  /**
+   * Pass the (at most) #max_results items nearest to the given
+   * location which match the predicate to the visitor, nearest
+   * first.
+   *
+   * @param range the maximum distance (inclusive)
+   */
+  template<typename P, typename V>
+  void VisitNearestIf(const Point location, distance_type range,
+                      size_type max_results, const P &predicate,
+                      V &visitor) const {
+    if (max_results == 0 || empty())
+      return;
+
+    std::vector<Candidate> heap;
+    heap.reserve(std::min(max_results, size()) + 1);
+
+    FindNearestK(0, size(), 0, location, Square(range), max_results,
+                 predicate, heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (const auto &i : heap)
+      visitor((const T &)nodes[i.index].value);
+  }
+
+  template<typename V>
+  void VisitNearest(const Point location, distance_type range,
+                    size_type max_results, V &visitor) const {
+    VisitNearestIf(location, range, max_results, AlwaysTrue(), visitor);
+  }
+
+  /**
+   * Pass all items within the given range to the visitor, in no
+   * particular order.
+   */
+  template<typename V>
+  void VisitWithinRange(const Point location, distance_type range,
+                        V &visitor) const {
+    VisitWithinRange(0, size(), 0, location, Square(range), visitor);
+  }
+
+private:
+  static constexpr size_type GetMiddle(size_type begin, size_type end) {
+    return begin + (end - begin) / 2;
+  }
+
+  void Split(size_type begin, size_type end, unsigned axis) {
+    while (end - begin > LEAF_SIZE) {
+      const size_type middle = GetMiddle(begin, end);
+      std::nth_element(nodes.begin() + begin, nodes.begin() + middle,
+                       nodes.begin() + end,
+                       [axis](const Node &a, const Node &b){
+                         return a.position.Get(axis) < b.position.Get(axis);
+                       });
+
+      Split(begin, middle, axis ^ 1);
+      begin = middle + 1;
+      axis ^= 1;
+    }
+  }
+
+  template<typename P>
+  void CheckNearest(size_type i, const Point location, const P &predicate,
+                    size_type &nearest,
+                    square_distance_type &nearest_square_distance) const {
+    const Node &node = nodes[i];
+    const square_distance_type square_distance =
+      node.position.SquareDistanceTo(location);
+    if (square_distance < nearest_square_distance &&
+        predicate(node.value)) {
+      nearest = i;
+      nearest_square_distance = square_distance;
+    }
+  }
+
+  template<typename P>
+  void FindNearestIf(size_type begin, size_type end, unsigned axis,
+                     const Point location, const P &predicate,
+                     size_type &nearest,
+                     square_distance_type &nearest_square_distance) const {
+    while (end - begin > LEAF_SIZE) {
+      const size_type middle = GetMiddle(begin, end);
+      CheckNearest(middle, location, predicate,
+                   nearest, nearest_square_distance);
+
+      const int64_t delta = int64_t(location.Get(axis)) -
+        nodes[middle].position.Get(axis);
+
+      /* descend into the half containing the location first, and
+         visit the other half only if it may contain a closer item */
+      if (delta < 0) {
+        FindNearestIf(begin, middle, axis ^ 1, location, predicate,
+                      nearest, nearest_square_distance);
+        begin = middle + 1;
+      } else {
+        FindNearestIf(middle + 1, end, axis ^ 1, location, predicate,
+                      nearest, nearest_square_distance);
+        end = middle;
+      }
+
+      if (Square(delta) >= nearest_square_distance)
+        return;
+
+      axis ^= 1;
+    }
+
+    for (size_type i = begin; i < end; ++i)
+      CheckNearest(i, location, predicate, nearest, nearest_square_distance);
+  }
+
+  template<typename P>
+  void CheckNearestK(size_type i, const Point location,
+                     square_distance_type square_range,
+                     size_type max_results, const P &predicate,
+                     std::vector<Candidate> &heap) const {
+    const Node &node = nodes[i];
+    const Candidate candidate{node.position.SquareDistanceTo(location), i};
+    if (candidate.square_distance > square_range ||
+        (heap.size() >= max_results && !(candidate < heap.front())) ||
+        !predicate(node.value))
+      return;
+
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end());
+
+    if (heap.size() > max_results) {
+      std::pop_heap(heap.begin(), heap.end());
+      heap.pop_back();
+    }
+  }
+
+  /**
+   * The square distance up to which items are still interesting for
+   * FindNearestK().
+   */
+  static square_distance_type GetSearchRadius(square_distance_type square_range,
+                                              size_type max_results,
+                                              const std::vector<Candidate> &heap) {
+    return heap.size() >= max_results
+      ? std::min(square_range, heap.front().square_distance)
+      : square_range;
+  }
+
+  template<typename P>
+  void FindNearestK(size_type begin, size_type end, unsigned axis,
+                    const Point location, square_distance_type square_range,
+                    size_type max_results, const P &predicate,
+                    std::vector<Candidate> &heap) const {
+    while (end - begin > LEAF_SIZE) {
+      const size_type middle = GetMiddle(begin, end);
+      CheckNearestK(middle, location, square_range, max_results,
+                    predicate, heap);
+
+      const int64_t delta = int64_t(location.Get(axis)) -
+        nodes[middle].position.Get(axis);
+
+      if (delta < 0) {
+        FindNearestK(begin, middle, axis ^ 1, location, square_range,
+                     max_results, predicate, heap);
+        begin = middle + 1;
+      } else {
+        FindNearestK(middle + 1, end, axis ^ 1, location, square_range,
+                     max_results, predicate, heap);
+        end = middle;
+      }
+
+      if (Square(delta) > GetSearchRadius(square_range, max_results, heap))
+        return;
+
+      axis ^= 1;
+    }
+
+    for (size_type i = begin; i < end; ++i)
+      CheckNearestK(i, location, square_range, max_results, predicate, heap);
+  }
+
+  template<typename V>
+  void VisitWithinRange(size_type begin, size_type end, unsigned axis,
+                        const Point location,
+                        square_distance_type square_range,
+                        V &visitor) const {
+    while (end - begin > LEAF_SIZE) {
+      const size_type middle = GetMiddle(begin, end);
+      const Node &node = nodes[middle];
+      if (node.position.SquareDistanceTo(location) <= square_range)
+        visitor((const T &)node.value);
+
+      const int64_t delta = int64_t(location.Get(axis)) -
+        node.position.Get(axis);
+      const bool within = Square(delta) <= square_range;
+
+      if (delta <= 0 || within) {
+        if (delta >= 0 || within)
+          /* the range overlaps both halves */
+          VisitWithinRange(middle + 1, end, axis ^ 1, location,
+                           square_range, visitor);
+
+        end = middle;
+      } else
+        begin = middle + 1;
+
+      axis ^= 1;
+    }
+
+    for (size_type i = begin; i < end; ++i) {
+      const Node &node = nodes[i];
+      if (node.position.SquareDistanceTo(location) <= square_range)
+        visitor((const T &)node.value);
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,152 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "StringViewParser.hpp"
+
+#include <string>
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Powers of ten which are exactly representable as double.
+ */
+static constexpr double exact_powers_of_ten[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/**
+ * Largest integer up to which all integers are exactly
+ * representable as double.
+ */
+static constexpr uint64_t MAX_EXACT_INTEGER = uint64_t(1) << 53;
+
+bool
+StringViewParser::ReadUnsigned(unsigned &value_r)
+{
+  const char *q = p;
+  while (q != end && IsWhitespaceNotNull(*q))
+    ++q;
+
+  bool negative = false;
+  if (q != end && (*q == '+' || *q == '-'))
+    negative = *q++ == '-';
+
+  if (q == end || !IsDigitASCII(*q))
+    return false;
+
+  unsigned long value = 0;
+  bool overflow = false;
+  for (; q != end && IsDigitASCII(*q); ++q) {
+    const unsigned digit = *q - '0';
+    if (value > (ULONG_MAX - digit) / 10)
+      overflow = true;
+    else
+      value = value * 10 + digit;
+  }
+
+  if (overflow)
+    value = ULONG_MAX;
+  else if (negative)
+    value = -value;
+
+  value_r = (unsigned)value;
+  p = q;
+  return true;
+}
+
+bool
+StringViewParser::ReadDouble(double &value_r)
+{
+  const char *q = p;
+  while (q != end && IsWhitespaceNotNull(*q))
+    ++q;
+
+  const char *const start = q;
+
+  bool negative = false;
+  if (q != end && (*q == '+' || *q == '-'))
+    negative = *q++ == '-';
+
+  uint64_t mantissa = 0;
+  unsigned n_digits = 0, n_significant = 0, n_fraction = 0;
+
+  for (; q != end && IsDigitASCII(*q); ++q, ++n_digits) {
+    if (n_significant < 19) {
+      mantissa = mantissa * 10 + unsigned(*q - '0');
+      if (mantissa > 0)
+        ++n_significant;
+    } else
+      ++n_significant;
+  }
+
+  if (q != end && *q == '.') {
+    ++q;
+    for (; q != end && IsDigitASCII(*q); ++q, ++n_digits, ++n_fraction) {
+      if (n_significant < 19) {
+        mantissa = mantissa * 10 + unsigned(*q - '0');
+        if (mantissa > 0)
+          ++n_significant;
+      } else
+        ++n_significant;
+    }
+  }
+
+  if (n_digits == 0)
+    return false;
+
+  bool has_exponent = false;
+  if (q != end && (*q == 'e' || *q == 'E')) {
+    const char *e = q + 1;
+    if (e != end && (*e == '+' || *e == '-'))
+      ++e;
+
+    if (e != end && IsDigitASCII(*e)) {
+      while (e != end && IsDigitASCII(*e))
+        ++e;
+      q = e;
+      has_exponent = true;
+    }
+  }
+
+  double value;
+  if (!has_exponent && n_significant < 19 &&
+      mantissa <= MAX_EXACT_INTEGER &&
+      n_fraction < sizeof(exact_powers_of_ten) / sizeof(exact_powers_of_ten[0])) {
+    /* both operands are exact, and IEEE division rounds correctly,
+       so this yields exactly what strtod() would return */
+    value = double(mantissa) / exact_powers_of_ten[n_fraction];
+    if (negative)
+      value = -value;
+  } else {
+    /* rare case: let strtod() handle it, on a null-terminated
+       copy */
+    const std::string copy(start, q);
+    value = strtod(copy.c_str(), nullptr);
+  }
+
+  value_r = value;
+  p = q;
+  return true;
+}
@@ -0,0 +1,170 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_STRING_VIEW_PARSER_HPP
+#define XCSOAR_STRING_VIEW_PARSER_HPP
+
+#include "StringView.hxx"
+#include "StringAPI.hxx"
+#include "CharUtil.hxx"
+#include "Compiler.h"
+
+#include <stddef.h>
+
+/**
+ * Parse a #StringView incrementally.  This is the bounded counterpart
+ * of #StringParser: it never reads past the end of the view, so it
+ * can tokenise lines inside a memory-mapped file which are not
+ * null-terminated.
+ *
+ * At the end of the view, front() returns '\0', just like
+ * #StringParser does at the end of a C string.
+ */
+class StringViewParser {
+  const char *p;
+  const char *const end;
+
+public:
+  explicit StringViewParser(StringView s)
+    :p(s.begin()), end(s.end()) {}
+
+  StringViewParser(const StringViewParser &) = delete;
+  StringViewParser &operator=(const StringViewParser &) = delete;
+
+  /**
+   * Returns the portion which has not been parsed yet.
+   */
+  StringView GetRest() const {
+    return StringView(p, end);
+  }
+
+  size_t GetRemaining() const {
+    return end - p;
+  }
+
+  bool IsEmpty() const {
+    return p == end;
+  }
+
+  char front() const {
+    return IsEmpty() ? '\0' : *p;
+  }
+
+  char pop_front() {
+    const auto value = front();
+    Skip();
+    return value;
+  }
+
+  void Strip() {
+    while (!IsEmpty() && IsWhitespaceNotNull(*p))
+      ++p;
+  }
+
+  /**
+   * Parse an unsigned decimal integer, with the same syntax as
+   * strtoul() (leading whitespace, optional sign).
+   */
+  bool ReadUnsigned(unsigned &value_r);
+
+  /**
+   * Parse a decimal floating point number.  The syntax is the
+   * decimal subset of strtod() and the result is bit-identical to
+   * strtod() for the same characters.
+   */
+  bool ReadDouble(double &value_r);
+
+  gcc_pure
+  bool MatchAll(StringView value) const {
+    return GetRest().Equals(value);
+  }
+
+  gcc_pure
+  bool MatchAllIgnoreCase(StringView value) const {
+    return GetRest().EqualsIgnoreCase(value);
+  }
+
+  gcc_pure
+  bool Match(char value) const {
+    return !IsEmpty() && *p == value;
+  }
+
+  gcc_pure
+  bool Match(const char *value, size_t size) const {
+    return GetRemaining() >= size && StringIsEqual(p, value, size);
+  }
+
+  gcc_pure
+  bool MatchIgnoreCase(const char *value, size_t size) const {
+    return GetRemaining() >= size &&
+      StringIsEqualIgnoreCase(p, value, size);
+  }
+
+  void Skip(size_t n=1) {
+    p += n < GetRemaining() ? n : GetRemaining();
+  }
+
+  bool SkipWhitespace() {
+    bool match = IsWhitespaceNotNull(front());
+    if (match)
+      Skip();
+    return match;
+  }
+
+  bool SkipMatch(char value) {
+    bool match = Match(value);
+    if (match)
+      Skip();
+    return match;
+  }
+
+  bool SkipMatch(const char *value, size_t size) {
+    bool match = Match(value, size);
+    if (match)
+      Skip(size);
+    return match;
+  }
+
+  bool SkipMatchIgnoreCase(const char *value, size_t size) {
+    bool match = MatchIgnoreCase(value, size);
+    if (match)
+      Skip(size);
+    return match;
+  }
+
+  /**
+   * Skip until the next whitespace is found.  If no whitespace
+   * is found, return false.  If yes, then that whitespace is
+   * skipped, too.
+   */
+  bool SkipWord() {
+    while (!IsEmpty()) {
+      if (IsWhitespaceFast(pop_front())) {
+        Strip();
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+#endif
@@ -173,7 +173,7 @@ SettingsLeave(const UISettings &old_ui_settings)
   if (TopographyFileChanged) {
     main_window.SetTopography(nullptr);
     topography->Reset();
-    LoadConfiguredTopography(*topography, operation);
+    LoadConfiguredTopography(*topography, operation, file_cache);
     main_window.SetTopography(topography);
   }
 
@@ -187,7 +187,7 @@ SettingsLeave(const UISettings &old_ui_settings)
     airspace_database.Clear();
     ReadAirspace(airspace_database, terrain,
                  CommonInterface::GetComputerSettings().pressure,
-                 operation);
+                 operation, file_cache);
   }
 
   if (DevicePortChanged)
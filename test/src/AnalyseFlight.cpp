@@ -24,6 +24,7 @@
 #include "Contest/ContestManager.hpp"
 #include "OS/Args.hpp"
 #include "Computer/CirclingComputer.hpp"
+#include "Computer/ComputerProfiler.hpp"
 #include "DebugReplay.hpp"
 #include "Util/Macros.hpp"
 #include "IO/StdioOutputStream.hxx"
@@ -34,6 +35,7 @@
 #include "FlightPhaseJSON.hpp"
 #include "Computer/Settings.hpp"
 #include "Util/StringCompare.hxx"
+#include "Util/StringAPI.hxx"
 
 struct Result {
   BrokenDateTime takeoff_time, release_time, landing_time;
@@ -53,6 +55,7 @@ struct Result {
 
 static CirclingComputer circling_computer;
 static FlightPhaseDetector flight_phase_detector;
+static ComputerProfiler profiler;
 
 static void
 Update(const MoreData &basic, const FlyingState &state,
@@ -126,12 +129,20 @@ Run(DebugReplay &replay, Result &result,
   constexpr Angle max_latitude_change = Angle::Degrees(1);
 
   while (replay.Next()) {
-    ComputeCircling(replay, circling_settings);
+    {
+      const ComputerProfiler::Scope scope(profiler,
+                                          ComputerProfiler::Stage::AIR_DATA);
+      ComputeCircling(replay, circling_settings);
+    }
 
     const MoreData &basic = replay.Basic();
 
-    Update(basic, replay.Calculated(), result);
-    flight_phase_detector.Update(replay.Basic(), replay.Calculated());
+    {
+      const ComputerProfiler::Scope scope(profiler,
+                                          ComputerProfiler::Stage::STATISTICS);
+      Update(basic, replay.Calculated(), result);
+      flight_phase_detector.Update(replay.Basic(), replay.Calculated());
+    }
 
     if (!basic.time_available || !basic.location_available ||
         !basic.NavAltitudeAvailable())
@@ -162,6 +173,9 @@ Run(DebugReplay &replay, Result &result,
          all flights in this IGC file */
       break;
 
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::TRACE);
+
     const TracePoint point(basic);
     full_trace.push_back(point);
     triangle_trace.push_back(point);
@@ -310,13 +324,15 @@ int main(int argc, char **argv)
   unsigned full_max_points = 512,
            triangle_max_points = 1024,
            sprint_max_points = 64;
+  bool profile = false;
 
   Args args(argc, argv,
             "[options] DRIVER FILE\n"
             "Options:\n"
             "  --full-points=512        Maximum number of full trace points (default = 512)\n"
             "  --triangle-points=1024   Maximum number of triangle trace points (default = 1024)\n"
-            "  --sprint-points=64       Maximum number of sprint trace points (default = 64)");
+            "  --sprint-points=64       Maximum number of sprint trace points (default = 64)\n"
+            "  --profile                Print the duration of each stage to stderr");
 
   const char *arg;
   while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
@@ -350,11 +366,15 @@ int main(int argc, char **argv)
         args.UsageError();
       }
 
+    } else if (StringIsEqual(arg, "--profile")) {
+      profile = true;
     } else {
       args.UsageError();
     }
   }
 
+  profiler.SetEnabled(profile);
+
   DebugReplay *replay = CreateDebugReplay(args);
   if (replay == NULL)
     return EXIT_FAILURE;
@@ -369,8 +389,22 @@ int main(int argc, char **argv)
   Run(*replay, result, full_trace, triangle_trace, sprint_trace);
   delete replay;
 
-  const ContestStatistics olc_plus = SolveContest(Contest::OLC_PLUS, full_trace, triangle_trace, sprint_trace);
-  const ContestStatistics dmst = SolveContest(Contest::DMST, full_trace, triangle_trace, sprint_trace);
+  ContestStatistics olc_plus, dmst;
+
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::CONTEST);
+    olc_plus = SolveContest(Contest::OLC_PLUS, full_trace, triangle_trace, sprint_trace);
+  }
+
+  {
+    const ComputerProfiler::Scope scope(profiler,
+                                        ComputerProfiler::Stage::CONTEST);
+    dmst = SolveContest(Contest::DMST, full_trace, triangle_trace, sprint_trace);
+  }
+
+  if (profile)
+    profiler.Dump(stderr);
 
   StdioOutputStream os(stdout);
   BufferedOutputStream writer(os);
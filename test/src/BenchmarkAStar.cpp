@@ -0,0 +1,289 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the AStar node bookkeeping: a shortest path search on a
+ * synthetic grid graph with pseudo-random edge costs, and a series
+ * of AirspaceRoute searches through synthetic airspaces over the
+ * terrain of a map file.  Prints the wall time, the number of heap
+ * allocations and a checksum of the results, which allows verifying
+ * that an optimisation did not change them.
+ */
+
+#include "Engine/Route/AStar.hpp"
+#include "Engine/Route/AirspaceRoute.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
+#include "Engine/GlideSolvers/GlideSettings.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+
+#include <zzip/zzip.h>
+
+#include <new>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned long n_allocations;
+
+void *
+operator new(size_t size)
+{
+  ++n_allocations;
+
+  void *p = malloc(size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+/**
+ * A simple deterministic pseudo-random generator, so the results do
+ * not depend on the C library.
+ */
+class Random {
+  uint32_t state;
+
+public:
+  explicit constexpr Random(uint32_t seed):state(seed) {}
+
+  unsigned operator()(unsigned n) {
+    state = state * 1103515245u + 12345u;
+    return (state >> 8) % n;
+  }
+};
+
+struct Result {
+  uint64_t duration_us;
+  unsigned long allocations;
+  uint64_t checksum;
+};
+
+static constexpr unsigned GRID_SIZE = 200;
+static constexpr unsigned GRID_RUNS = 10;
+
+/**
+ * Cost of entering the given grid cell.
+ */
+static unsigned
+GridCost(unsigned node)
+{
+  uint32_t x = node * 2654435761u;
+  return 10 + ((x >> 16) % 90);
+}
+
+static Result
+RunGrid()
+{
+  AStar<unsigned> astar;
+
+  const unsigned goal = GRID_SIZE * GRID_SIZE - 1;
+
+  Result result{0, 0, 0};
+  const unsigned long allocations_before = n_allocations;
+  const uint64_t start_time = MonotonicClockUS();
+
+  for (unsigned run = 0; run < GRID_RUNS; ++run) {
+    const unsigned start = run * (GRID_SIZE / GRID_RUNS);
+    astar.Restart(start);
+
+    while (!astar.IsEmpty()) {
+      const unsigned node = astar.Pop();
+      if (node == goal)
+        break;
+
+      const unsigned x = node % GRID_SIZE, y = node / GRID_SIZE;
+      const unsigned neighbours[4] = {
+        x > 0 ? node - 1 : node,
+        x + 1 < GRID_SIZE ? node + 1 : node,
+        y > 0 ? node - GRID_SIZE : node,
+        y + 1 < GRID_SIZE ? node + GRID_SIZE : node,
+      };
+
+      for (const unsigned n : neighbours) {
+        if (n == node)
+          continue;
+
+        const unsigned h = 10 * ((GRID_SIZE - 1 - n % GRID_SIZE) +
+                                 (GRID_SIZE - 1 - n / GRID_SIZE));
+        astar.Link(n, node, AStarPriorityValue(GridCost(n), h));
+      }
+    }
+
+    result.checksum = result.checksum * 31 + astar.GetNodeValue(goal).g;
+    for (unsigned n = goal; n != start; n = astar.GetPredecessor(n))
+      result.checksum = result.checksum * 31 + n;
+  }
+
+  result.duration_us = MonotonicClockUS() - start_time;
+  result.allocations = n_allocations - allocations_before;
+  return result;
+}
+
+static constexpr unsigned N_AIRSPACES = 80;
+static constexpr unsigned N_ROUTES = 8;
+
+static void
+SetupAirspaces(Airspaces &airspaces, const GeoPoint &center)
+{
+  Random random(42);
+
+  for (unsigned i = 0; i < N_AIRSPACES; ++i) {
+    const GeoPoint c(center.longitude +
+                     Angle::Degrees((random(1200) - 600.) / 1000.),
+                     center.latitude +
+                     Angle::Degrees((random(1200) - 600.) / 1000.));
+    const double radius = 2000. + random(8000);
+
+    AbstractAirspace *as = new AirspaceCircle(c, radius);
+
+    AirspaceAltitude base, top;
+    base.altitude = random(1500);
+    top.altitude = base.altitude + 1000 + random(3000);
+    as->SetProperties(_T("synthetic"), AirspaceClass::CLASSC, base, top);
+
+    airspaces.Add(as);
+  }
+
+  airspaces.Optimise();
+}
+
+static Result
+RunRoute(const RasterMap &map)
+{
+  const GeoPoint center = map.GetMapCenter();
+
+  Airspaces airspaces;
+  SetupAirspaces(airspaces, center);
+
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  config.mode = RoutePlannerConfig::Mode::BOTH;
+
+  const GlidePolar polar(1);
+  const SpeedVector wind(Angle::Degrees(0), 0);
+
+  AirspaceRoute route;
+  route.UpdatePolar(settings, config, polar, polar, wind);
+  route.SetTerrain(&map);
+
+  const AirspacePredicateTrue predicate;
+
+  Result result{0, 0, 0};
+  const unsigned long allocations_before = n_allocations;
+  const uint64_t start_time = MonotonicClockUS();
+
+  for (unsigned i = 0; i < N_ROUTES; ++i) {
+    const Angle direction = Angle::FullCircle() * i / N_ROUTES;
+    const GeoPoint p_start =
+      GeoVector(20000, direction).EndPoint(center);
+    const GeoPoint p_dest =
+      GeoVector(20000, direction.Reciprocal()).EndPoint(center);
+
+    const AGeoPoint loc_start(p_start,
+                              map.GetHeight(p_start).GetValueOr0() + 100);
+    const AGeoPoint loc_end(p_dest,
+                            map.GetHeight(p_dest).GetValueOr0() + 1200);
+
+    route.Synchronise(airspaces, predicate, loc_start, loc_end);
+    route.Solve(loc_start, loc_end, config);
+
+    for (const auto &p : route.GetSolution())
+      result.checksum = result.checksum * 31 +
+        uint64_t(p.longitude.Native() * 1e7) +
+        uint64_t(p.latitude.Native() * 1e7) * 7 + p.altitude;
+  }
+
+  result.duration_us = MonotonicClockUS() - start_time;
+  result.allocations = n_allocations - allocations_before;
+  return result;
+}
+
+static void
+Print(const char *name, const Result &result)
+{
+  printf("%s: us=%llu allocations=%lu checksum=%016llx\n", name,
+         (unsigned long long)result.duration_us, result.allocations,
+         (unsigned long long)result.checksum);
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "MAP.xcm");
+  const char *map_path = args.ExpectNext();
+  args.ExpectEnd();
+
+  Print("grid", RunGrid());
+
+  ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
+  if (dir == nullptr) {
+    fprintf(stderr, "Failed to open %s\n", map_path);
+    return EXIT_FAILURE;
+  }
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(dir, map.GetTileCache(), operation)) {
+    fprintf(stderr, "failed to load map\n");
+    zzip_dir_close(dir);
+    return EXIT_FAILURE;
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+  zzip_dir_close(dir);
+
+  Print("route", RunRoute(map));
+
+  return EXIT_SUCCESS;
+}
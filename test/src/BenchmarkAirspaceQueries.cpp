@@ -0,0 +1,230 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+/*
+ * Compare build and query times of the airspace R-tree with
+ * incremental insertion and with bulk loading at various node
+ * fan-outs.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Geo/Math.hpp"
+#include "IO/Charset.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileMapping.hpp"
+#include "Util/PrintException.hxx"
+#include "Util/StringCompare.hxx"
+#include "Util/StringView.hxx"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Config {
+  const char *mode;
+  bool bulk_load;
+  unsigned fan_out;
+};
+
+static constexpr Config configs[] = {
+  { "incremental", false, 16 },
+  { "bulk", true, 8 },
+  { "bulk", true, 16 },
+  { "bulk", true, 32 },
+  { "bulk", true, 64 },
+};
+
+struct Query {
+  GeoPoint location, end;
+};
+
+class CountingVisitor final : public AirspaceIntersectionVisitor {
+public:
+  unsigned count = 0;
+
+  void Visit(const AbstractAirspace &) override {
+    ++count;
+  }
+};
+
+struct Result {
+  uint64_t build_us, range_us, intersect_us;
+  unsigned range_hits, intersect_hits;
+};
+
+static bool
+Load(const FileMapping &mapping, Airspaces &airspaces)
+{
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+  return parser.Parse(StringView((const char *)mapping.data(),
+                                 mapping.size()),
+                      Charset::AUTO, operation);
+}
+
+/**
+ * Generate query locations and vectors within the area covered by
+ * the airspaces, with a deterministic pseudo-random sequence.
+ */
+static std::vector<Query>
+MakeQueries(const Airspaces &airspaces, unsigned n)
+{
+  double west = 180, east = -180, south = 90, north = -90;
+  for (const auto &i : airspaces.QueryAll()) {
+    const GeoPoint p = i.GetAirspace().GetReferenceLocation();
+    west = std::min(west, p.longitude.Degrees());
+    east = std::max(east, p.longitude.Degrees());
+    south = std::min(south, p.latitude.Degrees());
+    north = std::max(north, p.latitude.Degrees());
+  }
+
+  uint32_t seed = 1;
+  auto random = [&seed](){
+    seed = seed * 1103515245 + 12345;
+    return double((seed >> 8) & 0xffff) / 0xffff;
+  };
+
+  std::vector<Query> queries;
+  queries.reserve(n);
+  for (unsigned i = 0; i < n; ++i) {
+    Query q;
+    q.location = GeoPoint(Angle::Degrees(west + random() * (east - west)),
+                          Angle::Degrees(south + random() * (north - south)));
+    q.end = FindLatitudeLongitude(q.location,
+                                  Angle::Degrees(random() * 360), 30000);
+    queries.push_back(q);
+  }
+
+  return queries;
+}
+
+static Result
+Run(const FileMapping &mapping, const Config &config,
+    std::vector<Query> &queries, unsigned n_queries)
+{
+  Result result;
+
+  Airspaces airspaces;
+  airspaces.SetBulkLoad(config.bulk_load);
+  airspaces.SetTreeFanOut(config.fan_out);
+  if (!Load(mapping, airspaces)) {
+    fprintf(stderr, "Failed to parse input file\n");
+    exit(EXIT_FAILURE);
+  }
+
+  uint64_t start = MonotonicClockUS();
+  airspaces.Optimise();
+  result.build_us = MonotonicClockUS() - start;
+
+  if (queries.empty())
+    queries = MakeQueries(airspaces, n_queries);
+
+  result.range_hits = 0;
+  start = MonotonicClockUS();
+  for (const auto &q : queries)
+    for (const auto &i : airspaces.QueryWithinRange(q.location, 20000)) {
+      (void)i;
+      ++result.range_hits;
+    }
+  result.range_us = MonotonicClockUS() - start;
+
+  CountingVisitor visitor;
+  start = MonotonicClockUS();
+  for (const auto &q : queries)
+    airspaces.VisitIntersecting(q.location, q.end, visitor);
+  result.intersect_us = MonotonicClockUS() - start;
+  result.intersect_hits = visitor.count;
+
+  printf("mode=%s fan_out=%u airspaces=%u build_us=%llu "
+         "range_us=%llu range_hits=%u "
+         "intersect_us=%llu intersect_hits=%u\n",
+         config.mode, airspaces.GetTreeFanOut(), airspaces.GetSize(),
+         (unsigned long long)result.build_us,
+         (unsigned long long)result.range_us, result.range_hits,
+         (unsigned long long)result.intersect_us, result.intersect_hits);
+
+  return result;
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "[--queries=N] PATH");
+
+  unsigned n_queries = 20000;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--queries=")) != nullptr) {
+      n_queries = strtoul(value, nullptr, 10);
+      if (n_queries == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  const FileMapping mapping(path);
+  if (mapping.error()) {
+    fprintf(stderr, "Failed to open input file\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Query> queries;
+
+  bool first = true, consistent = true;
+  Result reference;
+  for (const auto &config : configs) {
+    const Result result = Run(mapping, config, queries, n_queries);
+    if (first) {
+      reference = result;
+      first = false;
+    } else if (result.range_hits != reference.range_hits ||
+               result.intersect_hits != reference.intersect_hits)
+      consistent = false;
+  }
+
+  if (!consistent) {
+    fprintf(stderr, "Query results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
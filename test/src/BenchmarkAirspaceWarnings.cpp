@@ -0,0 +1,234 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replays IGC files through the AirspaceWarningManager only and
+ * prints a JSON report with the time spent in
+ * AirspaceWarningManager::Update().  The "checksum" summarises all
+ * warning states and solutions, and allows verifying that an
+ * optimisation did not change the results.
+ */
+
+#include "DebugReplayIGC.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceWarningManager.hpp"
+#include "Engine/Airspace/AirspaceWarningConfig.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Task/Stats/TaskStats.hpp"
+#include "NMEA/Aircraft.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/StdioOutputStream.hxx"
+#include "JSON/Writer.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringAPI.hxx"
+#include "Util/PrintException.hxx"
+
+#include <vector>
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+class IGCFileCollector final : public File::Visitor {
+  std::vector<AllocatedPath> &files;
+
+public:
+  explicit IGCFileCollector(std::vector<AllocatedPath> &_files)
+    :files(_files) {}
+
+  void Visit(Path path, Path filename) override {
+    files.emplace_back(path);
+  }
+};
+
+struct Totals {
+  unsigned files = 0;
+  unsigned long fixes = 0;
+
+  /**
+   * Time spent in AirspaceWarningManager::Update().
+   */
+  uint64_t update_us = 0;
+
+  /**
+   * The longest AirspaceWarningManager::Update() call.
+   */
+  unsigned max_update_us = 0;
+
+  /**
+   * The sum of all warning list sizes after each update.
+   */
+  unsigned long warnings = 0;
+
+  uint64_t checksum = 0;
+};
+
+static void
+UpdateChecksum(Totals &totals, const AirspaceWarningManager &manager)
+{
+  for (const auto &w : manager) {
+    const auto &solution = w.GetSolution();
+    totals.checksum = totals.checksum * 31 + w.GetWarningState();
+    if (solution.IsValid())
+      totals.checksum = totals.checksum * 31 +
+        (uint64_t)(solution.distance + solution.elapsed_time);
+  }
+}
+
+static bool
+Run(Path path, AirspaceWarningManager &manager, const GlidePolar &glide_polar,
+    Totals &totals)
+{
+  DebugReplay *replay = DebugReplayIGC::Create(path);
+  if (replay == nullptr)
+    return false;
+
+  const TaskStats task_stats = TaskStats();
+
+  bool first = true;
+  double last_time = 0;
+
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+    const DerivedInfo &calculated = replay->Calculated();
+    if (!basic.location_available || !basic.time_available)
+      continue;
+
+    const AircraftState state = ToAircraftState(basic, calculated);
+    if (first) {
+      manager.Reset(state);
+      last_time = basic.time;
+      first = false;
+    }
+
+    const unsigned dt = basic.time > last_time
+      ? unsigned(basic.time - last_time)
+      : 0;
+    last_time = basic.time;
+
+    const uint64_t start = MonotonicClockUS();
+    manager.Update(state, glide_polar, task_stats,
+                   calculated.circling, dt);
+    const unsigned duration = MonotonicClockUS() - start;
+
+    totals.update_us += duration;
+    totals.max_update_us = std::max(totals.max_update_us, duration);
+    totals.warnings += std::distance(manager.begin(), manager.end());
+    UpdateChecksum(totals, manager);
+    ++totals.fixes;
+  }
+
+  delete replay;
+  ++totals.files;
+  return true;
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "AIRSPACE PATH...\n"
+            "PATH may be an IGC file or a directory containing IGC files.");
+
+  const auto airspace_path = args.ExpectNextPath();
+
+  std::vector<AllocatedPath> files;
+
+  do {
+    const AllocatedPath path(args.ExpectNextPath());
+    if (Directory::Exists(path)) {
+      IGCFileCollector collector(files);
+      Directory::VisitSpecificFiles(path, _T("*.igc"), collector, true);
+      Directory::VisitSpecificFiles(path, _T("*.IGC"), collector, true);
+    } else
+      files.emplace_back(Path(path));
+  } while (!args.IsEmpty());
+
+  /* process the files in a stable order, so results are comparable */
+  std::sort(files.begin(), files.end(),
+            [](const AllocatedPath &a, const AllocatedPath &b){
+              return StringCollate(a.c_str(), b.c_str()) < 0;
+            });
+
+  Airspaces airspaces;
+
+  {
+    FileLineReader reader(airspace_path, Charset::AUTO);
+    AirspaceParser parser(airspaces);
+    NullOperationEnvironment operation;
+    if (!parser.Parse(reader, operation)) {
+      fprintf(stderr, "Failed to parse airspace file\n");
+      return EXIT_FAILURE;
+    }
+
+    airspaces.Optimise();
+  }
+
+  AirspaceWarningConfig config;
+  config.SetDefaults();
+
+  AirspaceWarningManager manager(config, airspaces);
+
+  const GlidePolar glide_polar(1);
+
+  Totals totals;
+
+  for (const auto &path : files)
+    if (!Run(path, manager, glide_polar, totals))
+      fprintf(stderr, "Failed to open %s\n", path.c_str());
+
+  StdioOutputStream os(stdout);
+  BufferedOutputStream writer(os);
+
+  {
+    JSON::ObjectWriter root(writer);
+    root.WriteElement("files", JSON::WriteUnsigned, totals.files);
+    root.WriteElement("airspaces", JSON::WriteUnsigned,
+                      airspaces.GetSize());
+    root.WriteElement("fixes", JSON::WriteLong, (long)totals.fixes);
+    root.WriteElement("update_us", JSON::WriteLong, (long)totals.update_us);
+    root.WriteElement("avg_update_ns", JSON::WriteLong,
+                      totals.fixes > 0
+                      ? long(totals.update_us * 1000 / totals.fixes)
+                      : 0l);
+    root.WriteElement("max_update_us", JSON::WriteUnsigned,
+                      totals.max_update_us);
+    root.WriteElement("warnings", JSON::WriteLong, (long)totals.warnings);
+    root.WriteElement("checksum", JSON::WriteLong,
+                      (long)(totals.checksum & 0x7fffffffffffffffull));
+  }
+
+  writer.Write('\n');
+  writer.Flush();
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
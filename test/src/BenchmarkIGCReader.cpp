@@ -0,0 +1,242 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Scans IGC files with the line-based IGCParseFix() and with the
+ * memory-mapped IGCReader (per fix and in columnar batches) and
+ * prints the throughput of each in fixes per second.
+ */
+
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCReader.hpp"
+#include "IGC/IGCFixBatch.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileMapping.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/PrintException.hxx"
+
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+class IGCFileCollector final : public File::Visitor {
+  std::vector<AllocatedPath> &files;
+
+public:
+  explicit IGCFileCollector(std::vector<AllocatedPath> &_files)
+    :files(_files) {}
+
+  void Visit(Path path, Path filename) override {
+    /* match the suffix case-insensitively, so each file is visited
+       exactly once, regardless of the file system */
+    if (filename.MatchesExtension(_T(".igc")))
+      files.emplace_back(path);
+  }
+};
+
+/**
+ * Convert an angle back to the native IGC resolution [1/60000
+ * degrees], see #IGCFixBatch.
+ */
+static int32_t
+ToRawAngle(Angle angle)
+{
+  return (int32_t)lround(angle.Degrees() * 60000);
+}
+
+/**
+ * The sums of the fixed-width attributes of all fixes (everything
+ * except extensions), to verify that all methods produce the same
+ * results (and to keep the compiler from optimising the loops away).
+ */
+struct Result {
+  unsigned long fixes = 0, valid = 0;
+  long long time_sum = 0;
+  long long latitude_sum = 0, longitude_sum = 0;
+  long long pressure_altitude_sum = 0, gps_altitude_sum = 0;
+
+  void Add(const IGCFix &fix) {
+    ++fixes;
+    valid += fix.gps_valid;
+    time_sum += fix.time.GetSecondOfDay();
+    latitude_sum += ToRawAngle(fix.location.latitude);
+    longitude_sum += ToRawAngle(fix.location.longitude);
+    pressure_altitude_sum += fix.pressure_altitude;
+    gps_altitude_sum += fix.gps_altitude;
+  }
+
+  bool operator==(const Result &other) const {
+    return fixes == other.fixes && valid == other.valid &&
+      time_sum == other.time_sum &&
+      latitude_sum == other.latitude_sum &&
+      longitude_sum == other.longitude_sum &&
+      pressure_altitude_sum == other.pressure_altitude_sum &&
+      gps_altitude_sum == other.gps_altitude_sum;
+  }
+};
+
+static void
+ScanLines(Path path, Result &result)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  const char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (line[0] == 'B') {
+      if (IGCParseFix(line, extensions, fix))
+        result.Add(fix);
+    } else if (line[0] == 'I')
+      IGCParseExtensions(line, extensions);
+  }
+}
+
+static void
+ScanNext(Path path, Result &result)
+{
+  const FileMapping mapping(path);
+  if (mapping.error())
+    return;
+
+  IGCReader reader(StringView((const char *)mapping.data(), mapping.size()));
+  for (const IGCFix &fix : reader)
+    result.Add(fix);
+}
+
+static void
+ScanBatch(Path path, Result &result)
+{
+  const FileMapping mapping(path);
+  if (mapping.error())
+    return;
+
+  IGCReader reader(StringView((const char *)mapping.data(), mapping.size()));
+
+  IGCFixBatch batch;
+  while (reader.Read(batch) > 0) {
+    /* column-wise sums, which the compiler can vectorise */
+    unsigned long valid = 0;
+    long long time_sum = 0, latitude_sum = 0, longitude_sum = 0;
+    long long pressure_altitude_sum = 0, gps_altitude_sum = 0;
+    for (unsigned i = 0; i < batch.size; ++i)
+      valid += batch.gps_valid[i];
+    for (unsigned i = 0; i < batch.size; ++i)
+      time_sum += batch.time[i];
+    for (unsigned i = 0; i < batch.size; ++i)
+      latitude_sum += batch.latitude[i];
+    for (unsigned i = 0; i < batch.size; ++i)
+      longitude_sum += batch.longitude[i];
+    for (unsigned i = 0; i < batch.size; ++i)
+      pressure_altitude_sum += batch.pressure_altitude[i];
+    for (unsigned i = 0; i < batch.size; ++i)
+      gps_altitude_sum += batch.gps_altitude[i];
+
+    result.fixes += batch.size;
+    result.valid += valid;
+    result.time_sum += time_sum;
+    result.latitude_sum += latitude_sum;
+    result.longitude_sum += longitude_sum;
+    result.pressure_altitude_sum += pressure_altitude_sum;
+    result.gps_altitude_sum += gps_altitude_sum;
+  }
+}
+
+static Result
+Run(const char *name, void (*scan)(Path, Result &),
+    const std::vector<AllocatedPath> &files, unsigned repeat)
+{
+  Result result;
+
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < repeat; ++i)
+    for (const auto &path : files)
+      scan(path, result);
+  const uint64_t duration_us = MonotonicClockUS() - start;
+
+  printf("%s: fixes=%lu duration_ms=%.1f fixes_per_second=%.0f\n",
+         name, result.fixes, duration_us / 1000.,
+         duration_us > 0 ? result.fixes * 1000000. / duration_us : 0.);
+  return result;
+}
+
+int
+main(int argc, char **argv)
+try {
+  unsigned repeat = 10;
+
+  Args args(argc, argv,
+            "[--repeat=N] PATH...\n"
+            "PATH may be an IGC file or a directory containing IGC files.");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--repeat=")) != nullptr) {
+      repeat = strtoul(value, nullptr, 10);
+      if (repeat == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
+  std::vector<AllocatedPath> files;
+
+  do {
+    const AllocatedPath path(args.ExpectNextPath());
+    if (Directory::Exists(path)) {
+      IGCFileCollector collector(files);
+      Directory::VisitFiles(path, collector, true);
+    } else
+      files.emplace_back(Path(path));
+  } while (!args.IsEmpty());
+
+  printf("files=%u repeat=%u\n", (unsigned)files.size(), repeat);
+
+  const Result lines = Run("lines", ScanLines, files, repeat);
+  const Result next = Run("mapped", ScanNext, files, repeat);
+  const Result batch = Run("batch", ScanBatch, files, repeat);
+
+  if (!(next == lines) || !(batch == lines)) {
+    fprintf(stderr, "Results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Feeds NMEA sentences read from stdin (e.g. a log recorded with
+ * FeedNMEA's counterpart) through a device driver and the generic
+ * NMEAParser as fast as possible, the same way DeviceDescriptor
+ * does, and prints the throughput in sentences per second.
+ */
+
+#include "NMEA/Info.hpp"
+#include "Device/Port/NullPort.hpp"
+#include "Device/Driver.hpp"
+#include "Device/Register.hpp"
+#include "Device/Parser.hpp"
+#include "Device/Config.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "Util/ConvertString.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringUtil.hpp"
+
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "[--repeat=N] [DRIVER] <FILE.nmea");
+
+  unsigned repeat = 100;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--repeat=")) != nullptr) {
+      repeat = strtoul(value, nullptr, 10);
+      if (repeat == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
+  const struct DeviceRegister *driver = nullptr;
+  if (!args.IsEmpty()) {
+    tstring driver_name = args.ExpectNextT();
+    driver = FindDriverByName(driver_name.c_str());
+    if (driver == nullptr) {
+      _ftprintf(stderr, _T("No such driver: %s\n"), driver_name.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  args.ExpectEnd();
+
+  std::vector<std::string> lines;
+
+  char buffer[1024];
+  while (fgets(buffer, sizeof(buffer), stdin) != nullptr) {
+    StripRight(buffer);
+    if (*buffer != 0)
+      lines.emplace_back(buffer);
+  }
+
+  if (lines.empty()) {
+    fprintf(stderr, "No input\n");
+    return EXIT_FAILURE;
+  }
+
+  DeviceConfig config;
+  config.Clear();
+
+  NullPort port;
+  Device *device = driver != nullptr && driver->CreateOnPort != nullptr
+    ? driver->CreateOnPort(config, port)
+    : nullptr;
+
+  NMEAParser parser;
+
+  NMEAInfo data;
+  data.Reset();
+
+  unsigned long n_sentences = 0, n_parsed = 0;
+
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned i = 0; i < repeat; ++i) {
+    for (const auto &line : lines) {
+      data.UpdateClock();
+
+      if ((device != nullptr && device->ParseNMEA(line.c_str(), data)) ||
+          parser.ParseLine(line.c_str(), data))
+        ++n_parsed;
+
+      ++n_sentences;
+    }
+  }
+
+  const uint64_t duration_us = MonotonicClockUS() - start;
+  const double seconds = duration_us / 1000000.;
+
+  delete device;
+
+  printf("sentences=%lu\n", n_sentences);
+  printf("parsed=%lu\n", n_parsed);
+  printf("duration_ms=%.1f\n", duration_us / 1000.);
+  printf("sentences_per_second=%.0f\n", n_sentences / seconds);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,364 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Feeds IGC files through the complete GlideComputer pipeline
+ * (BasicComputer, task, airspace warnings, route planner, contest)
+ * as fast as possible and prints a JSON report: fixes per second,
+ * time per subsystem, peak RSS and heap allocations.
+ */
+
+#include "DebugReplayIGC.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Settings.hpp"
+#include "Computer/ComputerProfiler.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Task/TaskFile.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/StdioOutputStream.hxx"
+#include "JSON/Writer.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/StringAPI.hxx"
+#include "Util/PrintException.hxx"
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef HAVE_POSIX
+#include <sys/resource.h>
+#endif
+
+/* fake symbols: */
+
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+
+void
+ConditionMonitorsUpdate(const NMEAInfo &basic, const DerivedInfo &calculated,
+                        const ComputerSettings &settings)
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+/* count all heap allocations */
+
+static std::atomic<unsigned long> n_allocations(0);
+static std::atomic<unsigned long long> n_allocated_bytes(0);
+
+void *
+operator new(std::size_t size)
+{
+  n_allocations.fetch_add(1, std::memory_order_relaxed);
+  n_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+  void *p = malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+
+  return p;
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, std::size_t) noexcept
+{
+  free(p);
+}
+
+/**
+ * @return the peak resident set size in kB, or 0 if unknown
+ */
+static unsigned long
+GetPeakRSS()
+{
+#ifdef HAVE_POSIX
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    return usage.ru_maxrss;
+#endif
+
+  return 0;
+}
+
+class IGCFileCollector final : public File::Visitor {
+  std::vector<AllocatedPath> &files;
+
+public:
+  explicit IGCFileCollector(std::vector<AllocatedPath> &_files)
+    :files(_files) {}
+
+  void Visit(Path path, Path filename) override {
+    files.emplace_back(path);
+  }
+};
+
+struct Totals {
+  unsigned files = 0;
+  unsigned long fixes = 0;
+
+  /**
+   * Time spent parsing the IGC files and running the BasicComputer.
+   */
+  uint64_t replay_us = 0;
+
+  /**
+   * Time spent in the GlideComputer.
+   */
+  uint64_t computer_us = 0;
+};
+
+static bool
+Run(Path path, GlideComputer &glide_computer, unsigned idle_interval,
+    Totals &totals)
+{
+  DebugReplay *replay = DebugReplayIGC::Create(path);
+  if (replay == nullptr)
+    return false;
+
+  glide_computer.ResetFlight(true);
+
+  unsigned i = 0;
+  while (true) {
+    const uint64_t start = MonotonicClockUS();
+    if (!replay->Next())
+      break;
+
+    const uint64_t replay_done = MonotonicClockUS();
+    totals.replay_us += replay_done - start;
+
+    glide_computer.ReadBlackboard(replay->Basic());
+    glide_computer.ProcessGPS();
+
+    if (++i == idle_interval) {
+      i = 0;
+      glide_computer.ProcessIdle();
+    }
+
+    totals.computer_us += MonotonicClockUS() - replay_done;
+    ++totals.fixes;
+  }
+
+  /* the final contest result, as after landing */
+  const uint64_t start = MonotonicClockUS();
+  glide_computer.ProcessExhaustive();
+  totals.computer_us += MonotonicClockUS() - start;
+
+  delete replay;
+  ++totals.files;
+  return true;
+}
+
+static void
+WriteStage(BufferedOutputStream &writer,
+           const ComputerProfiler::Summary &summary)
+{
+  JSON::ObjectWriter object(writer);
+  object.WriteElement("count", JSON::WriteLong, (long)summary.count);
+  object.WriteElement("total_us", JSON::WriteLong, (long)summary.total);
+  object.WriteElement("min_us", JSON::WriteUnsigned, summary.min);
+  object.WriteElement("avg_us", JSON::WriteUnsigned, summary.average);
+  object.WriteElement("p99_us", JSON::WriteUnsigned, summary.p99);
+  object.WriteElement("max_us", JSON::WriteUnsigned, summary.max);
+}
+
+static void
+WriteStages(BufferedOutputStream &writer, const ComputerProfiler *profiler)
+{
+  JSON::ObjectWriter object(writer);
+
+  for (unsigned i = 0; i < ComputerProfiler::N_STAGES; ++i) {
+    const auto stage = ComputerProfiler::Stage(i);
+    object.WriteElement(ComputerProfiler::GetStageName(stage), WriteStage,
+                        profiler->GetSummary(stage));
+  }
+}
+
+int
+main(int argc, char **argv)
+try {
+  unsigned idle_interval = 8;
+  const char *airspace_path = nullptr, *task_path = nullptr;
+
+  Args args(argc, argv,
+            "[options] PATH...\n"
+            "PATH may be an IGC file or a directory containing IGC files.\n"
+            "Options:\n"
+            "  --airspace=FILE          Load an airspace file\n"
+            "  --task=FILE              Load a task file\n"
+            "  --idle=8                 Call ProcessIdle() every N fixes (default = 8)");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--airspace=")) != nullptr) {
+      airspace_path = value;
+    } else if ((value = StringAfterPrefix(arg, "--task=")) != nullptr) {
+      task_path = value;
+    } else if ((value = StringAfterPrefix(arg, "--idle=")) != nullptr) {
+      idle_interval = strtoul(value, nullptr, 10);
+      if (idle_interval == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
+  std::vector<AllocatedPath> files;
+
+  do {
+    const AllocatedPath path(args.ExpectNextPath());
+    if (Directory::Exists(path)) {
+      IGCFileCollector collector(files);
+      Directory::VisitSpecificFiles(path, _T("*.igc"), collector, true);
+      Directory::VisitSpecificFiles(path, _T("*.IGC"), collector, true);
+    } else
+      files.emplace_back(Path(path));
+  } while (!args.IsEmpty());
+
+  /* process the files in a stable order, so results are comparable */
+  std::sort(files.begin(), files.end(),
+            [](const AllocatedPath &a, const AllocatedPath &b){
+              return StringCollate(a.c_str(), b.c_str()) < 0;
+            });
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+
+  const Waypoints way_points;
+
+  Airspaces airspace_database;
+  if (airspace_path != nullptr) {
+    FileLineReader reader(Path(airspace_path), Charset::AUTO);
+    AirspaceParser parser(airspace_database);
+    NullOperationEnvironment operation;
+    if (!parser.Parse(reader, operation)) {
+      fprintf(stderr, "Failed to parse airspace file\n");
+      return EXIT_FAILURE;
+    }
+
+    airspace_database.Optimise();
+  }
+
+  TaskManager task_manager(settings.task, way_points);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  if (task_path != nullptr) {
+    OrderedTask *task = TaskFile::GetTask(Path(task_path), settings.task,
+                                          nullptr, 0);
+    if (task == nullptr) {
+      fprintf(stderr, "Failed to load task\n");
+      return EXIT_FAILURE;
+    }
+
+    task->UpdateGeometry();
+    task_manager.Commit(*task);
+    delete task;
+  }
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(settings, way_points, airspace_database,
+                               protected_task_manager, task_events);
+  glide_computer.SetContestIncremental(true);
+  glide_computer.Initialise();
+  glide_computer.GetProfiler().SetEnabled(true);
+
+  Totals totals;
+
+  const unsigned long allocations_before = n_allocations;
+  const unsigned long long bytes_before = n_allocated_bytes;
+  const uint64_t start = MonotonicClockUS();
+
+  for (const auto &path : files)
+    if (!Run(path, glide_computer, idle_interval, totals))
+      fprintf(stderr, "Failed to open %s\n", path.c_str());
+
+  const uint64_t duration_us = MonotonicClockUS() - start;
+  const unsigned long allocations = n_allocations - allocations_before;
+  const unsigned long long allocated_bytes = n_allocated_bytes - bytes_before;
+
+  StdioOutputStream os(stdout);
+  BufferedOutputStream writer(os);
+
+  {
+    JSON::ObjectWriter root(writer);
+    root.WriteElement("files", JSON::WriteUnsigned, totals.files);
+    root.WriteElement("fixes", JSON::WriteLong, (long)totals.fixes);
+    root.WriteElement("duration_us", JSON::WriteLong, (long)duration_us);
+    root.WriteElement("fixes_per_second", JSON::WriteUnsigned,
+                      duration_us > 0
+                      ? unsigned(totals.fixes * 1000000. / duration_us)
+                      : 0u);
+    root.WriteElement("replay_us", JSON::WriteLong, (long)totals.replay_us);
+    root.WriteElement("computer_us", JSON::WriteLong,
+                      (long)totals.computer_us);
+    root.WriteElement("stages", WriteStages, &glide_computer.GetProfiler());
+    root.WriteElement("peak_rss_kb", JSON::WriteLong, (long)GetPeakRSS());
+    root.WriteElement("allocations", JSON::WriteLong, (long)allocations);
+    root.WriteElement("allocated_bytes", JSON::WriteLong,
+                      (long)allocated_bytes);
+  }
+
+  writer.Write('\n');
+  writer.Flush();
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program measures the throughput of the terrain slope shading
+ * kernel (portable vs. SIMD) on a synthetic terrain.
+ */
+
+#include "Terrain/SlopeShading.hpp"
+#include "Util/AllocatedGrid.hxx"
+
+#include <algorithm>
+#include <chrono>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned WIDTH = 1024, HEIGHT = 768;
+static constexpr unsigned QUANTISATION = 1;
+static constexpr unsigned ITERATIONS = 50;
+
+typedef void (*ShadeRowFunction)(const SlopeShadingParameters &s,
+                                 unsigned dx, unsigned dy,
+                                 const TerrainHeight *above,
+                                 const TerrainHeight *below,
+                                 const TerrainHeight *left,
+                                 const TerrainHeight *right,
+                                 int8_t *dest, unsigned n);
+
+static void
+GenerateTerrain(AllocatedGrid<TerrainHeight> &grid)
+{
+  for (unsigned y = 0; y < grid.GetHeight(); ++y)
+    for (unsigned x = 0; x < grid.GetWidth(); ++x)
+      grid.Get(x, y) = TerrainHeight(int16_t(1000 +
+                                             400 * sin(x / 37.) +
+                                             300 * cos(y / 23.) +
+                                             50 * sin((x + y) / 5.)));
+}
+
+static void
+ShadeGrid(ShadeRowFunction f, const SlopeShadingParameters &s,
+          const AllocatedGrid<TerrainHeight> &grid,
+          AllocatedGrid<int8_t> &result)
+{
+  constexpr unsigned q = QUANTISATION;
+  const unsigned width = grid.GetWidth();
+
+  for (unsigned y = q; y < grid.GetHeight() - q; ++y) {
+    const TerrainHeight *src = grid.GetPointerAt(q, y);
+    f(s, 2 * q, 2 * q, src - q * width, src + q * width, src - q, src + q,
+      result.GetPointerAt(q, y), width - 2 * q);
+  }
+}
+
+static double
+Benchmark(const char *name, ShadeRowFunction f,
+          const SlopeShadingParameters &s,
+          const AllocatedGrid<TerrainHeight> &grid,
+          AllocatedGrid<int8_t> &result)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    ShadeGrid(f, s, grid, result);
+
+  const std::chrono::duration<double> duration =
+    std::chrono::steady_clock::now() - start;
+
+  const double pixels = double(WIDTH - 2 * QUANTISATION) *
+    (HEIGHT - 2 * QUANTISATION) * ITERATIONS;
+  const double mpps = pixels / duration.count() / 1e6;
+  printf("%-10s %8.1f Mpixel/s\n", name, mpps);
+  return mpps;
+}
+
+int
+main(int argc, char **argv)
+{
+  AllocatedGrid<TerrainHeight> grid(WIDTH, HEIGHT);
+  GenerateTerrain(grid);
+
+  const SlopeShadingParameters s{-127, -127, 177, 128, 30};
+
+  AllocatedGrid<int8_t> portable(WIDTH, HEIGHT), optimised(WIDTH, HEIGHT);
+  std::fill(portable.begin(), portable.end(), 0);
+  std::fill(optimised.begin(), optimised.end(), 0);
+
+  const double a = Benchmark("portable", CalculateSlopeShadeRowPortable,
+                             s, grid, portable);
+  const double b = Benchmark(GetSlopeShadingImplementation(),
+                             CalculateSlopeShadeRow, s, grid, optimised);
+  printf("speedup    %8.2fx\n", b / a);
+
+  if (!std::equal(portable.begin(), portable.end(), optimised.begin())) {
+    fprintf(stderr, "Results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
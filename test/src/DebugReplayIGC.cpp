@@ -22,17 +22,20 @@ Copyright_License {
 */
 
 #include "DebugReplayIGC.hpp"
-#include "IO/FileLineReader.hpp"
-#include "IGC/IGCParser.hpp"
 #include "IGC/IGCFix.hpp"
 #include "Units/System.hpp"
 #include "OS/Path.hpp"
 
+#include <stdexcept>
+
 DebugReplay*
 DebugReplayIGC::Create(Path input_file)
 {
-  FileLineReaderA *reader = new FileLineReaderA(input_file);
-  return new DebugReplayIGC(reader);
+  std::unique_ptr<FileMapping> mapping(new FileMapping(input_file));
+  if (mapping->error())
+    throw std::runtime_error("Failed to open " + input_file.ToUTF8());
+
+  return new DebugReplayIGC(std::move(mapping));
 }
 
 bool
@@ -40,26 +43,18 @@ DebugReplayIGC::Next()
 {
   last_basic = computed_basic;
 
-  const char *line;
-  while ((line = reader->ReadLine()) != NULL) {
-    if (line[0] == 'B') {
-      IGCFix fix;
-      if (IGCParseFix(line, extensions, fix)) {
-        CopyFromFix(fix);
-
-        Compute();
-        return true;
-      }
-    } else if (line[0] == 'H') {
-      BrokenDate date;
-      if (memcmp(line, "HFDTE", 5) == 0 &&
-          IGCParseDateRecord(line, date)) {
-        (BrokenDate &)raw_basic.date_time_utc = date;
-        raw_basic.time_available.Clear();
-      }
-    } else if (line[0] == 'I') {
-      IGCParseExtensions(line, extensions);
+  IGCFix fix;
+  if (reader.Next(fix)) {
+    if (!(reader.GetDate() == date)) {
+      date = reader.GetDate();
+      (BrokenDate &)raw_basic.date_time_utc = date;
+      raw_basic.time_available.Clear();
     }
+
+    CopyFromFix(fix);
+
+    Compute();
+    return true;
   }
 
   if (computed_basic.time_available)
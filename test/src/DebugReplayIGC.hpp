@@ -24,23 +24,39 @@ Copyright_License {
 #ifndef XCSOAR_DEBUG_REPLAY_IGC_HPP
 #define XCSOAR_DEBUG_REPLAY_IGC_HPP
 
-#include "DebugReplayFile.hpp"
-#include "IGC/IGCExtensions.hpp"
-#include "IO/FileLineReader.hpp"
+#include "DebugReplay.hpp"
+#include "IGC/IGCReader.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <memory>
 
 struct IGCFix;
 
-class DebugReplayIGC : public DebugReplayFile {
-  IGCExtensions extensions;
+class DebugReplayIGC : public DebugReplay {
+  std::unique_ptr<FileMapping> mapping;
+  IGCReader reader;
+
+  /**
+   * The date which was last copied to #raw_basic.
+   */
+  BrokenDate date;
 
 private:
-  DebugReplayIGC(FileLineReaderA *_reader)
-    : DebugReplayFile(_reader) {
-    extensions.clear();
-  }
+  explicit DebugReplayIGC(std::unique_ptr<FileMapping> &&_mapping)
+    :mapping(std::move(_mapping)),
+     reader(StringView((const char *)mapping->data(), mapping->size())),
+     date(BrokenDate::Invalid()) {}
 
 public:
-  virtual bool Next();
+  long Size() const override {
+    return reader.GetSize();
+  }
+
+  long Tell() const override {
+    return reader.Tell();
+  }
+
+  bool Next() override;
 
   static DebugReplay *Create(Path input_file);
 
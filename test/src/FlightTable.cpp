@@ -20,11 +20,11 @@
 }
 */
 
-#include "IGC/IGCParser.hpp"
+#include "IGC/IGCReader.hpp"
 #include "IGC/IGCFix.hpp"
-#include "IGC/IGCExtensions.hpp"
-#include "IO/FileLineReader.hpp"
+#include "OS/FileMapping.hpp"
 #include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
 #include "Util/StaticString.hxx"
 #include "Util/PrintException.hxx"
 #include "Compiler.h"
@@ -128,28 +128,21 @@ class IGCFileVisitor : public File::Visitor {
 void
 IGCFileVisitor::Visit(Path path, Path filename)
 {
-  FileLineReaderA reader(path);
+  const FileMapping mapping(path);
+  if (mapping.error()) {
+    fprintf(stderr, "Failed to open %s\n", path.ToUTF8().c_str());
+    return;
+  }
 
-  IGCExtensions extensions;
-  extensions.clear();
+  IGCReader reader(StringView((const char *)mapping.data(), mapping.size()));
 
   FlightCheck flight(filename.c_str());
-  char *line;
-  while ((line = reader.ReadLine()) != NULL) {
-    unsigned day, month, year;
-
-    IGCFix fix;
-    if (IGCParseFix(line, extensions, fix))
-      flight.fix(fix);
-    else if (sscanf(line, "HFDTE%02u%02u%02u", &day, &month, &year)) {
-      /* damn you, Y2K bug! */
-      if (year > 80)
-        year += 1900;
-      else
-        year += 2000;
-
-      flight.date(year, month, day);
-    }
+  for (const IGCFix &fix : reader) {
+    const BrokenDate &date = reader.GetDate();
+    if (date.IsPlausible())
+      flight.date(date.year, date.month, date.day);
+
+    flight.fix(fix);
   }
 
   flight.finish();
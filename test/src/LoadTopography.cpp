@@ -24,6 +24,10 @@ Copyright_License {
 /*
  * This program loads the topography from a map file and exits.  Useful
  * for valgrind and profiling.
+ *
+ * With a CACHE directory, the preprocessed shape stores are
+ * generated there on the first run and memory-mapped on subsequent
+ * runs.
  */
 
 #include "Topography/TopographyStore.hpp"
@@ -32,9 +36,14 @@ Copyright_License {
 #include "OS/Args.hpp"
 #include "IO/ZipArchive.hpp"
 #include "IO/ZipLineReader.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileUtil.hpp"
 #include "Operation/Operation.hpp"
 #include "Util/PrintException.hxx"
 
+#include <chrono>
+#include <memory>
+
 #include <stdio.h>
 #include <tchar.h>
 
@@ -63,20 +72,53 @@ TriangulateAll(const TopographyStore &store)
 
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH");
+  Args args(argc, argv, "PATH [CACHE]");
   const auto path = args.ExpectNextPath();
+
+  std::unique_ptr<FileCache> cache;
+  if (!args.IsEmpty()) {
+    const auto cache_path = args.ExpectNextPath();
+    Directory::Create(cache_path);
+    cache.reset(new FileCache(cache_path));
+  }
+
   args.ExpectEnd();
 
+  const auto start = std::chrono::steady_clock::now();
+
   ZipArchive archive(path);
 
   ZipLineReaderA reader(archive.get(), "topology.tpl");
 
   TopographyStore topography;
   NullOperationEnvironment operation;
-  topography.Load(operation, reader, NULL, archive.get());
+  topography.Load(operation, reader, NULL, archive.get(),
+                  cache.get(), path);
+
+  const auto loaded = std::chrono::steady_clock::now();
 
   topography.LoadAll();
 
+  const auto end = std::chrono::steady_clock::now();
+
+  unsigned n_stores = 0;
+  for (unsigned i = 0; i < topography.size(); ++i) {
+    const TopographyFile &file = topography[i];
+    if (file.HasStore())
+      ++n_stores;
+
+    _tprintf(_T("%s: allocated=%lu used=%lu\n"), file.GetName(),
+             (unsigned long)file.GetMemoryUsage(),
+             (unsigned long)file.GetUsedMemory());
+  }
+
+  using std::chrono::microseconds;
+  using std::chrono::duration_cast;
+  printf("files=%u stores=%u open_us=%ld load_all_us=%ld\n",
+         topography.size(), n_stores,
+         (long)duration_cast<microseconds>(loaded - start).count(),
+         (long)duration_cast<microseconds>(end - loaded).count());
+
 #ifdef ENABLE_OPENGL
   TriangulateAll(topography);
 #endif
@@ -25,9 +25,17 @@ Copyright_License {
 #include "Waypoint/Factory.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Geo/Flat/TaskProjection.hpp"
+#include "Geo/Math.hpp"
 #include "OS/ConvertPathName.hpp"
 #include "OS/Args.hpp"
+#include "OS/Clock.hpp"
 #include "Operation/Operation.hpp"
+#include "Util/QuadTree.hpp"
+#include "Util/PackedKDTree.hpp"
+
+#include <algorithm>
+#include <vector>
 
 #include <stdint.h>
 #include <stdio.h>
@@ -48,6 +56,55 @@ LoadWaypoints(Path path, Waypoints &waypoints)
   return true;
 }
 
+/**
+ * A deterministic pseudo-random number in the range [0, 1].
+ */
+static double
+Random(uint32_t &seed)
+{
+  seed = seed * 1103515245 + 12345;
+  return double((seed >> 8) & 0xffff) / 0xffff;
+}
+
+/**
+ * Fill the database with a synthetic world: clusters of waypoints
+ * around random centers, similar to the distribution of real
+ * waypoint files.  Every fourth waypoint is landable.
+ */
+static void
+GenerateWaypoints(Waypoints &waypoints, unsigned n)
+{
+  uint32_t seed = 42;
+
+  std::vector<GeoPoint> centers;
+  for (unsigned i = 0; i < 64; ++i)
+    centers.emplace_back(Angle::Degrees(-180 + Random(seed) * 360),
+                         Angle::Degrees(-55 + Random(seed) * 125));
+
+  for (unsigned i = 0; i < n; ++i) {
+    const GeoPoint &center = centers[i % centers.size()];
+
+    /* denser near the center of the cluster */
+    const double distance = Random(seed) * Random(seed) * 400000;
+    Waypoint waypoint(FindLatitudeLongitude(center,
+                                            Angle::Degrees(Random(seed) * 360),
+                                            distance));
+
+    TCHAR name[32];
+    _stprintf(name, _T("WP%u"), i);
+    waypoint.name = name;
+
+    if (i % 8 == 0)
+      waypoint.type = Waypoint::Type::AIRFIELD;
+    else if (i % 8 == 4)
+      waypoint.type = Waypoint::Type::OUTLANDING;
+
+    waypoints.Append(std::move(waypoint));
+  }
+
+  waypoints.Optimise();
+}
+
 static bool
 ParseGeopoint(const char *line, GeoPoint &location)
 {
@@ -114,6 +171,247 @@ GetNearestWaypoint(const GeoPoint &location, const Waypoints &waypoints,
   return waypoints.GetNearestIf(location, range, predicate);
 }
 
+struct FlatAccessor {
+  gcc_pure
+  int GetX(const WaypointPtr &wp) const {
+    return wp->flat_location.x;
+  }
+
+  gcc_pure
+  int GetY(const WaypointPtr &wp) const {
+    return wp->flat_location.y;
+  }
+};
+
+typedef QuadTree<WaypointPtr, FlatAccessor> WaypointQuadTree;
+typedef PackedKDTree<WaypointPtr, FlatAccessor> WaypointKDTree;
+
+static bool
+IsLandablePtr(const WaypointPtr &wp)
+{
+  return wp->IsLandable();
+}
+
+struct BenchmarkQuery {
+  FlatGeoPoint location;
+  unsigned range, visit_range;
+};
+
+/**
+ * Sum of the square distances of the results; both indexes must
+ * agree on it.
+ */
+struct BenchmarkResult {
+  uint64_t nearest = 0, landable = 0, knn = 0;
+  unsigned range_hits = 0;
+};
+
+static uint64_t
+SquareDistance(const WaypointPtr &wp, const FlatGeoPoint &p)
+{
+  return WaypointKDTree::Point(wp->flat_location.x, wp->flat_location.y)
+    .SquareDistanceTo(WaypointKDTree::Point(p.x, p.y));
+}
+
+static void
+PrintTiming(const char *index, uint64_t build_us, uint64_t nearest_us,
+            uint64_t landable_us, uint64_t knn_us, uint64_t range_us,
+            const BenchmarkResult &result)
+{
+  printf("index=%s build_us=%llu nearest_us=%llu landable_us=%llu "
+         "knn_us=%llu range_us=%llu range_hits=%u\n",
+         index, (unsigned long long)build_us,
+         (unsigned long long)nearest_us, (unsigned long long)landable_us,
+         (unsigned long long)knn_us, (unsigned long long)range_us,
+         result.range_hits);
+}
+
+/**
+ * The QuadTree has no k-nearest query: collect all landables within
+ * range, and sort them.
+ */
+static BenchmarkResult
+BenchmarkQuadTree(const Waypoints &waypoints,
+                  const std::vector<BenchmarkQuery> &queries, unsigned k)
+{
+  BenchmarkResult result;
+
+  uint64_t start = MonotonicClockUS();
+  WaypointQuadTree tree;
+  for (const auto &wp : waypoints)
+    tree.Add(wp);
+  tree.Optimise();
+  const uint64_t build_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    const auto found =
+      tree.FindNearest(WaypointQuadTree::Point(q.location.x, q.location.y),
+                       q.range);
+    if (found.first != tree.end())
+      result.nearest += SquareDistance(*found.first, q.location);
+  }
+  const uint64_t nearest_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    const auto found =
+      tree.FindNearestIf(WaypointQuadTree::Point(q.location.x, q.location.y),
+                         q.range, IsLandablePtr);
+    if (found.first != tree.end())
+      result.landable += SquareDistance(*found.first, q.location);
+  }
+  const uint64_t landable_us = MonotonicClockUS() - start;
+
+  std::vector<uint64_t> distances;
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    distances.clear();
+    auto collect = [&distances, &q](const WaypointPtr &wp){
+      if (wp->IsLandable())
+        distances.push_back(SquareDistance(wp, q.location));
+    };
+    tree.VisitWithinRange(WaypointQuadTree::Point(q.location.x, q.location.y),
+                          q.range, collect);
+
+    const unsigned n = std::min<unsigned>(k, distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + n,
+                      distances.end());
+    for (unsigned i = 0; i < n; ++i)
+      result.knn += distances[i];
+  }
+  const uint64_t knn_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    auto count = [&result](const WaypointPtr &){
+      ++result.range_hits;
+    };
+    tree.VisitWithinRange(WaypointQuadTree::Point(q.location.x, q.location.y),
+                          q.visit_range, count);
+  }
+  const uint64_t range_us = MonotonicClockUS() - start;
+
+  PrintTiming("quadtree", build_us, nearest_us, landable_us, knn_us,
+              range_us, result);
+  return result;
+}
+
+static BenchmarkResult
+BenchmarkKDTree(const Waypoints &waypoints,
+                const std::vector<BenchmarkQuery> &queries, unsigned k)
+{
+  BenchmarkResult result;
+
+  /* like class Waypoints, build a separate index for the landables */
+  uint64_t start = MonotonicClockUS();
+  WaypointKDTree tree, landables;
+  tree.Build(waypoints.begin(), waypoints.end());
+  landables.BuildIf(waypoints.begin(), waypoints.end(), IsLandablePtr);
+  const uint64_t build_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    const WaypointPtr *found =
+      tree.FindNearest(WaypointKDTree::Point(q.location.x, q.location.y),
+                       q.range);
+    if (found != nullptr)
+      result.nearest += SquareDistance(*found, q.location);
+  }
+  const uint64_t nearest_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    const WaypointPtr *found =
+      landables.FindNearest(WaypointKDTree::Point(q.location.x, q.location.y),
+                            q.range);
+    if (found != nullptr)
+      result.landable += SquareDistance(*found, q.location);
+  }
+  const uint64_t landable_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    auto sum = [&result, &q](const WaypointPtr &wp){
+      result.knn += SquareDistance(wp, q.location);
+    };
+    landables.VisitNearest(WaypointKDTree::Point(q.location.x, q.location.y),
+                           q.range, k, sum);
+  }
+  const uint64_t knn_us = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  for (const auto &q : queries) {
+    auto count = [&result](const WaypointPtr &){
+      ++result.range_hits;
+    };
+    tree.VisitWithinRange(WaypointKDTree::Point(q.location.x, q.location.y),
+                          q.visit_range, count);
+  }
+  const uint64_t range_us = MonotonicClockUS() - start;
+
+  PrintTiming("kdtree", build_us, nearest_us, landable_us, knn_us,
+              range_us, result);
+  return result;
+}
+
+/**
+ * Compare the QuadTree with the PackedKDTree on queries near random
+ * waypoints.
+ */
+static bool
+RunBenchmark(const Waypoints &waypoints, unsigned n_queries,
+             double range, unsigned k)
+{
+  /* the projection is only used to convert the ranges to flat
+     units, so it needs not be exactly the one of class Waypoints */
+  TaskProjection projection;
+  std::vector<WaypointPtr> all;
+  for (const auto &wp : waypoints) {
+    if (all.empty())
+      projection.Reset(wp->location);
+    else
+      projection.Scan(wp->location);
+
+    all.push_back(wp);
+  }
+
+  if (all.empty())
+    return false;
+
+  projection.Update();
+
+  uint32_t seed = 1;
+  std::vector<BenchmarkQuery> queries;
+  queries.reserve(n_queries);
+  for (unsigned i = 0; i < n_queries; ++i) {
+    const Waypoint &wp = *all[unsigned(Random(seed) * (all.size() - 1))];
+    const unsigned offset = projection.ProjectRangeInteger(wp.location,
+                                                           20000);
+
+    BenchmarkQuery q;
+    q.location = wp.flat_location;
+    q.location.x += int(Random(seed) * 2 * offset) - int(offset);
+    q.location.y += int(Random(seed) * 2 * offset) - int(offset);
+    q.range = projection.ProjectRangeInteger(wp.location, range);
+    q.visit_range = offset;
+    queries.push_back(q);
+  }
+
+  printf("waypoints=%u queries=%u range=%.0f k=%u\n",
+         waypoints.size(), n_queries, range, k);
+
+  const BenchmarkResult a = BenchmarkQuadTree(waypoints, queries, k);
+  const BenchmarkResult b = BenchmarkKDTree(waypoints, queries, k);
+  if (a.nearest != b.nearest || a.landable != b.landable ||
+      a.knn != b.knn || a.range_hits != b.range_hits) {
+    fprintf(stderr, "Query results differ\n");
+    return false;
+  }
+
+  return true;
+}
+
 static void
 PrintWaypoint(const Waypoint *waypoint)
 {
@@ -131,16 +429,22 @@ int main(int argc, char **argv)
 {
   WaypointType type = WaypointType::ALL;
   double range = 100000;
+  unsigned benchmark = 0, k = 10, random = 0;
 
   Args args(argc, argv,
-            "PATH\n\nPATH is expected to be any compatible waypoint file.\n"
+            "[--range=M] [--airports-only] [--landables-only] PATH\n"
+            "       [--benchmark[=N]] [--k=K] {PATH|--random=COUNT}\n\n"
+            "PATH is expected to be any compatible waypoint file.\n"
             "Stdin expects a list of coordinates at floating point values\n"
             "in the format: LAT LON\n\ne.g.\n"
             "-23.49858 123.45838\n"
             "2.12343 34.38432\n"
             "65.18234 -173.48307\n\n"
             "Output is in the format: LAT LON ELEV (in m) NAME\n\ne.g.\n"
-            "50.823055 6.186384 189 Aachen Merzbruc");
+            "50.823055 6.186384 189 Aachen Merzbruc\n\n"
+            "--benchmark runs N (default 20000) random queries on the\n"
+            "QuadTree and the PackedKDTree instead, and compares the\n"
+            "results.  --random generates a world of COUNT waypoints.");
 
   const char *arg;
   while ((arg = args.PeekNext()) != NULL && *arg == '-') {
@@ -155,17 +459,41 @@ int main(int argc, char **argv)
       type = WaypointType::AIRPORT;
     } else if (StringStartsWith(arg, "--landables-only")) {
       type = WaypointType::LANDABLE;
+    } else if (StringIsEqual(arg, "--benchmark")) {
+      benchmark = 20000;
+    } else if ((value = StringAfterPrefix(arg, "--benchmark=")) != NULL) {
+      benchmark = strtoul(value, NULL, 10);
+      if (benchmark == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--k=")) != NULL) {
+      k = strtoul(value, NULL, 10);
+      if (k == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--random=")) != NULL) {
+      random = strtoul(value, NULL, 10);
+      if (random == 0)
+        args.UsageError();
     } else {
       args.UsageError();
     }
   }
 
-  const auto path = args.ExpectNextPath();
-  args.ExpectEnd();
-
   Waypoints waypoints;
-  if (!LoadWaypoints(path, waypoints))
-    return EXIT_FAILURE;
+  if (random > 0) {
+    args.ExpectEnd();
+    GenerateWaypoints(waypoints, random);
+  } else {
+    const auto path = args.ExpectNextPath();
+    args.ExpectEnd();
+
+    if (!LoadWaypoints(path, waypoints))
+      return EXIT_FAILURE;
+  }
+
+  if (benchmark > 0)
+    return RunBenchmark(waypoints, benchmark, range, k)
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
 
   char buffer[1024];
   const char *line;
@@ -138,6 +138,8 @@ void PrintHelper::print_route(RoutePlanner& r)
   printf("#   unique links %d\n", (int)r.count_unique);
   printf("#   airspace queries %d\n", (int)r.count_airspace);
   printf("#   terrain queries %d\n", (int)r.count_terrain);
+  printf("#   terrain cache hits %lu misses %lu\n",
+         r.terrain_cache.GetHits(), r.terrain_cache.GetMisses());
   printf("#   supressed %d\n", (int)r.count_supressed);
 }
 
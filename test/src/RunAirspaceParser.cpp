@@ -22,28 +22,288 @@ Copyright_License {
 */
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
 #include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileMapping.hpp"
 #include "IO/FileLineReader.hpp"
+#include "IO/FileCache.hpp"
 #include "Operation/Operation.hpp"
 #include "Util/PrintException.hxx"
+#include "Util/StringAPI.hxx"
+#include "Util/StringCompare.hxx"
+#include "Util/StringView.hxx"
+
+#include <memory>
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <tchar.h>
 
+static bool
+ParseLines(Path path, Airspaces &airspaces)
+{
+  FileLineReader reader(path, Charset::AUTO);
+
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+  return parser.Parse(reader, operation);
+}
+
+static bool
+ParseMapped(Path path, Airspaces &airspaces)
+{
+  const FileMapping mapping(path);
+  if (mapping.error())
+    return false;
+
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+  return parser.Parse(StringView((const char *)mapping.data(),
+                                 mapping.size()),
+                      Charset::AUTO, operation);
+}
+
+static void
+Hash(uint64_t &h, const void *data, size_t size)
+{
+  /* FNV-1a */
+  const uint8_t *p = (const uint8_t *)data;
+  for (size_t i = 0; i < size; ++i) {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+}
+
+static void
+Hash(uint64_t &h, double value)
+{
+  Hash(h, &value, sizeof(value));
+}
+
+static void
+Hash(uint64_t &h, const GeoPoint &p)
+{
+  Hash(h, p.longitude.Native());
+  Hash(h, p.latitude.Native());
+}
+
+static void
+Hash(uint64_t &h, const AirspaceAltitude &altitude)
+{
+  Hash(h, altitude.altitude);
+  Hash(h, altitude.flight_level);
+  Hash(h, altitude.altitude_above_terrain);
+  const unsigned reference = unsigned(altitude.reference);
+  Hash(h, &reference, sizeof(reference));
+}
+
+/**
+ * Calculate a checksum over all airspaces which does not depend on
+ * their order in the tree.
+ */
+static uint64_t
+Checksum(const Airspaces &airspaces)
+{
+  uint64_t sum = 0;
+
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+
+    uint64_t h = 14695981039346656037ull;
+    Hash(h, airspace.GetName(), StringLength(airspace.GetName()) * sizeof(TCHAR));
+    Hash(h, airspace.GetRadioText().data(),
+         airspace.GetRadioText().length() * sizeof(TCHAR));
+
+    const unsigned type = airspace.GetType();
+    Hash(h, &type, sizeof(type));
+    Hash(h, airspace.GetBase());
+    Hash(h, airspace.GetTop());
+
+    if (airspace.GetShape() == AbstractAirspace::Shape::CIRCLE) {
+      const AirspaceCircle &circle = (const AirspaceCircle &)airspace;
+      Hash(h, circle.GetReferenceLocation());
+      Hash(h, circle.GetRadius());
+    } else {
+      const AirspacePolygon &polygon = (const AirspacePolygon &)airspace;
+      for (const auto &p : polygon.GetPoints())
+        Hash(h, p.GetLocation());
+    }
+
+    sum += h;
+  }
+
+  return sum;
+}
+
+static bool
+LoadCache(FileCache &cache, Path path, Airspaces &airspaces)
+{
+  size_t offset;
+  std::unique_ptr<FileMapping> mapping(cache.Map(_T("airspace"), path,
+                                                 offset));
+  return mapping &&
+    LoadAirspaceCache(airspaces,
+                      ConstBuffer<void>(mapping->at(offset),
+                                        mapping->size() - offset));
+}
+
+/**
+ * Compare a cold start (parse and write the cache) with warm starts
+ * (load the cache).
+ */
+static int
+BenchCache(Path path, Path cache_path, unsigned n)
+{
+  FileCache cache{AllocatedPath(cache_path)};
+  cache.Flush(_T("airspace"));
+
+  uint64_t cold_us, warm_us = 0, parsed_sum, cached_sum = 0;
+  unsigned cached_size = 0;
+
+  {
+    Airspaces airspaces;
+    const uint64_t start = MonotonicClockUS();
+    if (!ParseMapped(path, airspaces)) {
+      fprintf(stderr, "Failed to parse input file\n");
+      return EXIT_FAILURE;
+    }
+
+    airspaces.Optimise();
+
+    FILE *file = cache.Save(_T("airspace"), path);
+    if (file == nullptr || !SaveAirspaceCache(airspaces, file) ||
+        !cache.Commit(_T("airspace"), file)) {
+      fprintf(stderr, "Failed to write cache\n");
+      return EXIT_FAILURE;
+    }
+
+    cold_us = MonotonicClockUS() - start;
+    parsed_sum = Checksum(airspaces);
+  }
+
+  for (unsigned i = 0; i < n; ++i) {
+    Airspaces airspaces;
+    const uint64_t start = MonotonicClockUS();
+    if (!LoadCache(cache, path, airspaces)) {
+      fprintf(stderr, "Failed to load cache\n");
+      return EXIT_FAILURE;
+    }
+
+    airspaces.Optimise();
+    warm_us += MonotonicClockUS() - start;
+
+    cached_size = airspaces.GetSize();
+    cached_sum = Checksum(airspaces);
+  }
+
+  printf("cached_airspaces=%u\n", cached_size);
+  printf("cold_us=%llu\n", (unsigned long long)cold_us);
+  printf("warm_us=%llu\n", (unsigned long long)(warm_us / n));
+  printf("checksum=%016llx cached_checksum=%016llx\n",
+         (unsigned long long)parsed_sum, (unsigned long long)cached_sum);
+
+  if (parsed_sum != cached_sum) {
+    fprintf(stderr, "Results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Parse the file repeatedly with both parsers and compare speed and
+ * results.
+ */
+static int
+Bench(Path path, unsigned n)
+{
+  uint64_t lines_us = 0, mapped_us = 0;
+  uint64_t lines_sum = 0, mapped_sum = 0;
+  unsigned lines_size = 0, mapped_size = 0;
+
+  for (unsigned i = 0; i < n; ++i) {
+    Airspaces a, b;
+
+    uint64_t start = MonotonicClockUS();
+    if (!ParseLines(path, a)) {
+      fprintf(stderr, "Failed to parse input file\n");
+      return EXIT_FAILURE;
+    }
+    lines_us += MonotonicClockUS() - start;
+
+    start = MonotonicClockUS();
+    if (!ParseMapped(path, b)) {
+      fprintf(stderr, "Failed to parse mapped input file\n");
+      return EXIT_FAILURE;
+    }
+    mapped_us += MonotonicClockUS() - start;
+
+    a.Optimise();
+    b.Optimise();
+
+    lines_size = a.GetSize();
+    mapped_size = b.GetSize();
+    lines_sum = Checksum(a);
+    mapped_sum = Checksum(b);
+  }
+
+  printf("iterations=%u\n", n);
+  printf("airspaces=%u mapped_airspaces=%u\n", lines_size, mapped_size);
+  printf("line_reader_us=%llu\n", (unsigned long long)(lines_us / n));
+  printf("mapped_us=%llu\n", (unsigned long long)(mapped_us / n));
+  printf("checksum=%016llx mapped_checksum=%016llx\n",
+         (unsigned long long)lines_sum, (unsigned long long)mapped_sum);
+
+  if (lines_size != mapped_size || lines_sum != mapped_sum) {
+    fprintf(stderr, "Results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH");
+  Args args(argc, argv, "[--bench[=N]] [--cache=DIR] PATH");
+
+  unsigned bench = 0;
+  const char *cache_path = nullptr;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if (StringIsEqual(arg, "--bench")) {
+      bench = 10;
+    } else if ((value = StringAfterPrefix(arg, "--bench=")) != nullptr) {
+      bench = strtoul(value, nullptr, 10);
+      if (bench == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--cache=")) != nullptr) {
+      cache_path = value;
+    } else {
+      args.UsageError();
+    }
+  }
+
   const auto path = args.ExpectNextPath();
   args.ExpectEnd();
 
-  FileLineReader reader(path, Charset::AUTO);
+  if (cache_path != nullptr)
+    return BenchCache(path, Path(cache_path), bench > 0 ? bench : 10);
 
-  Airspaces airspaces;
-  AirspaceParser parser(airspaces);
+  if (bench > 0)
+    return Bench(path, bench);
 
-  NullOperationEnvironment operation;
-  if (!parser.Parse(reader, operation)) {
+  Airspaces airspaces;
+  if (!ParseMapped(path, airspaces)) {
     fprintf(stderr, "Failed to parse input file\n");
     return 1;
   }
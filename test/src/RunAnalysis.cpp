@@ -187,9 +187,12 @@ Main()
   glide_computer.SetContestIncremental(false);
   glide_computer.Initialise();
 
+  glide_computer.GetProfiler().SetEnabled(true);
   LoadReplay(replay, glide_computer, blackboard);
   delete replay;
 
+  glide_computer.GetProfiler().Dump(stderr);
+
   SingleWindow main_window;
   main_window.Create(_T("RunAnalysis"),
                      {640, 480});
@@ -0,0 +1,401 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * A UDP load generator for xcsoar-cloud-server.  It simulates many
+ * moving clients in clusters, each of which submits fixes and
+ * requests nearby traffic, and measures how quickly the server
+ * delivers the new locations to the neighbours.  Every fifth cluster
+ * straddles a tile boundary of the server's sharded index, so some
+ * clients cross from one shard to another.
+ *
+ * The fix sequence number is transported in the altitude field, which
+ * allows matching each received traffic record with the time its fix
+ * was sent.
+ */
+
+#include "Tracking/SkyLines/Assemble.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Tracking/SkyLines/Server.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/Math.hpp"
+#include "OS/Args.hpp"
+#include "OS/ByteOrder.hpp"
+#include "Util/StringCompare.hxx"
+#include "Util/PrintException.hxx"
+
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using boost::asio::ip::udp;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * The number of distinct fix sequence numbers which fit into the
+ * altitude field.
+ */
+static constexpr unsigned N_SEQUENCES = 65536;
+
+/**
+ * The number of datagrams sent per millisecond during the warmup.
+ */
+static constexpr unsigned WARMUP_CHUNK = 50;
+
+class LoadGenerator {
+  struct Socket {
+    udp::socket socket;
+    udp::endpoint sender;
+    uint8_t buffer[4096];
+
+    explicit Socket(boost::asio::io_service &io_service)
+      :socket(io_service, udp::endpoint(udp::v4(), 0)) {
+      socket.set_option(boost::asio::socket_base::receive_buffer_size(4 * 1024 * 1024));
+    }
+  };
+
+  struct SimulatedClient {
+    uint64_t key;
+    GeoPoint location;
+    Angle track;
+    Clock::time_point last_fix;
+  };
+
+  const udp::endpoint server;
+
+  const unsigned rate;
+
+  /**
+   * The ground speed of all clients [m/s].
+   */
+  const double speed;
+  const Clock::duration duration;
+
+  std::vector<std::unique_ptr<Socket>> sockets;
+  std::vector<SimulatedClient> clients;
+
+  boost::asio::steady_timer timer;
+
+  Clock::time_point start_time;
+
+  /**
+   * The time each fix was sent, indexed by its sequence number (i.e.
+   * the altitude).  Unset for fixes sent during the warmup.
+   */
+  std::array<Clock::time_point, N_SEQUENCES> send_times;
+
+  unsigned next_client = 0;
+  unsigned long n_sent = 0, n_requests = 0;
+  unsigned long n_datagrams = 0, n_records = 0;
+
+  std::vector<unsigned> latencies_us;
+
+public:
+  LoadGenerator(boost::asio::io_service &io_service, udp::endpoint _server,
+                unsigned n_clients, unsigned cluster_size,
+                unsigned _rate, double _speed, Clock::duration _duration)
+    :server(_server), rate(_rate), speed(_speed), duration(_duration),
+     timer(io_service) {
+    const unsigned n_sockets = std::min(n_clients, 64u);
+    for (unsigned i = 0; i < n_sockets; ++i) {
+      sockets.emplace_back(new Socket(io_service));
+      AsyncReceive(*sockets.back());
+    }
+
+    /* the clusters are one degree apart, so they don't see each
+       other; within a cluster, everybody sees everybody */
+    clients.reserve(n_clients);
+    const auto now = Clock::now();
+    for (unsigned i = 0; i < n_clients; ++i) {
+      const unsigned cluster = i / cluster_size;
+      const GeoPoint center(Angle::Degrees(-20 + int(cluster % 40)),
+                            Angle::Degrees(-40 + int(cluster / 40)));
+      clients.push_back({i + 1ULL,
+                         FindLatitudeLongitude(center, RandomAngle(),
+                                               rand() % 5000),
+                         RandomAngle(), now});
+    }
+  }
+
+  void Start() {
+    Warmup(0);
+  }
+
+  void PrintResult() {
+    const double seconds =
+      std::chrono::duration<double>(duration).count();
+
+    printf("clients=%u\n", unsigned(clients.size()));
+    printf("fixes_sent=%lu\n", n_sent);
+    printf("fixes_per_second=%.0f\n", n_sent / seconds);
+    printf("datagrams_received=%lu\n", n_datagrams);
+    printf("traffic_received=%lu\n", n_records);
+    printf("traffic_per_second=%.0f\n", n_records / seconds);
+
+    if (latencies_us.empty())
+      return;
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    const auto percentile = [this](unsigned p){
+      return latencies_us[(latencies_us.size() - 1) * p / 100] / 1000.;
+    };
+
+    printf("latency_p50_ms=%.2f\n", percentile(50));
+    printf("latency_p99_ms=%.2f\n", percentile(99));
+    printf("latency_max_ms=%.2f\n", latencies_us.back() / 1000.);
+  }
+
+private:
+  static Angle RandomAngle() {
+    return Angle::Degrees(rand() % 360);
+  }
+
+  Socket &GetSocket(unsigned i) {
+    return *sockets[i % sockets.size()];
+  }
+
+  void SendFix(unsigned i, unsigned seq) {
+    auto &client = clients[i];
+
+    /* fly along the current track, and turn a little */
+    const auto now = Clock::now();
+    const double dt = std::chrono::duration<double>(now - client.last_fix).count();
+    client.last_fix = now;
+    client.location = FindLatitudeLongitude(client.location, client.track,
+                                            speed * dt);
+    client.track = (client.track + Angle::Degrees(rand() % 31 - 15)).AsBearing();
+
+    const auto packet =
+      SkyLinesTracking::MakeFix(client.key,
+                                SkyLinesTracking::FixPacket::FLAG_LOCATION|
+                                SkyLinesTracking::FixPacket::FLAG_ALTITUDE,
+                                0, client.location, Angle::Zero(),
+                                0, 0, seq, 0, 0);
+
+    boost::system::error_code ec;
+    GetSocket(i).socket.send_to(boost::asio::buffer(&packet, sizeof(packet)),
+                                server, 0, ec);
+  }
+
+  void SendTrafficRequest(unsigned i) {
+    const auto packet =
+      SkyLinesTracking::MakeTrafficRequest(clients[i].key,
+                                           false, false, true);
+
+    boost::system::error_code ec;
+    GetSocket(i).socket.send_to(boost::asio::buffer(&packet, sizeof(packet)),
+                                server, 0, ec);
+  }
+
+  /**
+   * Create all clients on the server, then ask for traffic.  This is
+   * done in small chunks, because a burst would overflow the server's
+   * socket buffer.
+   */
+  void Warmup(unsigned position) {
+    const unsigned n = clients.size();
+    const unsigned end = std::min(position + WARMUP_CHUNK, 2 * n);
+    for (; position < end; ++position) {
+      if (position < n)
+        SendFix(position, 0);
+      else
+        SendTrafficRequest(position - n);
+    }
+
+    if (position < 2 * n)
+      timer.expires_from_now(std::chrono::milliseconds(1));
+    else
+      /* let the server settle down */
+      timer.expires_from_now(std::chrono::milliseconds(500));
+
+    timer.async_wait([this, position, n](const boost::system::error_code &ec){
+        if (ec)
+          return;
+
+        if (position < 2 * n) {
+          Warmup(position);
+        } else {
+          start_time = Clock::now();
+          Tick();
+        }
+      });
+  }
+
+  void Tick() {
+    const auto now = Clock::now();
+    const auto elapsed = now - start_time;
+
+    if (elapsed >= duration) {
+      /* let the last updates arrive */
+      timer.expires_from_now(std::chrono::seconds(2));
+      timer.async_wait([this](const boost::system::error_code &ec){
+          if (!ec)
+            timer.get_io_service().stop();
+        });
+      return;
+    }
+
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+
+    /* the server forgets traffic requests after 5 minutes; renew
+       each client's request once a minute */
+    const unsigned long due_requests = clients.size() * seconds / 60;
+    for (; n_requests < due_requests; ++n_requests)
+      SendTrafficRequest(n_requests % clients.size());
+
+    const unsigned long due = rate * seconds;
+    for (; n_sent < due; ++n_sent) {
+      const unsigned seq = n_sent % N_SEQUENCES;
+      send_times[seq] = now;
+      SendFix(next_client, seq);
+      next_client = (next_client + 1) % clients.size();
+    }
+
+    timer.expires_from_now(std::chrono::milliseconds(1));
+    timer.async_wait([this](const boost::system::error_code &ec){
+        if (!ec)
+          Tick();
+      });
+  }
+
+  void AsyncReceive(Socket &s) {
+    s.socket.async_receive_from(boost::asio::buffer(s.buffer, sizeof(s.buffer)),
+                                s.sender,
+                                [this, &s](const boost::system::error_code &ec,
+                                           size_t nbytes){
+                                  if (ec)
+                                    return;
+
+                                  OnDatagram(s.buffer, nbytes);
+                                  AsyncReceive(s);
+                                });
+  }
+
+  void OnDatagram(const void *data, size_t length) {
+    using namespace SkyLinesTracking;
+
+    const auto &packet = *(const TrafficResponsePacket *)data;
+    if (length < sizeof(packet) ||
+        packet.header.magic != ToBE32(MAGIC) ||
+        packet.header.type != ToBE16(Type::TRAFFIC_RESPONSE))
+      return;
+
+    const unsigned n = packet.traffic_count;
+    const auto *traffic = (const TrafficResponsePacket::Traffic *)(&packet + 1);
+    if (length < sizeof(packet) + n * sizeof(*traffic))
+      return;
+
+    ++n_datagrams;
+    n_records += n;
+
+    if (start_time == Clock::time_point())
+      /* still warming up */
+      return;
+
+    const auto now = Clock::now();
+    for (unsigned i = 0; i < n; ++i) {
+      const unsigned seq = (uint16_t)FromBE16(traffic[i].altitude);
+      if (seq >= N_SEQUENCES || send_times[seq] == Clock::time_point())
+        continue;
+
+      const auto latency = now - send_times[seq];
+      latencies_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    }
+  }
+};
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "[--clients=N] [--cluster=N] [--rate=FIXES_PER_SECOND] [--speed=M/S] [--duration=S] HOST\n\n"
+            "Simulates N clients (default 1000) in clusters of --cluster\n"
+            "(default 20), flying at --speed (default 30 m/s), and sends\n"
+            "--rate fixes per second (default 1000) for --duration seconds\n"
+            "(default 10) to the xcsoar-cloud-server on HOST.  Latencies\n"
+            "are only exact while the server delivers traffic within 65536\n"
+            "fixes.  Example for 50k clients with one fix every 2 seconds:\n"
+            "  --clients=50000 --rate=25000");
+
+  unsigned n_clients = 1000, cluster_size = 20, rate = 1000, duration = 10;
+  double speed = 30;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--clients=")) != nullptr) {
+      n_clients = strtoul(value, nullptr, 10);
+      if (n_clients == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--cluster=")) != nullptr) {
+      cluster_size = strtoul(value, nullptr, 10);
+      if (cluster_size == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--rate=")) != nullptr) {
+      rate = strtoul(value, nullptr, 10);
+      if (rate == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--speed=")) != nullptr) {
+      speed = strtod(value, nullptr);
+      if (speed < 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--duration=")) != nullptr) {
+      duration = strtoul(value, nullptr, 10);
+      if (duration == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
+  const char *host = args.ExpectNext();
+  args.ExpectEnd();
+
+  boost::asio::io_service io_service;
+
+  udp::resolver resolver(io_service);
+  const udp::resolver::query query(udp::v4(), host,
+                                   SkyLinesTracking::Server::GetDefaultPortString());
+  const udp::endpoint server = *resolver.resolve(query);
+
+  LoadGenerator generator(io_service, server, n_clients, cluster_size,
+                          rate, speed, std::chrono::seconds(duration));
+  generator.Start();
+
+  io_service.run();
+
+  generator.PrintResult();
+  return EXIT_SUCCESS;
+} catch (const std::exception &exception) {
+  PrintException(exception);
+  return EXIT_FAILURE;
+}
@@ -24,6 +24,8 @@
 #include "Contest/ContestManager.hpp"
 #include "Printing.hpp"
 #include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "Util/StringAPI.hxx"
 #include "DebugReplay.hpp"
 
 #include <assert.h>
@@ -61,11 +63,28 @@ static ContestManager sis_at(Contest::SIS_AT,
 static ContestManager olc_netcoupe(Contest::NET_COUPE,
                                    full_trace, triangle_trace, sprint_trace);
 
+static void
+SetParallel(bool parallel)
+{
+  olc_classic.SetParallel(parallel);
+  olc_fai.SetParallel(parallel);
+  olc_sprint.SetParallel(parallel);
+  olc_league.SetParallel(parallel);
+  olc_plus.SetParallel(parallel);
+  dmst.SetParallel(parallel);
+  xcontest.SetParallel(parallel);
+  sis_at.SetParallel(parallel);
+  olc_netcoupe.SetParallel(parallel);
+}
+
 static int
 TestOLC(DebugReplay &replay)
 {
   bool released = false;
 
+  const uint64_t start_time = MonotonicClockUS();
+  uint64_t idle_time = 0;
+
   for (int i = 1; replay.Next(); i++) {
     if (i % 500 == 0) {
       putchar('.');
@@ -90,10 +109,14 @@ TestOLC(DebugReplay &replay)
     full_trace.push_back(point);
     sprint_trace.push_back(point);
 
+    const uint64_t idle_start_time = MonotonicClockUS();
     olc_sprint.UpdateIdle();
     olc_league.UpdateIdle();
+    idle_time += MonotonicClockUS() - idle_start_time;
   }
 
+  const uint64_t exhaustive_start_time = MonotonicClockUS();
+
   olc_classic.SolveExhaustive();
   olc_fai.SolveExhaustive();
   olc_league.SolveExhaustive();
@@ -103,6 +126,8 @@ TestOLC(DebugReplay &replay)
   sis_at.SolveExhaustive();
   olc_netcoupe.SolveExhaustive();
 
+  const uint64_t end_time = MonotonicClockUS();
+
   putchar('\n');
 
   std::cout << "classic\n";
@@ -139,6 +164,13 @@ TestOLC(DebugReplay &replay)
   std::cout << "netcoupe\n";
   PrintHelper::print(olc_netcoupe.GetStats().GetResult());
 
+  std::cout << "time (" << (olc_plus.IsParallel() ? "parallel" : "sequential")
+            << ")\n"
+            << "# incremental " << idle_time / 1000 << " ms\n"
+            << "# exhaustive " << (end_time - exhaustive_start_time) / 1000
+            << " ms\n"
+            << "# total " << (end_time - start_time) / 1000 << " ms\n";
+
   olc_classic.Reset();
   olc_fai.Reset();
   olc_sprint.Reset();
@@ -155,7 +187,21 @@ TestOLC(DebugReplay &replay)
 
 int main(int argc, char **argv)
 {
-  Args args(argc, argv, "DRIVER FILE");
+  Args args(argc, argv,
+            "[options] DRIVER FILE\n"
+            "Options:\n"
+            "  --parallel               Solve independent contests concurrently");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    if (StringIsEqual(arg, "--parallel"))
+      SetParallel(true);
+    else
+      args.UsageError();
+  }
+
   DebugReplay *replay = CreateDebugReplay(args);
   if (replay == NULL)
     return EXIT_FAILURE;
@@ -0,0 +1,182 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Solves the terrain reach on a grid of origins around the centre of
+ * a map file, first sequentially and then on a #ReachWorkerPool, and
+ * prints the time spent by both.  The fans of both trees are compared
+ * to verify that the concurrent solver produces the same result.
+ */
+
+#include "Engine/Route/TerrainRoute.hpp"
+#include "Engine/Route/FlatTriangleFanTree.hpp"
+#include "Engine/GlideSolvers/GlideSettings.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "Util/ConstBuffer.hxx"
+
+#include <zzip/zzip.h>
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Collects all vertices of all fans, in visiting order.
+ */
+class FanCollector final : public FlatTriangleFanVisitor {
+public:
+  std::vector<FlatGeoPoint> points;
+
+  void VisitFan(FlatGeoPoint origin,
+                ConstBuffer<FlatGeoPoint> fan) override {
+    points.push_back(origin);
+    points.insert(points.end(), fan.begin(), fan.end());
+  }
+};
+
+struct Result {
+  unsigned fans = 0;
+  unsigned long vertices = 0;
+  uint64_t solve_us = 0;
+};
+
+static std::vector<AGeoPoint>
+MakeOrigins(const RasterMap &map)
+{
+  std::vector<AGeoPoint> origins;
+
+  const GeoPoint center = map.GetMapCenter();
+  constexpr int n = 5;
+  for (int i = -n / 2; i <= n / 2; ++i) {
+    for (int j = -n / 2; j <= n / 2; ++j) {
+      const GeoPoint p(center.longitude + Angle::Degrees(0.1 * i),
+                       center.latitude + Angle::Degrees(0.1 * j));
+      const int h = map.GetHeight(p).GetValueOr0();
+      origins.emplace_back(p, h + 500);
+      origins.emplace_back(p, h + 1500);
+    }
+  }
+
+  return origins;
+}
+
+static Result
+Run(const RasterMap &map, const std::vector<AGeoPoint> &origins,
+    unsigned n_workers, std::vector<std::vector<FlatGeoPoint>> &fans)
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  /* only turning reach has child fans */
+  config.reach_calc_mode = RoutePlannerConfig::ReachMode::TURNING;
+
+  const GlidePolar polar(0.1);
+  const SpeedVector wind(Angle::Degrees(0), 0);
+
+  TerrainRoute route;
+  route.UpdatePolar(settings, config, polar, polar, wind, 0);
+  route.SetTerrain(&map);
+  route.SetParallel(n_workers);
+
+  const GeoBounds bounds = map.GetBounds();
+
+  Result result;
+  fans.clear();
+
+  for (const auto &origin : origins) {
+    const uint64_t start_time = MonotonicClockUS();
+    route.SolveReachTerrain(origin, config, INT_MAX);
+    result.solve_us += MonotonicClockUS() - start_time;
+
+    FanCollector collector;
+    route.AcceptInRange(bounds, collector, false);
+    ++result.fans;
+    result.vertices += collector.points.size();
+    fans.emplace_back(std::move(collector.points));
+  }
+
+  return result;
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "MAP.xcm [WORKERS]");
+  const char *map_path = args.ExpectNext();
+  const unsigned n_workers = args.IsEmpty()
+    ? 3
+    : strtoul(args.ExpectNext(), nullptr, 10);
+  args.ExpectEnd();
+
+  ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
+  if (dir == nullptr) {
+    fprintf(stderr, "Failed to open %s\n", map_path);
+    return EXIT_FAILURE;
+  }
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(dir, map.GetTileCache(), operation)) {
+    fprintf(stderr, "failed to load map\n");
+    zzip_dir_close(dir);
+    return EXIT_FAILURE;
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+  zzip_dir_close(dir);
+
+  const auto origins = MakeOrigins(map);
+
+  std::vector<std::vector<FlatGeoPoint>> serial_fans, parallel_fans;
+  const Result serial = Run(map, origins, 0, serial_fans);
+  const Result parallel = Run(map, origins, n_workers, parallel_fans);
+
+  printf("origins=%u vertices=%lu\n",
+         unsigned(origins.size()), serial.vertices);
+  printf("serial_us=%llu\n", (unsigned long long)serial.solve_us);
+  printf("parallel_us=%llu workers=%u\n",
+         (unsigned long long)parallel.solve_us, n_workers);
+
+  if (serial_fans != parallel_fans) {
+    fprintf(stderr, "Concurrent reach differs from sequential reach\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Simulates an aircraft flying towards the centre of a map file from
+ * several directions and solves the terrain route at each fix, like
+ * the calculation thread does.  One planner is kept for the whole
+ * flight, so it may use the results of the previous fixes; a fresh
+ * planner is created at each fix for comparison.  Prints the time
+ * spent by both and the terrain cache hit rate, and fails if the
+ * solutions differ.
+ */
+
+#include "Engine/Route/TerrainRoute.hpp"
+#include "Engine/GlideSolvers/GlideSettings.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+
+#include <zzip/zzip.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** distance between two fixes [m] */
+static constexpr double FIX_DISTANCE = 250;
+
+/** height lost between two fixes [m] */
+static constexpr int FIX_HEIGHT_LOSS = 20;
+
+static constexpr unsigned N_FIXES = 80;
+
+static void
+Setup(TerrainRoute &route, const RasterMap &map,
+      const RoutePlannerConfig &config)
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  const GlidePolar polar(1);
+  const SpeedVector wind(Angle::Degrees(0), 5);
+
+  route.UpdatePolar(settings, config, polar, polar, wind);
+  route.SetTerrain(&map);
+}
+
+static bool
+IsSameRoute(const Route &a, const Route &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i)
+    if (!(a[i] == b[i]) || a[i].altitude != b[i].altitude)
+      return false;
+
+  return true;
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "MAP.xcm");
+  const char *map_path = args.ExpectNext();
+  args.ExpectEnd();
+
+  ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
+  if (dir == nullptr) {
+    fprintf(stderr, "Failed to open %s\n", map_path);
+    return EXIT_FAILURE;
+  }
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(dir, map.GetTileCache(), operation)) {
+    fprintf(stderr, "failed to load map\n");
+    zzip_dir_close(dir);
+    return EXIT_FAILURE;
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+  zzip_dir_close(dir);
+
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  config.mode = RoutePlannerConfig::Mode::TERRAIN;
+
+  const GeoPoint target = map.GetMapCenter();
+  const AGeoPoint a_target(target, map.GetHeight(target).GetValueOr0() + 100);
+
+  uint64_t warm_us = 0, cold_us = 0;
+  unsigned solves = 0, differences = 0;
+  unsigned long cold_queries = 0;
+
+  TerrainRoute warm;
+  Setup(warm, map, config);
+
+  for (unsigned direction = 0; direction < 8; ++direction) {
+    const GeoPoint start =
+      GeoVector(FIX_DISTANCE * N_FIXES,
+                Angle::Degrees(45 * direction)).EndPoint(target);
+    const int start_altitude =
+      map.GetHeight(start).GetValueOr0() + 200 + FIX_HEIGHT_LOSS * N_FIXES / 2;
+
+    for (unsigned i = 0; i < N_FIXES; ++i) {
+      const GeoPoint location = start.Interpolate(target, double(i) / N_FIXES);
+      const AGeoPoint aircraft(location,
+                               start_altitude - int(FIX_HEIGHT_LOSS * i));
+
+      uint64_t start_time = MonotonicClockUS();
+      warm.Solve(a_target, aircraft, config, INT_MAX);
+      warm_us += MonotonicClockUS() - start_time;
+
+      TerrainRoute cold;
+      Setup(cold, map, config);
+
+      start_time = MonotonicClockUS();
+      cold.Solve(a_target, aircraft, config, INT_MAX);
+      cold_us += MonotonicClockUS() - start_time;
+      cold_queries += cold.GetTerrainCache().GetMisses();
+
+      ++solves;
+      if (!IsSameRoute(warm.GetSolution(), cold.GetSolution()))
+        ++differences;
+    }
+  }
+
+  const TerrainClearanceCache &cache = warm.GetTerrainCache();
+  printf("solves=%u differences=%u\n", solves, differences);
+  printf("cold_us=%llu terrain_queries=%lu\n",
+         (unsigned long long)cold_us, cold_queries);
+  printf("warm_us=%llu terrain_queries=%lu cache_hits=%lu hit_rate=%.3f\n",
+         (unsigned long long)warm_us, cache.GetMisses(), cache.GetHits(),
+         cache.GetHitRate());
+
+  return differences == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,106 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/Task/Unordered/AbortTask.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+static const GeoPoint center(Angle::Degrees(7), Angle::Degrees(45));
+
+/**
+ * Fill the waypoint database with 200 landables near #center, all
+ * on a mountain which is out of reach, and one reachable landable
+ * far away, but still within the abort range.
+ */
+static void
+AddWaypoints(Waypoints &waypoints)
+{
+  for (unsigned i = 0; i < 200; ++i) {
+    Waypoint wp(GeoVector(1000 + 20 * i,
+                          Angle::Degrees(i * 37)).EndPoint(center));
+    wp.name = _T("Mountain");
+    wp.type = Waypoint::Type::AIRFIELD;
+    wp.elevation = 3000;
+    waypoints.Append(std::move(wp));
+  }
+
+  Waypoint wp(GeoVector(30000, Angle::Degrees(90)).EndPoint(center));
+  wp.name = _T("Valley");
+  wp.type = Waypoint::Type::OUTLANDING;
+  wp.elevation = 0;
+  waypoints.Append(std::move(wp));
+}
+
+/**
+ * All landables within the abort range are evaluated, even if there
+ * are more than 128 nearer ones.
+ */
+static void
+TestManyLandables(const Waypoints &waypoints)
+{
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  AbortTask task(task_behaviour, waypoints);
+  task.SetActive(false);
+
+  const GlidePolar glide_polar(0);
+
+  AircraftState state;
+  state.Reset();
+  state.location = center;
+  state.altitude = 1500;
+  state.flying = true;
+
+  task.Update(state, state, glide_polar);
+
+  ok1(task.HasReachableLandable());
+  ok1(task.TaskSize() > 0);
+  ok1(task.TaskSize() > 0 &&
+      task.GetAlternate(0).GetWaypoint().name == _T("Valley"));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(2 * 3);
+
+  Waypoints waypoints;
+  AddWaypoints(waypoints);
+
+  /* the packed index */
+  waypoints.Optimise();
+  TestManyLandables(waypoints);
+
+  /* a modification clears the packed index; until the next
+     Optimise() call, the QuadTree is used */
+  Waypoint wp(GeoVector(5000, Angle::Degrees(180)).EndPoint(center));
+  wp.name = _T("Turnpoint");
+  waypoints.Append(std::move(wp));
+  TestManyLandables(waypoints);
+
+  return exit_status();
+}
@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/AbstractAirspace.hpp"
 #include "Engine/Airspace/AirspaceCircle.hpp"
 #include "Engine/Airspace/AirspacePolygon.hpp"
@@ -31,10 +32,15 @@ Copyright_License {
 #include "Util/StringAPI.hxx"
 #include "Util/PrintException.hxx"
 #include "IO/FileLineReader.hpp"
+#include "OS/FileMapping.hpp"
+#include "Util/StringView.hxx"
 #include "Operation/Operation.hpp"
 #include "TestUtil.hpp"
 
+#include <vector>
+
 #include <tchar.h>
+#include <stdio.h>
 
 struct AirspaceClassTestCouple
 {
@@ -42,26 +48,96 @@ struct AirspaceClassTestCouple
   AirspaceClass type;
 };
 
+enum class ParseMode {
+  LINES,
+  MAPPED,
+
+  /**
+   * Parse the mapped file, and load the database from a binary
+   * cache written by SaveAirspaceCache().
+   */
+  CACHED,
+};
+
 static bool
-ParseFile(Path path, Airspaces &airspaces)
+ParseMapped(Path path, Airspaces &airspaces)
 {
-  FileLineReader reader(path, Charset::AUTO);
+  const FileMapping mapping(path);
+  if (mapping.error())
+    return false;
 
   AirspaceParser parser(airspaces);
   NullOperationEnvironment operation;
+  const StringView buffer((const char *)mapping.data(), mapping.size());
+  return parser.Parse(buffer, Charset::AUTO, operation);
+}
+
+static bool
+RoundTripCache(Path path, Airspaces &airspaces)
+{
+  Airspaces parsed;
+  if (!ParseMapped(path, parsed))
+    return false;
+
+  parsed.Optimise();
+
+  FILE *file = tmpfile();
+  if (file == nullptr)
+    return false;
 
-  if (!ok1(parser.Parse(reader, operation)))
+  if (!SaveAirspaceCache(parsed, file)) {
+    fclose(file);
     return false;
+  }
+
+  const long size = ftell(file);
+  rewind(file);
+
+  /* use a double array to get the alignment of a mapped file */
+  std::vector<double> buffer((size + sizeof(double) - 1) / sizeof(double));
+  const bool success = size > 0 &&
+    fread(buffer.data(), 1, size, file) == size_t(size);
+  fclose(file);
+
+  return success &&
+    LoadAirspaceCache(airspaces, ConstBuffer<void>(buffer.data(), size)) &&
+    airspaces.GetSize() == 0 /* not yet optimised */;
+}
+
+static bool
+ParseFile(Path path, Airspaces &airspaces, ParseMode mode)
+{
+  switch (mode) {
+  case ParseMode::LINES: {
+    AirspaceParser parser(airspaces);
+    NullOperationEnvironment operation;
+    FileLineReader reader(path, Charset::AUTO);
+    if (!ok1(parser.Parse(reader, operation)))
+      return false;
+    break;
+  }
+
+  case ParseMode::MAPPED:
+    if (!ok1(ParseMapped(path, airspaces)))
+      return false;
+    break;
+
+  case ParseMode::CACHED:
+    if (!ok1(RoundTripCache(path, airspaces)))
+      return false;
+    break;
+  }
 
   airspaces.Optimise();
   return true;
 }
 
 static void
-TestOpenAir()
+TestOpenAir(ParseMode mode)
 {
   Airspaces airspaces;
-  if (!ParseFile(Path(_T("test/data/airspace/openair.txt")), airspaces)) {
+  if (!ParseFile(Path(_T("test/data/airspace/openair.txt")), airspaces,
+                 mode)) {
     skip(3, 0, "Failed to parse input file");
     return;
   }
@@ -166,10 +242,11 @@ TestOpenAir()
 }
 
 static void
-TestTNP()
+TestTNP(ParseMode mode)
 {
   Airspaces airspaces;
-  if (!ParseFile(Path(_T("test/data/airspace/tnp.sua")), airspaces)) {
+  if (!ParseFile(Path(_T("test/data/airspace/tnp.sua")), airspaces,
+                 mode)) {
     skip(3, 0, "Failed to parse input file");
     return;
   }
@@ -275,10 +352,12 @@ TestTNP()
 
 int main(int argc, char **argv)
 try {
-  plan_tests(102);
+  plan_tests(306);
 
-  TestOpenAir();
-  TestTNP();
+  for (auto mode : {ParseMode::LINES, ParseMode::MAPPED, ParseMode::CACHED}) {
+    TestOpenAir(mode);
+    TestTNP(mode);
+  }
 
   return exit_status();
 } catch (const std::runtime_error &e) {
@@ -0,0 +1,198 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/Airspace/AirspacePolygonIndex.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/Flat/FlatRay.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+#include <math.h>
+
+static const GeoPoint center(Angle::Degrees(7.5), Angle::Degrees(51.5));
+
+/**
+ * Generate a closed, jagged, non-convex polygon around #center, the
+ * kind of border-following shape the index is meant for.
+ */
+static SearchPointVector
+MakePolygon(unsigned n)
+{
+  SearchPointVector v;
+  unsigned seed = 12345;
+
+  for (unsigned i = 0; i < n; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const double r = 0.2 + 0.3 * ((seed >> 16) & 0x7fff) / 32768.;
+    const double a = 2 * M_PI * i / n;
+    v.emplace_back(GeoPoint(center.longitude + Angle::Degrees(r * cos(a)),
+                            center.latitude + Angle::Degrees(r * sin(a))));
+  }
+
+  v.emplace_back(v.front().GetLocation());
+  return v;
+}
+
+static void
+TestSmall(const FlatProjection &projection)
+{
+  SearchPointVector v = MakePolygon(AirspacePolygonIndex::MIN_VERTICES - 2);
+  v.Project(projection);
+
+  AirspacePolygonIndex index;
+  index.Build(v, projection);
+  ok1(!index.IsDefined());
+}
+
+static void
+TestInside(const SearchPointVector &v, const AirspacePolygonIndex &index)
+{
+  unsigned n_inside = 0, n_mismatch = 0;
+
+  for (int x = -60; x <= 60; ++x) {
+    for (int y = -60; y <= 60; ++y) {
+      const GeoPoint p(center.longitude + Angle::Degrees(x / 100.),
+                       center.latitude + Angle::Degrees(y / 100.));
+      const bool expected = v.IsInside(p);
+      if (expected)
+        ++n_inside;
+      if (index.IsInside(p, v) != expected)
+        ++n_mismatch;
+    }
+  }
+
+  ok1(n_inside > 0);
+  ok1(n_mismatch == 0);
+
+  /* the vertices themselves are the trickiest cases */
+  n_mismatch = 0;
+  for (const auto &i : v)
+    if (index.IsInside(i.GetLocation(), v) != v.IsInside(i.GetLocation()))
+      ++n_mismatch;
+
+  ok1(n_mismatch == 0);
+}
+
+static bool
+CheckSegment(const SearchPointVector &v, const AirspacePolygonIndex &index,
+             FlatGeoPoint a, FlatGeoPoint b)
+{
+  const FlatRay ray(a, b);
+
+  std::vector<unsigned> expected;
+  for (unsigned i = 0; i + 1 < v.size(); ++i) {
+    const FlatRay edge(v[i].GetFlatLocation(), v[i + 1].GetFlatLocation());
+    if (ray.DistinctIntersection(edge) >= 0)
+      expected.push_back(i);
+  }
+
+  std::vector<unsigned> visited(v.size(), 0);
+  bool found_all = true;
+  index.VisitEdges(a, b, [&](unsigned i, FlatGeoPoint e0, FlatGeoPoint e1){
+      ++visited[i];
+      if (e0 != v[i].GetFlatLocation() || e1 != v[i + 1].GetFlatLocation())
+        found_all = false;
+    });
+
+  for (unsigned i : expected)
+    if (visited[i] == 0)
+      found_all = false;
+
+  for (unsigned n : visited)
+    if (n > 1)
+      /* duplicate visit */
+      return false;
+
+  return found_all;
+}
+
+static void
+TestIntersects(const SearchPointVector &v, const AirspacePolygonIndex &index,
+               const FlatProjection &projection)
+{
+  const FlatGeoPoint c = projection.ProjectInteger(center);
+  unsigned n_failed = 0;
+
+  /* rays from the center in all directions */
+  for (unsigned i = 0; i < 360; i += 3) {
+    const double a = i * M_PI / 180;
+    const GeoPoint end(center.longitude + Angle::Degrees(0.7 * cos(a)),
+                       center.latitude + Angle::Degrees(0.7 * sin(a)));
+    if (!CheckSegment(v, index, c, projection.ProjectInteger(end)))
+      ++n_failed;
+  }
+
+  ok1(n_failed == 0);
+
+  /* short horizontal and vertical segments, across slab borders */
+  n_failed = 0;
+  for (int j = -50; j <= 50; j += 5) {
+    const GeoPoint a(center.longitude + Angle::Degrees(j / 100.),
+                     center.latitude - Angle::Degrees(0.6));
+    const GeoPoint b(center.longitude + Angle::Degrees(j / 100.),
+                     center.latitude + Angle::Degrees(0.6));
+    if (!CheckSegment(v, index, projection.ProjectInteger(a),
+                      projection.ProjectInteger(b)))
+      ++n_failed;
+
+    const GeoPoint d(center.longitude - Angle::Degrees(0.6),
+                     center.latitude + Angle::Degrees(j / 100.));
+    const GeoPoint e(center.longitude + Angle::Degrees(0.6),
+                     center.latitude + Angle::Degrees(j / 100.));
+    if (!CheckSegment(v, index, projection.ProjectInteger(d),
+                      projection.ProjectInteger(e)))
+      ++n_failed;
+  }
+
+  ok1(n_failed == 0);
+
+  /* a segment far away */
+  const GeoPoint far(center.longitude, center.latitude + Angle::Degrees(2));
+  ok1(CheckSegment(v, index, projection.ProjectInteger(far),
+                   projection.ProjectInteger(far)));
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(1 + 2 * (1 + 3 + 3));
+
+  const FlatProjection projection(center);
+
+  TestSmall(projection);
+
+  for (unsigned n : {100u, 1000u}) {
+    SearchPointVector v = MakePolygon(n);
+    v.Project(projection);
+
+    AirspacePolygonIndex index;
+    index.Build(v, projection);
+    ok1(index.IsDefined());
+
+    TestInside(v, index);
+    TestIntersects(v, index, projection);
+  }
+
+  return exit_status();
+}
@@ -21,6 +21,8 @@
 */
 
 #include "IO/CSVLine.hpp"
+#include "NMEA/InputLine.hpp"
+#include "NMEA/Checksum.hpp"
 #include "TestUtil.hpp"
 
 #include <cstring>
@@ -97,13 +99,55 @@ Test2()
   ok1(!line.ReadChecked(temp_int) && temp_int == 42);
 }
 
+static void
+TestNMEAInputLine()
+{
+  static constexpr const char *lines[] = {
+    "$GPRMC,082310,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.1,E*7D",
+    "$GPRMC,082310,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.1,E*7B",
+    "$PFLAU,3,1,1,1,0*50",
+    "$PFLAU,3,1,1,1,0",
+    "$PFLAU,3,1,1,1,0*",
+    "$PFLAU,3,1,1,1,0*5G",
+    "$PFLAU,3*1,1,1,0*56",
+    "!w,1*6A",
+    "*",
+    "",
+  };
+
+  /* the one-pass checksum must agree with VerifyNMEAChecksum() */
+  for (const char *i : lines)
+    ok1(NMEAInputLine(i).HasValidChecksum() == VerifyNMEAChecksum(i));
+
+  NMEAInputLine line("$PFLAU,3,1,1,1,0*50");
+  ok1(NMEAInputLine("$PFLAU,3*1,1,1,0*56").HasValidChecksum());
+  ok1(line.HasValidChecksum());
+  ok1(line.ReadSentenceHash() == NMEASentenceHash("$PFLAU"));
+  ok1(line.Read(-1) == 3);
+
+  /* the data ends at the first asterisk */
+  const auto rest = line.Rest();
+  ok1(std::string(rest.begin(), rest.end()) == "1,1,1,0");
+
+  NMEAInputLine line2("$GPGGA,,*");
+  ok1(line2.ReadView().Equals("$GPGGA"));
+  ok1(line2.ReadView().IsEmpty());
+
+  NMEAInputLine line3("$PDGFTL1X,1*00");
+  ok1(line3.ReadSentenceHash() == 0);
+
+  static_assert(NMEASentenceHash("$PFLAA") != NMEASentenceHash("$PFLAU"), "");
+  static_assert(NMEASentenceHash("$C") != NMEASentenceHash("$c"), "");
+}
+
 int
 main(int argc, char **argv)
 {
-  plan_tests(19);
+  plan_tests(19 + 10 + 8);
 
   Test1();
   Test2();
+  TestNMEAInputLine();
 
   return exit_status();
 }
@@ -0,0 +1,218 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Cloud/Journal.hpp"
+#include "Cloud/ShardedData.hpp"
+#include "Cloud/Serialiser.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/FileReader.hxx"
+#include "OS/FileUtil.hpp"
+#include "Util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <unistd.h>
+
+static const GeoPoint center(Angle::Degrees(7), Angle::Degrees(51));
+
+static const Path db_path(_T("output/test/cloud.db"));
+
+static GeoPoint
+MakeLocation(unsigned i)
+{
+  return GeoPoint(center.longitude + Angle::Degrees(0.01 * i),
+                  center.latitude);
+}
+
+static CloudClient
+MakeClient(ShardedCloudData &data, uint64_t key, unsigned i)
+{
+  const boost::asio::ip::udp::endpoint endpoint;
+  const unsigned id = data.clients.Make(endpoint, key, MakeLocation(i), i);
+  return CloudClient(endpoint, key, id, MakeLocation(i), i);
+}
+
+static void
+AddClient(ShardedCloudData &data, CloudJournal &journal,
+          uint64_t key, unsigned i)
+{
+  journal.AppendClient(MakeClient(data, key, i));
+}
+
+static void
+AddThermal(ShardedCloudData &data, CloudJournal &journal,
+           uint64_t key, unsigned i)
+{
+  const AGeoPoint bottom(MakeLocation(i), 500);
+  const AGeoPoint top(MakeLocation(i), 1500);
+  journal.AppendThermal(*data.thermals.Make(key, bottom, top, 0.5 * i));
+}
+
+static void
+SaveSnapshot(const ShardedCloudData &data)
+{
+  FileOutputStream fos(db_path);
+
+  {
+    Serialiser s(fos);
+    data.Save(s);
+    s.Flush();
+  }
+
+  fos.Commit();
+}
+
+static void
+LoadSnapshot(ShardedCloudData &data)
+{
+  FileReader fr(db_path);
+  Deserialiser s(fr);
+  data.Load(s);
+}
+
+static unsigned
+CountThermals(const ShardedCloudData &data)
+{
+  unsigned n = 0;
+  data.thermals.VisitWithinRange(center, 100000,
+                                 [&n](const CloudThermal &){ ++n; });
+  return n;
+}
+
+gcc_pure
+static int
+GetAltitude(const ShardedCloudData &data, uint64_t key)
+{
+  int altitude = -1;
+  data.clients.VisitAll([key, &altitude](const CloudClient &client){
+      if (client.key == key)
+        altitude = client.altitude;
+    });
+  return altitude;
+}
+
+/**
+ * Simulate a crash during compaction: the snapshot has been written
+ * after Rotate(), but the old journal has not been deleted, and the
+ * last record of the current journal is incomplete.
+ */
+static void
+TestRecovery()
+{
+  {
+    ShardedCloudData data;
+    CloudJournal journal(db_path);
+    journal.Reset();
+
+    AddClient(data, journal, 1, 1);
+    AddClient(data, journal, 2, 2);
+    AddClient(data, journal, 3, 3);
+    AddThermal(data, journal, 1, 1);
+    AddThermal(data, journal, 2, 2);
+    journal.AppendExpireClients(std::chrono::steady_clock::time_point());
+
+    journal.Rotate();
+    ok1(File::Exists(journal.GetOldPath()));
+
+    /* these records are in the snapshot and in the old journal */
+    SaveSnapshot(data);
+
+    /* client 2 moves; client 4 is new */
+    AddClient(data, journal, 2, 5);
+    AddClient(data, journal, 4, 4);
+    AddThermal(data, journal, 4, 4);
+  }
+
+  /* cut the last record (a thermal) in half */
+  const Path path(_T("output/test/cloud.db.journal"));
+  const uint64_t size = File::GetSize(path);
+  ok1(truncate(path.c_str(), size - 10) == 0);
+
+  ShardedCloudData data;
+  LoadSnapshot(data);
+  ok1(data.clients.size() == 3);
+  ok1(CountThermals(data) == 2);
+
+  ok1(ReplayCloudJournal(Path(_T("output/test/cloud.db.journal.old")),
+                         data) == 6);
+  ok1(ReplayCloudJournal(path, data) == 2);
+
+  ok1(data.clients.size() == 4);
+  ok1(CountThermals(data) == 2);
+  ok1(GetAltitude(data, 2) == 5);
+  ok1(GetAltitude(data, 4) == 4);
+
+  /* replaying everything again changes nothing */
+  ReplayCloudJournal(Path(_T("output/test/cloud.db.journal.old")), data);
+  ReplayCloudJournal(path, data);
+  ok1(data.clients.size() == 4);
+  ok1(CountThermals(data) == 2);
+  ok1(GetAltitude(data, 2) == 5);
+}
+
+static void
+TestRotate()
+{
+  {
+    ShardedCloudData data;
+    CloudJournal journal(db_path);
+    journal.Reset();
+    ok1(!File::Exists(journal.GetOldPath()));
+
+    AddClient(data, journal, 1, 1);
+    journal.Rotate();
+    ok1(File::Exists(journal.GetOldPath()));
+
+    /* while the old file exists, Rotate() keeps appending to the
+       current one, so the next snapshot covers both */
+    AddClient(data, journal, 2, 2);
+    journal.Rotate();
+    AddClient(data, journal, 3, 3);
+
+    ShardedCloudData replayed;
+    ok1(ReplayCloudJournal(journal.GetOldPath(), replayed) == 1);
+
+    journal.DeleteOld();
+    ok1(!File::Exists(journal.GetOldPath()));
+  }
+
+  /* the destructor has written the rest */
+  ShardedCloudData replayed;
+  ok1(ReplayCloudJournal(Path(_T("output/test/cloud.db.journal")),
+                         replayed) == 2);
+  ok1(replayed.clients.size() == 2);
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(19);
+
+  Directory::Create(Path(_T("output/test")));
+
+  TestRecovery();
+  TestRotate();
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
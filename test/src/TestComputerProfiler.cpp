@@ -0,0 +1,107 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Computer/ComputerProfiler.hpp"
+#include "OS/Sleep.h"
+#include "TestUtil.hpp"
+
+typedef ComputerProfiler::Stage Stage;
+
+static void
+Measure(ComputerProfiler &profiler, Stage stage, unsigned ms)
+{
+  const ComputerProfiler::Scope scope(profiler, stage);
+  Sleep(ms);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(14);
+
+  ComputerProfiler profiler;
+
+  /* disabled: nothing is recorded */
+  {
+    const ComputerProfiler::Cycle cycle(profiler);
+    Measure(profiler, Stage::AIR_DATA, 1);
+  }
+
+  ok1(profiler.GetSummary(Stage::AIR_DATA).count == 0);
+
+  profiler.SetEnabled(true);
+
+  /* several scopes of one stage in a cycle make one sample */
+  {
+    const ComputerProfiler::Cycle cycle(profiler);
+    Measure(profiler, Stage::AIR_DATA, 10);
+    Measure(profiler, Stage::TASK, 1);
+    Measure(profiler, Stage::AIR_DATA, 10);
+    Measure(profiler, Stage::AIR_DATA, 10);
+  }
+
+  ComputerProfiler::Summary air_data =
+    profiler.GetSummary(Stage::AIR_DATA);
+  ok1(air_data.count == 1);
+  ok1(air_data.window == 1);
+  ok1(air_data.max >= 30000);
+  ok1(profiler.GetSummary(Stage::TASK).count == 1);
+  ok1(profiler.GetSummary(Stage::TRACE).count == 0);
+
+  /* a nested cycle belongs to the outer one */
+  {
+    const ComputerProfiler::Cycle cycle(profiler);
+    Measure(profiler, Stage::AIR_DATA, 1);
+
+    {
+      const ComputerProfiler::Cycle inner(profiler);
+      Measure(profiler, Stage::AIR_DATA, 1);
+    }
+
+    ok1(profiler.GetSummary(Stage::AIR_DATA).count == 1);
+  }
+
+  air_data = profiler.GetSummary(Stage::AIR_DATA);
+  ok1(air_data.count == 2);
+  ok1(air_data.min >= 2000);
+
+  /* the sums of the first cycle were not carried over */
+  ok1(air_data.min < 30000);
+
+  {
+    const ComputerProfiler::Cycle cycle(profiler);
+    Measure(profiler, Stage::TASK, 1);
+  }
+
+  ok1(profiler.GetSummary(Stage::AIR_DATA).count == 2);
+  ok1(profiler.GetSummary(Stage::TASK).count == 2);
+
+  /* without a cycle, each scope is a sample */
+  Measure(profiler, Stage::ROUTE, 0);
+  Measure(profiler, Stage::ROUTE, 0);
+  ok1(profiler.GetSummary(Stage::ROUTE).count == 2);
+
+  profiler.Reset();
+  ok1(profiler.GetSummary(Stage::TASK).count == 0);
+
+  return exit_status();
+}
@@ -0,0 +1,89 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/FlatHashMap.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * A hash function with many collisions, to exercise the linear
+ * probing.
+ */
+struct BadHash {
+  size_t operator()(unsigned x) const {
+    return x % 3;
+  }
+};
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(16);
+
+  FlatHashMap<unsigned, unsigned> map;
+  ok1(map.empty());
+  ok1(map.Find(42) == map.NOT_FOUND);
+
+  auto result = map.Insert(42, 1);
+  ok1(result.second);
+  ok1(result.first == 0);
+  ok1(map.size() == 1);
+  ok1(map.Find(42) == 0);
+
+  /* inserting an existing key does not modify it */
+  result = map.Insert(42, 2);
+  ok1(!result.second);
+  ok1(result.first == 0);
+  ok1(map[0].value == 1);
+
+  /* grow and rehash; the indices remain stable */
+  bool found = true;
+  for (unsigned i = 0; i < 10000; ++i)
+    map.Insert(1000 + i, i);
+  for (unsigned i = 0; i < 10000; ++i)
+    if (map.Find(1000 + i) != i + 1 || map[i + 1].value != i)
+      found = false;
+  ok1(found);
+  ok1(map.Find(42) == 0);
+
+  /* clear() keeps the memory */
+  const unsigned long allocations = map.GetAllocationCount();
+  map.clear();
+  ok1(map.empty());
+  ok1(map.Find(1000) == map.NOT_FOUND);
+  for (unsigned i = 0; i < 10000; ++i)
+    map.Insert(i, i);
+  ok1(map.GetAllocationCount() == allocations);
+
+  FlatHashMap<unsigned, unsigned, BadHash> bad;
+  for (unsigned i = 0; i < 100; ++i)
+    bad.Insert(i, i * 2);
+  found = true;
+  for (unsigned i = 0; i < 100; ++i) {
+    const unsigned j = bad.Find(i);
+    if (j == bad.NOT_FOUND || bad[j].value != i * 2)
+      found = false;
+  }
+  ok1(found);
+  ok1(bad.Find(100) == bad.NOT_FOUND);
+
+  return exit_status();
+}
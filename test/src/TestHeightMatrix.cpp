@@ -0,0 +1,220 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Verifies that scrolling a #HeightMatrix with Shift() and scanning
+ * only the exposed cells (as RasterRenderer::ScrollMap() does) yields
+ * the same matrix as a full Fill() at the new position.
+ */
+
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/HeightMatrix.hpp"
+#include "Terrain/Loader.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Screen/Layout.hpp"
+#include "Screen/Point.hpp"
+#include "IO/ZipArchive.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Path.hpp"
+#include "Util/Macros.hpp"
+#include "Util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+#include <stdlib.h>
+
+unsigned Layout::scale_1024 = 1024;
+
+#ifndef ENABLE_OPENGL
+
+static constexpr unsigned Q = 2;
+static constexpr int SCREEN_WIDTH = 240, SCREEN_HEIGHT = 160;
+
+/**
+ * The maximum tolerated difference [m] between a shifted and a
+ * freshly scanned cell.  RasterMap::ScanLine() steps through each row
+ * in fixed-point raster coordinates starting at the row's first
+ * sample, so after a horizontal shift, a preserved cell may have been
+ * sampled a fraction of a raster pixel away from where a full scan
+ * samples it.  A misplaced strip or an off-by-one shift would yield
+ * much larger differences.
+ */
+static constexpr int TOLERANCE = 2;
+
+/**
+ * The maximum number of cells which may differ at all, per 1000.
+ */
+static constexpr unsigned MAX_DIFFERENT_PERMILLE = 50;
+
+static WindowProjection
+MakeProjection(const GeoPoint &center)
+{
+  WindowProjection projection;
+  projection.SetScreenSize({SCREEN_WIDTH, SCREEN_HEIGHT});
+  projection.SetScaleFromRadius(20000);
+  projection.SetGeoLocation(center);
+  projection.SetScreenOrigin(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+  projection.UpdateScreenBounds();
+  return projection;
+}
+
+/**
+ * Scroll the matrix by the given number of cells, and scan the
+ * exposed strips.
+ */
+static void
+Scroll(HeightMatrix &matrix, const RasterMap &map,
+       const WindowProjection &shifted, int dx, int dy)
+{
+  const int width = matrix.GetWidth(), height = matrix.GetHeight();
+
+  if (abs(dx) >= width || abs(dy) >= height) {
+    /* nothing is preserved; scan everything */
+    matrix.Shift(dx, dy);
+    matrix.Fill(map, shifted, Q, PixelRect(0, 0, width, height), true);
+    return;
+  }
+
+  matrix.Shift(dx, dy);
+
+  int top = 0, bottom = height;
+  if (dy > 0) {
+    bottom -= dy;
+    matrix.Fill(map, shifted, Q, PixelRect(0, bottom, width, height), true);
+  } else if (dy < 0) {
+    top = -dy;
+    matrix.Fill(map, shifted, Q, PixelRect(0, 0, width, top), true);
+  }
+
+  if (dx > 0)
+    matrix.Fill(map, shifted, Q, PixelRect(width - dx, top, width, bottom),
+                true);
+  else if (dx < 0)
+    matrix.Fill(map, shifted, Q, PixelRect(0, top, -dx, bottom), true);
+}
+
+static bool
+Equals(const HeightMatrix &a, const HeightMatrix &b)
+{
+  if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight())
+    return false;
+
+  unsigned n_different = 0;
+
+  for (auto i = a.GetData(), j = b.GetData(), end = a.GetDataEnd();
+       i != end; ++i, ++j) {
+    if (i->IsInvalid() != j->IsInvalid())
+      return false;
+
+    if (i->IsInvalid() || i->GetValue() == j->GetValue())
+      continue;
+
+    if (abs(i->GetValue() - j->GetValue()) > TOLERANCE)
+      return false;
+
+    ++n_different;
+  }
+
+  return n_different * 1000 <=
+    a.GetWidth() * a.GetHeight() * MAX_DIFFERENT_PERMILLE;
+}
+
+static void
+TestShift(const RasterMap &map, int dx, int dy)
+{
+  const WindowProjection projection = MakeProjection(map.GetMapCenter());
+
+  HeightMatrix scrolled;
+  scrolled.Fill(map, projection, Q, true);
+
+  /* the new position, as calculated by ScrollMap() */
+  WindowProjection shifted = projection;
+  shifted.SetScreenOrigin(projection.GetScreenOrigin().x - dx * int(Q),
+                          projection.GetScreenOrigin().y - dy * int(Q));
+  shifted.UpdateScreenBounds();
+
+  Scroll(scrolled, map, shifted, dx, dy);
+
+  HeightMatrix expected;
+  expected.Fill(map, shifted, Q, true);
+
+  ok(Equals(scrolled, expected), "shift %d,%d", dx, dy);
+}
+
+static constexpr struct {
+  int dx, dy;
+} offsets[] = {
+  { 0, 0 },
+  { 1, 0 },
+  { -1, 0 },
+  { 0, 1 },
+  { 0, -1 },
+  { 7, 3 },
+  { -7, -3 },
+  { 5, -9 },
+  { -12, 4 },
+  { 59, 0 },
+  { 0, -39 },
+  /* larger than the matrix */
+  { SCREEN_WIDTH / Q + 3, 0 },
+  { 0, -int(SCREEN_HEIGHT / Q) - 1 },
+  { -500, 700 },
+};
+
+#endif
+
+int main(int argc, char **argv)
+try {
+#ifdef ENABLE_OPENGL
+  return plan_skip_all("HeightMatrix::Shift() is not used with OpenGL");
+#else
+  plan_tests(ARRAY_SIZE(offsets));
+
+  ZipArchive archive(Path(_T("test/data/benalla9.xcm")));
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation)) {
+    fprintf(stderr, "failed to load map\n");
+    return EXIT_FAILURE;
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(), map.GetMapCenter(), 50000);
+  } while (map.IsDirty());
+
+  for (const auto &i : offsets)
+    TestShift(map, i.dx, i.dy);
+
+  return exit_status();
+#endif
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -25,6 +25,8 @@
 #include "IGC/IGCFix.hpp"
 #include "IGC/IGCHeader.hpp"
 #include "IGC/IGCDeclaration.hpp"
+#include "IGC/IGCReader.hpp"
+#include "IGC/IGCFixBatch.hpp"
 #include "Time/BrokenDate.hpp"
 #include "Time/BrokenTime.hpp"
 #include "TestUtil.hpp"
@@ -250,9 +252,92 @@ TestDeclarationTurnpoint()
   ok1(tp.name.empty());
 }
 
+static bool
+operator==(const IGCFix &a, const IGCFix &b)
+{
+  return a.time == b.time && a.location == b.location &&
+    a.gps_valid == b.gps_valid &&
+    a.pressure_altitude == b.pressure_altitude &&
+    a.gps_altitude == b.gps_altitude &&
+    a.enl == b.enl && a.gsp == b.gsp;
+}
+
+static void
+TestReader()
+{
+  static constexpr char input[] =
+    "AXCSfoo\r\n"
+    "HFDTE040910\r\n"
+    "I023638ENL3941GSP\r\n"
+    "B1122385103117N00742367EA0049000487123045\r\n"
+    "B1122395103117N00742367EX0049000487\r\n"
+    "LXCSbar\n"
+    "\n"
+    "B1122435103117S00742367WV-001200000\n"
+    "B112244510311\n"
+    "B1122455103117N00742367EA0049000487999";
+
+  /* the expected results, obtained from the line-based parser */
+  IGCExtensions extensions;
+  IGCParseExtensions("I023638ENL3941GSP", extensions);
+  IGCFix expected[3];
+  IGCParseFix("B1122385103117N00742367EA0049000487123045",
+              extensions, expected[0]);
+  IGCParseFix("B1122435103117S00742367WV-001200000",
+              extensions, expected[1]);
+  IGCParseFix("B1122455103117N00742367EA0049000487999",
+              extensions, expected[2]);
+
+  ok1(expected[0].enl == 123);
+  ok1(expected[0].gsp == 45);
+  ok1(expected[1].pressure_altitude == -12);
+  ok1(expected[1].enl == -1);
+  ok1(expected[2].enl == 999);
+  ok1(expected[2].gsp == -1);
+
+  const StringView buffer(input, sizeof(input) - 1);
+
+  IGCReader reader(buffer);
+  ok1(reader.GetSize() == buffer.size);
+  ok1(reader.Tell() == 0);
+  ok1(!reader.GetDate().IsPlausible());
+
+  IGCFix fix;
+  ok1(reader.Next(fix));
+  ok1(fix == expected[0]);
+  ok1(reader.GetDate() == BrokenDate(2010, 9, 4));
+  ok1(reader.Next(fix));
+  ok1(fix == expected[1]);
+  ok1(reader.Next(fix));
+  ok1(fix == expected[2]);
+  ok1(!reader.Next(fix));
+  ok1(reader.Tell() == reader.GetSize());
+
+  unsigned n = 0;
+  for (const IGCFix &i : IGCReader(buffer))
+    ok1(i == expected[n++]);
+  ok1(n == 3);
+
+  IGCFixBatch batch;
+  IGCReader batch_reader(buffer);
+  ok1(batch_reader.Read(batch) == 3);
+  ok1(batch.time[0] == expected[0].time.GetSecondOfDay());
+  ok1(batch.time[2] == expected[2].time.GetSecondOfDay());
+  ok1(batch.GetLocation(0) == expected[0].location);
+  ok1(batch.GetLocation(1) == expected[1].location);
+  ok1(batch.latitude[1] == -(51 * 60000 + 3117));
+  ok1(batch.longitude[1] == -(7 * 60000 + 42367));
+  ok1(batch.gps_valid[0] && !batch.gps_valid[1]);
+  ok1(batch.pressure_altitude[1] == -12);
+  ok1(batch.gps_altitude[2] == 487);
+  ok1(batch_reader.GetDate() == BrokenDate(2010, 9, 4));
+  ok1(batch_reader.Read(batch) == 0);
+  ok1(batch.empty());
+}
+
 int main(int argc, char **argv)
 {
-  plan_tests(136);
+  plan_tests(136 + 35);
 
   TestHeader();
   TestDate();
@@ -262,6 +347,7 @@ int main(int argc, char **argv)
   TestFixTime();
   TestDeclarationHeader();
   TestDeclarationTurnpoint();
+  TestReader();
 
   return exit_status();
 }
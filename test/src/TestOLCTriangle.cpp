@@ -0,0 +1,171 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/Contest/Solvers/OLCFAI.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+#include <math.h>
+
+/**
+ * Generate a synthetic flight around a triangle with 100 km legs,
+ * with a wiggle perpendicular to the course so the turn points are
+ * not trivially the corners.
+ */
+static std::vector<TracePoint>
+GenerateFlight(unsigned n)
+{
+  std::vector<TracePoint> flight;
+
+  const GeoPoint corners[] = {
+    GeoPoint(Angle::Degrees(7.0), Angle::Degrees(51.0)),
+    GeoPoint(Angle::Degrees(8.4), Angle::Degrees(51.3)),
+    GeoPoint(Angle::Degrees(7.4), Angle::Degrees(51.8)),
+  };
+
+  for (unsigned i = 0; i < n; ++i) {
+    const double f = 3. * i / n;
+    const unsigned leg = std::min(unsigned(f), 2u);
+    const GeoPoint &a = corners[leg], &b = corners[(leg + 1) % 3];
+    GeoPoint location = a.Interpolate(b, f - leg);
+    location = GeoVector(2000 * sin(i * 0.7),
+                         a.Bearing(b) + Angle::QuarterCircle())
+      .EndPoint(location);
+
+    flight.emplace_back(location, 10000 + i * 20, 1000, 0, 0);
+  }
+
+  return flight;
+}
+
+static double
+SolveExhaustive(const Trace &trace)
+{
+  OLCFAI solver(trace, true);
+  solver.SetTickBudget(1000000000, std::chrono::steady_clock::duration::zero());
+  solver.SetMaxTreeSize(100000000);
+  solver.Reset();
+  solver.Solve(false);
+  return solver.GetBestResult().distance;
+}
+
+/**
+ * Feed the flight point by point to a solver with a small budget and
+ * check that it converges to the same distance as an unlimited
+ * search over the complete trace.  The solver works on flat
+ * distances, so triangles which differ by less than the flat
+ * projection's resolution are equivalent.
+ *
+ * @param thinned the trace will be thinned; the solver may then keep
+ * a better result found before points were dropped
+ */
+static void
+TestIncremental(unsigned n, unsigned max_points, unsigned budget,
+                std::chrono::steady_clock::duration duration,
+                bool thinned=false)
+{
+  const auto flight = GenerateFlight(n);
+
+  Trace trace(0, Trace::null_time, max_points);
+  OLCFAI solver(trace, true);
+  solver.SetIncremental(true);
+  solver.SetTickBudget(budget, duration);
+  solver.Reset();
+
+  for (const auto &point : flight) {
+    trace.push_back(point);
+    solver.Solve(false);
+  }
+
+  for (unsigned i = 0; i < 100000; ++i)
+    solver.Solve(false);
+
+  const double expected = SolveExhaustive(trace);
+  ok1(expected > 250000);
+  const double distance = solver.GetBestResult().distance;
+  if (thinned)
+    ok1(distance > expected * 0.999);
+  else
+    ok1(fabs(distance - expected) < expected * 0.001);
+}
+
+/**
+ * Append the flight in chunks to a non-predictive solver, which has
+ * to find the closing pairs incrementally, and compare the result
+ * with a solver which sees the complete trace at once.
+ */
+static void
+TestClosingPairs(unsigned n, unsigned chunk)
+{
+  auto flight = GenerateFlight(n);
+
+  /* return to the start point to close the loop */
+  flight.emplace_back(flight.front().GetLocation(), 10000 + n * 20,
+                      1000, 0, 0);
+  ++n;
+
+  Trace trace(0, Trace::null_time, 1024);
+  OLCFAI solver(trace, false);
+  solver.SetIncremental(true);
+  solver.Reset();
+
+  for (unsigned i = 0; i < n; ++i) {
+    trace.push_back(flight[i]);
+    if ((i + 1) % chunk == 0 || i + 1 == n)
+      solver.Solve(false);
+  }
+
+  OLCFAI reference(trace, false);
+  reference.Reset();
+  reference.Solve(true);
+
+  const double expected = reference.GetBestResult().distance;
+  ok1(expected > 250000);
+  ok1(fabs(solver.GetBestResult().distance - expected) < expected * 0.001);
+}
+
+int main(int argc, char **argv)
+{
+  using std::chrono::steady_clock;
+  using std::chrono::microseconds;
+
+  plan_tests(12);
+
+  TestIncremental(300, 512, 20, steady_clock::duration::zero());
+  TestIncremental(500, 1024, 200, steady_clock::duration::zero());
+
+  /* automatic iteration budget, limited by time */
+  TestIncremental(500, 1024, 0, microseconds(50));
+
+  /* the trace gets thinned, which restarts the search */
+  TestIncremental(600, 128, 50, steady_clock::duration::zero(), true);
+
+  /* closing pairs found in chunks of new points */
+  TestClosingPairs(300, 37);
+  TestClosingPairs(300, 1);
+
+  return exit_status();
+}
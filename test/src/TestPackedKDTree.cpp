@@ -0,0 +1,217 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/PackedKDTree.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include <stdlib.h>
+
+struct Item {
+  int x, y;
+  unsigned id;
+};
+
+struct ItemAccessor {
+  int GetX(const Item &item) const {
+    return item.x;
+  }
+
+  int GetY(const Item &item) const {
+    return item.y;
+  }
+};
+
+typedef PackedKDTree<Item, ItemAccessor> Tree;
+
+static bool
+IsEven(const Item &item)
+{
+  return item.id % 2 == 0;
+}
+
+static Tree::square_distance_type
+SquareDistance(const Item &item, const Tree::Point p)
+{
+  return Tree::Point(item.x, item.y).SquareDistanceTo(p);
+}
+
+/**
+ * Brute force reference implementation: the ids of the
+ * #max_results items nearest to #p, nearest first.
+ */
+template<typename P>
+static std::vector<unsigned>
+BruteNearest(const std::vector<Item> &items, const Tree::Point p,
+             unsigned range, unsigned max_results, const P &predicate)
+{
+  std::vector<std::pair<Tree::square_distance_type, unsigned>> v;
+  for (const auto &i : items)
+    if (SquareDistance(i, p) <= Tree::Square(range) && predicate(i))
+      v.emplace_back(SquareDistance(i, p), i.id);
+
+  std::sort(v.begin(), v.end());
+  if (v.size() > max_results)
+    v.resize(max_results);
+
+  std::vector<unsigned> result;
+  for (const auto &i : v)
+    result.push_back(i.second);
+  return result;
+}
+
+/**
+ * Compare only the distances, because items with equal distances
+ * may be reported in a different order.
+ */
+static bool
+SameDistances(const std::vector<Item> &items, const Tree::Point p,
+              const std::vector<unsigned> &a, const std::vector<unsigned> &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i)
+    if (SquareDistance(items[a[i]], p) != SquareDistance(items[b[i]], p))
+      return false;
+
+  return true;
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(16);
+
+  Tree tree;
+  ok1(tree.empty());
+  ok1(tree.FindNearest(Tree::Point(0, 0), 1000) == nullptr);
+
+  /* clustered random points, with duplicates */
+  srand(42);
+  std::vector<Item> items;
+  for (unsigned i = 0; i < 5000; ++i) {
+    const int cx = (rand() % 8) * 2000, cy = (rand() % 8) * 2000;
+    items.push_back({cx + rand() % 500, cy + rand() % 500, i});
+  }
+  items.push_back({items[17].x, items[17].y, unsigned(items.size())});
+
+  tree.Build(items.begin(), items.end());
+  ok1(tree.size() == items.size());
+
+  /* exact match */
+  const Item *found = tree.FindNearest(Tree::Point(items[99].x,
+                                                   items[99].y), 0);
+  ok1(found != nullptr && found->x == items[99].x && found->y == items[99].y);
+
+  /* nothing in range */
+  ok1(tree.FindNearest(Tree::Point(-100000, -100000), 1000) == nullptr);
+
+  bool nearest_ok = true, nearest_if_ok = true, knn_ok = true;
+  bool knn_if_ok = true, range_ok = true;
+  for (unsigned n = 0; n < 500; ++n) {
+    const Tree::Point p(rand() % 17000 - 500, rand() % 17000 - 500);
+    const unsigned range = rand() % 3000;
+
+    auto expected = BruteNearest(items, p, range, 1,
+                                 [](const Item &){ return true; });
+    found = tree.FindNearest(p, range);
+    if (expected.empty()
+        ? found != nullptr
+        : (found == nullptr ||
+           SquareDistance(*found, p) != SquareDistance(items[expected.front()], p)))
+      nearest_ok = false;
+
+    expected = BruteNearest(items, p, range, 1, IsEven);
+    found = tree.FindNearestIf(p, range, IsEven);
+    if (expected.empty()
+        ? found != nullptr
+        : (found == nullptr || !IsEven(*found) ||
+           SquareDistance(*found, p) != SquareDistance(items[expected.front()], p)))
+      nearest_if_ok = false;
+
+    const unsigned k = 1 + rand() % 40;
+    std::vector<unsigned> result;
+    auto collect = [&result](const Item &item){
+      result.push_back(item.id);
+    };
+
+    tree.VisitNearest(p, range, k, collect);
+    if (!SameDistances(items, p, result,
+                       BruteNearest(items, p, range, k,
+                                    [](const Item &){ return true; })))
+      knn_ok = false;
+
+    result.clear();
+    tree.VisitNearestIf(p, range, k, IsEven, collect);
+    if (!SameDistances(items, p, result,
+                       BruteNearest(items, p, range, k, IsEven)))
+      knn_if_ok = false;
+
+    result.clear();
+    tree.VisitWithinRange(p, range, collect);
+    std::sort(result.begin(), result.end());
+    expected = BruteNearest(items, p, range, items.size(),
+                            [](const Item &){ return true; });
+    std::sort(expected.begin(), expected.end());
+    if (result != expected)
+      range_ok = false;
+  }
+
+  ok1(nearest_ok);
+  ok1(nearest_if_ok);
+  ok1(knn_ok);
+  ok1(knn_if_ok);
+  ok1(range_ok);
+
+  /* k larger than the tree */
+  std::vector<unsigned> all;
+  auto collect_all = [&all](const Item &item){
+    all.push_back(item.id);
+  };
+  tree.VisitNearest(Tree::Point(0, 0), 100000, 100000, collect_all);
+  ok1(all.size() == items.size());
+  ok1(std::is_sorted(all.begin(), all.end(),
+                     [&items](unsigned a, unsigned b){
+                       return SquareDistance(items[a], Tree::Point(0, 0)) <
+                         SquareDistance(items[b], Tree::Point(0, 0));
+                     }));
+
+  /* k=0 visits nothing */
+  all.clear();
+  tree.VisitNearest(Tree::Point(0, 0), 100000, 0, collect_all);
+  ok1(all.empty());
+
+  /* far apart points don't overflow the square distance */
+  std::vector<Item> far{{-2000000000, 0, 0}, {2000000000, 0, 1}};
+  tree.Build(far.begin(), far.end());
+  found = tree.FindNearest(Tree::Point(1999999999, 0), 10);
+  ok1(found != nullptr && found->id == 1);
+
+  tree.clear();
+  ok1(tree.empty());
+  ok1(tree.FindNearest(Tree::Point(0, 0), 1000) == nullptr);
+
+  return exit_status();
+}
@@ -0,0 +1,192 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/RasterTileStore.hpp"
+#include "OS/FileMapping.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "TestUtil.hpp"
+
+extern "C" {
+#include "jasper/jas_seq.h"
+}
+
+#include <string>
+
+#include <stdio.h>
+#include <string.h>
+
+static constexpr char store_path[] = "output/test/terrain.store";
+
+/**
+ * Some bytes in front of the store, like the #FileCache header.
+ */
+static constexpr size_t PREFIX = 8;
+
+static constexpr unsigned COLUMNS = 2, ROWS = 2;
+static constexpr unsigned TILE_WIDTH = 5, TILE_HEIGHT = 3;
+
+static int
+MakeHeight(unsigned tile, unsigned x, unsigned y)
+{
+  return int(tile * 1000 + y * 10 + x) - 1500;
+}
+
+/**
+ * Write a store with all tiles except the last one, and return its
+ * contents.
+ */
+static std::string
+WriteStore()
+{
+  FILE *file = fopen(store_path, "w+b");
+  if (file == nullptr)
+    return std::string();
+
+  fwrite("PREFIX..", 1, PREFIX, file);
+
+  RasterTileStoreWriter writer(file);
+  writer.Begin(COLUMNS, ROWS);
+
+  jas_matrix_t *m = jas_matrix_create(TILE_HEIGHT, TILE_WIDTH);
+  for (unsigned tile = 0; tile < COLUMNS * ROWS - 1; ++tile) {
+    for (unsigned y = 0; y < TILE_HEIGHT; ++y)
+      for (unsigned x = 0; x < TILE_WIDTH; ++x)
+        jas_matrix_set(m, y, x, MakeHeight(tile, x, y));
+
+    writer.PutTile(tile, *m);
+  }
+
+  jas_matrix_destroy(m);
+
+  ok1(writer.Finish());
+
+  std::string contents;
+  rewind(file);
+  char buffer[4096];
+  size_t nbytes;
+  while ((nbytes = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, nbytes);
+
+  fclose(file);
+  return contents;
+}
+
+static void
+Save(const std::string &contents)
+{
+  FILE *file = fopen(store_path, "wb");
+  fwrite(contents.data(), 1, contents.size(), file);
+  fclose(file);
+}
+
+static bool
+CheckTile(const RasterTileStore &store, unsigned tile)
+{
+  const TerrainHeight *p = store.GetTile(tile, TILE_WIDTH, TILE_HEIGHT);
+  if (p == nullptr)
+    return false;
+
+  for (unsigned y = 0; y < TILE_HEIGHT; ++y)
+    for (unsigned x = 0; x < TILE_WIDTH; ++x)
+      if (p[y * TILE_WIDTH + x].GetValue() != MakeHeight(tile, x, y))
+        return false;
+
+  return true;
+}
+
+static void
+TestRoundTrip(const std::string &contents)
+{
+  Save(contents);
+
+  const RasterTileStore store(new FileMapping(Path(_T(store_path))), PREFIX);
+  ok1(store.IsValid(COLUMNS, ROWS));
+  ok1(!store.IsValid(COLUMNS + 1, ROWS));
+
+  ok1(CheckTile(store, 0));
+  ok1(CheckTile(store, 1));
+  ok1(CheckTile(store, 2));
+
+  /* not written */
+  ok1(store.GetTile(3, TILE_WIDTH, TILE_HEIGHT) == nullptr);
+
+  /* dimension mismatch and out of range */
+  ok1(store.GetTile(0, TILE_WIDTH - 1, TILE_HEIGHT) == nullptr);
+  ok1(store.GetTile(COLUMNS * ROWS, TILE_WIDTH, TILE_HEIGHT) == nullptr);
+}
+
+static void
+TestCorrupt(const std::string &contents)
+{
+  /* wrong magic */
+  std::string corrupt = contents;
+  corrupt[PREFIX] ^= 0xff;
+  Save(corrupt);
+
+  {
+    const RasterTileStore store(new FileMapping(Path(_T(store_path))),
+                                PREFIX);
+    ok1(!store.IsValid(COLUMNS, ROWS));
+    ok1(store.GetTile(0, TILE_WIDTH, TILE_HEIGHT) == nullptr);
+  }
+
+  /* truncated inside the tile table */
+  Save(contents.substr(0, PREFIX + sizeof(RasterTileStoreFormat::Header) +
+                       sizeof(RasterTileStoreFormat::Entry)));
+
+  {
+    const RasterTileStore store(new FileMapping(Path(_T(store_path))),
+                                PREFIX);
+    ok1(!store.IsValid(COLUMNS, ROWS));
+    ok1(store.GetTile(0, TILE_WIDTH, TILE_HEIGHT) == nullptr);
+  }
+
+  /* truncated inside the last tile: only that one is rejected */
+  Save(contents.substr(0, contents.size() - 2));
+
+  {
+    const RasterTileStore store(new FileMapping(Path(_T(store_path))),
+                                PREFIX);
+    ok1(store.IsValid(COLUMNS, ROWS));
+    ok1(CheckTile(store, 0));
+    ok1(CheckTile(store, 1));
+    ok1(store.GetTile(2, TILE_WIDTH, TILE_HEIGHT) == nullptr);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(1 + 8 + 8);
+
+  Directory::Create(Path(_T("output/test")));
+
+  const std::string contents = WriteStore();
+
+  TestRoundTrip(contents);
+  TestCorrupt(contents);
+
+  File::Delete(Path(_T(store_path)));
+
+  return exit_status();
+}
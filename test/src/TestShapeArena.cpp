@@ -0,0 +1,171 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Topography/ShapeArena.hpp"
+#include "TestUtil.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+
+static void
+TestPages()
+{
+  ShapeArena arena;
+  ok1(arena.GetPageCount() == 0);
+  ok1(arena.GetAllocatedSize() == 0);
+
+  /* many small allocations share few pages */
+  std::vector<char *> v;
+  for (unsigned i = 0; i < 1000; ++i) {
+    char *p = arena.NewArray<char>(1 + i % 100);
+    memset(p, i, 1 + i % 100);
+    v.push_back(p);
+  }
+
+  ok1(arena.GetPageCount() > 1);
+  ok1(arena.GetPageCount() < 10);
+  ok1(arena.GetUsedSize() > 0);
+  ok1(arena.GetUsedSize() <= arena.GetAllocatedSize());
+
+  bool aligned = true, intact = true;
+  for (unsigned i = 0; i < v.size(); ++i) {
+    aligned &= uintptr_t(v[i]) % alignof(max_align_t) == 0;
+    intact &= v[i][i % 100] == char(i);
+  }
+  ok1(aligned);
+  ok1(intact);
+
+  /* freeing the first half releases the pages which contain only
+     those */
+  const unsigned n_pages = arena.GetPageCount();
+  for (unsigned i = 0; i < v.size() / 2; ++i)
+    arena.Free(v[i]);
+  ok1(arena.GetPageCount() < n_pages);
+
+  /* a large allocation gets its own page, which is released
+     immediately */
+  const size_t allocated = arena.GetAllocatedSize();
+  void *large = arena.Allocate(100000);
+  ok1(arena.GetAllocatedSize() >= allocated + 100000);
+  arena.Free(large);
+  ok1(arena.GetAllocatedSize() == allocated);
+
+  for (unsigned i = v.size() / 2; i < v.size(); ++i)
+    arena.Free(v[i]);
+
+  /* only the current page remains */
+  ok1(arena.GetUsedSize() == 0);
+  ok1(arena.GetPageCount() == 1);
+}
+
+struct Object {
+  static unsigned n_live;
+
+  int value;
+
+  explicit Object(int _value):value(_value) {
+    ++n_live;
+  }
+
+  ~Object() {
+    --n_live;
+  }
+};
+
+unsigned Object::n_live;
+
+static void
+TestObjects()
+{
+  ShapeArena arena;
+
+  Object *a = arena.New<Object>(42);
+  const Object *b = arena.New<Object>(43);
+  ok1(Object::n_live == 2);
+  ok1(a->value == 42 && b->value == 43);
+
+  arena.Delete(a);
+  arena.Delete(b);
+  ok1(Object::n_live == 0);
+  ok1(arena.GetUsedSize() == 0);
+}
+
+struct Throwing {
+  Throwing() {
+    throw std::runtime_error("Throwing");
+  }
+};
+
+struct Initialized {
+  int value = 7;
+};
+
+static void
+TestEdgeCases()
+{
+  ShapeArena arena;
+
+  /* deleting nullptr is a no-op, like the "delete" operator */
+  arena.Delete((const Object *)nullptr);
+  ok1(Object::n_live == 0);
+
+  /* a throwing constructor does not leak its allocation */
+  bool thrown = false;
+  try {
+    arena.New<Throwing>();
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  ok1(thrown);
+  ok1(arena.GetUsedSize() == 0);
+
+  /* each array element is constructed, and the array occupies
+     exactly as much as a raw allocation of the same size */
+  Initialized *array = arena.NewArray<Initialized>(100);
+  bool initialized = true;
+  for (unsigned i = 0; i < 100; ++i)
+    initialized &= array[i].value == 7;
+  ok1(initialized);
+
+  const size_t array_size = arena.GetUsedSize();
+  arena.Free(array);
+
+  void *raw = arena.Allocate(100 * sizeof(Initialized));
+  ok1(arena.GetUsedSize() == array_size);
+  arena.Free(raw);
+  ok1(arena.GetUsedSize() == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(23);
+
+  TestPages();
+  TestObjects();
+  TestEdgeCases();
+
+  return exit_status();
+}
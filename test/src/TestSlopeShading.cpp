@@ -0,0 +1,162 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/SlopeShading.hpp"
+#include "Math/Angle.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <stdlib.h>
+
+static constexpr unsigned WIDTH = 203;
+
+/**
+ * A tiny deterministic pseudo random number generator, to make the
+ * test reproducible on all platforms.
+ */
+static unsigned
+NextRandom(unsigned &state)
+{
+  state = state * 1103515245u + 12345u;
+  return state >> 8;
+}
+
+static void
+FillRandom(TerrainHeight *p, unsigned n, unsigned &state, int range)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned r = NextRandom(state);
+    if (r % 97 == 0)
+      p[i] = TerrainHeight::Invalid();
+    else if (r % 89 == 0)
+      /* water */
+      p[i] = TerrainHeight(-31000);
+    else
+      p[i] = TerrainHeight(int(r % (2 * range + 1)) - range / 4);
+  }
+}
+
+static SlopeShadingParameters
+MakeShading(Angle azimuth, int brightness, int contrast,
+            unsigned height_slope_factor)
+{
+  const Angle elevation = Angle::Degrees(10) +
+    Angle::Degrees(80.0 / 255.0) * brightness;
+
+  return SlopeShadingParameters{
+    (int)(255 * elevation.fastcosine() * -azimuth.fastsine()),
+    (int)(255 * elevation.fastcosine() * -azimuth.fastcosine()),
+    (int)(255 * elevation.fastsine()),
+    contrast,
+    height_slope_factor,
+  };
+}
+
+/**
+ * Compare CalculateSlopeShadeRow() with the per-pixel reference.
+ */
+static bool
+TestRow(const SlopeShadingParameters &s, unsigned dx, unsigned dy,
+        unsigned &state, int range)
+{
+  TerrainHeight above[WIDTH], below[WIDTH], left[WIDTH], right[WIDTH];
+  FillRandom(above, WIDTH, state, range);
+  FillRandom(below, WIDTH, state, range);
+  FillRandom(left, WIDTH, state, range);
+  FillRandom(right, WIDTH, state, range);
+
+  int8_t result[WIDTH];
+  CalculateSlopeShadeRow(s, dx, dy, above, below, left, right,
+                         result, WIDTH);
+
+  for (unsigned i = 0; i < WIDTH; ++i)
+    if (result[i] != CalculateSlopeShade(s, dx, dy, above[i], below[i],
+                                         left[i], right[i]))
+      return false;
+
+  return true;
+}
+
+static void
+TestShading(const SlopeShadingParameters &s, unsigned quantisation,
+            unsigned &state)
+{
+  const unsigned height_slope_factor = s.height_slope_factor;
+  const unsigned dx = 2 * quantisation;
+
+  /* small slopes (realistic terrain), large slopes (the clipped
+     range) and broken values (integer overflows) */
+  ok(TestRow(s, dx, dx, state, 100), "q=%u hsf=%u small slope",
+     quantisation, height_slope_factor);
+  ok(TestRow(s, dx, quantisation, state, 1000), "q=%u hsf=%u large slope",
+     quantisation, height_slope_factor);
+  ok(TestRow(s, dx, 1, state, 32000), "q=%u hsf=%u extreme",
+     quantisation, height_slope_factor);
+}
+
+int main(int argc, char **argv)
+{
+  static constexpr unsigned quantisations[] = { 1, 2, 3, 7, 25 };
+  static constexpr int contrasts[] = { 0, 64, 255 };
+  static constexpr unsigned n_azimuths = 4;
+
+  plan_tests(ARRAY_SIZE(quantisations) * ARRAY_SIZE(contrasts) *
+             n_azimuths * 2 * 3 + 1);
+
+  unsigned state = 42;
+
+  for (unsigned q : quantisations) {
+    /* see RasterRenderer::GenerateSlopeImage() */
+    const unsigned max_hsf = 8192u / (q * q);
+
+    for (int contrast : contrasts) {
+      for (unsigned i = 0; i < n_azimuths; ++i) {
+        const Angle azimuth = Angle::Degrees(45 + 100 * i);
+
+        TestShading(MakeShading(azimuth, 128, contrast, 1), q, state);
+        TestShading(MakeShading(azimuth, 255, contrast, max_hsf), q, state);
+      }
+    }
+  }
+
+  /* flat terrain, lit from above: no shading */
+  {
+    /* odd magnitude, to avoid the "mag|1" rounding */
+    const SlopeShadingParameters s{0, 0, 255, 255, 11};
+    TerrainHeight h[WIDTH];
+    for (auto &i : h)
+      i = TerrainHeight(500);
+
+    int8_t result[WIDTH];
+    CalculateSlopeShadeRow(s, 1, 1, h, h, h, h, result, WIDTH);
+
+    bool all_zero = true;
+    for (auto i : result)
+      if (i != 0)
+        all_zero = false;
+
+    ok(all_zero, "flat");
+  }
+
+  return exit_status();
+}
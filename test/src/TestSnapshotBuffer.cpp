@@ -0,0 +1,167 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Blackboard/SnapshotBuffer.hpp"
+#include "Thread/Thread.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * A value which is large enough that copying it is not atomic.  Each
+ * published value has all elements set to the same number, so a torn
+ * copy is easy to detect.
+ */
+struct StressValue {
+  unsigned values[256];
+
+  void Set(unsigned v) {
+    for (auto &i : values)
+      i = v;
+  }
+
+  bool IsConsistent() const {
+    for (auto i : values)
+      if (i != values[0])
+        return false;
+    return true;
+  }
+};
+
+typedef SnapshotBuffer<StressValue, 4> StressBuffer;
+
+static constexpr unsigned STRESS_COUNT = 200000;
+
+class StressReader : public Thread {
+  const StressBuffer &buffer;
+
+public:
+  unsigned reads = 0, torn = 0, backwards = 0;
+
+  explicit StressReader(const StressBuffer &_buffer):buffer(_buffer) {}
+
+protected:
+  void Run() override {
+    unsigned last = 0;
+
+    while (true) {
+      const StressBuffer::Reader reader(buffer);
+      ++reads;
+
+      if (!reader->IsConsistent())
+        ++torn;
+
+      const unsigned v = reader->values[0];
+      if (v < last)
+        ++backwards;
+      last = v;
+
+      if (v == STRESS_COUNT)
+        break;
+    }
+  }
+};
+
+/**
+ * One writer and more readers than the buffer can serve without
+ * making the writer wait: no reader may see a torn value, and the
+ * values seen by one reader must never go back in time.
+ */
+static void
+TestStress()
+{
+  StressBuffer buffer;
+
+  StressValue value;
+  value.Set(0);
+  buffer.Publish(value);
+
+  StressReader a(buffer), b(buffer), c(buffer);
+  StressReader *const readers[] = { &a, &b, &c };
+
+  for (auto *reader : readers)
+    reader->Start();
+
+  for (unsigned i = 1; i <= STRESS_COUNT; ++i) {
+    value.Set(i);
+    buffer.Publish(value);
+  }
+
+  for (auto *reader : readers) {
+    reader->Join();
+    ok1(reader->reads > 0);
+    ok1(reader->torn == 0);
+    ok1(reader->backwards == 0);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(19);
+
+  typedef SnapshotBuffer<unsigned, 4> Buffer;
+  Buffer buffer;
+
+  buffer.Publish(1);
+  ok1(*Buffer::Reader(buffer) == 1);
+
+  buffer.Publish(2);
+
+  unsigned value;
+  buffer.Read(value);
+  ok1(value == 2);
+
+  {
+    /* a pinned snapshot is not modified by new values */
+    const Buffer::Reader a(buffer);
+    buffer.Publish(3);
+    const Buffer::Reader b(buffer);
+    buffer.Publish(4);
+    buffer.Publish(5);
+    buffer.Publish(6);
+
+    ok1(*a == 2);
+    ok1(*b == 3);
+
+    /* with two slots pinned, the remaining two are used
+       alternately */
+    buffer.Read(value);
+    ok1(value == 6);
+
+    buffer.Publish(7);
+    ok1(*a == 2);
+    ok1(*b == 3);
+  }
+
+  buffer.Read(value);
+  ok1(value == 7);
+
+  for (unsigned i = 8; i < 100; ++i)
+    buffer.Publish(i);
+
+  buffer.Read(value);
+  ok1(value == 99);
+  ok1(*Buffer::Reader(buffer) == 99);
+
+  TestStress();
+
+  return exit_status();
+}
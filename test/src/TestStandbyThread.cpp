@@ -0,0 +1,106 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Thread/StandbyThread.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * A thread whose Tick() blocks until the test releases it, and
+ * records IsPending() before and after.
+ */
+class BlockingThread final : private StandbyThread {
+  Cond test_cond;
+
+  bool started = false, released = false;
+
+public:
+  unsigned n_ticks = 0;
+  bool pending_before[2], pending_after[2];
+
+  BlockingThread():StandbyThread("Test") {}
+
+  using StandbyThread::LockWaitDone;
+  using StandbyThread::LockStop;
+
+  void TriggerTwice() {
+    const ScopeLock protect(mutex);
+
+    Trigger();
+
+    /* wait for the first Tick() */
+    while (!started)
+      test_cond.wait(mutex);
+
+    /* trigger again while it is busy */
+    Trigger();
+
+    released = true;
+    test_cond.broadcast();
+  }
+
+  bool IsPendingNow() {
+    const ScopeLock protect(mutex);
+    return IsPending();
+  }
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() override {
+    const bool before = IsPending();
+
+    started = true;
+    test_cond.broadcast();
+
+    while (!released)
+      test_cond.wait(mutex);
+
+    if (n_ticks < 2) {
+      pending_before[n_ticks] = before;
+      pending_after[n_ticks] = IsPending();
+    }
+
+    ++n_ticks;
+  }
+};
+
+int main(int argc, char **argv)
+{
+  plan_tests(6);
+
+  BlockingThread thread;
+  thread.TriggerTwice();
+  thread.LockWaitDone();
+
+  /* the first Tick() sees the second Trigger() call, the second
+     Tick() sees nothing */
+  ok1(thread.n_ticks == 2);
+  ok1(!thread.pending_before[0]);
+  ok1(thread.pending_after[0]);
+  ok1(!thread.pending_before[1]);
+  ok1(!thread.pending_after[1]);
+  ok1(!thread.IsPendingNow());
+
+  thread.LockStop();
+
+  return exit_status();
+}
@@ -0,0 +1,95 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/StringViewParser.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * ReadDouble() must return exactly what strtod() returns for the
+ * same characters, and consume exactly as many of them.
+ */
+static bool
+CheckDouble(const char *s)
+{
+  char *endptr;
+  const double expected = strtod(s, &endptr);
+
+  StringViewParser input{StringView(s)};
+  double value;
+  if (!input.ReadDouble(value))
+    return endptr == s;
+
+  return memcmp(&value, &expected, sizeof(value)) == 0 &&
+    input.GetRest().data == endptr;
+}
+
+int
+main(int argc, char **argv)
+{
+  static const char *const doubles[] = {
+    "0", "1", "-1", "+2.5", "0.1", "53.345", "  7.25", "5.", ".5",
+    "010:24:41", "1000nm", "2e3", "1e", "1e+", "0.30000000000000004",
+    "123456789012345678901234567890", "0.0000000000000000000000001",
+    "-0", "x", "-", ".",
+  };
+
+  plan_tests(ARRAY_SIZE(doubles) + 14);
+
+  for (auto s : doubles)
+    ok1(CheckDouble(s));
+
+  /* the parser must not look beyond the end of the view */
+  const char *buffer = "12345";
+  {
+    StringViewParser input(StringView(buffer, 2));
+    double value;
+    ok1(input.ReadDouble(value));
+    ok1(value == 12);
+    ok1(input.IsEmpty());
+    ok1(input.front() == '\0');
+    ok1(input.pop_front() == '\0');
+  }
+
+  {
+    StringViewParser input(StringView(buffer, 3));
+    unsigned value;
+    ok1(input.ReadUnsigned(value));
+    ok1(value == 123);
+    ok1(!input.ReadUnsigned(value));
+  }
+
+  {
+    StringViewParser input(StringView("AC CTR", 4));
+    ok1(!input.MatchIgnoreCase("ac ctr", 6));
+    ok1(input.SkipMatchIgnoreCase("ac", 2));
+    ok1(input.SkipWhitespace());
+    ok1(input.MatchAll("C"));
+    ok1(!input.SkipWord());
+    ok1(input.IsEmpty());
+  }
+
+  return exit_status();
+}
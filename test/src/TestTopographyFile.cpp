@@ -0,0 +1,142 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Topography/TopographyFile.hpp"
+#include "IO/ZipArchive.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+static unsigned
+CountShapes(const TopographyFile &file)
+{
+  const ScopeLock protect(file.mutex);
+
+  unsigned n = 0;
+  for (auto i = file.begin(), end = file.end(); i != end; ++i)
+    ++n;
+  return n;
+}
+
+static GeoBounds
+GetTestBounds(const TopographyFile &file)
+{
+  const GeoPoint center = file.GetCenter();
+  const Angle delta = Angle::Degrees(1);
+  return GeoBounds(GeoPoint(center.longitude - delta,
+                            center.latitude + delta),
+                   GeoPoint(center.longitude + delta,
+                            center.latitude - delta));
+}
+
+/**
+ * Verify that TopographyFile::Update() loads no more than the given
+ * number of shapes per call, and that subsequent calls continue
+ * where the previous one stopped.
+ */
+static void
+TestUpdateLimit(zzip_dir *dir, FileCache *cache)
+{
+  TopographyFile reference(dir, "roadltrans_line.shp", 1e6, 0, 0,
+                           Color(), -1, ResourceId::Null(),
+                           ResourceId::Null(), 1, cache,
+                           Path(_T("test/data/benalla9.xcm")));
+  ok1(reference.HasStore() == (cache != nullptr));
+
+  const GeoBounds bounds = GetTestBounds(reference);
+  ok1(reference.Update(bounds, 1));
+  const unsigned n_total = CountShapes(reference);
+  ok1(n_total > 10);
+
+  /* the cache is complete, nothing to do */
+  ok1(!reference.Update(bounds, 1));
+
+  TopographyFile file(dir, "roadltrans_line.shp", 1e6, 0, 0,
+                      Color(), -1, ResourceId::Null(),
+                      ResourceId::Null(), 1, cache,
+                      Path(_T("test/data/benalla9.xcm")));
+
+  ok1(file.Update(bounds, 1, 4));
+  ok1(CountShapes(file) == 4);
+
+  ok1(file.Update(bounds, 1, 4));
+  ok1(CountShapes(file) == 8);
+
+  unsigned n_calls = 2;
+  while (file.Update(bounds, 1, 4))
+    ++n_calls;
+
+  ok1(CountShapes(file) == n_total);
+  ok1(n_calls == (n_total + 3) / 4);
+}
+
+/**
+ * Destroy a TopographyFile which has not loaded all of its shapes.
+ * The destructor must skip the shapes which were never loaded.
+ */
+static void
+TestDestroyPartial(zzip_dir *dir, FileCache *cache)
+{
+  {
+    TopographyFile file(dir, "roadltrans_line.shp", 1e6, 0, 0,
+                        Color(), -1, ResourceId::Null(),
+                        ResourceId::Null(), 1, cache,
+                        Path(_T("test/data/benalla9.xcm")));
+    ok1(file.GetUsedMemory() == 0);
+  }
+
+  {
+    TopographyFile file(dir, "roadltrans_line.shp", 1e6, 0, 0,
+                        Color(), -1, ResourceId::Null(),
+                        ResourceId::Null(), 1, cache,
+                        Path(_T("test/data/benalla9.xcm")));
+    ok1(file.Update(GetTestBounds(file), 1, 4));
+    ok1(CountShapes(file) == 4);
+    ok1(file.GetUsedMemory() > 0);
+  }
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(2 * 14);
+
+  ZipArchive archive(Path(_T("test/data/benalla9.xcm")));
+
+  /* from the shapefile */
+  TestUpdateLimit(archive.get(), nullptr);
+  TestDestroyPartial(archive.get(), nullptr);
+
+  /* from the shape store */
+  Directory::Create(Path(_T("output/test")));
+  Directory::Create(Path(_T("output/test/topography-cache")));
+  FileCache cache(AllocatedPath(_T("output/test/topography-cache")));
+  TestUpdateLimit(archive.get(), &cache);
+  TestDestroyPartial(archive.get(), &cache);
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,237 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Topography/TopographyFileStore.hpp"
+#include "Topography/XShape.hpp"
+#include "Topography/Convert.hpp"
+#include "IO/ZipArchive.hpp"
+#include "OS/FileMapping.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static constexpr char store_path[] = "output/test/topography.store";
+
+/** simulate the #FileCache header which precedes the store */
+static constexpr size_t PREFIX = 24;
+
+static bool
+WriteStore(shapefileObj &file, const GeoPoint &center, int label_field)
+{
+  FILE *out = fopen(store_path, "wb");
+  if (out == nullptr)
+    return false;
+
+  static constexpr char prefix[PREFIX] = {};
+  fwrite(prefix, 1, PREFIX, out);
+
+  const float min_distance[TopographyFileStoreFormat::THINNING_LEVELS] = {};
+  const TopographyFileStoreWriter writer(file, center, label_field, 1000);
+  const bool success = writer.Write(out, min_distance);
+  return fclose(out) == 0 && success;
+}
+
+/**
+ * Make the point range of the given shape point beyond the points
+ * section.
+ */
+static bool
+CorruptShape(unsigned i)
+{
+  using namespace TopographyFileStoreFormat;
+
+  FILE *file = fopen(store_path, "r+b");
+  if (file == nullptr)
+    return false;
+
+  /* the store begins at the next aligned offset after the prefix */
+  const long base = (PREFIX + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+  Header header;
+  Shape shape;
+  bool success = fseek(file, base, SEEK_SET) == 0 &&
+    fread(&header, sizeof(header), 1, file) == 1;
+
+  const long position = base + header.shapes + i * sizeof(shape);
+  success = success &&
+    fseek(file, position, SEEK_SET) == 0 &&
+    fread(&shape, sizeof(shape), 1, file) == 1;
+
+  if (success) {
+    shape.first_point = header.n_points;
+    success = fseek(file, position, SEEK_SET) == 0 &&
+      fwrite(&shape, sizeof(shape), 1, file) == 1;
+  }
+
+  return fclose(file) == 0 && success;
+}
+
+static bool
+Equals(const XShape &a, const XShape &b)
+{
+  if (a.get_type() != b.get_type())
+    return false;
+
+  if (a.GetPoints() == nullptr)
+    return b.GetPoints() == nullptr;
+
+  if (a.get_bounds().GetWest() != b.get_bounds().GetWest() ||
+      a.get_bounds().GetSouth() != b.get_bounds().GetSouth() ||
+      a.get_bounds().GetEast() != b.get_bounds().GetEast() ||
+      a.get_bounds().GetNorth() != b.get_bounds().GetNorth())
+    return false;
+
+  const auto lines = a.GetLines(), b_lines = b.GetLines();
+  if (lines.size != b_lines.size ||
+      !std::equal(lines.begin(), lines.end(), b_lines.begin()))
+    return false;
+
+  unsigned n_points = 0;
+  for (uint16_t n : lines)
+    n_points += n;
+
+  if (memcmp(a.GetPoints(), b.GetPoints(),
+             n_points * sizeof(*a.GetPoints())) != 0)
+    return false;
+
+  if (a.GetLabel() == nullptr || b.GetLabel() == nullptr)
+    return a.GetLabel() == b.GetLabel();
+
+  return _tcscmp(a.GetLabel(), b.GetLabel()) == 0;
+}
+
+static void
+TestFile(struct zzip_dir *dir, const char *name, int label_field)
+{
+  shapefileObj file;
+  if (msShapefileOpen(&file, "rb", dir, name, 0) == -1) {
+    skip(8, 0, "failed to open shapefile");
+    return;
+  }
+
+  const unsigned n_shapes = file.numshapes;
+  const GeoPoint center = ImportRect(file.bounds).GetCenter();
+
+  ok1(WriteStore(file, center, label_field));
+
+  TopographyFileStore store(new FileMapping(Path(_T(store_path))), PREFIX);
+  ok1(store.IsValid(n_shapes, label_field, 1000));
+  ok1(!store.IsValid(n_shapes, label_field + 1, 1000));
+
+  if (!store.IsValid(n_shapes, label_field, 1000)) {
+    skip(5, 0, "invalid store");
+    msShapefileClose(&file);
+    return;
+  }
+
+  /* the mapped shapes must be identical to the ones loaded from the
+     shapefile */
+  bool equal = store.size_shapes() == n_shapes;
+  for (unsigned i = 0; equal && i < n_shapes; ++i)
+    equal = Equals(XShape(&file, center, i, label_field), XShape(store, i));
+  ok1(equal);
+
+  /* the spatial index must find exactly the shapes whose bounds
+     overlap the query */
+  const GeoBounds file_bounds = ImportRect(file.bounds);
+  const GeoPoint query_center(file_bounds.GetWest() * 0.7 +
+                              file_bounds.GetEast() * 0.3,
+                              file_bounds.GetSouth() * 0.4 +
+                              file_bounds.GetNorth() * 0.6);
+  const Angle delta = Angle::Degrees(0.1);
+  const GeoBounds query(GeoPoint(query_center.longitude - delta,
+                                 query_center.latitude + delta),
+                        GeoPoint(query_center.longitude + delta,
+                                 query_center.latitude - delta));
+
+  std::vector<bool> found;
+  bool match = store.FindShapes(query, found) && found.size() == n_shapes;
+  for (unsigned i = 0; match && i < n_shapes; ++i) {
+    const XShape shape(&file, center, i, label_field);
+    const bool expected = shape.GetPoints() != nullptr &&
+      shape.get_bounds().Overlaps(query);
+    match = found[i] == expected;
+  }
+  ok1(match);
+
+  /* a broken shape entry is not checked when the store is opened,
+     but it is never found */
+  std::vector<bool> all;
+  store.FindShapes(file_bounds, all);
+  const unsigned broken =
+    std::find(all.begin(), all.end(), true) - all.begin();
+
+  if (broken < n_shapes && CorruptShape(broken)) {
+    TopographyFileStore corrupt(new FileMapping(Path(_T(store_path))),
+                                PREFIX);
+    ok1(corrupt.IsValid(n_shapes, label_field, 1000));
+
+    std::vector<bool> found2;
+    bool match2 = corrupt.FindShapes(file_bounds, found2) &&
+      !found2[broken];
+    for (unsigned i = 0; match2 && i < n_shapes; ++i)
+      if (i != broken)
+        match2 = found2[i] == all[i];
+    ok1(match2);
+  } else
+    skip(2, 0, "no shape to corrupt");
+
+  /* a truncated store must be rejected */
+  FileMapping *mapping = new FileMapping(Path(_T(store_path)));
+  const size_t size = mapping->size();
+  delete mapping;
+  if (truncate(store_path, PREFIX + (size - PREFIX) / 2) == 0) {
+    TopographyFileStore truncated(new FileMapping(Path(_T(store_path))),
+                                  PREFIX);
+    ok1(!truncated.IsValid(n_shapes, label_field, 1000));
+  } else
+    skip(1, 0, "truncate() failed");
+
+  msShapefileClose(&file);
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(3 * 8);
+
+  Directory::Create(Path(_T("output/test")));
+
+  ZipArchive archive(Path(_T("test/data/benalla9.xcm")));
+
+  TestFile(archive.get(), "roadltrans_line.shp", -1);
+  TestFile(archive.get(), "mispopppop_point.shp", 0);
+  TestFile(archive.get(), "builtupapop_area.shp", 0);
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,102 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Topography/Prefetch.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "TestUtil.hpp"
+
+static GeoBounds
+MakeGeoBounds(double west, double north, double east, double south)
+{
+  return GeoBounds(GeoPoint(Angle::Degrees(west), Angle::Degrees(north)),
+                   GeoPoint(Angle::Degrees(east), Angle::Degrees(south)));
+}
+
+static bool
+Equals(const GeoBounds &a, double west, double north,
+       double east, double south)
+{
+  return equals(a.GetWest(), west) && equals(a.GetNorth(), north) &&
+    equals(a.GetEast(), east) && equals(a.GetSouth(), south);
+}
+
+static void
+TestPrefetchBounds()
+{
+  const GeoBounds screen = MakeGeoBounds(10, 46, 12, 44);
+
+  /* not moving: just the screen */
+  ok1(Equals(GetPrefetchBounds(screen, Angle::Zero(), 0), 10, 46, 12, 44));
+  ok1(Equals(GetPrefetchBounds(screen, Angle::Degrees(90), -10),
+             10, 46, 12, 44));
+
+  /* 50 m/s north: 6 km (0.054 degrees) ahead */
+  GeoBounds b = GetPrefetchBounds(screen, Angle::Zero(), 50);
+  ok1(equals(b.GetWest(), 10));
+  ok1(equals(b.GetEast(), 12));
+  ok1(equals(b.GetSouth(), 44));
+  ok1(b.GetNorth().Degrees() > 46.05 && b.GetNorth().Degrees() < 46.06);
+
+  /* south-west: extended to the south and to the west only */
+  b = GetPrefetchBounds(screen, Angle::Degrees(225), 100);
+  ok1(b.GetWest().Degrees() < 10 && b.GetWest().Degrees() > 9.8);
+  ok1(b.GetSouth().Degrees() < 44 && b.GetSouth().Degrees() > 43.8);
+  ok1(equals(b.GetEast(), 12));
+  ok1(equals(b.GetNorth(), 46));
+
+  /* very fast: the extension is limited to one screen size */
+  b = GetPrefetchBounds(screen, Angle::Degrees(90), 10000);
+  ok1(equals(b.GetWest(), 10));
+  ok1(equals(b.GetEast(), 14));
+  ok1(Equals(GetPrefetchBounds(screen, Angle::Degrees(180), 10000),
+             10, 46, 12, 42));
+}
+
+static void
+TestThresholdBounds()
+{
+  const GeoBounds screen = MakeGeoBounds(10, 46, 12, 44);
+  const GeoPoint center(Angle::Degrees(11), Angle::Degrees(45));
+  const GeoPoint corner(Angle::Degrees(10.2), Angle::Degrees(44.2));
+
+  /* zooming in to half the scale shows half the screen around the
+     aircraft */
+  ok1(Equals(GetThresholdBounds(screen, center, 0.5),
+             10.5, 45.5, 11.5, 44.5));
+  ok1(Equals(GetThresholdBounds(screen, corner, 0.25),
+             9.95, 44.45, 10.45, 43.95));
+
+  /* never larger than the screen */
+  ok1(Equals(GetThresholdBounds(screen, center, 1), 10, 46, 12, 44));
+  ok1(Equals(GetThresholdBounds(screen, center, 3), 10, 46, 12, 44));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(17);
+
+  TestPrefetchBounds();
+  TestThresholdBounds();
+
+  return exit_status();
+}
@@ -26,6 +26,7 @@
 #include "test_debug.hpp"
 
 #include <functional>
+#include <vector>
 
 #include <stdio.h>
 #include <tchar.h>
@@ -188,6 +189,20 @@ TestRangeVisitor(const Waypoints &waypoints, const GeoPoint &center)
   TestRangeVisitor(waypoints, center, 1000000, 151);
 }
 
+static void
+TestLandableRangeVisitor(const Waypoints &waypoints, const GeoPoint &center)
+{
+  WaypointPredicateCounter::Predicate predicate = CloserThan(10500, center);
+  WaypointPredicateCounter near_counter(predicate);
+  waypoints.VisitLandableWithinRange(center, 10500, near_counter);
+  ok1(near_counter.GetCounter() == 5);
+
+  predicate = [](const Waypoint &wp){ return wp.IsLandable(); };
+  WaypointPredicateCounter landable_counter(predicate);
+  waypoints.VisitLandableWithinRange(center, 1000000, landable_counter);
+  ok1(landable_counter.GetCounter() == 65);
+}
+
 static bool
 OriginalIDAbove5(const Waypoint &waypoint) {
   return waypoint.original_id > 5;
@@ -234,6 +249,71 @@ TestGetNearest(const Waypoints &waypoints, const GeoPoint &center)
   ok1(waypoint->original_id == 6);
 }
 
+class WaypointIdCollector : public WaypointVisitor
+{
+public:
+  std::vector<unsigned> ids;
+
+  void Visit(const WaypointPtr &wp) override {
+    ids.push_back(wp->original_id);
+  }
+};
+
+static std::vector<unsigned>
+VisitNearest(const Waypoints &waypoints, const GeoPoint &location,
+             double range, unsigned max_results, bool landable=false)
+{
+  WaypointIdCollector collector;
+  if (landable)
+    waypoints.VisitNearestLandable(location, range, max_results, collector);
+  else
+    waypoints.VisitNearest(location, range, max_results, collector);
+  return collector.ids;
+}
+
+static void
+TestVisitNearest(const Waypoints &waypoints, const GeoPoint &center)
+{
+  ok1(VisitNearest(waypoints, center, 10000, 5) ==
+      std::vector<unsigned>({0, 1, 2, 3, 4}));
+  ok1(VisitNearest(waypoints, center, 2500, 10) ==
+      std::vector<unsigned>({0, 1, 2}));
+  ok1(VisitNearest(waypoints, center, 10000, 0).empty());
+  ok1(VisitNearest(waypoints, center, 1000000, 1000).size() == 151);
+  ok1(VisitNearest(waypoints, center, 10000, 4, true) ==
+      std::vector<unsigned>({0, 3, 6, 7}));
+
+  const GeoPoint far = GeoVector(150000, Angle::Degrees(0)).EndPoint(center);
+  ok1(VisitNearest(waypoints, far, 10000, 1).size() == 1);
+}
+
+/**
+ * Modifications invalidate the search index; until the next
+ * Optimise() call, the queries are answered by the QuadTree.
+ */
+static void
+TestVisitNearestModified(const GeoPoint &center)
+{
+  Waypoints waypoints;
+  AddSpiralWaypoints(waypoints, center);
+
+  Waypoint waypoint(GeoVector(400, Angle::Degrees(90)).EndPoint(center));
+  waypoint.original_id = 1000;
+  waypoint.name = _T("Near");
+  waypoints.Append(std::move(waypoint));
+
+  ok1(VisitNearest(waypoints, center, 10000, 3) ==
+      std::vector<unsigned>({0, 1000, 1}));
+  ok1(waypoints.GetNearest(GeoVector(300, Angle::Degrees(90)).EndPoint(center),
+                           1000)->original_id == 1000);
+
+  waypoints.Optimise();
+  ok1(VisitNearest(waypoints, center, 10000, 3) ==
+      std::vector<unsigned>({0, 1000, 1}));
+  ok1(waypoints.GetNearest(GeoVector(300, Angle::Degrees(90)).EndPoint(center),
+                           1000)->original_id == 1000);
+}
+
 static void
 TestIterator(const Waypoints &waypoints)
 {
@@ -301,7 +381,7 @@ main(int argc, char** argv)
   if (!ParseArgs(argc, argv))
     return 0;
 
-  plan_tests(52);
+  plan_tests(64);
 
   Waypoints waypoints;
   GeoPoint center(Angle::Degrees(51.4), Angle::Degrees(7.85));
@@ -316,7 +396,10 @@ main(int argc, char** argv)
   TestLookups(waypoints, center);
   TestNamePrefixVisitor(waypoints);
   TestRangeVisitor(waypoints, center);
+  TestLandableRangeVisitor(waypoints, center);
   TestGetNearest(waypoints, center);
+  TestVisitNearest(waypoints, center);
+  TestVisitNearestModified(center);
   TestIterator(waypoints);
 
   ok(TestCopy(waypoints), "waypoint copy", 0);